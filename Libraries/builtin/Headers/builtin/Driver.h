@@ -9,6 +9,7 @@
 #ifndef __builtin_Driver_h
 #define __builtin_Driver_h
 
+#include <cstdio>
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -23,11 +24,54 @@ protected:
     Driver();
     virtual ~Driver();
 
+public:
+    /*
+     * Where the messages a tool prints go. By default, they are written to
+     * standard output and error. They can instead be appended to one string
+     * for both, or to a separate string for each.
+     */
+    class Output {
+    private:
+        std::string *_output;
+        std::string *_error;
+
+    public:
+        Output(std::string *output = nullptr) :
+            _output(output),
+            _error (output)
+        {
+        }
+
+        Output(std::string *output, std::string *error) :
+            _output(output),
+            _error (error)
+        {
+        }
+
+    public:
+        /*
+         * The string messages for a stream are appended to, or null to
+         * write them to the stream.
+         */
+        std::string *capture(FILE *stream) const
+        { return (stream == stderr ? _error : _output); }
+    };
+
 public:
     virtual std::string name() = 0;
 
 public:
-    virtual int run(process::Context const *processContext, libutil::Filesystem *filesystem) = 0;
+    /*
+     * Run the tool. Drivers don't share state between runs, so a driver can
+     * run more than once at the same time.
+     */
+    virtual int run(process::Context const *processContext, libutil::Filesystem *filesystem, Output const &output = Output()) = 0;
+
+public:
+    /*
+     * Print a message from a tool to `stream`, or where `output` captures it.
+     */
+    static void Print(Output const &output, FILE *stream, char const *format, ...);
 };
 
 }
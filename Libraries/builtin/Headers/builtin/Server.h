@@ -0,0 +1,108 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef __builtin_Server_h
+#define __builtin_Server_h
+
+#include <builtin/Registry.h>
+
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace libutil { class Filesystem; }
+namespace libutil { class ThreadPool; }
+namespace process { class Context; }
+
+namespace builtin {
+
+/*
+ * Runs builtin tools for other processes, over a local socket. Running a
+ * tool this way costs a round trip rather than starting a new process for
+ * each invocation. Clients send the command line, working directory, and
+ * environment of a tool, and get back its exit code, standard output, and
+ * standard error.
+ */
+class Server {
+private:
+    Registry                             _registry;
+    libutil::Filesystem                 *_filesystem;
+
+private:
+    std::string                          _path;
+    int                                  _socket;
+    int                                  _wake[2];
+    std::thread                          _thread;
+    std::unique_ptr<libutil::ThreadPool> _pool;
+
+public:
+    /*
+     * Create a server running the tools in a registry.
+     */
+    Server(Registry const &registry, libutil::Filesystem *filesystem);
+
+    /*
+     * Stops the server, if started.
+     */
+    ~Server();
+
+    Server(Server const &) = delete;
+    Server &operator=(Server const &) = delete;
+
+public:
+    /*
+     * Start accepting clients at a socket path, in the background. Fails if
+     * the socket can't be created, or if its directory can be accessed by
+     * other users.
+     */
+    bool start(std::string const &path);
+
+    /*
+     * Stop accepting clients and wait for running tools to finish.
+     */
+    void stop();
+
+private:
+    void accept();
+    void handle(int connection);
+
+public:
+    /*
+     * The result of running a tool with a server.
+     */
+    enum class ForwardResult {
+        /*
+         * The server ran the tool.
+         */
+        Finished,
+
+        /*
+         * The tool didn't run: there is no server at the path, or the server
+         * can't run the tool. The tool can be run some other way instead.
+         */
+        NotHandled,
+
+        /*
+         * The request or its reply was lost, so the tool may have run.
+         */
+        Failed,
+    };
+
+    /*
+     * Run a builtin tool with a server at a socket path. The tool is found by
+     * the name of the context's executable. Once it has finished, its exit
+     * code is stored in `exitCode`, and what it printed to standard output
+     * and error is appended to `output` and `error`.
+     */
+    static ForwardResult
+    Forward(std::string const &path, process::Context const *context, int *exitCode, std::string *output, std::string *error);
+};
+
+}
+
+#endif // !__builtin_Server_h
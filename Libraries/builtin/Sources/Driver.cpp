@@ -8,6 +8,8 @@
 
 #include <builtin/Driver.h>
 
+#include <cstdarg>
+
 using builtin::Driver;
 
 Driver::
@@ -20,3 +22,29 @@ Driver::
 {
 }
 
+void Driver::
+Print(Output const &output, FILE *stream, char const *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+
+    std::string *capture = output.capture(stream);
+    if (capture == nullptr) {
+        vfprintf(stream, format, args);
+    } else {
+        va_list copy;
+        va_copy(copy, args);
+        int size = vsnprintf(nullptr, 0, format, copy);
+        va_end(copy);
+
+        if (size > 0) {
+            /* Format in place, including the terminator, then remove it. */
+            size_t offset = capture->size();
+            capture->resize(offset + size + 1);
+            vsnprintf(&(*capture)[offset], size + 1, format, args);
+            capture->resize(offset + size);
+        }
+    }
+
+    va_end(args);
+}
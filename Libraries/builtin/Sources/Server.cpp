@@ -0,0 +1,517 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree.
+ */
+
+#include <builtin/Server.h>
+#include <builtin/Driver.h>
+#include <libutil/FSUtil.h>
+#include <libutil/ThreadPool.h>
+#include <process/Context.h>
+#include <process/MemoryContext.h>
+
+#include <cerrno>
+#include <cstring>
+
+#if !_WIN32
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+using builtin::Server;
+using builtin::Driver;
+using builtin::Registry;
+using libutil::Filesystem;
+using libutil::FSUtil;
+using libutil::ThreadPool;
+
+#if !_WIN32
+/*
+ * Increment when the messages between client and server change.
+ */
+static uint32_t const ProtocolVersion = 2;
+
+namespace {
+
+/*
+ * Builds a message out of integers and strings.
+ */
+class MessageWriter {
+private:
+    std::string _contents;
+
+public:
+    std::string const &contents() const
+    { return _contents; }
+
+public:
+    void integer(uint32_t value)
+    { _contents.append(reinterpret_cast<char const *>(&value), sizeof(value)); }
+    void string(std::string const &value)
+    { integer(static_cast<uint32_t>(value.size())); _contents.append(value); }
+};
+
+/*
+ * Reads integers and strings from a message. Fails past the end.
+ */
+class MessageReader {
+private:
+    std::string const &_contents;
+    size_t             _offset;
+
+public:
+    explicit MessageReader(std::string const &contents) :
+        _contents(contents),
+        _offset  (0)
+    {
+    }
+
+public:
+    bool integer(uint32_t *value)
+    {
+        if (_contents.size() - _offset < sizeof(*value)) {
+            return false;
+        }
+
+        memcpy(value, _contents.data() + _offset, sizeof(*value));
+        _offset += sizeof(*value);
+        return true;
+    }
+
+    bool string(std::string *value)
+    {
+        uint32_t size;
+        if (!integer(&size) || _contents.size() - _offset < size) {
+            return false;
+        }
+
+        value->assign(_contents, _offset, size);
+        _offset += size;
+        return true;
+    }
+};
+
+}
+
+/*
+ * Only this user should be able to create or connect to sockets in the
+ * directory. Otherwise, another user could run tools as this one, or
+ * pretend to be the server.
+ */
+static bool
+PrivateDirectory(std::string const &directory, bool create)
+{
+    if (create && ::mkdir(directory.c_str(), 0700) != 0 && errno != EEXIST) {
+        return false;
+    }
+
+    struct stat st;
+    if (::lstat(directory.c_str(), &st) != 0) {
+        return false;
+    }
+
+    return (S_ISDIR(st.st_mode) && st.st_uid == ::geteuid() && (st.st_mode & 077) == 0);
+}
+
+static bool
+SocketAddress(std::string const &path, struct sockaddr_un *address)
+{
+    memset(address, 0, sizeof(*address));
+    address->sun_family = AF_UNIX;
+
+    /* Socket paths are limited to a short length. */
+    if (path.size() >= sizeof(address->sun_path)) {
+        return false;
+    }
+
+    memcpy(address->sun_path, path.c_str(), path.size() + 1);
+    return true;
+}
+
+/*
+ * Prepare a socket: don't pass it on to launched processes, and don't
+ * raise a signal if writing to a socket the other side has closed.
+ */
+static void
+ConfigureSocket(int fd)
+{
+    ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+#if defined(SO_NOSIGPIPE)
+    int value = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &value, sizeof(value));
+#endif
+}
+
+static int
+Connect(std::string const &path)
+{
+    struct sockaddr_un address;
+    if (!SocketAddress(path, &address)) {
+        return -1;
+    }
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd == -1) {
+        return -1;
+    }
+    ConfigureSocket(fd);
+
+    if (::connect(fd, reinterpret_cast<struct sockaddr *>(&address), sizeof(address)) != 0) {
+        ::close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+static bool
+WriteAll(int fd, char const *data, size_t size)
+{
+#if defined(MSG_NOSIGNAL)
+    int flags = MSG_NOSIGNAL;
+#else
+    int flags = 0;
+#endif
+
+    while (size > 0) {
+        ssize_t written = ::send(fd, data, size, flags);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+
+        data += written;
+        size -= written;
+    }
+
+    return true;
+}
+
+static bool
+ReadAll(int fd, char *data, size_t size)
+{
+    while (size > 0) {
+        ssize_t read = ::read(fd, data, size);
+        if (read < 0 && errno == EINTR) {
+            continue;
+        } else if (read <= 0) {
+            return false;
+        }
+
+        data += read;
+        size -= read;
+    }
+
+    return true;
+}
+
+/*
+ * Messages are sent as their size, followed by their contents.
+ */
+static bool
+SendMessage(int fd, std::string const &message)
+{
+    uint32_t size = static_cast<uint32_t>(message.size());
+    return WriteAll(fd, reinterpret_cast<char const *>(&size), sizeof(size)) && WriteAll(fd, message.data(), message.size());
+}
+
+static bool
+ReceiveMessage(int fd, std::string *message)
+{
+    uint32_t size;
+    if (!ReadAll(fd, reinterpret_cast<char *>(&size), sizeof(size))) {
+        return false;
+    }
+
+    message->resize(size);
+    return (size == 0 || ReadAll(fd, &(*message)[0], size));
+}
+#endif
+
+Server::
+Server(Registry const &registry, Filesystem *filesystem) :
+    _registry  (registry),
+    _filesystem(filesystem),
+    _socket    (-1),
+    _wake      { -1, -1 }
+{
+}
+
+Server::
+~Server()
+{
+    stop();
+}
+
+bool Server::
+start(std::string const &path)
+{
+#if _WIN32
+    return false;
+#else
+    if (_socket != -1) {
+        return false;
+    }
+
+    if (!PrivateDirectory(FSUtil::GetDirectoryName(path), true)) {
+        return false;
+    }
+
+    struct sockaddr_un address;
+    if (!SocketAddress(path, &address)) {
+        return false;
+    }
+
+    /*
+     * If another server is already running at this path, leave it be: its
+     * clients would be disconnected by replacing it. Otherwise, remove any
+     * socket left behind by a server that didn't stop.
+     */
+    int existing = Connect(path);
+    if (existing != -1) {
+        ::close(existing);
+        return false;
+    }
+    ::unlink(path.c_str());
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd == -1) {
+        return false;
+    }
+    ConfigureSocket(fd);
+
+    if (::bind(fd, reinterpret_cast<struct sockaddr *>(&address), sizeof(address)) != 0 || ::listen(fd, SOMAXCONN) != 0) {
+        ::close(fd);
+        return false;
+    }
+
+    /* Written to when stopping, to wake up the thread accepting clients. */
+    if (::pipe(_wake) != 0) {
+        ::close(fd);
+        ::unlink(path.c_str());
+        return false;
+    }
+    ::fcntl(_wake[0], F_SETFD, FD_CLOEXEC);
+    ::fcntl(_wake[1], F_SETFD, FD_CLOEXEC);
+
+    _path = path;
+    _socket = fd;
+    _pool = std::unique_ptr<ThreadPool>(new ThreadPool(ThreadPool::DefaultThreadCount()));
+    _thread = std::thread([this] {
+        this->accept();
+    });
+
+    return true;
+#endif
+}
+
+void Server::
+stop()
+{
+#if !_WIN32
+    if (_socket == -1) {
+        return;
+    }
+
+    char stop = 0;
+    while (::write(_wake[1], &stop, sizeof(stop)) < 0 && errno == EINTR) {
+    }
+    _thread.join();
+
+    /* Wait for tools still running. */
+    _pool.reset();
+
+    ::close(_socket);
+    ::close(_wake[0]);
+    ::close(_wake[1]);
+    ::unlink(_path.c_str());
+
+    _socket = -1;
+    _wake[0] = -1;
+    _wake[1] = -1;
+#endif
+}
+
+void Server::
+accept()
+{
+#if !_WIN32
+    while (true) {
+        struct pollfd fds[2] = {
+            { _socket, POLLIN, 0 },
+            { _wake[0], POLLIN, 0 },
+        };
+
+        if (::poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+
+        if (fds[1].revents != 0) {
+            /* Stopping. */
+            break;
+        }
+
+        if (fds[0].revents != 0) {
+            int connection = ::accept(_socket, nullptr, nullptr);
+            if (connection == -1) {
+                continue;
+            }
+            ConfigureSocket(connection);
+
+            /* Each client runs one tool. Run tools at the same time as each other. */
+            _pool->dispatch([this, connection] {
+                this->handle(connection);
+                ::close(connection);
+            });
+        }
+    }
+#endif
+}
+
+void Server::
+handle(int connection)
+{
+#if !_WIN32
+    std::string request;
+    if (!ReceiveMessage(connection, &request)) {
+        return;
+    }
+
+    MessageReader reader = MessageReader(request);
+    MessageWriter response;
+
+    uint32_t version;
+    if (!reader.integer(&version) || version != ProtocolVersion) {
+        /* Can't run the tool; the client will run it instead. */
+        response.integer(0);
+        SendMessage(connection, response.contents());
+        return;
+    }
+
+    std::string executable;
+    std::string directory;
+    uint32_t count;
+    std::vector<std::string> arguments;
+    std::unordered_map<std::string, std::string> environment;
+
+    if (!reader.string(&executable) || !reader.integer(&count)) {
+        return;
+    }
+
+    for (uint32_t n = 0; n < count; n++) {
+        std::string argument;
+        if (!reader.string(&argument)) {
+            return;
+        }
+        arguments.push_back(argument);
+    }
+
+    if (!reader.string(&directory) || !reader.integer(&count)) {
+        return;
+    }
+
+    for (uint32_t n = 0; n < count; n++) {
+        std::string name;
+        std::string value;
+        if (!reader.string(&name) || !reader.string(&value)) {
+            return;
+        }
+        environment.insert({ name, value });
+    }
+
+    std::shared_ptr<Driver> driver = _registry.driver(FSUtil::GetBaseName(executable));
+    if (driver == nullptr) {
+        response.integer(0);
+    } else {
+        process::MemoryContext context = process::MemoryContext(executable, directory, arguments, environment);
+
+        std::string output;
+        std::string error;
+        int exitCode = driver->run(&context, _filesystem, Driver::Output(&output, &error));
+
+        response.integer(1);
+        response.integer(static_cast<uint32_t>(exitCode));
+        response.string(output);
+        response.string(error);
+    }
+
+    SendMessage(connection, response.contents());
+#endif
+}
+
+Server::ForwardResult Server::
+Forward(std::string const &path, process::Context const *context, int *exitCode, std::string *output, std::string *error)
+{
+#if _WIN32
+    return ForwardResult::NotHandled;
+#else
+    if (!PrivateDirectory(FSUtil::GetDirectoryName(path), false)) {
+        return ForwardResult::NotHandled;
+    }
+
+    int fd = Connect(path);
+    if (fd == -1) {
+        /* No server running. */
+        return ForwardResult::NotHandled;
+    }
+
+    MessageWriter request;
+    request.integer(ProtocolVersion);
+    request.string(context->executablePath());
+    request.integer(static_cast<uint32_t>(context->commandLineArguments().size()));
+    for (std::string const &argument : context->commandLineArguments()) {
+        request.string(argument);
+    }
+    request.string(context->currentDirectory());
+    request.integer(static_cast<uint32_t>(context->environmentVariables().size()));
+    for (auto const &variable : context->environmentVariables()) {
+        request.string(variable.first);
+        request.string(variable.second);
+    }
+
+    /*
+     * Once the request is sent, the server could run the tool. Running it
+     * again elsewhere would repeat its effects, so it's only safe to do
+     * that if the server replies that it didn't.
+     */
+    std::string response;
+    bool success = SendMessage(fd, request.contents()) && ReceiveMessage(fd, &response);
+    ::close(fd);
+    if (!success) {
+        return ForwardResult::Failed;
+    }
+
+    MessageReader reader = MessageReader(response);
+
+    uint32_t handled;
+    if (!reader.integer(&handled)) {
+        return ForwardResult::Failed;
+    } else if (handled == 0) {
+        return ForwardResult::NotHandled;
+    }
+
+    uint32_t code;
+    std::string standardOutput;
+    std::string standardError;
+    if (!reader.integer(&code) || !reader.string(&standardOutput) || !reader.string(&standardError)) {
+        return ForwardResult::Failed;
+    }
+
+    *exitCode = static_cast<int>(code);
+    output->append(standardOutput);
+    error->append(standardError);
+    return ForwardResult::Finished;
+#endif
+}
@@ -92,27 +92,28 @@ CopyPath(Filesystem *filesystem, std::string const &inputPath, std::string const
 }
 
 static int
-Run(Filesystem *filesystem, Options const &options, std::string const &workingDirectory)
+Run(Filesystem *filesystem, Options const &options, std::string const &workingDirectory, Driver::Output const &output)
 {
     if (!options.output()) {
-        fprintf(stderr, "error: no output path provided\n");
+        Driver::Print(output, stderr, "error: no output path provided\n");
         return 1;
     }
 
     if (options.stripDebugSymbols() || options.bitcodeStrip() != Options::BitcodeStripMode::None) {
         // TODO(grp): Implement strip support when copying.
 #if 0
-        fprintf(stderr, "warning: strip on copy is not supported\n");
+        Driver::Print(output, stderr, "warning: strip on copy is not supported\n");
 #endif
     }
 
     if (options.preserveHFSData()) {
-        fprintf(stderr, "warning: preserve HFS data is not supported\n");
+        Driver::Print(output, stderr, "warning: preserve HFS data is not supported\n");
     }
 
-    std::string const &output = FSUtil::ResolveRelativePath(*options.output(), workingDirectory);
-    if (!filesystem->createDirectory(output, true)) {
-        return false;
+    std::string const &outputDirectory = FSUtil::ResolveRelativePath(*options.output(), workingDirectory);
+    if (!filesystem->createDirectory(outputDirectory, true)) {
+        Driver::Print(output, stderr, "error: unable to create output directory '%s'\n", outputDirectory.c_str());
+        return 1;
     }
 
 #if 0
@@ -131,16 +132,16 @@ Run(Filesystem *filesystem, Options const &options, std::string const &workingDi
             if (options.ignoreMissingInputs()) {
                 continue;
             } else {
-                fprintf(stderr, "error: missing input '%s'\n", input.c_str());
+                Driver::Print(output, stderr, "error: missing input '%s'\n", input.c_str());
                 return 1;
             }
         }
 
         if (options.verbose()) {
-            printf("verbose: copying %s -> %s\n", input.c_str(), output.c_str());
+            Driver::Print(output, stdout, "verbose: copying %s -> %s\n", input.c_str(), outputDirectory.c_str());
         }
 
-        std::string outputPath = output + "/" + FSUtil::GetBaseName(input);
+        std::string outputPath = outputDirectory + "/" + FSUtil::GetBaseName(input);
         if (!CopyPath(filesystem, input, outputPath)) {
             return 1;
         }
@@ -150,14 +151,14 @@ Run(Filesystem *filesystem, Options const &options, std::string const &workingDi
 }
 
 int Driver::
-run(process::Context const *processContext, libutil::Filesystem *filesystem)
+run(process::Context const *processContext, libutil::Filesystem *filesystem, Driver::Output const &output)
 {
     Options options;
     std::pair<bool, std::string> result = libutil::Options::Parse<Options>(&options, processContext->commandLineArguments());
     if (!result.first) {
-        fprintf(stderr, "error: %s\n", result.second.c_str());
+        Driver::Print(output, stderr, "error: %s\n", result.second.c_str());
         return 1;
     }
 
-    return Run(filesystem, options, processContext->currentDirectory());
+    return Run(filesystem, options, processContext->currentDirectory(), output);
 }
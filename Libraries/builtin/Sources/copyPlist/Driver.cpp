@@ -36,12 +36,12 @@ name()
 }
 
 int Driver::
-run(process::Context const *processContext, libutil::Filesystem *filesystem)
+run(process::Context const *processContext, libutil::Filesystem *filesystem, Driver::Output const &output)
 {
     Options options;
     std::pair<bool, std::string> result = libutil::Options::Parse<Options>(&options, processContext->commandLineArguments());
     if (!result.first) {
-        fprintf(stderr, "error: %s\n", result.second.c_str());
+        Driver::Print(output, stderr, "error: %s\n", result.second.c_str());
         return 1;
     }
 
@@ -50,7 +50,7 @@ run(process::Context const *processContext, libutil::Filesystem *filesystem)
      * now since the behavior without one is also unclear.
      */
     if (!options.outputDirectory()) {
-        fprintf(stderr, "error: output directory not provided\n");
+        Driver::Print(output, stderr, "error: output directory not provided\n");
         return 1;
     }
 
@@ -58,7 +58,7 @@ run(process::Context const *processContext, libutil::Filesystem *filesystem)
      * Require at least one input.
      */
     if (options.inputs().empty()) {
-        fprintf(stderr, "error: no input files provided\n");
+        Driver::Print(output, stderr, "error: no input files provided\n");
         return 1;
     }
 
@@ -80,7 +80,7 @@ run(process::Context const *processContext, libutil::Filesystem *filesystem)
                 plist::Format::ASCII::Create(false, plist::Format::Encoding::UTF8)
             )));
         } else {
-            fprintf(stderr, "error: unknown output format %s\n", options.convertFormat()->c_str());
+            Driver::Print(output, stderr, "error: unknown output format %s\n", options.convertFormat()->c_str());
             return 1;
         }
     }
@@ -92,7 +92,7 @@ run(process::Context const *processContext, libutil::Filesystem *filesystem)
         /* Read in the input. */
         std::vector<uint8_t> inputContents;
         if (!filesystem->read(&inputContents, FSUtil::ResolveRelativePath(inputPath, processContext->currentDirectory()))) {
-            fprintf(stderr, "error: unable to read input %s\n", inputPath.c_str());
+            Driver::Print(output, stderr, "error: unable to read input %s\n", inputPath.c_str());
             return 1;
         }
 
@@ -107,14 +107,14 @@ run(process::Context const *processContext, libutil::Filesystem *filesystem)
             /* Determine the input format. */
             std::unique_ptr<plist::Format::Any> inputFormat = plist::Format::Any::Identify(inputContents);
             if (inputFormat == nullptr) {
-                fprintf(stderr, "error: input %s is not a plist\n", inputPath.c_str());
+                Driver::Print(output, stderr, "error: input %s is not a plist\n", inputPath.c_str());
                 return 1;
             }
 
             /* Deserialize the input. */
             auto deserialize = plist::Format::Any::Deserialize(inputContents, *inputFormat);
             if (!deserialize.first) {
-                fprintf(stderr, "error: %s: %s\n", inputPath.c_str(), deserialize.second.c_str());
+                Driver::Print(output, stderr, "error: %s: %s\n", inputPath.c_str(), deserialize.second.c_str());
                 return 1;
             }
 
@@ -124,7 +124,7 @@ run(process::Context const *processContext, libutil::Filesystem *filesystem)
             /* Serialize the output. */
             auto serialize = plist::Format::Any::Serialize(deserialize.first.get(), outputFormat);
             if (serialize.first == nullptr) {
-                fprintf(stderr, "error: %s: %s\n", inputPath.c_str(), serialize.second.c_str());
+                Driver::Print(output, stderr, "error: %s: %s\n", inputPath.c_str(), serialize.second.c_str());
                 return 1;
             }
 
@@ -136,7 +136,7 @@ run(process::Context const *processContext, libutil::Filesystem *filesystem)
 
         /* Write out the output. */
         if (!filesystem->write(outputContents, outputPath)) {
-            fprintf(stderr, "error: could not open output path %s to write\n", outputPath.c_str());
+            Driver::Print(output, stderr, "error: could not open output path %s to write\n", outputPath.c_str());
             return 1;
         }
     }
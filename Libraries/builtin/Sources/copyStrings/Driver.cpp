@@ -86,7 +86,7 @@ ValidateStrings(plist::Object const *root)
 }
 
 static bool
-ValidateOptions(Options const &options)
+ValidateOptions(Options const &options, Driver::Output const &output)
 {
 
     /*
@@ -94,7 +94,7 @@ ValidateOptions(Options const &options)
      * now since the behavior without one is also unclear.
      */
     if (!options.outputDirectory()) {
-        fprintf(stderr, "error: output directory not provided\n");
+        Driver::Print(output, stderr, "error: output directory not provided\n");
         return false;
     }
 
@@ -102,7 +102,7 @@ ValidateOptions(Options const &options)
      * Require at least one input.
      */
     if (options.inputs().empty()) {
-        fprintf(stderr, "error: no input files provided\n");
+        Driver::Print(output, stderr, "error: no input files provided\n");
         return false;
     }
 
@@ -110,19 +110,19 @@ ValidateOptions(Options const &options)
 }
 
 int Driver::
-run(process::Context const *processContext, libutil::Filesystem *filesystem)
+run(process::Context const *processContext, libutil::Filesystem *filesystem, Driver::Output const &output)
 {
     Options options;
     std::pair<bool, std::string> result = libutil::Options::Parse<Options>(&options, processContext->commandLineArguments());
     if (!result.first) {
-        fprintf(stderr, "error: %s\n", result.second.c_str());
+        Driver::Print(output, stderr, "error: %s\n", result.second.c_str());
         return -1;
     }
 
     /*
      * Validate options.
      */
-    if (!ValidateOptions(options)) {
+    if (!ValidateOptions(options, output)) {
         return -1;
     }
 
@@ -131,7 +131,7 @@ run(process::Context const *processContext, libutil::Filesystem *filesystem)
      */
     plist::Format::Any outputFormat = plist::Format::Any::Create(plist::Format::ASCII::Create(true, plist::Format::Encoding::UTF16LE));
     if (options.outputEncoding() && !ParseStringsEncoding(*options.outputEncoding(), &outputFormat)) {
-        fprintf(stderr, "error: invalid output encoding '%s'\n", options.outputEncoding()->c_str());
+        Driver::Print(output, stderr, "error: invalid output encoding '%s'\n", options.outputEncoding()->c_str());
         return -1;
     }
 
@@ -143,28 +143,28 @@ run(process::Context const *processContext, libutil::Filesystem *filesystem)
         std::string resolvedInputPath = FSUtil::ResolveRelativePath(inputPath, processContext->currentDirectory());
         std::vector<uint8_t> inputContents;
         if (!filesystem->read(&inputContents, resolvedInputPath)) {
-            fprintf(stderr, "error: unable to read input %s\n", inputPath.c_str());
+            Driver::Print(output, stderr, "error: unable to read input %s\n", inputPath.c_str());
             return 1;
         }
 
         /* Determine the input format. */
         std::unique_ptr<plist::Format::Any> inputFormat = plist::Format::Any::Identify(inputContents);
         if (inputFormat == nullptr) {
-            fprintf(stderr, "error: input %s is not a plist\n", inputPath.c_str());
+            Driver::Print(output, stderr, "error: input %s is not a plist\n", inputPath.c_str());
             return 1;
         }
 
         /* If no input format was specified, use the detected strings encoding. */
         plist::Format::Any resolvedInputFormat = *inputFormat;
         if (options.inputEncoding() && !ParseStringsEncoding(*options.inputEncoding(), &resolvedInputFormat)) {
-            fprintf(stderr, "error: invalid input encoding '%s'\n", options.inputEncoding()->c_str());
+            Driver::Print(output, stderr, "error: invalid input encoding '%s'\n", options.inputEncoding()->c_str());
             return -1;
         }
 
         /* Deserialize the input. */
         auto deserialize = plist::Format::Any::Deserialize(inputContents, resolvedInputFormat);
         if (!deserialize.first) {
-            fprintf(stderr, "error: %s: %s\n", inputPath.c_str(), deserialize.second.c_str());
+            Driver::Print(output, stderr, "error: %s: %s\n", inputPath.c_str(), deserialize.second.c_str());
             return 1;
         }
 
@@ -172,7 +172,7 @@ run(process::Context const *processContext, libutil::Filesystem *filesystem)
         if (options.validate()) {
             auto validation = ValidateStrings(deserialize.first.get());
             if (!validation.first) {
-                fprintf(stderr, "error: %s: %s\n", inputPath.c_str(), validation.second.c_str());
+                Driver::Print(output, stderr, "error: %s: %s\n", inputPath.c_str(), validation.second.c_str());
                 return 1;
             }
         }
@@ -183,12 +183,12 @@ run(process::Context const *processContext, libutil::Filesystem *filesystem)
         /* Write out the output. */
         auto serialize = plist::Format::Any::Serialize(deserialize.first.get(), outputFormat);
         if (serialize.first == nullptr) {
-            fprintf(stderr, "error: %s: %s\n", inputPath.c_str(), serialize.second.c_str());
+            Driver::Print(output, stderr, "error: %s: %s\n", inputPath.c_str(), serialize.second.c_str());
             return 1;
         }
 
         if (!filesystem->write(*serialize.first, outputPath)) {
-            fprintf(stderr, "error: %s: could not write output\n", inputPath.c_str());
+            Driver::Print(output, stderr, "error: %s: could not write output\n", inputPath.c_str());
             return 1;
         }
     }
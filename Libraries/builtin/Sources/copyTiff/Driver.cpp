@@ -32,16 +32,16 @@ name()
 }
 
 int Driver::
-run(process::Context const *processContext, libutil::Filesystem *filesystem)
+run(process::Context const *processContext, libutil::Filesystem *filesystem, Driver::Output const &output)
 {
     Options options;
     std::pair<bool, std::string> result = libutil::Options::Parse<Options>(&options, processContext->commandLineArguments());
     if (!result.first) {
-        fprintf(stderr, "error: %s\n", result.second.c_str());
+        Driver::Print(output, stderr, "error: %s\n", result.second.c_str());
         return 1;
     }
 
     // TODO(grp): Implement copy tiff builtin.
-    fprintf(stderr, "error: copy tiff not supported\n");
+    Driver::Print(output, stderr, "error: copy tiff not supported\n");
     return 1;
 }
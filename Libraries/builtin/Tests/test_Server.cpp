@@ -0,0 +1,141 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+#include <builtin/Server.h>
+#include <builtin/Driver.h>
+#include <builtin/Registry.h>
+#include <libutil/MemoryFilesystem.h>
+#include <process/MemoryContext.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using builtin::Server;
+using builtin::Registry;
+using libutil::MemoryFilesystem;
+
+namespace {
+
+class EchoDriver : public builtin::Driver {
+public:
+    virtual std::string name()
+    { return "builtin-echo"; }
+
+    virtual int run(process::Context const *processContext, libutil::Filesystem *filesystem, Output const &output = Output())
+    {
+        for (std::string const &argument : processContext->commandLineArguments()) {
+            Driver::Print(output, stdout, "%s ", argument.c_str());
+        }
+        Driver::Print(output, stdout, "%s %s",
+            processContext->currentDirectory().c_str(),
+            processContext->environmentVariable("ECHO").value_or("").c_str());
+        Driver::Print(output, stderr, "error");
+        return static_cast<int>(processContext->commandLineArguments().size());
+    }
+};
+
+}
+
+static std::string
+SocketDirectory()
+{
+    char path[] = "/tmp/builtin-test-XXXXXX";
+    return ::mkdtemp(path);
+}
+
+TEST(Server, Forward)
+{
+    std::string directory = SocketDirectory();
+    std::string path = directory + "/server.sock";
+
+    MemoryFilesystem filesystem = MemoryFilesystem({ });
+    Server server(Registry::Create({ std::make_shared<EchoDriver>() }), &filesystem);
+    ASSERT_TRUE(server.start(path));
+
+    /* Only one server at a time. */
+    Server other(Registry::Create({ }), &filesystem);
+    EXPECT_FALSE(other.start(path));
+
+    process::MemoryContext context = process::MemoryContext(
+        "/usr/bin/builtin-echo",
+        "/directory",
+        { "one", "two" },
+        { { "ECHO", "value" } });
+
+    /* Standard output and error are kept separate. */
+    int exitCode = -1;
+    std::string output;
+    std::string error;
+    EXPECT_EQ(Server::ForwardResult::Finished, Server::Forward(path, &context, &exitCode, &output, &error));
+    EXPECT_EQ(2, exitCode);
+    EXPECT_EQ("one two /directory value", output);
+    EXPECT_EQ("error", error);
+
+    /* Unknown tools are left to the client. */
+    process::MemoryContext unknown = process::MemoryContext("/usr/bin/builtin-unknown", "/", { }, { });
+    EXPECT_EQ(Server::ForwardResult::NotHandled, Server::Forward(path, &unknown, &exitCode, &output, &error));
+
+    server.stop();
+    EXPECT_EQ(Server::ForwardResult::NotHandled, Server::Forward(path, &context, &exitCode, &output, &error));
+
+    ::rmdir(directory.c_str());
+}
+
+TEST(Server, NoReply)
+{
+    std::string directory = SocketDirectory();
+    std::string path = directory + "/server.sock";
+
+    /* A server that takes the request, then goes away without replying. */
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    ASSERT_NE(-1, fd);
+    ASSERT_EQ(0, ::bind(fd, reinterpret_cast<struct sockaddr *>(&address), sizeof(address)));
+    ASSERT_EQ(0, ::listen(fd, 1));
+
+    std::thread thread = std::thread([fd] {
+        int connection = ::accept(fd, nullptr, nullptr);
+        char buffer[64];
+        ::read(connection, buffer, sizeof(buffer));
+        ::close(connection);
+    });
+
+    /* The tool could have run, so it isn't safe to run it again. */
+    process::MemoryContext context = process::MemoryContext("/usr/bin/builtin-echo", "/", { }, { });
+    int exitCode = -1;
+    std::string output;
+    std::string error;
+    EXPECT_EQ(Server::ForwardResult::Failed, Server::Forward(path, &context, &exitCode, &output, &error));
+
+    thread.join();
+    ::close(fd);
+    ::unlink(path.c_str());
+    ::rmdir(directory.c_str());
+}
+
+TEST(Server, PrivateDirectory)
+{
+    std::string directory = SocketDirectory();
+    ASSERT_EQ(0, ::chmod(directory.c_str(), 0755));
+
+    MemoryFilesystem filesystem = MemoryFilesystem({ });
+    Server server(Registry::Create({ }), &filesystem);
+    EXPECT_FALSE(server.start(directory + "/server.sock"));
+
+    ::rmdir(directory.c_str());
+}
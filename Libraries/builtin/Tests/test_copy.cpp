@@ -91,7 +91,9 @@ TEST(copy, IgnoreMissingOutput)
 
     /* Missing input should fail if not allowed. */
     auto fail = process::MemoryContext(filesystem.path(driver.name()), filesystem.path(""), { "exists", "missing", "output", }, std::unordered_map<std::string, std::string>());
-    EXPECT_NE(0, driver.run(&fail, &filesystem));
+    std::string output;
+    EXPECT_NE(0, driver.run(&fail, &filesystem, &output));
+    EXPECT_EQ("error: missing input '" + filesystem.path("missing") + "'\n", output);
 
     /* Missing input should succeed when allowed. */
     auto succeed = process::MemoryContext(filesystem.path(driver.name()), filesystem.path(""), { "-ignore-missing-inputs", "exists", "missing", "output", }, std::unordered_map<std::string, std::string>());
@@ -0,0 +1,58 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree.
+ */
+
+#include <builtin/Server.h>
+#include <process/DefaultContext.h>
+#include <process/MemoryContext.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+
+/*
+ * Runs a builtin tool with the server at a socket, without starting the
+ * tool itself. If there's no server to run it, runs the tool directly. If
+ * the server was asked to run the tool but didn't reply, fails rather than
+ * risk running the tool twice.
+ *
+ * Usage: builtin-client <socket> <tool> [arguments...]
+ */
+int
+main(int argc, char **argv, char **envp)
+{
+    if (argc < 3) {
+        fprintf(stderr, "usage: %s socket tool [arguments...]\n", argv[0]);
+        return 1;
+    }
+
+    process::DefaultContext processContext = process::DefaultContext();
+    process::MemoryContext toolContext = process::MemoryContext(
+        argv[2],
+        processContext.currentDirectory(),
+        std::vector<std::string>(argv + 3, argv + argc),
+        processContext.environmentVariables());
+
+    int exitCode;
+    std::string output;
+    std::string error;
+    switch (builtin::Server::Forward(argv[1], &toolContext, &exitCode, &output, &error)) {
+        case builtin::Server::ForwardResult::Finished:
+            fwrite(output.data(), 1, output.size(), stdout);
+            fwrite(error.data(), 1, error.size(), stderr);
+            return exitCode;
+        case builtin::Server::ForwardResult::NotHandled:
+            ::execve(argv[2], argv + 2, envp);
+            perror(argv[2]);
+            return 1;
+        case builtin::Server::ForwardResult::Failed:
+            fprintf(stderr, "error: lost connection to builtin server running %s\n", argv[2]);
+            return 1;
+    }
+
+    abort();
+}
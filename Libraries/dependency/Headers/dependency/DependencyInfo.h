@@ -9,8 +9,13 @@
 #ifndef __dependency_DependencyInfo_h
 #define __dependency_DependencyInfo_h
 
+#include <dependency/DependencyInfoFormat.h>
+
 #include <string>
 #include <vector>
+#include <ext/optional>
+
+namespace libutil { class Filesystem; }
 
 namespace dependency {
 
@@ -44,6 +49,15 @@ public:
     { return _outputs; }
     std::vector<std::string> &outputs()
     { return _outputs; }
+
+public:
+    /*
+     * Load the dependency info from a path in any format. Some formats can
+     * contain more than one set of dependency info. On failure, describes why
+     * in the error, if given.
+     */
+    static ext::optional<std::vector<DependencyInfo>>
+    Load(libutil::Filesystem const *filesystem, DependencyInfoFormat format, std::string const &path, std::string *error = nullptr);
 };
 
 }
@@ -7,8 +7,16 @@
  */
 
 #include <dependency/DependencyInfo.h>
+#include <dependency/BinaryDependencyInfo.h>
+#include <dependency/DirectoryDependencyInfo.h>
+#include <dependency/MakefileDependencyInfo.h>
+#include <libutil/Filesystem.h>
+
+#include <cstdlib>
 
 using dependency::DependencyInfo;
+using dependency::DependencyInfoFormat;
+using libutil::Filesystem;
 
 DependencyInfo::
 DependencyInfo(std::vector<std::string> const &inputs, std::vector<std::string> const &outputs) :
@@ -22,3 +30,61 @@ DependencyInfo() :
     DependencyInfo(std::vector<std::string>(), std::vector<std::string>())
 {
 }
+
+ext::optional<std::vector<DependencyInfo>> DependencyInfo::
+Load(Filesystem const *filesystem, DependencyInfoFormat format, std::string const &path, std::string *error)
+{
+    std::string ignored;
+    if (error == nullptr) {
+        error = &ignored;
+    }
+
+    switch (format) {
+        case DependencyInfoFormat::Binary: {
+            std::vector<uint8_t> contents;
+            if (!filesystem->read(&contents, path)) {
+                *error = "failed to open " + path;
+                return ext::nullopt;
+            }
+
+            auto binaryInfo = BinaryDependencyInfo::Deserialize(contents);
+            if (!binaryInfo) {
+                *error = "invalid binary dependency info " + path;
+                return ext::nullopt;
+            }
+
+            return std::vector<DependencyInfo>({ binaryInfo->dependencyInfo() });
+        }
+        case DependencyInfoFormat::Directory: {
+            /* Non-directories have no dependencies. */
+            if (filesystem->type(path) != Filesystem::Type::Directory) {
+                return std::vector<DependencyInfo>();
+            }
+
+            auto directoryInfo = DirectoryDependencyInfo::Deserialize(filesystem, path);
+            if (!directoryInfo) {
+                *error = "invalid directory " + path;
+                return ext::nullopt;
+            }
+
+            return std::vector<DependencyInfo>({ directoryInfo->dependencyInfo() });
+        }
+        case DependencyInfoFormat::Makefile: {
+            std::vector<uint8_t> contents;
+            if (!filesystem->read(&contents, path)) {
+                *error = "failed to open " + path;
+                return ext::nullopt;
+            }
+
+            auto makefileInfo = MakefileDependencyInfo::Deserialize(std::string(contents.begin(), contents.end()));
+            if (!makefileInfo) {
+                *error = "invalid makefile dependency info " + path;
+                return ext::nullopt;
+            }
+
+            return makefileInfo->dependencyInfo();
+        }
+    }
+
+    abort();
+}
@@ -15,11 +15,8 @@
 #include <process/Context.h>
 
 #include <dependency/DependencyInfo.h>
-#include <dependency/BinaryDependencyInfo.h>
-#include <dependency/DirectoryDependencyInfo.h>
 #include <dependency/MakefileDependencyInfo.h>
 
-#include <cassert>
 #include <cstdlib>
 
 using libutil::Escape;
@@ -143,60 +140,6 @@ Version()
     return EXIT_SUCCESS;
 }
 
-static bool
-LoadDependencyInfo(Filesystem const *filesystem, std::string const &path, dependency::DependencyInfoFormat format, std::vector<dependency::DependencyInfo> *dependencyInfo)
-{
-    if (format == dependency::DependencyInfoFormat::Binary) {
-        std::vector<uint8_t> contents;
-        if (!filesystem->read(&contents, path)) {
-            fprintf(stderr, "error: failed to open %s\n", path.c_str());
-            return false;
-        }
-
-        auto binaryInfo = dependency::BinaryDependencyInfo::Deserialize(contents);
-        if (!binaryInfo) {
-            fprintf(stderr, "error: invalid binary dependency info\n");
-            return false;
-        }
-
-        dependencyInfo->push_back(binaryInfo->dependencyInfo());
-        return true;
-    } else if (format == dependency::DependencyInfoFormat::Directory) {
-        if (filesystem->type(path) != Filesystem::Type::Directory) {
-            fprintf(stderr, "warning: ignoring non-directory %s\n", path.c_str());
-            return true;
-        }
-
-        auto directoryInfo = dependency::DirectoryDependencyInfo::Deserialize(filesystem, path);
-        if (!directoryInfo) {
-            fprintf(stderr, "error: invalid directory\n");
-            return false;
-        }
-
-        dependencyInfo->push_back(directoryInfo->dependencyInfo());
-        return true;
-    } else if (format == dependency::DependencyInfoFormat::Makefile) {
-        std::vector<uint8_t> contents;
-        if (!filesystem->read(&contents, path)) {
-            fprintf(stderr, "error: failed to open %s\n", path.c_str());
-            return false;
-        }
-
-        std::string makefileContents = std::string(contents.begin(), contents.end());
-        auto makefileInfo = dependency::MakefileDependencyInfo::Deserialize(makefileContents);
-        if (!makefileInfo) {
-            fprintf(stderr, "error: invalid makefile dependency info\n");
-            return false;
-        }
-
-        dependencyInfo->insert(dependencyInfo->end(), makefileInfo->dependencyInfo().begin(), makefileInfo->dependencyInfo().end());
-        return true;
-    } else {
-        assert(false);
-        return false;
-    }
-}
-
 static std::string
 SerializeMakefileDependencyInfo(std::string const &currentDirectory, std::string const &output, std::vector<std::string> const &inputs)
 {
@@ -248,15 +191,22 @@ main(int argc, char **argv)
 
     std::vector<std::string> inputs;
     for (std::pair<dependency::DependencyInfoFormat, std::string> const &input : options.inputs()) {
+        if (input.first == dependency::DependencyInfoFormat::Directory && filesystem.type(input.second) != Filesystem::Type::Directory) {
+            fprintf(stderr, "warning: ignoring non-directory %s\n", input.second.c_str());
+            continue;
+        }
+
         /*
          * Load the dependency info.
          */
-        std::vector<dependency::DependencyInfo> info;
-        if (!LoadDependencyInfo(&filesystem, input.second, input.first, &info)) {
+        std::string error;
+        ext::optional<std::vector<dependency::DependencyInfo>> info = dependency::DependencyInfo::Load(&filesystem, input.first, input.second, &error);
+        if (!info) {
+            fprintf(stderr, "error: %s\n", error.c_str());
             return EXIT_FAILURE;
         }
 
-        for (dependency::DependencyInfo const &dependencyInfo : info) {
+        for (dependency::DependencyInfo const &dependencyInfo : *info) {
             inputs.insert(inputs.end(), dependencyInfo.inputs().begin(), dependencyInfo.inputs().end());
         }
     }
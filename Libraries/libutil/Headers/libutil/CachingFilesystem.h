@@ -0,0 +1,139 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef __libutil_CachingFilesystem_h
+#define __libutil_CachingFilesystem_h
+
+#include <libutil/Filesystem.h>
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <mutex>
+
+namespace libutil {
+
+/*
+ * A filesystem that remembers the metadata of entries read from another
+ * filesystem, so asking about the same path again doesn't go back to it.
+ * A change made through this filesystem forgets what was remembered about
+ * the changed path, its parents, and anything inside it. Changes made any
+ * other way are not noticed, including through symbolic links pointing at
+ * a changed path: only use it while the filesystem isn't changing
+ * underneath it, such as when creating a build.
+ */
+class CachingFilesystem : public Filesystem {
+private:
+    class Entry {
+    public:
+        ext::optional<bool>                  exists;
+        ext::optional<ext::optional<Type>>   type;
+        ext::optional<ext::optional<Status>> status;
+        ext::optional<bool>                  readable;
+        ext::optional<bool>                  writable;
+        ext::optional<bool>                  executable;
+    };
+
+private:
+    Filesystem                                    *_filesystem;
+
+private:
+    mutable std::mutex                             _mutex;
+    mutable std::map<std::string, Entry>           _entries;
+    uint64_t                                       _generation;
+
+private:
+    mutable std::atomic<uint64_t>                  _hits;
+    mutable std::atomic<uint64_t>                  _misses;
+
+public:
+    /*
+     * Cache the metadata of a filesystem. The filesystem must outlive this.
+     */
+    explicit CachingFilesystem(Filesystem *filesystem);
+
+public:
+    /*
+     * The filesystem being cached.
+     */
+    Filesystem *filesystem() const
+    { return _filesystem; }
+
+public:
+    /*
+     * How many questions about an entry were answered from the cache.
+     */
+    uint64_t hits() const
+    { return _hits; }
+
+    /*
+     * How many questions about an entry had to be asked of the filesystem.
+     */
+    uint64_t misses() const
+    { return _misses; }
+
+public:
+    /*
+     * Forget everything cached, such as after the filesystem changes.
+     */
+    void invalidate();
+
+    /*
+     * Forget what is cached about a path, its parents, and anything inside it.
+     */
+    void invalidate(std::string const &path);
+
+private:
+    template<typename T>
+    T lookup(std::string const &path, ext::optional<T> Entry::*field, std::function<T()> const &read) const;
+
+public:
+    virtual bool exists(std::string const &path) const;
+    virtual ext::optional<Type> type(std::string const &path) const;
+    virtual ext::optional<Status> stat(std::string const &path) const;
+
+public:
+    virtual bool isReadable(std::string const &path) const;
+    virtual bool isWritable(std::string const &path) const;
+    virtual bool isExecutable(std::string const &path) const;
+
+public:
+    virtual ext::optional<Permissions> readFilePermissions(std::string const &path) const;
+    virtual bool writeFilePermissions(std::string const &path, Permissions::Operation operation, Permissions permissions);
+    virtual bool createFile(std::string const &path);
+    virtual bool read(std::vector<uint8_t> *contents, std::string const &path, size_t offset = 0, ext::optional<size_t> length = ext::nullopt) const;
+    virtual std::unique_ptr<MappedFile> map(std::string const &path) const;
+    virtual bool write(std::vector<uint8_t> const &contents, std::string const &path);
+    virtual bool copyFile(std::string const &from, std::string const &to);
+    virtual bool moveFile(std::string const &from, std::string const &to);
+    virtual bool removeFile(std::string const &path);
+
+public:
+    virtual ext::optional<Permissions> readSymbolicLinkPermissions(std::string const &path) const;
+    virtual bool writeSymbolicLinkPermissions(std::string const &path, Permissions::Operation operation, Permissions permissions);
+    virtual ext::optional<std::string> readSymbolicLinkCanonical(std::string const &path, bool *directory = nullptr) const;
+    virtual ext::optional<std::string> readSymbolicLink(std::string const &path, bool *directory = nullptr) const;
+    virtual bool writeSymbolicLink(std::string const &target, std::string const &path, bool directory);
+    virtual bool copySymbolicLink(std::string const &from, std::string const &to);
+    virtual bool removeSymbolicLink(std::string const &path);
+
+public:
+    virtual ext::optional<Permissions> readDirectoryPermissions(std::string const &path) const;
+    virtual bool writeDirectoryPermissions(std::string const &path, Permissions::Operation operation, Permissions permissions, bool recursive);
+    virtual bool createDirectory(std::string const &path, bool recursive);
+    virtual bool readDirectory(std::string const &path, bool recursive, std::function<void(std::string const &)> const &cb) const;
+    virtual bool copyDirectory(std::string const &from, std::string const &to, bool recursive);
+    virtual bool removeDirectory(std::string const &path, bool recursive);
+
+public:
+    virtual std::string resolvePath(std::string const &path) const;
+};
+
+}
+
+#endif  // !__libutil_CachingFilesystem_h
@@ -12,9 +12,11 @@
 #include <libutil/Permissions.h>
 
 #include <functional>
+#include <memory>
 #include <string>
 #include <vector>
 #include <ext/optional>
+#include <ext/span>
 
 namespace libutil {
 
@@ -38,6 +40,72 @@ public:
         Directory,
     };
 
+public:
+    /*
+     * The contents of a file, held in memory for as long as this exists. The
+     * contents are either mapped from the file, or read into a buffer.
+     */
+    class MappedFile {
+    private:
+        std::vector<uint8_t>     _buffer;
+        ext::span<uint8_t const> _contents;
+        std::function<void()>    _unmap;
+
+    public:
+        explicit MappedFile(std::vector<uint8_t> &&buffer);
+        MappedFile(ext::span<uint8_t const> contents, std::function<void()> const &unmap);
+        ~MappedFile();
+
+        MappedFile(MappedFile const &) = delete;
+        MappedFile &operator=(MappedFile const &) = delete;
+
+    public:
+        ext::span<uint8_t const> contents() const
+        { return _contents; }
+    };
+
+public:
+    /*
+     * Information about a filesystem entry, read at once.
+     */
+    class Status {
+    private:
+        Type                       _type;
+        ext::optional<Permissions> _permissions;
+        uint64_t                   _size;
+        int64_t                    _modificationTime;
+
+    public:
+        Status(Type type, uint64_t size, int64_t modificationTime);
+        Status(Type type, ext::optional<Permissions> const &permissions, uint64_t size, int64_t modificationTime);
+
+    public:
+        /*
+         * The type of the entry.
+         */
+        Type type() const
+        { return _type; }
+
+        /*
+         * The permissions of the entry, if the filesystem has them.
+         */
+        ext::optional<Permissions> const &permissions() const
+        { return _permissions; }
+
+        /*
+         * The size of the entry's contents, in bytes.
+         */
+        uint64_t size() const
+        { return _size; }
+
+        /*
+         * When the entry was last modified, in nanoseconds since the epoch.
+         * Zero if the filesystem does not track modification times.
+         */
+        int64_t modificationTime() const
+        { return _modificationTime; }
+    };
+
 public:
     /*
      * Test if a filesystem entry exists.
@@ -49,6 +117,11 @@ public:
      */
     virtual ext::optional<Type> type(std::string const &path) const = 0;
 
+    /*
+     * Get the status of a filesystem entry, following symbolic links.
+     */
+    virtual ext::optional<Status> stat(std::string const &path) const = 0;
+
 public:
     /*
      * Test if a file is readable.
@@ -87,6 +160,12 @@ public:
      */
     virtual bool read(std::vector<uint8_t> *contents, std::string const &path, size_t offset = 0, ext::optional<size_t> length = ext::nullopt) const = 0;
 
+    /*
+     * Map a file's contents into memory without copying them, if possible.
+     * By default, the file is read into memory.
+     */
+    virtual std::unique_ptr<MappedFile> map(std::string const &path) const;
+
     /*
      * Write to a file.
      */
@@ -97,6 +176,14 @@ public:
      */
     virtual bool copyFile(std::string const &from, std::string const &to);
 
+    /*
+     * Move a file to a new path, replacing any file already there. Where
+     * supported, the replacement is atomic: anything opening the new path
+     * sees either the old file or the new one. By default, copies the file
+     * and removes the original, which is not atomic.
+     */
+    virtual bool moveFile(std::string const &from, std::string const &to);
+
     /*
      * Delete a file.
      */
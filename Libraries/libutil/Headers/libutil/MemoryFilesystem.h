@@ -72,6 +72,7 @@ public:
 public:
     virtual bool exists(std::string const &path) const;
     virtual ext::optional<Type> type(std::string const &path) const;
+    virtual ext::optional<Status> stat(std::string const &path) const;
 
 public:
     virtual bool isReadable(std::string const &path) const;
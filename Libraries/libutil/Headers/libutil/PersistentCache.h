@@ -0,0 +1,59 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef __libutil_PersistentCache_h
+#define __libutil_PersistentCache_h
+
+#include <libutil/Filesystem.h>
+
+#include <string>
+#include <vector>
+#include <ext/optional>
+
+namespace libutil {
+
+/*
+ * Shared handling for caches kept in files between runs, which can be used
+ * by several processes at the same time.
+ */
+class PersistentCache {
+public:
+    /*
+     * The directory for a kind of cache: a subdirectory of the cache
+     * directory set in the environment, if any, or of the user's cache
+     * directory. An empty cache directory in the environment disables it.
+     */
+    static ext::optional<std::string> Directory(
+        ext::optional<std::string> const &environmentDirectory,
+        ext::optional<std::string> const &userCacheDirectory,
+        std::string const &name);
+
+    /*
+     * The path to the cache file for a key, in a cache directory.
+     */
+    static std::string Path(std::string const &directory, std::string const &key);
+
+public:
+    /*
+     * If a file is unchanged since it was cached, judging by its status.
+     * Missing files are equal to each other.
+     */
+    static bool StatusEqual(ext::optional<Filesystem::Status> const &a, ext::optional<Filesystem::Status> const &b);
+
+public:
+    /*
+     * Replace a cache file. Other processes may be reading the old file,
+     * including through a mapping, so it is never modified in place: the
+     * new contents are written beside it, then moved over it.
+     */
+    static bool Write(Filesystem *filesystem, std::vector<uint8_t> const &contents, std::string const &path);
+};
+
+}
+
+#endif  // !__libutil_PersistentCache_h
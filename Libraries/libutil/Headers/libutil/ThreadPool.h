@@ -0,0 +1,88 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef __libutil_ThreadPool_h
+#define __libutil_ThreadPool_h
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace libutil {
+
+/*
+ * A fixed-size pool of worker threads executing dispatched work in
+ * first-in, first-out order. Work is not cancellable once dispatched.
+ */
+class ThreadPool {
+private:
+    std::vector<std::thread>          _threads;
+    std::deque<std::function<void()>> _queue;
+    size_t                            _active;
+    bool                              _stopping;
+
+private:
+    std::mutex                        _mutex;
+    std::condition_variable           _available;
+    std::condition_variable           _finished;
+
+public:
+    /*
+     * Creates a pool with the given number of threads. At least one thread
+     * is always created.
+     */
+    explicit ThreadPool(size_t threads);
+
+    /*
+     * Waits for all dispatched work to finish, then stops the threads.
+     */
+    ~ThreadPool();
+
+public:
+    /*
+     * The number of threads in the pool.
+     */
+    size_t threads() const
+    { return _threads.size(); }
+
+public:
+    /*
+     * Queues work to run on one of the threads in the pool.
+     */
+    void dispatch(std::function<void()> const &work);
+
+    /*
+     * Waits until all dispatched work has finished running.
+     */
+    void wait();
+
+public:
+    /*
+     * Runs a function for each index in `[0, count)` across the pool and
+     * waits for all of them to finish. Calls must not depend on each other,
+     * and this must not be called from work running on the same pool.
+     */
+    void apply(size_t count, std::function<void(size_t)> const &work);
+
+public:
+    /*
+     * The number of threads to use by default: the number of hardware
+     * threads available, or one if that can't be determined.
+     */
+    static size_t DefaultThreadCount();
+
+private:
+    void run();
+};
+
+}
+
+#endif  // !__libutil_ThreadPool_h
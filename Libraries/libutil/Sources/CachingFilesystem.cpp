@@ -0,0 +1,320 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree.
+ */
+
+#include <libutil/CachingFilesystem.h>
+#include <libutil/FSUtil.h>
+
+using libutil::CachingFilesystem;
+using libutil::Filesystem;
+using libutil::FSUtil;
+using libutil::Permissions;
+
+CachingFilesystem::
+CachingFilesystem(Filesystem *filesystem) :
+    _filesystem(filesystem),
+    _generation(0),
+    _hits      (0),
+    _misses    (0)
+{
+}
+
+void CachingFilesystem::
+invalidate()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _entries.clear();
+    _generation++;
+}
+
+void CachingFilesystem::
+invalidate(std::string const &path)
+{
+    std::string key = FSUtil::NormalizePath(path);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    /* The path itself, and anything inside it. */
+    _entries.erase(key);
+    std::string prefix = (!key.empty() && key.back() == '/' ? key : key + "/");
+    for (auto it = _entries.lower_bound(prefix); it != _entries.end() && it->first.compare(0, prefix.size(), prefix) == 0;) {
+        it = _entries.erase(it);
+    }
+
+    /* Parents: they can be created along with it, or have changed contents. */
+    std::string current = key;
+    while (true) {
+        std::string parent = FSUtil::GetDirectoryName(current);
+        if (parent.empty() || parent == current) {
+            break;
+        }
+
+        _entries.erase(parent);
+        current = parent;
+    }
+
+    _generation++;
+}
+
+template<typename T>
+T CachingFilesystem::
+lookup(std::string const &path, ext::optional<T> Entry::*field, std::function<T()> const &read) const
+{
+    /* Different spellings of a path share one entry. */
+    std::string key = FSUtil::NormalizePath(path);
+
+    uint64_t generation;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        auto it = _entries.find(key);
+        if (it != _entries.end() && it->second.*field) {
+            _hits++;
+            return *(it->second.*field);
+        }
+
+        generation = _generation;
+    }
+
+    /*
+     * Read without holding the lock so other paths can be looked up at the
+     * same time. If two threads miss on the same path, both read it.
+     */
+    _misses++;
+    T value = read();
+
+    /*
+     * If anything changed during the read, the value could be from before
+     * the change. Return it, but don't remember it.
+     */
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_generation == generation) {
+        _entries[key].*field = value;
+    }
+    return value;
+}
+
+bool CachingFilesystem::
+exists(std::string const &path) const
+{
+    return lookup<bool>(path, &Entry::exists, [this, &path] {
+        return _filesystem->exists(path);
+    });
+}
+
+ext::optional<Filesystem::Type> CachingFilesystem::
+type(std::string const &path) const
+{
+    return lookup<ext::optional<Type>>(path, &Entry::type, [this, &path] {
+        return _filesystem->type(path);
+    });
+}
+
+ext::optional<Filesystem::Status> CachingFilesystem::
+stat(std::string const &path) const
+{
+    return lookup<ext::optional<Status>>(path, &Entry::status, [this, &path] {
+        return _filesystem->stat(path);
+    });
+}
+
+bool CachingFilesystem::
+isReadable(std::string const &path) const
+{
+    return lookup<bool>(path, &Entry::readable, [this, &path] {
+        return _filesystem->isReadable(path);
+    });
+}
+
+bool CachingFilesystem::
+isWritable(std::string const &path) const
+{
+    return lookup<bool>(path, &Entry::writable, [this, &path] {
+        return _filesystem->isWritable(path);
+    });
+}
+
+bool CachingFilesystem::
+isExecutable(std::string const &path) const
+{
+    return lookup<bool>(path, &Entry::executable, [this, &path] {
+        return _filesystem->isExecutable(path);
+    });
+}
+
+/*
+ * Changing one entry can change others: its parent directories and anything
+ * inside it. Changing a symbolic link can change any path through it, so
+ * those changes forget everything.
+ */
+
+ext::optional<Permissions> CachingFilesystem::
+readFilePermissions(std::string const &path) const
+{
+    return _filesystem->readFilePermissions(path);
+}
+
+bool CachingFilesystem::
+writeFilePermissions(std::string const &path, Permissions::Operation operation, Permissions permissions)
+{
+    bool result = _filesystem->writeFilePermissions(path, operation, permissions);
+    invalidate(path);
+    return result;
+}
+
+bool CachingFilesystem::
+createFile(std::string const &path)
+{
+    bool result = _filesystem->createFile(path);
+    invalidate(path);
+    return result;
+}
+
+bool CachingFilesystem::
+read(std::vector<uint8_t> *contents, std::string const &path, size_t offset, ext::optional<size_t> length) const
+{
+    return _filesystem->read(contents, path, offset, length);
+}
+
+std::unique_ptr<Filesystem::MappedFile> CachingFilesystem::
+map(std::string const &path) const
+{
+    return _filesystem->map(path);
+}
+
+bool CachingFilesystem::
+write(std::vector<uint8_t> const &contents, std::string const &path)
+{
+    bool result = _filesystem->write(contents, path);
+    invalidate(path);
+    return result;
+}
+
+bool CachingFilesystem::
+copyFile(std::string const &from, std::string const &to)
+{
+    bool result = _filesystem->copyFile(from, to);
+    invalidate(to);
+    return result;
+}
+
+bool CachingFilesystem::
+moveFile(std::string const &from, std::string const &to)
+{
+    bool result = _filesystem->moveFile(from, to);
+    invalidate(from);
+    invalidate(to);
+    return result;
+}
+
+bool CachingFilesystem::
+removeFile(std::string const &path)
+{
+    bool result = _filesystem->removeFile(path);
+    invalidate(path);
+    return result;
+}
+
+ext::optional<Permissions> CachingFilesystem::
+readSymbolicLinkPermissions(std::string const &path) const
+{
+    return _filesystem->readSymbolicLinkPermissions(path);
+}
+
+bool CachingFilesystem::
+writeSymbolicLinkPermissions(std::string const &path, Permissions::Operation operation, Permissions permissions)
+{
+    bool result = _filesystem->writeSymbolicLinkPermissions(path, operation, permissions);
+    invalidate(path);
+    return result;
+}
+
+ext::optional<std::string> CachingFilesystem::
+readSymbolicLinkCanonical(std::string const &path, bool *directory) const
+{
+    return _filesystem->readSymbolicLinkCanonical(path, directory);
+}
+
+ext::optional<std::string> CachingFilesystem::
+readSymbolicLink(std::string const &path, bool *directory) const
+{
+    return _filesystem->readSymbolicLink(path, directory);
+}
+
+bool CachingFilesystem::
+writeSymbolicLink(std::string const &target, std::string const &path, bool directory)
+{
+    bool result = _filesystem->writeSymbolicLink(target, path, directory);
+    invalidate();
+    return result;
+}
+
+bool CachingFilesystem::
+copySymbolicLink(std::string const &from, std::string const &to)
+{
+    bool result = _filesystem->copySymbolicLink(from, to);
+    invalidate();
+    return result;
+}
+
+bool CachingFilesystem::
+removeSymbolicLink(std::string const &path)
+{
+    bool result = _filesystem->removeSymbolicLink(path);
+    invalidate();
+    return result;
+}
+
+ext::optional<Permissions> CachingFilesystem::
+readDirectoryPermissions(std::string const &path) const
+{
+    return _filesystem->readDirectoryPermissions(path);
+}
+
+bool CachingFilesystem::
+writeDirectoryPermissions(std::string const &path, Permissions::Operation operation, Permissions permissions, bool recursive)
+{
+    bool result = _filesystem->writeDirectoryPermissions(path, operation, permissions, recursive);
+    invalidate(path);
+    return result;
+}
+
+bool CachingFilesystem::
+createDirectory(std::string const &path, bool recursive)
+{
+    bool result = _filesystem->createDirectory(path, recursive);
+    invalidate(path);
+    return result;
+}
+
+bool CachingFilesystem::
+readDirectory(std::string const &path, bool recursive, std::function<void(std::string const &)> const &cb) const
+{
+    return _filesystem->readDirectory(path, recursive, cb);
+}
+
+bool CachingFilesystem::
+copyDirectory(std::string const &from, std::string const &to, bool recursive)
+{
+    bool result = _filesystem->copyDirectory(from, to, recursive);
+    invalidate(to);
+    return result;
+}
+
+bool CachingFilesystem::
+removeDirectory(std::string const &path, bool recursive)
+{
+    bool result = _filesystem->removeDirectory(path, recursive);
+    invalidate(path);
+    return result;
+}
+
+std::string CachingFilesystem::
+resolvePath(std::string const &path) const
+{
+    return _filesystem->resolvePath(path);
+}
@@ -9,7 +9,10 @@
 #include <libutil/DefaultFilesystem.h>
 #include <libutil/FSUtil.h>
 #include <libutil/Relative.h>
+#include <libutil/ThreadPool.h>
 
+#include <algorithm>
+#include <atomic>
 #include <stack>
 #include <climits>
 #include <cstdlib>
@@ -23,9 +26,16 @@
 #include <unistd.h>
 #include <libgen.h>
 #include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #if defined(__APPLE__)
 #include <copyfile.h>
+#elif defined(__linux__)
+#include <sys/ioctl.h>
+#include <sys/sendfile.h>
+#include <sys/syscall.h>
+#include <linux/fs.h>
 #endif
 #endif
 
@@ -34,6 +44,7 @@
 using libutil::DefaultFilesystem;
 using libutil::Filesystem;
 using libutil::Permissions;
+using libutil::ThreadPool;
 
 #if _WIN32
 using WideString = std::basic_string<std::remove_const<std::remove_pointer<LPCWSTR>::type>::type>;
@@ -182,6 +193,73 @@ type(std::string const &path) const
 #endif
 }
 
+#if !_WIN32
+static Permissions
+ModePermissions(mode_t mode)
+{
+    Permissions permissions;
+    permissions.flag(Permissions::Flag::Sticky, (mode & S_ISVTX) != 0);
+    permissions.flag(Permissions::Flag::SetUserID, (mode & S_ISUID) != 0);
+    permissions.flag(Permissions::Flag::SetGroupID, (mode & S_ISGID) != 0);
+    permissions.user(Permissions::Permission::Read, (mode & S_IRUSR) != 0);
+    permissions.user(Permissions::Permission::Write, (mode & S_IWUSR) != 0);
+    permissions.user(Permissions::Permission::Execute, (mode & S_IXUSR) != 0);
+    permissions.group(Permissions::Permission::Read, (mode & S_IRGRP) != 0);
+    permissions.group(Permissions::Permission::Write, (mode & S_IWGRP) != 0);
+    permissions.group(Permissions::Permission::Execute, (mode & S_IXGRP) != 0);
+    permissions.other(Permissions::Permission::Read, (mode & S_IROTH) != 0);
+    permissions.other(Permissions::Permission::Write, (mode & S_IWOTH) != 0);
+    permissions.other(Permissions::Permission::Execute, (mode & S_IXOTH) != 0);
+    return permissions;
+}
+#endif
+
+ext::optional<Filesystem::Status> DefaultFilesystem::
+stat(std::string const &path) const
+{
+#if _WIN32
+    WideString wide = StringToWideString(path);
+
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if (!GetFileAttributesExW(wide.c_str(), GetFileExInfoStandard, &data)) {
+        return ext::nullopt;
+    }
+
+    Type type = ((data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0 ? Type::Directory : Type::File);
+    uint64_t size = (static_cast<uint64_t>(data.nFileSizeHigh) << 32) | data.nFileSizeLow;
+
+    /* File times are in 100 nanosecond intervals since 1601. */
+    uint64_t time = (static_cast<uint64_t>(data.ftLastWriteTime.dwHighDateTime) << 32) | data.ftLastWriteTime.dwLowDateTime;
+    int64_t modificationTime = (static_cast<int64_t>(time) - 116444736000000000LL) * 100;
+
+    return Status(type, size, modificationTime);
+#else
+    struct stat st;
+    if (::stat(path.c_str(), &st) < 0) {
+        return ext::nullopt;
+    }
+
+    Type type;
+    if (S_ISREG(st.st_mode)) {
+        type = Type::File;
+    } else if (S_ISDIR(st.st_mode)) {
+        type = Type::Directory;
+    } else {
+        /* Unsupported file type, e.g. character or block device. */
+        return ext::nullopt;
+    }
+
+#if defined(__APPLE__)
+    struct timespec const &time = st.st_mtimespec;
+#else
+    struct timespec const &time = st.st_mtim;
+#endif
+    int64_t modificationTime = static_cast<int64_t>(time.tv_sec) * 1000000000 + time.tv_nsec;
+
+    return Status(type, ModePermissions(st.st_mode), static_cast<uint64_t>(st.st_size), modificationTime);
+#endif
+}
+
 bool DefaultFilesystem::
 isReadable(std::string const &path) const
 {
@@ -239,27 +317,6 @@ isExecutable(std::string const &path) const
 #endif
 }
 
-#if !_WIN32
-static Permissions
-ModePermissions(mode_t mode)
-{
-    Permissions permissions;
-    permissions.flag(Permissions::Flag::Sticky, (mode & S_ISVTX) != 0);
-    permissions.flag(Permissions::Flag::SetUserID, (mode & S_ISUID) != 0);
-    permissions.flag(Permissions::Flag::SetGroupID, (mode & S_ISGID) != 0);
-    permissions.user(Permissions::Permission::Read, (mode & S_IRUSR) != 0);
-    permissions.user(Permissions::Permission::Write, (mode & S_IWUSR) != 0);
-    permissions.user(Permissions::Permission::Execute, (mode & S_IXUSR) != 0);
-    permissions.group(Permissions::Permission::Read, (mode & S_IRGRP) != 0);
-    permissions.group(Permissions::Permission::Write, (mode & S_IWGRP) != 0);
-    permissions.group(Permissions::Permission::Execute, (mode & S_IXGRP) != 0);
-    permissions.other(Permissions::Permission::Read, (mode & S_IROTH) != 0);
-    permissions.other(Permissions::Permission::Write, (mode & S_IWOTH) != 0);
-    permissions.other(Permissions::Permission::Execute, (mode & S_IXOTH) != 0);
-    return permissions;
-}
-#endif
-
 ext::optional<Permissions> DefaultFilesystem::
 readFilePermissions(std::string const &path) const
 {
@@ -561,6 +618,44 @@ read(std::vector<uint8_t> *contents, std::string const &path, size_t offset, ext
 #endif
 }
 
+std::unique_ptr<Filesystem::MappedFile> DefaultFilesystem::
+map(std::string const &path) const
+{
+#if _WIN32
+    return Filesystem::map(path);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        ::close(fd);
+        return nullptr;
+    }
+
+    /* Empty files can't be mapped. */
+    size_t size = static_cast<size_t>(st.st_size);
+    if (size == 0) {
+        ::close(fd);
+        return std::unique_ptr<MappedFile>(new MappedFile(std::vector<uint8_t>()));
+    }
+
+    void *address = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (address == MAP_FAILED) {
+        /* Not all files can be mapped; fall back to reading them. */
+        return Filesystem::map(path);
+    }
+
+    auto contents = ext::span<uint8_t const>(static_cast<uint8_t const *>(address), size);
+    return std::unique_ptr<MappedFile>(new MappedFile(contents, [address, size] {
+        ::munmap(address, size);
+    }));
+#endif
+}
+
 bool DefaultFilesystem::
 write(std::vector<uint8_t> const &contents, std::string const &path)
 {
@@ -602,6 +697,87 @@ write(std::vector<uint8_t> const &contents, std::string const &path)
 #endif
 }
 
+#if !_WIN32 && !defined(__APPLE__)
+/*
+ * Copy the rest of one file into another, from each file's current offset.
+ * The kernel does the copy where it can, so the contents don't pass through
+ * memory here; each method falls back to the next if it isn't supported for
+ * these files, continuing from wherever the last one stopped.
+ */
+static bool
+CopyContents(int in, int out)
+{
+#if defined(__linux__) && defined(FICLONE)
+    /* Share the original's blocks on filesystems that support it. */
+    if (::ioctl(out, FICLONE, in) == 0) {
+        return true;
+    }
+#endif
+
+#if defined(__linux__) && defined(__NR_copy_file_range)
+    for (;;) {
+        ssize_t copied = ::syscall(__NR_copy_file_range, in, nullptr, out, nullptr, SSIZE_MAX, 0);
+        if (copied == 0) {
+            return true;
+        } else if (copied < 0) {
+            if (errno == EINTR) {
+                continue;
+            } else if (errno == EXDEV || errno == EINVAL || errno == ENOSYS || errno == EOPNOTSUPP || errno == EBADF) {
+                break;
+            }
+
+            return false;
+        }
+    }
+#endif
+
+#if defined(__linux__)
+    for (;;) {
+        ssize_t copied = ::sendfile(out, in, nullptr, SSIZE_MAX);
+        if (copied == 0) {
+            return true;
+        } else if (copied < 0) {
+            if (errno == EINTR) {
+                continue;
+            } else if (errno == EINVAL || errno == ENOSYS) {
+                break;
+            }
+
+            return false;
+        }
+    }
+#endif
+
+    /* Otherwise, copy through a fixed-size buffer. */
+    std::vector<uint8_t> buffer = std::vector<uint8_t>(128 * 1024);
+    for (;;) {
+        ssize_t size = ::read(in, buffer.data(), buffer.size());
+        if (size == 0) {
+            return true;
+        } else if (size < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            return false;
+        }
+
+        for (ssize_t written = 0; written < size;) {
+            ssize_t result = ::write(out, buffer.data() + written, size - written);
+            if (result < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+
+                return false;
+            }
+
+            written += result;
+        }
+    }
+}
+#endif
+
 bool DefaultFilesystem::
 copyFile(std::string const &from, std::string const &to)
 {
@@ -659,7 +835,51 @@ copyFile(std::string const &from, std::string const &to)
 
     return true;
 #else
-    return Filesystem::copyFile(from, to);
+    int in = ::open(from.c_str(), O_RDONLY);
+    if (in < 0) {
+        return false;
+    }
+
+    struct stat st;
+    if (::fstat(in, &st) != 0 || !S_ISREG(st.st_mode)) {
+        ::close(in);
+        return false;
+    }
+
+    /* New files get the same permissions as the original, as with cp(1). */
+    int out = ::open(to.c_str(), O_WRONLY | O_CREAT | O_TRUNC, st.st_mode & 0777);
+    if (out < 0) {
+        ::close(in);
+        return false;
+    }
+
+    bool success = CopyContents(in, out);
+    if (::close(out) != 0) {
+        success = false;
+    }
+    ::close(in);
+
+    return success;
+#endif
+}
+
+bool DefaultFilesystem::
+moveFile(std::string const &from, std::string const &to)
+{
+#if _WIN32
+    WideString fromWide = StringToWideString(from);
+    WideString toWide = StringToWideString(to);
+    if (!MoveFileExW(fromWide.c_str(), toWide.c_str(), MOVEFILE_REPLACE_EXISTING)) {
+        return false;
+    }
+
+    return true;
+#else
+    if (::rename(from.c_str(), to.c_str()) != 0) {
+        return false;
+    }
+
+    return true;
 #endif
 }
 
@@ -895,18 +1115,36 @@ removeSymbolicLink(std::string const &path)
     return true;
 }
 
-bool DefaultFilesystem::
-createDirectory(std::string const &path, bool recursive)
+/*
+ * Create a single directory. Another thread or process creating the same
+ * directory at the same time isn't a failure: the directory still exists.
+ */
+static bool
+CreateDirectoryEntry(Filesystem const *filesystem, std::string const &path)
 {
-#if !_WIN32
-    /* Get and re-set current mode mask. */
-    mode_t mask = ::umask(0);
-    ::umask(mask);
+#if _WIN32
+    WideString wide = StringToWideString(path);
+    if (CreateDirectoryW(wide.c_str(), nullptr)) {
+        return true;
+    }
 
-    /* Mode is most allowed by mask. */
-    mode_t mode = (S_IRWXU | S_IRWXG | S_IRWXO) & ~mask;
+    return (GetLastError() == ERROR_ALREADY_EXISTS && filesystem->type(path) == Filesystem::Type::Directory);
+#else
+    /*
+     * The kernel applies the process umask to the mode. Don't read the umask
+     * here: that requires changing it, which races with other threads.
+     */
+    if (::mkdir(path.c_str(), S_IRWXU | S_IRWXG | S_IRWXO) == 0) {
+        return true;
+    }
+
+    return (errno == EEXIST && filesystem->type(path) == Filesystem::Type::Directory);
 #endif
+}
 
+bool DefaultFilesystem::
+createDirectory(std::string const &path, bool recursive)
+{
     if (recursive) {
         std::string current = path;
         std::stack<std::string> create;
@@ -919,32 +1157,16 @@ createDirectory(std::string const &path, bool recursive)
 
         /* Create intermediate directories. */
         while (!create.empty()) {
-            std::string const &directory = create.top();
-
-#if _WIN32
-            WideString wide = StringToWideString(directory);
-            if (!CreateDirectoryW(wide.c_str(), nullptr)) {
+            if (!CreateDirectoryEntry(this, create.top())) {
                 return false;
             }
-#else
-            if (::mkdir(directory.c_str(), mode) != 0) {
-                return false;
-            }
-#endif
 
             create.pop();
         }
     } else {
-#if _WIN32
-            WideString wide = StringToWideString(path);
-            if (!CreateDirectoryW(wide.c_str(), nullptr)) {
-                return false;
-            }
-#else
-            if (::mkdir(path.c_str(), mode) != 0) {
-                return false;
-            }
-#endif
+        if (!CreateDirectoryEntry(this, path)) {
+            return false;
+        }
     }
 
     return true;
@@ -1054,6 +1276,12 @@ readDirectory(std::string const &path, bool recursive, std::function<void(std::s
     return process(path, ext::nullopt);
 }
 
+/*
+ * Most of the time copying a file is spent waiting on the disk, so more
+ * threads than this don't make copying a directory faster.
+ */
+static size_t const CopyDirectoryThreadCount = 4;
+
 bool DefaultFilesystem::
 copyDirectory(std::string const &from, std::string const &to, bool recursive)
 {
@@ -1076,8 +1304,125 @@ copyDirectory(std::string const &from, std::string const &to, bool recursive)
     ::copyfile_state_free(state);
 
     return true;
-#else
+#elif _WIN32
     return Filesystem::copyDirectory(from, to, recursive);
+#else
+    if (!recursive) {
+        return Filesystem::copyDirectory(from, to, recursive);
+    }
+
+    if (this->type(from) != Type::Directory) {
+        return false;
+    }
+
+    /*
+     * Remove any existing directory to overwrite, in the same way that copying
+     * a file overwrites an existing file at the same path, but not a directory.
+     */
+    if (this->type(to) == Type::Directory) {
+        if (!this->removeDirectory(to, recursive)) {
+            return false;
+        }
+    }
+
+    if (!this->createDirectory(to, false)) {
+        return false;
+    }
+
+    /*
+     * Create the directory structure first, using the entry types from the
+     * directory listing to avoid a stat for each entry. The files are copied
+     * afterwards, in parallel, since each copy is independent.
+     */
+    std::vector<std::pair<std::string, Type>> entries;
+
+    std::function<bool(std::string const &)> process = [this, &from, &to, &entries, &process](std::string const &relative) -> bool {
+        std::string fromDirectory = (relative.empty() ? from : from + "/" + relative);
+
+        DIR *dp = ::opendir(fromDirectory.c_str());
+        if (dp == nullptr) {
+            return false;
+        }
+
+        while (struct dirent *entry = ::readdir(dp)) {
+            char const *name = entry->d_name;
+            if (::strcmp(name, ".") == 0 || ::strcmp(name, "..") == 0) {
+                continue;
+            }
+
+            std::string path = (relative.empty() ? name : relative + "/" + name);
+
+            ext::optional<Type> type;
+#if defined(_DIRENT_HAVE_D_TYPE) || defined(DT_UNKNOWN)
+            switch (entry->d_type) {
+                case DT_REG: type = Type::File; break;
+                case DT_LNK: type = Type::SymbolicLink; break;
+                case DT_DIR: type = Type::Directory; break;
+                case DT_UNKNOWN: type = this->type(from + "/" + path); break;
+                default: break;
+            }
+#else
+            type = this->type(from + "/" + path);
+#endif
+
+            if (!type) {
+                /* Other types of entries can't be copied. */
+                ::closedir(dp);
+                return false;
+            }
+
+            if (*type == Type::Directory) {
+                if (!this->createDirectory(to + "/" + path, false) || !process(path)) {
+                    ::closedir(dp);
+                    return false;
+                }
+            } else {
+                entries.push_back({ path, *type });
+            }
+        }
+
+        ::closedir(dp);
+        return true;
+    };
+
+    if (!process(std::string())) {
+        return false;
+    }
+
+    if (entries.empty()) {
+        return true;
+    }
+
+    std::atomic<bool> success = ATOMIC_VAR_INIT(true);
+
+    /*
+     * Directories are often copied from tasks already running in parallel,
+     * so only use a few threads here rather than one for each processor.
+     */
+    size_t threads = std::min(std::min(ThreadPool::DefaultThreadCount(), CopyDirectoryThreadCount), entries.size());
+    ThreadPool pool(threads);
+    pool.apply(entries.size(), [this, &from, &to, &entries, &success](size_t n) {
+        std::string fromPath = from + "/" + entries[n].first;
+        std::string toPath = to + "/" + entries[n].first;
+
+        bool copied = false;
+        switch (entries[n].second) {
+            case Type::File:
+                copied = this->copyFile(fromPath, toPath);
+                break;
+            case Type::SymbolicLink:
+                copied = this->copySymbolicLink(fromPath, toPath);
+                break;
+            case Type::Directory:
+                break;
+        }
+
+        if (!copied) {
+            success = false;
+        }
+    });
+
+    return success;
 #endif
 }
 
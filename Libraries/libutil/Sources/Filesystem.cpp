@@ -15,6 +15,56 @@
 using libutil::Filesystem;
 using libutil::FSUtil;
 
+Filesystem::MappedFile::
+MappedFile(std::vector<uint8_t> &&buffer) :
+    _buffer  (std::move(buffer)),
+    _contents(_buffer)
+{
+}
+
+Filesystem::MappedFile::
+MappedFile(ext::span<uint8_t const> contents, std::function<void()> const &unmap) :
+    _contents(contents),
+    _unmap   (unmap)
+{
+}
+
+Filesystem::MappedFile::
+~MappedFile()
+{
+    if (_unmap) {
+        _unmap();
+    }
+}
+
+Filesystem::Status::
+Status(Type type, uint64_t size, int64_t modificationTime) :
+    _type            (type),
+    _size            (size),
+    _modificationTime(modificationTime)
+{
+}
+
+Filesystem::Status::
+Status(Type type, ext::optional<Permissions> const &permissions, uint64_t size, int64_t modificationTime) :
+    _type            (type),
+    _permissions     (permissions),
+    _size            (size),
+    _modificationTime(modificationTime)
+{
+}
+
+std::unique_ptr<Filesystem::MappedFile> Filesystem::
+map(std::string const &path) const
+{
+    std::vector<uint8_t> contents;
+    if (!this->read(&contents, path)) {
+        return nullptr;
+    }
+
+    return std::unique_ptr<MappedFile>(new MappedFile(std::move(contents)));
+}
+
 bool Filesystem::
 copyFile(std::string const &from, std::string const &to)
 {
@@ -31,6 +81,20 @@ copyFile(std::string const &from, std::string const &to)
     return true;
 }
 
+bool Filesystem::
+moveFile(std::string const &from, std::string const &to)
+{
+    if (!this->copyFile(from, to)) {
+        return false;
+    }
+
+    if (!this->removeFile(from)) {
+        return false;
+    }
+
+    return true;
+}
+
 bool Filesystem::
 copySymbolicLink(std::string const &from, std::string const &to)
 {
@@ -50,7 +114,7 @@ copySymbolicLink(std::string const &from, std::string const &to)
         }
     }
 
-    if (!this->writeSymbolicLink(to, *target, directory)) {
+    if (!this->writeSymbolicLink(*target, to, directory)) {
         return false;
     }
 
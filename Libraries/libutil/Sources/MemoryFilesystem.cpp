@@ -195,6 +195,34 @@ type(std::string const &path) const
     return type;
 }
 
+static Permissions
+AllPermissions()
+{
+    return Permissions(
+        { Permissions::Permission::Read, Permissions::Permission::Write, Permissions::Permission::Execute },
+        { Permissions::Permission::Read, Permissions::Permission::Write, Permissions::Permission::Execute },
+        { Permissions::Permission::Read, Permissions::Permission::Write, Permissions::Permission::Execute });
+}
+
+ext::optional<Filesystem::Status> MemoryFilesystem::
+stat(std::string const &path) const
+{
+    ext::optional<Status> status;
+
+    if (!WalkPath<MemoryFilesystem::Entry const>(this, path, false, [&status](MemoryFilesystem::Entry const *parent, std::string const &name, MemoryFilesystem::Entry const *entry) -> MemoryFilesystem::Entry const * {
+        if (entry != nullptr) {
+            /* Entries have no modification time. */
+            status = Status(entry->type(), AllPermissions(), entry->contents().size(), 0);
+        }
+
+        return entry;
+    })) {
+        return ext::nullopt;
+    }
+
+    return status;
+}
+
 bool MemoryFilesystem::
 isReadable(std::string const &path) const
 {
@@ -213,15 +241,6 @@ isExecutable(std::string const &path) const
     return this->exists(path);
 }
 
-static Permissions
-AllPermissions()
-{
-    return Permissions(
-        { Permissions::Permission::Read, Permissions::Permission::Write, Permissions::Permission::Execute },
-        { Permissions::Permission::Read, Permissions::Permission::Write, Permissions::Permission::Execute },
-        { Permissions::Permission::Read, Permissions::Permission::Write, Permissions::Permission::Execute });
-}
-
 ext::optional<Permissions> MemoryFilesystem::
 readFilePermissions(std::string const &path) const
 {
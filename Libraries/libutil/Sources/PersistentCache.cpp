@@ -0,0 +1,96 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree.
+ */
+
+#include <libutil/PersistentCache.h>
+#include <libutil/FSUtil.h>
+#include <libutil/md5.h>
+
+#include <iomanip>
+#include <random>
+#include <sstream>
+
+using libutil::PersistentCache;
+using libutil::Filesystem;
+using libutil::FSUtil;
+
+ext::optional<std::string> PersistentCache::
+Directory(
+    ext::optional<std::string> const &environmentDirectory,
+    ext::optional<std::string> const &userCacheDirectory,
+    std::string const &name)
+{
+    if (environmentDirectory) {
+        if (environmentDirectory->empty()) {
+            return ext::nullopt;
+        }
+
+        return *environmentDirectory + "/" + name;
+    }
+
+    if (userCacheDirectory) {
+        return *userCacheDirectory + "/xcbuild/" + name;
+    }
+
+    return ext::nullopt;
+}
+
+std::string PersistentCache::
+Path(std::string const &directory, std::string const &key)
+{
+    md5_state_t state;
+    md5_init(&state);
+    md5_append(&state, reinterpret_cast<const md5_byte_t *>(key.data()), key.size());
+    uint8_t digest[16];
+    md5_finish(&state, reinterpret_cast<md5_byte_t *>(&digest));
+
+    std::ostringstream ss;
+    ss << std::hex << std::setfill('0');
+    for (uint8_t c : digest) {
+        ss << std::setw(2) << static_cast<int>(c);
+    }
+
+    return directory + "/" + ss.str() + ".plist";
+}
+
+bool PersistentCache::
+StatusEqual(ext::optional<Filesystem::Status> const &a, ext::optional<Filesystem::Status> const &b)
+{
+    if (!a || !b) {
+        return (!a && !b);
+    }
+
+    return (a->type() == b->type() && a->size() == b->size() && a->modificationTime() == b->modificationTime());
+}
+
+bool PersistentCache::
+Write(Filesystem *filesystem, std::vector<uint8_t> const &contents, std::string const &path)
+{
+    if (!filesystem->createDirectory(FSUtil::GetDirectoryName(path), true)) {
+        return false;
+    }
+
+    /*
+     * The temporary file is in the same directory so it can be moved over
+     * the cache atomically, and uniquely named as other processes could be
+     * writing the same cache.
+     */
+    std::random_device random;
+    std::string temporary = path + ".tmp-" + std::to_string(random()) + std::to_string(random());
+
+    if (!filesystem->write(contents, temporary)) {
+        filesystem->removeFile(temporary);
+        return false;
+    }
+
+    if (!filesystem->moveFile(temporary, path)) {
+        filesystem->removeFile(temporary);
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,117 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree.
+ */
+
+#include <libutil/ThreadPool.h>
+
+using libutil::ThreadPool;
+
+ThreadPool::
+ThreadPool(size_t threads) :
+    _active  (0),
+    _stopping(false)
+{
+    if (threads == 0) {
+        threads = 1;
+    }
+
+    for (size_t i = 0; i < threads; ++i) {
+        _threads.push_back(std::thread(&ThreadPool::run, this));
+    }
+}
+
+ThreadPool::
+~ThreadPool()
+{
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _finished.wait(lock, [this] { return _queue.empty() && _active == 0; });
+        _stopping = true;
+    }
+    _available.notify_all();
+
+    for (std::thread &thread : _threads) {
+        thread.join();
+    }
+}
+
+void ThreadPool::
+dispatch(std::function<void()> const &work)
+{
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _queue.push_back(work);
+    }
+    _available.notify_one();
+}
+
+void ThreadPool::
+wait()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _finished.wait(lock, [this] { return _queue.empty() && _active == 0; });
+}
+
+void ThreadPool::
+apply(size_t count, std::function<void(size_t)> const &work)
+{
+    std::mutex mutex;
+    std::condition_variable finished;
+    size_t remaining = count;
+
+    for (size_t i = 0; i < count; ++i) {
+        dispatch([&, i] {
+            work(i);
+
+            std::unique_lock<std::mutex> lock(mutex);
+            if (--remaining == 0) {
+                finished.notify_all();
+            }
+        });
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [&] { return remaining == 0; });
+}
+
+void ThreadPool::
+run()
+{
+    while (true) {
+        std::function<void()> work;
+
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _available.wait(lock, [this] { return _stopping || !_queue.empty(); });
+            if (_queue.empty()) {
+                /* Stopping and nothing left to do. */
+                return;
+            }
+
+            work = std::move(_queue.front());
+            _queue.pop_front();
+            _active++;
+        }
+
+        work();
+
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _active--;
+            if (_queue.empty() && _active == 0) {
+                _finished.notify_all();
+            }
+        }
+    }
+}
+
+size_t ThreadPool::
+DefaultThreadCount()
+{
+    unsigned int count = std::thread::hardware_concurrency();
+    return (count != 0 ? count : 1);
+}
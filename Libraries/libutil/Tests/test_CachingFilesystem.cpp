@@ -0,0 +1,201 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+#include <libutil/CachingFilesystem.h>
+#include <libutil/MemoryFilesystem.h>
+
+using libutil::CachingFilesystem;
+using libutil::MemoryFilesystem;
+using libutil::Filesystem;
+
+static std::vector<uint8_t>
+Contents(std::string const &string)
+{
+    return std::vector<uint8_t>(string.begin(), string.end());
+}
+
+TEST(CachingFilesystem, Hits)
+{
+    auto memory = MemoryFilesystem({
+        MemoryFilesystem::Entry::File("file1", Contents("one")),
+        MemoryFilesystem::Entry::Directory("dir1", { }),
+    });
+    CachingFilesystem filesystem(&memory);
+
+    EXPECT_TRUE(filesystem.exists(memory.path("file1")));
+    EXPECT_EQ(0, filesystem.hits());
+    EXPECT_EQ(1, filesystem.misses());
+
+    EXPECT_TRUE(filesystem.exists(memory.path("file1")));
+    EXPECT_EQ(1, filesystem.hits());
+    EXPECT_EQ(1, filesystem.misses());
+
+    /* Each question about a path is cached separately. */
+    EXPECT_EQ(Filesystem::Type::File, filesystem.type(memory.path("file1")));
+    EXPECT_EQ(Filesystem::Type::File, filesystem.type(memory.path("file1")));
+    EXPECT_EQ(2, filesystem.hits());
+    EXPECT_EQ(2, filesystem.misses());
+
+    /* Missing entries are cached too. */
+    EXPECT_FALSE(filesystem.exists(memory.path("invalid")));
+    EXPECT_FALSE(filesystem.exists(memory.path("invalid")));
+    EXPECT_EQ(3, filesystem.hits());
+    EXPECT_EQ(3, filesystem.misses());
+
+    /* Finding files goes through the cache, which already knows about file1. */
+    EXPECT_EQ(memory.path("file1"), filesystem.findFile("file1", { memory.path("dir1"), memory.path("") }));
+    EXPECT_EQ(memory.path("file1"), filesystem.findFile("file1", { memory.path("dir1"), memory.path("") }));
+    EXPECT_EQ(6, filesystem.hits());
+    EXPECT_EQ(4, filesystem.misses());
+}
+
+TEST(CachingFilesystem, Stat)
+{
+    auto memory = MemoryFilesystem({
+        MemoryFilesystem::Entry::File("file1", Contents("one")),
+    });
+    CachingFilesystem filesystem(&memory);
+
+    ext::optional<Filesystem::Status> status = filesystem.stat(memory.path("file1"));
+    ASSERT_NE(ext::nullopt, status);
+    EXPECT_EQ(Filesystem::Type::File, status->type());
+    EXPECT_EQ(3, status->size());
+    ASSERT_NE(ext::nullopt, status->permissions());
+    EXPECT_TRUE(status->permissions()->user(libutil::Permissions::Permission::Read));
+
+    status = filesystem.stat(memory.path("file1"));
+    ASSERT_NE(ext::nullopt, status);
+    EXPECT_EQ(3, status->size());
+    EXPECT_EQ(1, filesystem.hits());
+
+    EXPECT_EQ(ext::nullopt, filesystem.stat(memory.path("invalid")));
+}
+
+TEST(CachingFilesystem, Invalidate)
+{
+    auto memory = MemoryFilesystem({
+        MemoryFilesystem::Entry::File("file1", Contents("one")),
+    });
+    CachingFilesystem filesystem(&memory);
+
+    /* Changes made through the cache are seen. */
+    EXPECT_FALSE(filesystem.exists(memory.path("file2")));
+    EXPECT_TRUE(filesystem.write(Contents("two"), memory.path("file2")));
+    EXPECT_TRUE(filesystem.exists(memory.path("file2")));
+
+    EXPECT_EQ(3, filesystem.stat(memory.path("file1"))->size());
+    EXPECT_TRUE(filesystem.write(Contents("longer"), memory.path("file1")));
+    EXPECT_EQ(6, filesystem.stat(memory.path("file1"))->size());
+
+    EXPECT_TRUE(filesystem.removeFile(memory.path("file1")));
+    EXPECT_FALSE(filesystem.exists(memory.path("file1")));
+
+    /* Changes made around the cache are not, until invalidated. */
+    EXPECT_TRUE(filesystem.exists(memory.path("file2")));
+    EXPECT_TRUE(memory.removeFile(memory.path("file2")));
+    EXPECT_TRUE(filesystem.exists(memory.path("file2")));
+    filesystem.invalidate();
+    EXPECT_FALSE(filesystem.exists(memory.path("file2")));
+}
+
+TEST(CachingFilesystem, InvalidatePath)
+{
+    auto memory = MemoryFilesystem({
+        MemoryFilesystem::Entry::File("file1", Contents("one")),
+        MemoryFilesystem::Entry::Directory("dir1", {
+            MemoryFilesystem::Entry::File("file2", Contents("two")),
+        }),
+    });
+    CachingFilesystem filesystem(&memory);
+
+    /* Changing one path keeps what's known about unrelated paths. */
+    EXPECT_TRUE(filesystem.exists(memory.path("file1")));
+    EXPECT_TRUE(filesystem.exists(memory.path("dir1/file2")));
+    EXPECT_TRUE(filesystem.write(Contents("three"), memory.path("file3")));
+    EXPECT_TRUE(filesystem.exists(memory.path("file1")));
+    EXPECT_TRUE(filesystem.exists(memory.path("dir1/file2")));
+    EXPECT_EQ(2, filesystem.hits());
+
+    /* Changing a directory forgets what's inside it and its parents. */
+    EXPECT_EQ(Filesystem::Type::Directory, filesystem.type(memory.path("dir1")));
+    EXPECT_TRUE(filesystem.removeDirectory(memory.path("dir1"), true));
+    EXPECT_FALSE(filesystem.exists(memory.path("dir1/file2")));
+    EXPECT_EQ(ext::nullopt, filesystem.type(memory.path("dir1")));
+
+    EXPECT_TRUE(filesystem.createDirectory(memory.path("dir2/dir3"), true));
+    EXPECT_EQ(Filesystem::Type::Directory, filesystem.type(memory.path("dir2")));
+}
+
+TEST(CachingFilesystem, NormalizedPaths)
+{
+    auto memory = MemoryFilesystem({
+        MemoryFilesystem::Entry::Directory("dir1", {
+            MemoryFilesystem::Entry::File("file1", Contents("one")),
+        }),
+    });
+    CachingFilesystem filesystem(&memory);
+
+    /* Different spellings of the same path share what's known about it. */
+    EXPECT_TRUE(filesystem.exists(memory.path("dir1/file1")));
+    EXPECT_TRUE(filesystem.exists(memory.path("dir1/./file1")));
+    EXPECT_TRUE(filesystem.exists(memory.path("dir1//file1")));
+    EXPECT_EQ(2, filesystem.hits());
+    EXPECT_EQ(1, filesystem.misses());
+
+    /* And changes through one spelling are seen through the others. */
+    EXPECT_FALSE(filesystem.exists(memory.path("dir1/file2")));
+    EXPECT_TRUE(filesystem.write(Contents("two"), memory.path("dir1/../dir1/file2")));
+    EXPECT_TRUE(filesystem.exists(memory.path("dir1/file2")));
+
+    EXPECT_TRUE(filesystem.removeFile(memory.path("dir1/./file1")));
+    EXPECT_FALSE(filesystem.exists(memory.path("dir1/file1")));
+}
+
+namespace {
+
+/*
+ * A filesystem that runs a callback the next time a path is checked.
+ */
+class InterruptingFilesystem : public MemoryFilesystem {
+public:
+    std::function<void()> interrupt;
+
+public:
+    InterruptingFilesystem(std::vector<MemoryFilesystem::Entry> const &entries) :
+        MemoryFilesystem(entries)
+    {
+    }
+
+public:
+    virtual bool exists(std::string const &path) const
+    {
+        bool result = MemoryFilesystem::exists(path);
+        if (interrupt) {
+            std::function<void()> function = interrupt;
+            const_cast<InterruptingFilesystem *>(this)->interrupt = nullptr;
+            function();
+        }
+        return result;
+    }
+};
+
+}
+
+TEST(CachingFilesystem, ChangeDuringRead)
+{
+    auto memory = InterruptingFilesystem({ });
+    CachingFilesystem filesystem(&memory);
+
+    /* A write finishing while a read is in progress isn't hidden by the read. */
+    memory.interrupt = [&] {
+        EXPECT_TRUE(filesystem.write(Contents("one"), memory.path("file1")));
+    };
+    EXPECT_FALSE(filesystem.exists(memory.path("file1")));
+    EXPECT_TRUE(filesystem.exists(memory.path("file1")));
+}
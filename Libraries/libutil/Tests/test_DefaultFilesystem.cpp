@@ -0,0 +1,213 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+#include <libutil/DefaultFilesystem.h>
+#include <libutil/ThreadPool.h>
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+
+#include <ftw.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using libutil::DefaultFilesystem;
+using libutil::Filesystem;
+using libutil::ThreadPool;
+
+namespace {
+
+/*
+ * A directory for a test, removed with everything in it afterwards.
+ */
+class TemporaryDirectory {
+private:
+    std::string _path;
+
+public:
+    TemporaryDirectory()
+    {
+        char path[] = "/tmp/libutil-test-XXXXXX";
+        _path = ::mkdtemp(path);
+    }
+
+    ~TemporaryDirectory()
+    {
+        ::nftw(_path.c_str(), [](char const *path, struct stat const *st, int type, struct FTW *ftw) -> int {
+            return ::remove(path);
+        }, 16, FTW_DEPTH | FTW_PHYS);
+    }
+
+public:
+    std::string const &path() const
+    { return _path; }
+};
+
+}
+
+TEST(DefaultFilesystem, CreateDirectoryExisting)
+{
+    TemporaryDirectory temporary;
+    DefaultFilesystem filesystem;
+
+    std::string path = temporary.path() + "/directory";
+    EXPECT_TRUE(filesystem.createDirectory(path, false));
+    EXPECT_TRUE(filesystem.createDirectory(path, false));
+    EXPECT_TRUE(filesystem.createDirectory(path, true));
+
+    /* Not a directory. */
+    EXPECT_TRUE(filesystem.createFile(temporary.path() + "/file"));
+    EXPECT_FALSE(filesystem.createDirectory(temporary.path() + "/file", false));
+    EXPECT_FALSE(filesystem.createDirectory(temporary.path() + "/file/directory", true));
+}
+
+TEST(DefaultFilesystem, CreateDirectoryConcurrent)
+{
+    TemporaryDirectory temporary;
+    DefaultFilesystem filesystem;
+
+    mode_t mask = ::umask(022);
+
+    /* Each thread creates the same intermediate directories. */
+    std::atomic<int> failures(0);
+    ThreadPool pool(8);
+    pool.apply(64, [&](size_t index) {
+        std::string path = temporary.path() + "/a/b/c/" + std::to_string(index % 4);
+        if (!filesystem.createDirectory(path, true)) {
+            failures++;
+        }
+    });
+
+    ::umask(mask);
+    EXPECT_EQ(0, failures);
+
+    /* Created with the process umask applied. */
+    struct stat st;
+    ASSERT_EQ(0, ::stat((temporary.path() + "/a/b").c_str(), &st));
+    EXPECT_EQ(0755, st.st_mode & 0777);
+}
+
+static mode_t
+Mode(std::string const &path)
+{
+    struct stat st;
+    if (::lstat(path.c_str(), &st) != 0) {
+        return 0;
+    }
+
+    return st.st_mode;
+}
+
+TEST(DefaultFilesystem, CopyDirectoryPermissions)
+{
+    TemporaryDirectory temporary;
+    DefaultFilesystem filesystem;
+
+    std::string from = temporary.path() + "/from";
+    std::string to = temporary.path() + "/to";
+    ASSERT_TRUE(filesystem.createDirectory(from, false));
+    ASSERT_TRUE(filesystem.write({ 'a' }, from + "/executable"));
+    ASSERT_TRUE(filesystem.write({ 'b' }, from + "/private"));
+    ASSERT_EQ(0, ::chmod((from + "/executable").c_str(), 0755));
+    ASSERT_EQ(0, ::chmod((from + "/private").c_str(), 0600));
+
+    EXPECT_TRUE(filesystem.copyDirectory(from, to, true));
+    EXPECT_EQ(0755, Mode(to + "/executable") & 0777);
+    EXPECT_EQ(0600, Mode(to + "/private") & 0777);
+}
+
+TEST(DefaultFilesystem, CopyDirectoryNested)
+{
+    TemporaryDirectory temporary;
+    DefaultFilesystem filesystem;
+
+    std::string from = temporary.path() + "/from";
+    std::string to = temporary.path() + "/to";
+    ASSERT_TRUE(filesystem.createDirectory(from + "/a/b/c", true));
+    ASSERT_TRUE(filesystem.createDirectory(from + "/empty", true));
+    ASSERT_TRUE(filesystem.write({ '1' }, from + "/a/one"));
+    ASSERT_TRUE(filesystem.write({ '3' }, from + "/a/b/c/three"));
+
+    /* Replaces the contents of an existing directory. */
+    ASSERT_TRUE(filesystem.createDirectory(to, false));
+    ASSERT_TRUE(filesystem.write({ 'x' }, to + "/stale"));
+
+    EXPECT_TRUE(filesystem.copyDirectory(from, to, true));
+    EXPECT_EQ(Filesystem::Type::Directory, filesystem.type(to + "/a/b/c"));
+    EXPECT_EQ(Filesystem::Type::Directory, filesystem.type(to + "/empty"));
+    EXPECT_FALSE(filesystem.exists(to + "/stale"));
+
+    std::vector<uint8_t> contents;
+    EXPECT_TRUE(filesystem.read(&contents, to + "/a/one"));
+    EXPECT_EQ(std::vector<uint8_t>({ '1' }), contents);
+    EXPECT_TRUE(filesystem.read(&contents, to + "/a/b/c/three"));
+    EXPECT_EQ(std::vector<uint8_t>({ '3' }), contents);
+}
+
+TEST(DefaultFilesystem, CopyDirectorySymbolicLinks)
+{
+    TemporaryDirectory temporary;
+    DefaultFilesystem filesystem;
+
+    std::string from = temporary.path() + "/from";
+    std::string to = temporary.path() + "/to";
+    ASSERT_TRUE(filesystem.createDirectory(from + "/directory", true));
+    ASSERT_TRUE(filesystem.write({ 'a' }, from + "/file"));
+    ASSERT_TRUE(filesystem.writeSymbolicLink("file", from + "/file-link", false));
+    ASSERT_TRUE(filesystem.writeSymbolicLink("directory", from + "/directory-link", true));
+    ASSERT_TRUE(filesystem.writeSymbolicLink("missing", from + "/broken-link", false));
+
+    /* Links are copied as links, not as what they point to. */
+    EXPECT_TRUE(filesystem.copyDirectory(from, to, true));
+    EXPECT_TRUE(S_ISLNK(Mode(to + "/file-link")));
+    EXPECT_TRUE(S_ISLNK(Mode(to + "/directory-link")));
+    EXPECT_TRUE(S_ISLNK(Mode(to + "/broken-link")));
+    EXPECT_EQ(ext::optional<std::string>("file"), filesystem.readSymbolicLink(to + "/file-link"));
+    EXPECT_EQ(ext::optional<std::string>("directory"), filesystem.readSymbolicLink(to + "/directory-link"));
+    EXPECT_EQ(ext::optional<std::string>("missing"), filesystem.readSymbolicLink(to + "/broken-link"));
+}
+
+TEST(DefaultFilesystem, CopyDirectoryLargeFile)
+{
+    TemporaryDirectory temporary;
+    DefaultFilesystem filesystem;
+
+    std::string from = temporary.path() + "/from";
+    std::string to = temporary.path() + "/to";
+    ASSERT_TRUE(filesystem.createDirectory(from, false));
+
+    /* Larger than a single copy buffer, and not a multiple of its size. */
+    std::vector<uint8_t> contents = std::vector<uint8_t>(4 * 1024 * 1024 + 7);
+    for (size_t n = 0; n < contents.size(); n++) {
+        contents[n] = static_cast<uint8_t>(n * 31 + n / 251);
+    }
+    ASSERT_TRUE(filesystem.write(contents, from + "/large"));
+
+    EXPECT_TRUE(filesystem.copyDirectory(from, to, true));
+
+    std::vector<uint8_t> copied;
+    EXPECT_TRUE(filesystem.read(&copied, to + "/large"));
+    EXPECT_TRUE(contents == copied);
+}
+
+TEST(DefaultFilesystem, CopyDirectoryUnsupported)
+{
+    TemporaryDirectory temporary;
+    DefaultFilesystem filesystem;
+
+    std::string from = temporary.path() + "/from";
+    std::string to = temporary.path() + "/to";
+    ASSERT_TRUE(filesystem.createDirectory(from, false));
+    ASSERT_TRUE(filesystem.write({ 'a' }, from + "/file"));
+    ASSERT_EQ(0, ::mkfifo((from + "/fifo").c_str(), 0644));
+
+    /* Can't be copied, so the copy fails rather than leaving it out. */
+    EXPECT_FALSE(filesystem.copyDirectory(from, to, true));
+}
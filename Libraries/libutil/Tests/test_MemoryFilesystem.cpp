@@ -60,6 +60,22 @@ TEST(MemoryFilesystem, Type)
     EXPECT_EQ(filesystem.type(filesystem.path("invalid1/invalid2")), ext::nullopt);
 }
 
+TEST(MemoryFilesystem, Stat)
+{
+    auto filesystem = BasicFilesystem();
+
+    ext::optional<Filesystem::Status> file = filesystem.stat(filesystem.path("dir2/file2"));
+    ASSERT_NE(file, ext::nullopt);
+    EXPECT_EQ(file->type(), Filesystem::Type::File);
+    EXPECT_EQ(file->size(), 4);
+
+    ext::optional<Filesystem::Status> directory = filesystem.stat(filesystem.path("dir2/dir3"));
+    ASSERT_NE(directory, ext::nullopt);
+    EXPECT_EQ(directory->type(), Filesystem::Type::Directory);
+
+    EXPECT_EQ(filesystem.stat(filesystem.path("invalid")), ext::nullopt);
+}
+
 TEST(MemoryFilesystem, IsReadable)
 {
     auto filesystem = BasicFilesystem();
@@ -163,6 +179,22 @@ TEST(MemoryFilesystem, Read)
     EXPECT_EQ(contents, Contents(""));
 }
 
+TEST(MemoryFilesystem, Map)
+{
+    auto filesystem = BasicFilesystem();
+
+    /* Map file. */
+    std::unique_ptr<Filesystem::MappedFile> mapped = filesystem.map(filesystem.path("dir1/file2"));
+    ASSERT_NE(mapped, nullptr);
+    EXPECT_EQ(std::vector<uint8_t>(mapped->contents().begin(), mapped->contents().end()), Contents("two1"));
+
+    /* Can't map directory. */
+    EXPECT_EQ(filesystem.map(filesystem.path("dir1")), nullptr);
+
+    /* Can't map nonexistent file. */
+    EXPECT_EQ(filesystem.map(filesystem.path("invalid")), nullptr);
+}
+
 TEST(MemoryFilesystem, Write)
 {
     auto filesystem = BasicFilesystem();
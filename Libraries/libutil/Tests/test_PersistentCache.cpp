@@ -0,0 +1,97 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+#include <libutil/PersistentCache.h>
+#include <libutil/DefaultFilesystem.h>
+#include <libutil/MemoryFilesystem.h>
+
+#include <cstdlib>
+#include <unistd.h>
+
+using libutil::PersistentCache;
+using libutil::DefaultFilesystem;
+using libutil::MemoryFilesystem;
+
+static std::vector<uint8_t>
+Contents(std::string const &string)
+{
+    return std::vector<uint8_t>(string.begin(), string.end());
+}
+
+TEST(PersistentCache, Write)
+{
+    auto filesystem = MemoryFilesystem({ });
+
+    /* Creates the directory, and leaves only the cache behind. */
+    EXPECT_TRUE(PersistentCache::Write(&filesystem, Contents("one"), filesystem.path("cache/file")));
+    EXPECT_TRUE(PersistentCache::Write(&filesystem, Contents("two"), filesystem.path("cache/file")));
+
+    std::vector<uint8_t> contents;
+    EXPECT_TRUE(filesystem.read(&contents, filesystem.path("cache/file")));
+    EXPECT_EQ(Contents("two"), contents);
+
+    std::vector<std::string> files;
+    EXPECT_TRUE(filesystem.readDirectory(filesystem.path("cache"), false, [&files](std::string const &name) {
+        files.push_back(name);
+    }));
+    EXPECT_EQ(std::vector<std::string>({ "file" }), files);
+}
+
+#if !_WIN32
+TEST(PersistentCache, ReplaceMapped)
+{
+    char directory[] = "/tmp/libutil-test-XXXXXX";
+    ASSERT_NE(nullptr, ::mkdtemp(directory));
+    std::string path = std::string(directory) + "/cache";
+
+    DefaultFilesystem filesystem;
+    EXPECT_TRUE(PersistentCache::Write(&filesystem, Contents("one"), path));
+
+    /* Readers of the old cache keep seeing the old contents. */
+    std::unique_ptr<libutil::Filesystem::MappedFile> mapped = filesystem.map(path);
+    ASSERT_NE(nullptr, mapped);
+    EXPECT_TRUE(PersistentCache::Write(&filesystem, Contents("three"), path));
+    EXPECT_EQ(Contents("one"), std::vector<uint8_t>(mapped->contents().begin(), mapped->contents().end()));
+
+    std::vector<uint8_t> contents;
+    EXPECT_TRUE(filesystem.read(&contents, path));
+    EXPECT_EQ(Contents("three"), contents);
+
+    mapped.reset();
+    EXPECT_TRUE(filesystem.removeFile(path));
+    EXPECT_EQ(0, ::rmdir(directory));
+}
+#endif
+
+TEST(PersistentCache, Directory)
+{
+    EXPECT_EQ(std::string("/cache/Name"), PersistentCache::Directory(std::string("/cache"), std::string("/home/.cache"), "Name"));
+    EXPECT_EQ(std::string("/home/.cache/xcbuild/Name"), PersistentCache::Directory(ext::nullopt, std::string("/home/.cache"), "Name"));
+    EXPECT_EQ(ext::nullopt, PersistentCache::Directory(std::string(""), std::string("/home/.cache"), "Name"));
+    EXPECT_EQ(ext::nullopt, PersistentCache::Directory(ext::nullopt, ext::nullopt, "Name"));
+}
+
+TEST(PersistentCache, Path)
+{
+    /* Named by the key's hash, so it's the same each time. */
+    EXPECT_EQ("/cache/d41d8cd98f00b204e9800998ecf8427e.plist", PersistentCache::Path("/cache", ""));
+    EXPECT_NE(PersistentCache::Path("/cache", "one"), PersistentCache::Path("/cache", "two"));
+}
+
+TEST(PersistentCache, StatusEqual)
+{
+    using libutil::Filesystem;
+
+    Filesystem::Status status = Filesystem::Status(Filesystem::Type::File, 10, 100);
+    EXPECT_TRUE(PersistentCache::StatusEqual(status, Filesystem::Status(Filesystem::Type::File, 10, 100)));
+    EXPECT_FALSE(PersistentCache::StatusEqual(status, Filesystem::Status(Filesystem::Type::File, 11, 100)));
+    EXPECT_FALSE(PersistentCache::StatusEqual(status, Filesystem::Status(Filesystem::Type::File, 10, 101)));
+    EXPECT_FALSE(PersistentCache::StatusEqual(status, ext::nullopt));
+    EXPECT_TRUE(PersistentCache::StatusEqual(ext::nullopt, ext::nullopt));
+}
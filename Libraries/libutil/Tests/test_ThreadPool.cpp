@@ -0,0 +1,54 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+#include <libutil/ThreadPool.h>
+
+#include <atomic>
+
+using libutil::ThreadPool;
+
+TEST(ThreadPool, Dispatch)
+{
+    std::atomic<int> count(0);
+
+    ThreadPool pool(4);
+    EXPECT_EQ(4, pool.threads());
+
+    for (int i = 0; i < 100; ++i) {
+        pool.dispatch([&count] { count++; });
+    }
+    pool.wait();
+
+    EXPECT_EQ(100, count);
+}
+
+TEST(ThreadPool, Apply)
+{
+    std::vector<int> values = std::vector<int>(100, 0);
+
+    ThreadPool pool(3);
+    pool.apply(values.size(), [&values](size_t index) {
+        values[index] = static_cast<int>(index) * 2;
+    });
+
+    for (size_t i = 0; i < values.size(); ++i) {
+        EXPECT_EQ(static_cast<int>(i) * 2, values[i]);
+    }
+}
+
+TEST(ThreadPool, MinimumThreads)
+{
+    ThreadPool pool(0);
+    EXPECT_EQ(1, pool.threads());
+
+    bool ran = false;
+    pool.dispatch([&ran] { ran = true; });
+    pool.wait();
+    EXPECT_TRUE(ran);
+}
@@ -14,6 +14,7 @@
 #include <pbxbuild/Build/Environment.h>
 #include <pbxbuild/Target/Environment.h>
 
+#include <mutex>
 #include <ext/optional>
 
 namespace pbxbuild {
@@ -36,6 +37,7 @@ private:
 
 private:
     std::shared_ptr<std::unordered_map<pbxproj::PBX::Target::shared_ptr, Target::Environment>> _targetEnvironments;
+    std::shared_ptr<std::mutex>                                                                 _targetEnvironmentsMutex;
 
 public:
     Context(
@@ -106,7 +108,8 @@ public:
 
 public:
     /*
-     * Create or fetch a target's computed environment.
+     * Create or fetch a target's computed environment. Safe to call from
+     * multiple threads at once.
      */
     ext::optional<Target::Environment>
     targetEnvironment(Build::Environment const &buildEnvironment, pbxproj::PBX::Target::shared_ptr const &target) const;
@@ -75,7 +75,7 @@ public:
     Default(
         process::User const *user,
         process::Context const *processContext,
-        libutil::Filesystem const *filesystem);
+        libutil::Filesystem *filesystem);
 };
 
 }
@@ -26,7 +26,9 @@ private:
 
 public:
     /*
-     * Determine the file type of a file path.
+     * Determine the file type of a file path. The sorted file types are indexed
+     * once per spec manager and domains, and paths that exist are only examined
+     * on the filesystem the first time they are resolved.
      */
     static pbxspec::PBX::FileType::shared_ptr
     Resolve(libutil::Filesystem const *filesystem, pbxspec::Manager::shared_ptr const &specManager, std::vector<std::string> const &domains, std::string const &filePath);
@@ -9,6 +9,7 @@
 #ifndef __pbxbuild_Tool_ClangResolver_h
 #define __pbxbuild_Tool_ClangResolver_h
 
+#include <pbxbuild/Tool/OptionsResult.h>
 #include <pbxspec/Manager.h>
 #include <pbxspec/PBX/Compiler.h>
 
@@ -30,6 +31,12 @@ class ClangResolver {
 private:
     pbxspec::PBX::Compiler::shared_ptr _compiler;
 
+private:
+    /*
+     * Options are the same for most sources of a file type, so are shared.
+     */
+    mutable Tool::OptionsResult::Cache _optionsCache;
+
 public:
     ClangResolver(pbxspec::PBX::Compiler::shared_ptr const &compiler);
     ~ClangResolver();
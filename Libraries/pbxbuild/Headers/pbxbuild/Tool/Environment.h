@@ -12,6 +12,10 @@
 #include <pbxbuild/Tool/Input.h>
 #include <pbxsetting/Environment.h>
 
+#include <string>
+#include <unordered_set>
+#include <vector>
+
 namespace pbxbuild {
 namespace Tool {
 
@@ -56,6 +60,13 @@ public:
         std::string const &workingDirectory,
         std::vector<Tool::Input> const &inputs,
         std::vector<std::string> const &outputs = { });
+
+public:
+    /*
+     * The settings `Create` adds for a tool's first input and output.
+     */
+    static std::unordered_set<std::string> const &
+    InputOutputSettings();
 };
 
 }
@@ -9,11 +9,16 @@
 #ifndef __pbxbuild_Tool_OptionsResult_h
 #define __pbxbuild_Tool_OptionsResult_h
 
+#include <pbxbuild/Tool/Input.h>
+#include <pbxbuild/Tool/Tokens.h>
 #include <pbxspec/PBX/FileType.h>
 #include <pbxspec/PBX/PropertyOption.h>
+#include <pbxspec/PBX/Tool.h>
 
+#include <memory>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace pbxsetting { class Environment; }
@@ -53,6 +58,54 @@ public:
         Tool::Environment const &toolEnvironment,
         std::string const &workingDirectory,
         pbxspec::PBX::FileType::shared_ptr const &fileType);
+
+public:
+    struct ToolResult;
+    class Cache;
+};
+
+/*
+ * The options and command line of a tool for one input.
+ */
+struct OptionsResult::ToolResult {
+    OptionsResult          options;
+    Tokens::ToolExpansions tokens;
+};
+
+/*
+ * Caches a tool's options and command line across inputs that share a
+ * settings environment, file type and localization. Options are evaluated
+ * once with placeholder inputs and outputs. If evaluating them used the input
+ * or output settings or paths, the options are evaluated for each input instead.
+ */
+class OptionsResult::Cache {
+private:
+    struct Entry {
+        std::shared_ptr<void const>         environment;
+        pbxspec::PBX::Tool::shared_ptr      tool;
+        pbxspec::PBX::FileType::shared_ptr  fileType;
+        ext::optional<std::string>          localization;
+        std::shared_ptr<ToolResult const>   result;
+    };
+
+private:
+    std::vector<Entry> _entries;
+
+public:
+    Cache();
+    ~Cache();
+
+public:
+    /*
+     * Get the options and command line for an input, evaluated in a tool
+     * environment created for that input from the base environment.
+     */
+    std::shared_ptr<ToolResult const>
+    get(
+        pbxsetting::Environment const &environment,
+        Tool::Environment const &toolEnvironment,
+        std::string const &workingDirectory,
+        Tool::Input const &input);
 };
 
 }
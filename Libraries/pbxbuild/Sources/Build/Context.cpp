@@ -22,30 +22,36 @@ Context(
     bool defaultConfiguration,
     std::vector<pbxsetting::Level> const &overrideLevels
 ) :
-    _workspaceContext    (workspaceContext),
-    _scheme              (scheme),
-    _schemeGroup         (schemeGroup),
-    _action              (action),
-    _configuration       (configuration),
-    _defaultConfiguration(defaultConfiguration),
-    _overrideLevels      (overrideLevels),
-    _targetEnvironments  (std::make_shared<std::unordered_map<pbxproj::PBX::Target::shared_ptr, Target::Environment>>())
+    _workspaceContext       (workspaceContext),
+    _scheme                 (scheme),
+    _schemeGroup            (schemeGroup),
+    _action                 (action),
+    _configuration          (configuration),
+    _defaultConfiguration   (defaultConfiguration),
+    _overrideLevels         (overrideLevels),
+    _targetEnvironments     (std::make_shared<std::unordered_map<pbxproj::PBX::Target::shared_ptr, Target::Environment>>()),
+    _targetEnvironmentsMutex(std::make_shared<std::mutex>())
 {
 }
 
 ext::optional<pbxbuild::Target::Environment> Build::Context::
 targetEnvironment(Build::Environment const &buildEnvironment, pbxproj::PBX::Target::shared_ptr const &target) const
 {
-    auto TEI = _targetEnvironments->find(target);
-    if (TEI != _targetEnvironments->end()) {
-        return TEI->second;
-    } else {
-        ext::optional<Target::Environment> targetEnvironment = Target::Environment::Create(buildEnvironment, *this, target);
-        if (targetEnvironment) {
-            _targetEnvironments->insert(std::make_pair(target, *targetEnvironment));
+    {
+        std::lock_guard<std::mutex> lock(*_targetEnvironmentsMutex);
+        auto TEI = _targetEnvironments->find(target);
+        if (TEI != _targetEnvironments->end()) {
+            return TEI->second;
         }
-        return targetEnvironment;
     }
+
+    /* Create outside the lock so targets can be created concurrently. */
+    ext::optional<Target::Environment> targetEnvironment = Target::Environment::Create(buildEnvironment, *this, target);
+    if (targetEnvironment) {
+        std::lock_guard<std::mutex> lock(*_targetEnvironmentsMutex);
+        _targetEnvironments->insert(std::make_pair(target, *targetEnvironment));
+    }
+    return targetEnvironment;
 }
 
 pbxproj::PBX::Target::shared_ptr Build::Context::
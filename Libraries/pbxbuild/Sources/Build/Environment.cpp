@@ -32,7 +32,7 @@ Environment(
 }
 
 ext::optional<Build::Environment> Build::Environment::
-Default(process::User const *user, process::Context const *processContext, Filesystem const *filesystem)
+Default(process::User const *user, process::Context const *processContext, Filesystem *filesystem)
 {
     ext::optional<std::string> developerRoot = xcsdk::Environment::DeveloperRoot(user, processContext, filesystem);
     if (!developerRoot) {
@@ -46,6 +46,10 @@ Default(process::User const *user, process::Context const *processContext, Files
         return ext::nullopt;
     }
 
+    if (ext::optional<std::string> cacheDirectory = pbxspec::Manager::DefaultCacheDirectory(user, processContext)) {
+        specManager->setCacheDirectory(filesystem, *cacheDirectory);
+    }
+
     /*
      * Register global build rules.
      */
@@ -63,7 +67,12 @@ Default(process::User const *user, process::Context const *processContext, Files
     specManager->registerDomains(filesystem, pbxspec::Manager::DefaultDomains(*developerRoot));
 
     auto configuration = xcsdk::Configuration::Load(filesystem, xcsdk::Configuration::DefaultPaths(user, processContext));
-    auto sdkManager = xcsdk::SDK::Manager::Open(filesystem, *developerRoot, configuration);
+    std::shared_ptr<xcsdk::SDK::Manager> sdkManager;
+    if (ext::optional<std::string> cacheDirectory = xcsdk::SDK::Manager::DefaultCacheDirectory(user, processContext)) {
+        sdkManager = xcsdk::SDK::Manager::Open(filesystem, *developerRoot, configuration, *cacheDirectory);
+    } else {
+        sdkManager = xcsdk::SDK::Manager::Open(filesystem, *developerRoot, configuration);
+    }
     if (sdkManager == nullptr) {
         fprintf(stderr, "error: couldn't create SDK manager\n");
         return ext::nullopt;
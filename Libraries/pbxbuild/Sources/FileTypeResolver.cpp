@@ -13,7 +13,11 @@
 #include <libutil/Strings.h>
 #include <libutil/Wildcard.h>
 
+#include <algorithm>
 #include <cassert>
+#include <iterator>
+#include <mutex>
+#include <unordered_map>
 
 using pbxbuild::FileTypeResolver;
 using pbxbuild::DirectedGraph;
@@ -37,49 +41,151 @@ SortedFileTypes(std::vector<pbxspec::PBX::FileType::shared_ptr> const &fileTypes
     return graph.ordered();
 }
 
-pbxspec::PBX::FileType::shared_ptr FileTypeResolver::
-Resolve(Filesystem const *filesystem, pbxspec::Manager::shared_ptr const &specManager, std::vector<std::string> const &domains, std::string const &filePath)
+static std::string
+LowercaseExtension(std::string const &extension)
 {
-    bool isReadable = filesystem->isReadable(filePath);
-    bool isFolder = isReadable && filesystem->type(filePath) == Filesystem::Type::Directory;
+    std::string result = extension;
+    std::transform(result.begin(), result.end(), result.begin(), ::tolower);
+    return result;
+}
 
-    std::string fileExtension = FSUtil::GetFileExtension(filePath);
-    std::string fileName = FSUtil::GetBaseName(filePath);
+namespace {
 
-    std::vector<uint8_t> fileContents;
+/*
+ * The file types for a spec manager and set of domains, sorted so more specific
+ * file types come first, and indexed by extension. File types that specify
+ * extensions are only candidates for paths with one of those extensions; the
+ * rest must be checked for every path. Resolved paths are remembered for as
+ * long as the spec manager is alive, so each path is examined on disk once.
+ */
+class FileTypeIndex {
+public:
+    typedef std::pair<libutil::Filesystem const *, std::string> PathKey;
+
+    struct PathKeyHash {
+        size_t operator()(PathKey const &key) const
+        { return std::hash<libutil::Filesystem const *>()(key.first) ^ std::hash<std::string>()(key.second); }
+    };
+
+public:
+    std::vector<pbxspec::PBX::FileType::shared_ptr>              sorted;
+    std::unordered_map<std::string, std::vector<size_t>>         extensions;
+    std::vector<size_t>                                          anyExtension;
+
+public:
+    std::mutex                                                                     mutex;
+    std::unordered_map<PathKey, pbxspec::PBX::FileType::shared_ptr, PathKeyHash> paths;
+
+public:
+    explicit FileTypeIndex(std::vector<pbxspec::PBX::FileType::shared_ptr> const &sortedFileTypes) :
+        sorted(sortedFileTypes)
+    {
+        for (size_t i = 0; i < sorted.size(); ++i) {
+            pbxspec::PBX::FileType::shared_ptr const &fileType = sorted[i];
+            if (!fileType->extensions()) {
+                anyExtension.push_back(i);
+                continue;
+            }
+
+            for (std::string const &extension : *fileType->extensions()) {
+                std::vector<size_t> &candidates = extensions[LowercaseExtension(extension)];
+                if (candidates.empty() || candidates.back() != i) {
+                    candidates.push_back(i);
+                }
+            }
+        }
+    }
+
+public:
+    /*
+     * The file types that could match a path with an extension, in sorted order.
+     */
+    std::vector<size_t>
+    candidates(std::string const &fileExtension) const
+    {
+        auto it = extensions.find(LowercaseExtension(fileExtension));
+        if (it == extensions.end()) {
+            return anyExtension;
+        }
+
+        std::vector<size_t> result;
+        result.reserve(it->second.size() + anyExtension.size());
+        std::merge(it->second.begin(), it->second.end(), anyExtension.begin(), anyExtension.end(), std::back_inserter(result));
+        return result;
+    }
+
+public:
+    /*
+     * Get the index for a spec manager and domains, building it the first time.
+     */
+    static std::shared_ptr<FileTypeIndex>
+    Get(pbxspec::Manager::shared_ptr const &specManager, std::vector<std::string> const &domains);
+};
+
+struct FileTypeIndexEntry {
+    std::weak_ptr<pbxspec::Manager>  specManager;
+    std::vector<std::string>         domains;
+    std::shared_ptr<FileTypeIndex>   index;
+};
+
+}
+
+std::shared_ptr<FileTypeIndex> FileTypeIndex::
+Get(pbxspec::Manager::shared_ptr const &specManager, std::vector<std::string> const &domains)
+{
+    static std::mutex mutex;
+    static std::vector<FileTypeIndexEntry> entries;
 
-    /* Reverse first so more specific file types are processed first. */
-    std::vector<pbxspec::PBX::FileType::shared_ptr> const &fileTypes = specManager->fileTypes(domains);
-    ext::optional<std::vector<pbxspec::PBX::FileType::shared_ptr>> result = SortedFileTypes(fileTypes);
-    if (!result) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    /* Forget indexes for spec managers that no longer exist. */
+    entries.erase(std::remove_if(entries.begin(), entries.end(), [](FileTypeIndexEntry const &entry) {
+        return entry.specManager.expired();
+    }), entries.end());
+
+    for (FileTypeIndexEntry const &entry : entries) {
+        if (entry.specManager.lock() == specManager && entry.domains == domains) {
+            return entry.index;
+        }
+    }
+
+    ext::optional<std::vector<pbxspec::PBX::FileType::shared_ptr>> sorted = SortedFileTypes(specManager->fileTypes(domains));
+    if (!sorted) {
         fprintf(stderr, "error: cycle creating file type graph\n");
         return nullptr;
     }
 
-    std::vector<pbxspec::PBX::FileType::shared_ptr> const &sortedFileTypes = *result;
-    for (pbxspec::PBX::FileType::shared_ptr const &fileType : sortedFileTypes) {
-        if (isReadable && fileType->isFolder() != isFolder) {
-            continue;
-        }
+    auto index = std::make_shared<FileTypeIndex>(*sorted);
+    entries.push_back({ specManager, domains, index });
+    return index;
+}
 
-        bool empty = true;
+static pbxspec::PBX::FileType::shared_ptr
+ResolveUncached(Filesystem const *filesystem, pbxspec::Manager::shared_ptr const &specManager, std::vector<std::string> const &domains, FileTypeIndex const &index, std::string const &filePath, bool *exists)
+{
+    bool isReadable = filesystem->isReadable(filePath);
+    *exists = isReadable;
+    bool isFolder = isReadable && filesystem->type(filePath) == Filesystem::Type::Directory;
 
-        if (fileType->extensions()) {
-            empty = false;
-            bool matched = false;
+    std::string fileExtension = FSUtil::GetFileExtension(filePath);
+    std::string fileName = FSUtil::GetBaseName(filePath);
 
-            for (std::string const &extension : *fileType->extensions()) {
-                // TODO(grp): Is this correct? Needed for handling ".S" as ".s", but might be over-broad.
-                if (libutil::strcasecmp(extension.c_str(), fileExtension.c_str()) == 0) {
-                    matched = true;
-                }
-            }
+    std::vector<uint8_t> fileContents;
 
-            if (!matched) {
-                continue;
-            }
+    /* Only consider file types that could match the extension, in sorted order. */
+    for (size_t candidate : index.candidates(fileExtension)) {
+        pbxspec::PBX::FileType::shared_ptr const &fileType = index.sorted[candidate];
+
+        if (isReadable && fileType->isFolder() != isFolder) {
+            continue;
         }
 
+        /*
+         * Extensions were matched by the index: candidates either have a
+         * matching extension (compared case-insensitively, to handle ".S"
+         * as ".s") or specify no extensions at all.
+         */
+        bool empty = !fileType->extensions();
 
         if (fileType->prefix()) {
             empty = false;
@@ -175,6 +281,40 @@ Resolve(Filesystem const *filesystem, pbxspec::Manager::shared_ptr const &specMa
     return fileType;
 }
 
+pbxspec::PBX::FileType::shared_ptr FileTypeResolver::
+Resolve(Filesystem const *filesystem, pbxspec::Manager::shared_ptr const &specManager, std::vector<std::string> const &domains, std::string const &filePath)
+{
+    std::shared_ptr<FileTypeIndex> index = FileTypeIndex::Get(specManager, domains);
+    if (index == nullptr) {
+        return nullptr;
+    }
+
+    FileTypeIndex::PathKey key = FileTypeIndex::PathKey(filesystem, filePath);
+
+    {
+        std::lock_guard<std::mutex> lock(index->mutex);
+        auto it = index->paths.find(key);
+        if (it != index->paths.end()) {
+            return it->second;
+        }
+    }
+
+    /* Resolve outside the lock; racing resolutions of a path agree. */
+    bool exists = false;
+    pbxspec::PBX::FileType::shared_ptr fileType = ResolveUncached(filesystem, specManager, domains, *index, filePath, &exists);
+
+    /*
+     * Paths that don't exist yet are not remembered: they may be created by the
+     * build, and resolve differently (e.g. as folders) once they are.
+     */
+    if (exists) {
+        std::lock_guard<std::mutex> lock(index->mutex);
+        index->paths.insert({ key, fileType });
+    }
+
+    return fileType;
+}
+
 pbxspec::PBX::FileType::shared_ptr FileTypeResolver::
 Resolve(Filesystem const *filesystem, pbxspec::Manager::shared_ptr const &specManager, std::vector<std::string> const &domains, pbxproj::PBX::FileReference::shared_ptr const &fileReference, std::string const &filePath)
 {
@@ -225,8 +225,10 @@ resolveSource(
     Tool::Environment toolEnvironment = Tool::Environment::Create(tool, environment, toolContext->workingDirectory(), { input }, { output });
     pbxsetting::Environment const &env = toolEnvironment.environment();
 
-    Tool::OptionsResult options = Tool::OptionsResult::Create(toolEnvironment, toolContext->workingDirectory(), input.fileType());
-    Tool::Tokens::ToolExpansions tokens = Tool::Tokens::ExpandTool(toolEnvironment, options);
+    /* Options only need to be evaluated again if they depend on the input or output. */
+    std::shared_ptr<Tool::OptionsResult::ToolResult const> toolResult = _optionsCache.get(environment, toolEnvironment, toolContext->workingDirectory(), input);
+    Tool::OptionsResult const &options = toolResult->options;
+    Tool::Tokens::ToolExpansions const &tokens = toolResult->tokens;
 
     std::vector<std::string> inputDependencies;
     inputDependencies.insert(inputDependencies.end(), headermapInfo.systemHeadermapFiles().begin(), headermapInfo.systemHeadermapFiles().end());
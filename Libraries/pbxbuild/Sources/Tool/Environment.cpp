@@ -196,3 +196,18 @@ Create(
 
     return Tool::Environment(tool, environment, inputPaths, outputPaths);
 }
+
+std::unordered_set<std::string> const &Tool::Environment::
+InputOutputSettings()
+{
+    static std::unordered_set<std::string> const settings = [] {
+        std::unordered_set<std::string> settings;
+        for (pbxsetting::Level const &level : { InputLevel(Tool::Input("/", nullptr), "/"), OutputLevel(std::string()) }) {
+            for (pbxsetting::Setting const &setting : level.settings()) {
+                settings.insert(setting.name());
+            }
+        }
+        return settings;
+    }();
+    return settings;
+}
@@ -16,6 +16,11 @@
 #include <libutil/Filesystem.h>
 #include <libutil/FSUtil.h>
 
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+
 namespace Tool = pbxbuild::Tool;
 using pbxbuild::HeaderMap;
 using pbxbuild::FileTypeResolver;
@@ -70,6 +75,216 @@ HeadermapSearchPaths(pbxspec::Manager::shared_ptr const &specManager, pbxsetting
     return orderedHeaderSearchPaths;
 }
 
+namespace {
+
+/*
+ * A header in the project, as it appears in the project-wide headermaps.
+ */
+struct ProjectHeader {
+    std::string fileName;
+    std::string fileDirectory;
+};
+
+/*
+ * A header in a target's headers phase.
+ */
+struct TargetHeader {
+    std::string fileName;
+    std::string fileDirectory;
+    std::string frameworkName;
+    bool        isPublicOrPrivate;
+    bool        isNonFramework;
+};
+
+/*
+ * The headermaps shared by all targets of a project in a configuration. These
+ * only depend on the project's file references and headers phases, and where
+ * their source trees are, so they are computed and serialized once, and each
+ * target only builds its own maps.
+ */
+class ProjectHeadermaps {
+public:
+    std::vector<ProjectHeader>                                                      projectHeaders;
+    std::unordered_map<pbxproj::PBX::Target const *, std::vector<TargetHeader>>     targetHeaders;
+
+public:
+    std::vector<uint8_t> projectHeadersData;
+    std::vector<uint8_t> allTargetHeadersData;
+    std::vector<uint8_t> allNonFrameworkTargetHeadersData;
+
+public:
+    ProjectHeadermaps(pbxspec::Manager::shared_ptr const &specManager, pbxsetting::Environment const &environment, pbxproj::PBX::Project::shared_ptr const &project);
+
+public:
+    /*
+     * Get the headermaps for a project and configuration, computing them the
+     * first time for each set of source tree locations.
+     */
+    static std::shared_ptr<ProjectHeadermaps const>
+    Get(pbxspec::Manager::shared_ptr const &specManager, pbxsetting::Environment const &environment, pbxproj::PBX::Project::shared_ptr const &project);
+};
+
+struct ProjectHeadermapsEntry {
+    std::weak_ptr<pbxspec::Manager>               specManager;
+    std::weak_ptr<pbxproj::PBX::Project>          project;
+    std::string                                   configuration;
+    std::string                                   sourceTrees;
+    std::shared_ptr<ProjectHeadermaps const>      headermaps;
+};
+
+}
+
+/*
+ * Where each of the source trees the project's files are in is. Files in the
+ * same source tree resolve to different paths if it is somewhere else, for
+ * example if another target uses a different SDK.
+ */
+static std::string
+ProjectSourceTrees(pbxsetting::Environment const &environment, pbxproj::PBX::Project::shared_ptr const &project)
+{
+    std::map<std::string, std::string> sourceTrees;
+    for (pbxproj::PBX::FileReference::shared_ptr const &fileReference : project->fileReferences()) {
+        pbxsetting::Value path = fileReference->resolve();
+        if (path.entries().empty() || path.entries().front().type() != pbxsetting::Value::Entry::Type::Value) {
+            /* Absolute paths don't depend on any source tree. */
+            continue;
+        }
+
+        pbxsetting::Value sourceTree = pbxsetting::Value({ path.entries().front() });
+        std::string name = sourceTree.raw();
+        if (sourceTrees.find(name) == sourceTrees.end()) {
+            sourceTrees.insert({ name, environment.expand(sourceTree) });
+        }
+    }
+
+    std::string key;
+    for (auto const &entry : sourceTrees) {
+        key += entry.first + "=" + entry.second + "\n";
+    }
+    return key;
+}
+
+static bool
+IsHeaderFileType(pbxspec::PBX::FileType::shared_ptr const &fileType)
+{
+    return fileType != nullptr && (fileType->identifier() == "sourcecode.c.h" || fileType->identifier() == "sourcecode.cpp.h");
+}
+
+ProjectHeadermaps::
+ProjectHeadermaps(pbxspec::Manager::shared_ptr const &specManager, pbxsetting::Environment const &environment, pbxproj::PBX::Project::shared_ptr const &project)
+{
+    HeaderMap projectHeaderMap;
+    HeaderMap allTargetHeaderMap;
+    HeaderMap allNonFrameworkTargetHeaderMap;
+
+    for (pbxproj::PBX::FileReference::shared_ptr const &fileReference : project->fileReferences()) {
+        std::string filePath = environment.expand(fileReference->resolve());
+        pbxspec::PBX::FileType::shared_ptr fileType = FileTypeResolver::Resolve(Filesystem::GetDefaultUNSAFE(), specManager, { pbxspec::Manager::AnyDomain() }, fileReference, filePath);
+        if (!IsHeaderFileType(fileType)) {
+            continue;
+        }
+
+        ProjectHeader header = { FSUtil::GetBaseName(filePath), FSUtil::GetDirectoryName(filePath) + "/" };
+        projectHeaderMap.add(header.fileName, header.fileDirectory, header.fileName);
+        projectHeaders.push_back(header);
+    }
+
+    for (pbxproj::PBX::Target::shared_ptr const &projectTarget : project->targets()) {
+        std::vector<TargetHeader> *headers = &targetHeaders[projectTarget.get()];
+
+        // TODO(grp): This is a little messy. Maybe check the product type specification, or the product reference's file type?
+        bool isNonFramework = (projectTarget->type() == pbxproj::PBX::Target::Type::Native && std::static_pointer_cast<pbxproj::PBX::NativeTarget>(projectTarget)->productType().find("framework") == std::string::npos);
+
+        for (pbxproj::PBX::BuildPhase::shared_ptr const &buildPhase : projectTarget->buildPhases()) {
+            if (buildPhase->type() != pbxproj::PBX::BuildPhase::Type::Headers) {
+                continue;
+            }
+
+            for (pbxproj::PBX::BuildFile::shared_ptr const &buildFile : buildPhase->files()) {
+                if (buildFile->fileRef() == nullptr || buildFile->fileRef()->type() != pbxproj::PBX::GroupItem::Type::FileReference) {
+                    continue;
+                }
+
+                pbxproj::PBX::FileReference::shared_ptr const &fileReference = std::static_pointer_cast <pbxproj::PBX::FileReference> (buildFile->fileRef());
+                std::string filePath = environment.expand(fileReference->resolve());
+                pbxspec::PBX::FileType::shared_ptr fileType = FileTypeResolver::Resolve(Filesystem::GetDefaultUNSAFE(), specManager, { pbxspec::Manager::AnyDomain() }, fileReference, filePath);
+                if (!IsHeaderFileType(fileType)) {
+                    continue;
+                }
+
+                std::vector<std::string> const &attributes = buildFile->attributes();
+                bool isPublic  = std::find(attributes.begin(), attributes.end(), "Public") != attributes.end();
+                bool isPrivate = std::find(attributes.begin(), attributes.end(), "Private") != attributes.end();
+
+                std::string fileName = FSUtil::GetBaseName(filePath);
+                TargetHeader header = {
+                    fileName,
+                    FSUtil::GetDirectoryName(filePath) + "/",
+                    projectTarget->productName() + "/" + fileName,
+                    isPublic || isPrivate,
+                    isNonFramework,
+                };
+
+                if (header.isPublicOrPrivate) {
+                    allTargetHeaderMap.add(header.frameworkName, header.fileDirectory, header.fileName);
+                    if (header.isNonFramework) {
+                        allNonFrameworkTargetHeaderMap.add(header.frameworkName, header.fileDirectory, header.fileName);
+                    }
+                }
+
+                headers->push_back(header);
+            }
+        }
+    }
+
+    projectHeadersData = projectHeaderMap.write();
+    allTargetHeadersData = allTargetHeaderMap.write();
+    allNonFrameworkTargetHeadersData = allNonFrameworkTargetHeaderMap.write();
+}
+
+std::shared_ptr<ProjectHeadermaps const> ProjectHeadermaps::
+Get(pbxspec::Manager::shared_ptr const &specManager, pbxsetting::Environment const &environment, pbxproj::PBX::Project::shared_ptr const &project)
+{
+    static std::mutex mutex;
+    static std::vector<ProjectHeadermapsEntry> entries;
+
+    std::string configuration = environment.resolve("CONFIGURATION");
+    std::string sourceTrees = ProjectSourceTrees(environment, project);
+
+    auto find = [&]() -> std::shared_ptr<ProjectHeadermaps const> {
+        for (ProjectHeadermapsEntry const &entry : entries) {
+            if (entry.specManager.lock() == specManager && entry.project.lock() == project && entry.configuration == configuration && entry.sourceTrees == sourceTrees) {
+                return entry.headermaps;
+            }
+        }
+        return nullptr;
+    };
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        /* Forget headermaps for projects that no longer exist. */
+        entries.erase(std::remove_if(entries.begin(), entries.end(), [](ProjectHeadermapsEntry const &entry) {
+            return entry.specManager.expired() || entry.project.expired();
+        }), entries.end());
+
+        if (std::shared_ptr<ProjectHeadermaps const> headermaps = find()) {
+            return headermaps;
+        }
+    }
+
+    /* Compute without blocking other projects. If another target got here first, use its headermaps. */
+    auto headermaps = std::make_shared<ProjectHeadermaps const>(specManager, environment, project);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (std::shared_ptr<ProjectHeadermaps const> existing = find()) {
+        return existing;
+    }
+
+    entries.push_back({ specManager, project, configuration, sourceTrees, headermaps });
+    return headermaps;
+}
+
 void Tool::HeadermapResolver::
 resolve(
     Tool::Context *toolContext,
@@ -91,9 +306,6 @@ resolve(
 
     HeaderMap targetName;
     HeaderMap ownTargetHeaders;
-    HeaderMap projectHeaders;
-    HeaderMap allTargetHeaders;
-    HeaderMap allNonFrameworkTargetHeaders;
 
     bool includeFlatEntriesForTargetBeingBuilt     = pbxsetting::Type::ParseBoolean(compilerEnvironment.resolve("HEADERMAP_INCLUDES_FLAT_ENTRIES_FOR_TARGET_BEING_BUILT"));
     bool includeFrameworkEntriesForAllProductTypes = pbxsetting::Type::ParseBoolean(compilerEnvironment.resolve("HEADERMAP_INCLUDES_FRAMEWORK_ENTRIES_FOR_ALL_PRODUCT_TYPES"));
@@ -103,6 +315,7 @@ resolve(
     HeaderMap generatedFiles;
 
     pbxproj::PBX::Project::shared_ptr project = target->project();
+    std::shared_ptr<ProjectHeadermaps const> projectHeadermaps = ProjectHeadermaps::Get(_specManager, compilerEnvironment, project);
 
     std::vector<std::string> headermapSearchPaths = HeadermapSearchPaths(_specManager, compilerEnvironment, target, toolContext->searchPaths(), toolContext->workingDirectory());
     for (std::string const &path : headermapSearchPaths) {
@@ -118,72 +331,38 @@ resolve(
         });
     }
 
-    for (pbxproj::PBX::FileReference::shared_ptr const &fileReference : project->fileReferences()) {
-        std::string filePath = compilerEnvironment.expand(fileReference->resolve());
-        pbxspec::PBX::FileType::shared_ptr fileType = FileTypeResolver::Resolve(Filesystem::GetDefaultUNSAFE(), _specManager, { pbxspec::Manager::AnyDomain() }, fileReference, filePath);
-        if (fileType == nullptr || (fileType->identifier() != "sourcecode.c.h" && fileType->identifier() != "sourcecode.cpp.h")) {
-            continue;
-        }
-
-        std::string fileName = FSUtil::GetBaseName(filePath);
-        std::string fileDirectory = FSUtil::GetDirectoryName(filePath) + "/";
-
-        projectHeaders.add(fileName, fileDirectory, fileName);
-        if (includeProjectHeaders) {
-            targetName.add(fileName, fileDirectory, fileName);
+    if (includeProjectHeaders) {
+        for (ProjectHeader const &header : projectHeadermaps->projectHeaders) {
+            targetName.add(header.fileName, header.fileDirectory, header.fileName);
         }
     }
 
+    /* Only the target's own headers and the target-wide map vary per target. */
     for (pbxproj::PBX::Target::shared_ptr const &projectTarget : project->targets()) {
-       for (pbxproj::PBX::BuildPhase::shared_ptr const &buildPhase : projectTarget->buildPhases()) {
-            if (buildPhase->type() != pbxproj::PBX::BuildPhase::Type::Headers) {
-                continue;
-            }
-
-            for (pbxproj::PBX::BuildFile::shared_ptr const &buildFile : buildPhase->files()) {
-                if (buildFile->fileRef() == nullptr || buildFile->fileRef()->type() != pbxproj::PBX::GroupItem::Type::FileReference) {
-                    continue;
-                }
-
-                pbxproj::PBX::FileReference::shared_ptr const &fileReference = std::static_pointer_cast <pbxproj::PBX::FileReference> (buildFile->fileRef());
-                std::string filePath = compilerEnvironment.expand(fileReference->resolve());
-                pbxspec::PBX::FileType::shared_ptr fileType = FileTypeResolver::Resolve(Filesystem::GetDefaultUNSAFE(), _specManager, { pbxspec::Manager::AnyDomain() }, fileReference, filePath);
-                if (fileType == nullptr || (fileType->identifier() != "sourcecode.c.h" && fileType->identifier() != "sourcecode.cpp.h")) {
-                    continue;
-                }
-
-                std::string fileName = FSUtil::GetBaseName(filePath);
-                std::string fileDirectory = FSUtil::GetDirectoryName(filePath) + "/";
-                std::string frameworkName = projectTarget->productName() + "/" + fileName;
-
-                std::vector<std::string> const &attributes = buildFile->attributes();
-                bool isPublic  = std::find(attributes.begin(), attributes.end(), "Public") != attributes.end();
-                bool isPrivate = std::find(attributes.begin(), attributes.end(), "Private") != attributes.end();
+        auto it = projectHeadermaps->targetHeaders.find(projectTarget.get());
+        if (it == projectHeadermaps->targetHeaders.end()) {
+            continue;
+        }
 
-                if (projectTarget == target) {
-                    ownTargetHeaders.add(fileName, fileDirectory, fileName);
+        for (TargetHeader const &header : it->second) {
+            if (projectTarget == target) {
+                ownTargetHeaders.add(header.fileName, header.fileDirectory, header.fileName);
 
-                    if (!isPublic && !isPrivate) {
-                        ownTargetHeaders.add(frameworkName, fileDirectory, fileName);
-                        if (includeFlatEntriesForTargetBeingBuilt) {
-                            targetName.add(frameworkName, fileDirectory, fileName);
-                        }
+                if (!header.isPublicOrPrivate) {
+                    ownTargetHeaders.add(header.frameworkName, header.fileDirectory, header.fileName);
+                    if (includeFlatEntriesForTargetBeingBuilt) {
+                        targetName.add(header.frameworkName, header.fileDirectory, header.fileName);
                     }
                 }
+            }
 
-                if (isPublic || isPrivate) {
-                    allTargetHeaders.add(frameworkName, fileDirectory, fileName);
-                    if (includeFrameworkEntriesForAllProductTypes) {
-                        targetName.add(frameworkName, fileDirectory, fileName);
-                    }
+            if (header.isPublicOrPrivate) {
+                if (includeFrameworkEntriesForAllProductTypes) {
+                    targetName.add(header.frameworkName, header.fileDirectory, header.fileName);
+                }
 
-                    // TODO(grp): This is a little messy. Maybe check the product type specification, or the product reference's file type?
-                    if (projectTarget->type() == pbxproj::PBX::Target::Type::Native && std::static_pointer_cast<pbxproj::PBX::NativeTarget>(projectTarget)->productType().find("framework") == std::string::npos) {
-                        allNonFrameworkTargetHeaders.add(frameworkName, fileDirectory, fileName);
-                        if (!includeFrameworkEntriesForAllProductTypes) {
-                            targetName.add(frameworkName, fileDirectory, fileName);
-                        }
-                    }
+                if (header.isNonFramework && !includeFrameworkEntriesForAllProductTypes) {
+                    targetName.add(header.frameworkName, header.fileDirectory, header.fileName);
                 }
             }
         }
@@ -199,10 +378,10 @@ resolve(
     std::vector<Tool::AuxiliaryFile> auxiliaryFiles = {
         Tool::AuxiliaryFile::Data(headermapFile, targetName.write()),
         Tool::AuxiliaryFile::Data(headermapFileForOwnTargetHeaders, ownTargetHeaders.write()),
-        Tool::AuxiliaryFile::Data(headermapFileForAllTargetHeaders, allTargetHeaders.write()),
-        Tool::AuxiliaryFile::Data(headermapFileForAllNonFrameworkTargetHeaders, allNonFrameworkTargetHeaders.write()),
+        Tool::AuxiliaryFile::Data(headermapFileForAllTargetHeaders, projectHeadermaps->allTargetHeadersData),
+        Tool::AuxiliaryFile::Data(headermapFileForAllNonFrameworkTargetHeaders, projectHeadermaps->allNonFrameworkTargetHeadersData),
         Tool::AuxiliaryFile::Data(headermapFileForGeneratedFiles, generatedFiles.write()),
-        Tool::AuxiliaryFile::Data(headermapFileForProjectFiles, projectHeaders.write()),
+        Tool::AuxiliaryFile::Data(headermapFileForProjectFiles, projectHeadermaps->projectHeadersData),
     };
 
     toolContext->auxiliaryFiles().insert(toolContext->auxiliaryFiles().end(), auxiliaryFiles.begin(), auxiliaryFiles.end());
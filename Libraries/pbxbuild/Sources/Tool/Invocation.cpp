@@ -66,7 +66,8 @@ Tool::Invocation::
 Invocation() :
     _showEnvironmentInLog   (true),
     _createsProductStructure(false),
-    _waitForSwiftArtifacts  (false)
+    _waitForSwiftArtifacts  (false),
+    _priority               (0)
 {
 }
 
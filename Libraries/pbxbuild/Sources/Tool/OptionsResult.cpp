@@ -15,6 +15,9 @@
 #include <plist/Object.h>
 #include <plist/String.h>
 
+#include <algorithm>
+#include <iterator>
+
 namespace Tool = pbxbuild::Tool;
 
 Tool::OptionsResult::
@@ -263,7 +266,8 @@ Create(
     std::unordered_map<std::string, std::string> environmentVariables = optionsResult.environment();
     if (toolEnvironment.tool()->environmentVariables()) {
         for (auto const &variable : *toolEnvironment.tool()->environmentVariables()) {
-            environmentVariables.insert({ variable.first, toolEnvironment.environment().expand(variable.second) });
+            std::string value = toolEnvironment.environment().expand(variable.second);
+            environmentVariables.insert({ variable.first, value });
         }
     }
 
@@ -273,3 +277,87 @@ Create(
 
     return Tool::OptionsResult(optionsResult.arguments(), environmentVariables, optionsResult.linkerArgs());
 }
+
+Tool::OptionsResult::Cache::
+Cache()
+{
+}
+
+Tool::OptionsResult::Cache::
+~Cache()
+{
+}
+
+/*
+ * Stands in for input and output paths. It can't appear in real paths.
+ */
+static std::string const Placeholder = "\x01xcbuild-placeholder\x01";
+
+/*
+ * Checks if any command line argument contains the placeholder.
+ */
+static bool
+ContainsPlaceholder(std::vector<std::string> const &values)
+{
+    return std::any_of(values.begin(), values.end(), [](std::string const &value) {
+        return value.find(Placeholder) != std::string::npos;
+    });
+}
+
+std::shared_ptr<Tool::OptionsResult::ToolResult const> Tool::OptionsResult::Cache::
+get(
+    pbxsetting::Environment const &environment,
+    Tool::Environment const &toolEnvironment,
+    std::string const &workingDirectory,
+    Tool::Input const &input)
+{
+    pbxspec::PBX::Tool::shared_ptr const &tool = toolEnvironment.tool();
+    std::shared_ptr<void const> identity = environment.identity();
+
+    auto it = std::find_if(_entries.begin(), _entries.end(), [&](Entry const &entry) {
+        return entry.environment != nullptr && entry.environment == identity && entry.tool == tool && entry.fileType == input.fileType() && entry.localization == input.localization();
+    });
+
+    if (it == _entries.end() && identity != nullptr) {
+        /* Evaluate the options once for all inputs, with placeholder paths. */
+        std::string path = "/" + Placeholder + "/" + Placeholder + "." + Placeholder;
+        Tool::Input placeholderInput = Tool::Input(path, input.fileType(), input.buildRule(), Placeholder, input.localization(), input.localizationGroupIdentifier(), ext::nullopt, ext::nullopt);
+
+        /*
+         * Note the settings the options use. Operations like `:identifier` change
+         * paths, so which settings were evaluated is checked rather than values.
+         */
+        std::unordered_set<std::string> settings;
+        pbxsetting::Environment trackedEnvironment = pbxsetting::Environment(environment);
+        trackedEnvironment.track(&settings);
+
+        Tool::Environment placeholderEnvironment = Tool::Environment::Create(tool, trackedEnvironment, workingDirectory, { placeholderInput }, { path });
+        settings.clear();
+
+        Tool::OptionsResult options = Tool::OptionsResult::Create(placeholderEnvironment, workingDirectory, input.fileType());
+        Tool::Tokens::ToolExpansions tokens = Tool::Tokens::ExpandTool(placeholderEnvironment, options);
+
+        /* Input and output paths can also be used directly as command line tokens. */
+        std::unordered_set<std::string> const &inputOutputSettings = Tool::Environment::InputOutputSettings();
+        bool usesInputOutput = ContainsPlaceholder({ tokens.executable() }) || ContainsPlaceholder(tokens.arguments()) || std::any_of(settings.begin(), settings.end(), [&](std::string const &setting) {
+            return inputOutputSettings.find(setting) != inputOutputSettings.end();
+        });
+
+        /* If the options depend on the input or output, they can't be shared. */
+        std::shared_ptr<ToolResult const> result = nullptr;
+        if (!usesInputOutput) {
+            result = std::make_shared<ToolResult const>(ToolResult { options, tokens });
+        }
+
+        _entries.push_back({ identity, tool, input.fileType(), input.localization(), result });
+        it = std::prev(_entries.end());
+    }
+
+    if (it != _entries.end() && it->result != nullptr) {
+        return it->result;
+    }
+
+    Tool::OptionsResult options = Tool::OptionsResult::Create(toolEnvironment, workingDirectory, input.fileType());
+    Tool::Tokens::ToolExpansions tokens = Tool::Tokens::ExpandTool(toolEnvironment, options);
+    return std::make_shared<ToolResult const>(ToolResult { options, tokens });
+}
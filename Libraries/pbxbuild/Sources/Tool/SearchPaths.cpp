@@ -49,12 +49,16 @@ AppendPaths(std::vector<std::string> *args, pbxsetting::Environment const &envir
             }
         }
 
+        /*
+         * Paths are made absolute: tools write the paths they're passed into
+         * dependency info, which is read from a different directory.
+         */
         std::string recursive = "**";
         if (path.size() >= recursive.size() && path.substr(path.size() - recursive.size()) == recursive) {
             std::string root = path.substr(0, path.size() - recursive.size());
-            args->push_back(root);
-
             std::string absoluteRoot = FSUtil::ResolveRelativePath(root, workingDirectory);
+            args->push_back(absoluteRoot);
+
             filesystem->readDirectory(absoluteRoot, true, [&](std::string const &relative) -> bool {
                 // TODO(grp): Use build settings for included and excluded recursive paths.
                 // Included: INCLUDED_RECURSIVE_SEARCH_PATH_SUBDIRECTORIES
@@ -63,12 +67,12 @@ AppendPaths(std::vector<std::string> *args, pbxsetting::Environment const &envir
 
                 std::string absolute = absoluteRoot + "/" + relative;
                 if (filesystem->type(absolute) == Filesystem::Type::Directory) {
-                    args->push_back(root + "/" + relative);
+                    args->push_back(absolute);
                 }
                 return true;
             });
         } else {
-            args->push_back(path);
+            args->push_back(FSUtil::ResolveRelativePath(path, workingDirectory));
         }
     }
 }
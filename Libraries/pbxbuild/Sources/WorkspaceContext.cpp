@@ -10,11 +10,13 @@
 #include <pbxsetting/Environment.h>
 #include <libutil/Filesystem.h>
 #include <libutil/FSUtil.h>
+#include <libutil/ThreadPool.h>
 
 using pbxbuild::WorkspaceContext;
 using pbxbuild::DerivedDataHash;
 using libutil::Filesystem;
 using libutil::FSUtil;
+using libutil::ThreadPool;
 
 WorkspaceContext::
 WorkspaceContext(
@@ -135,25 +137,35 @@ IterateWorkspaceFiles(xcworkspace::XC::Workspace::shared_ptr const &workspace, s
 }
 
 static void
-LoadWorkspaceProjects(Filesystem const *filesystem, std::vector<pbxproj::PBX::Project::shared_ptr> *projects, xcworkspace::XC::Workspace::shared_ptr const &workspace)
+LoadWorkspaceProjects(Filesystem const *filesystem, ThreadPool *pool, std::vector<pbxproj::PBX::Project::shared_ptr> *projects, xcworkspace::XC::Workspace::shared_ptr const &workspace)
 {
     /*
-     * Load all the projects in the workspace.
+     * Find all the projects in the workspace.
      */
+    std::vector<std::string> paths;
     IterateWorkspaceFiles(workspace, [&](xcworkspace::XC::FileRef::shared_ptr const &ref) {
-        std::string path = ref->resolve(workspace);
+        paths.push_back(ref->resolve(workspace));
+    });
+
+    /*
+     * Load the projects in parallel, but keep them in workspace order.
+     */
+    std::vector<pbxproj::PBX::Project::shared_ptr> loaded = std::vector<pbxproj::PBX::Project::shared_ptr>(paths.size());
+    pool->apply(paths.size(), [&](size_t n) {
+        loaded[n] = pbxproj::PBX::Project::Open(filesystem, paths[n]);
+    });
 
-        pbxproj::PBX::Project::shared_ptr project = pbxproj::PBX::Project::Open(filesystem, path);
+    for (pbxproj::PBX::Project::shared_ptr const &project : loaded) {
         if (project != nullptr) {
             projects->push_back(project);
         }
-    });
+    }
 }
 
 static void
 LoadConfigurationFiles(
     Filesystem const *filesystem,
-    std::unordered_map<pbxproj::XC::BuildConfiguration::shared_ptr, pbxsetting::XC::Config> *configs,
+    std::vector<std::pair<pbxproj::XC::BuildConfiguration::shared_ptr, pbxsetting::XC::Config>> *configs,
     pbxsetting::Environment const &environment,
     pbxproj::XC::ConfigurationList::shared_ptr const &configurationList)
 {
@@ -170,7 +182,7 @@ LoadConfigurationFiles(
 
             /* Load the configuration file. */
             if (ext::optional<pbxsetting::XC::Config> configuration = pbxsetting::XC::Config::Load(filesystem, environment, configurationPath)) {
-                configs->insert({ buildConfiguration, *configuration });
+                configs->push_back({ buildConfiguration, *configuration });
             }
         }
     }
@@ -179,17 +191,28 @@ LoadConfigurationFiles(
 static void
 LoadNestedProjects(
     Filesystem const *filesystem,
+    ThreadPool *pool,
     std::vector<pbxproj::PBX::Project::shared_ptr> *projects,
     std::unordered_map<pbxproj::XC::BuildConfiguration::shared_ptr, pbxsetting::XC::Config> *configs,
     pbxsetting::Environment const &baseEnvironment,
     std::vector<pbxproj::PBX::Project::shared_ptr> const &rootProjects)
 {
-    std::vector<pbxproj::PBX::Project::shared_ptr> nestedProjects;
+    /*
+     * Each project's configuration files and nested projects are loaded in
+     * parallel, then merged in project order so the result is the same no
+     * matter which project finishes loading first.
+     */
+    std::vector<std::vector<std::pair<pbxproj::XC::BuildConfiguration::shared_ptr, pbxsetting::XC::Config>>> projectConfigs =
+        std::vector<std::vector<std::pair<pbxproj::XC::BuildConfiguration::shared_ptr, pbxsetting::XC::Config>>>(rootProjects.size());
+    std::vector<std::vector<pbxproj::PBX::Project::shared_ptr>> projectNestedProjects =
+        std::vector<std::vector<pbxproj::PBX::Project::shared_ptr>>(rootProjects.size());
 
     /*
      * Load all nested projects recursively.
      */
-    for (pbxproj::PBX::Project::shared_ptr const &project : rootProjects) {
+    pool->apply(rootProjects.size(), [&](size_t n) {
+        pbxproj::PBX::Project::shared_ptr const &project = rootProjects[n];
+
         /*
          * Determine the settings environment to find the project paths. This may not be complete,
          * but it's unclear exactly what settings are available here. Notably, we don't yet know what
@@ -201,9 +224,9 @@ LoadNestedProjects(
         /*
          * Load project and target configurations.
          */
-        LoadConfigurationFiles(filesystem, configs, environment, project->buildConfigurationList());
+        LoadConfigurationFiles(filesystem, &projectConfigs[n], environment, project->buildConfigurationList());
         for (pbxproj::PBX::Target::shared_ptr const &target : project->targets()) {
-            LoadConfigurationFiles(filesystem, configs, environment, target->buildConfigurationList());
+            LoadConfigurationFiles(filesystem, &projectConfigs[n], environment, target->buildConfigurationList());
         }
 
         /*
@@ -218,9 +241,15 @@ LoadNestedProjects(
              */
             pbxproj::PBX::Project::shared_ptr project = pbxproj::PBX::Project::Open(filesystem, projectPath);
             if (project != nullptr) {
-                nestedProjects.push_back(project);
+                projectNestedProjects[n].push_back(project);
             }
         }
+    });
+
+    std::vector<pbxproj::PBX::Project::shared_ptr> nestedProjects;
+    for (size_t n = 0; n < rootProjects.size(); n++) {
+        configs->insert(projectConfigs[n].begin(), projectConfigs[n].end());
+        nestedProjects.insert(nestedProjects.end(), projectNestedProjects[n].begin(), projectNestedProjects[n].end());
     }
 
     /*
@@ -232,18 +261,24 @@ LoadNestedProjects(
         /*
          * Load nested projects of the nested projects.
          */
-        LoadNestedProjects(filesystem, projects, configs, baseEnvironment, nestedProjects);
+        LoadNestedProjects(filesystem, pool, projects, configs, baseEnvironment, nestedProjects);
     }
 }
 
 static void
-LoadProjectSchemes(Filesystem const *filesystem, std::string const &userName, std::vector<xcscheme::SchemeGroup::shared_ptr> *schemeGroups, std::vector<pbxproj::PBX::Project::shared_ptr> const &projects)
+LoadProjectSchemes(Filesystem const *filesystem, ThreadPool *pool, std::string const &userName, std::vector<xcscheme::SchemeGroup::shared_ptr> *schemeGroups, std::vector<pbxproj::PBX::Project::shared_ptr> const &projects)
 {
     /*
-     * Load the schemes inside the projects.
+     * Load the schemes inside the projects in parallel, but keep them in
+     * project order.
      */
-    for (pbxproj::PBX::Project::shared_ptr const &project : projects) {
-        xcscheme::SchemeGroup::shared_ptr projectGroup = xcscheme::SchemeGroup::Open(filesystem, userName, project->basePath(), project->projectFile(), project->name());
+    std::vector<xcscheme::SchemeGroup::shared_ptr> projectGroups = std::vector<xcscheme::SchemeGroup::shared_ptr>(projects.size());
+    pool->apply(projects.size(), [&](size_t n) {
+        pbxproj::PBX::Project::shared_ptr const &project = projects[n];
+        projectGroups[n] = xcscheme::SchemeGroup::Open(filesystem, userName, project->basePath(), project->projectFile(), project->name());
+    });
+
+    for (xcscheme::SchemeGroup::shared_ptr const &projectGroup : projectGroups) {
         if (projectGroup != nullptr) {
             schemeGroups->push_back(projectGroup);
         }
@@ -270,6 +305,7 @@ Workspace(Filesystem const *filesystem, std::string const &userName, pbxsetting:
     std::vector<pbxproj::PBX::Project::shared_ptr> projects;
     std::vector<xcscheme::SchemeGroup::shared_ptr> schemeGroups;
     std::unordered_map<pbxproj::XC::BuildConfiguration::shared_ptr, pbxsetting::XC::Config> configs;
+    ThreadPool pool(ThreadPool::DefaultThreadCount());
 
     /*
      * Add the schemes from the workspace itself.
@@ -282,17 +318,17 @@ Workspace(Filesystem const *filesystem, std::string const &userName, pbxsetting:
     /*
      * Load projects within the workspace.
      */
-    LoadWorkspaceProjects(filesystem, &projects, workspace);
+    LoadWorkspaceProjects(filesystem, &pool, &projects, workspace);
 
     /*
      * Recursively load nested projects within those projects.
      */
-    LoadNestedProjects(filesystem, &projects, &configs, baseEnvironment, projects);
+    LoadNestedProjects(filesystem, &pool, &projects, &configs, baseEnvironment, projects);
 
     /*
      * Load schemes for all projects, including nested projects.
      */
-    LoadProjectSchemes(filesystem, userName, &schemeGroups, projects);
+    LoadProjectSchemes(filesystem, &pool, userName, &schemeGroups, projects);
 
     /*
      * Determine the DerivedData path for the workspace.
@@ -308,6 +344,7 @@ Project(Filesystem const *filesystem, std::string const &userName, pbxsetting::E
     std::vector<pbxproj::PBX::Project::shared_ptr> projects;
     std::vector<xcscheme::SchemeGroup::shared_ptr> schemeGroups;
     std::unordered_map<pbxproj::XC::BuildConfiguration::shared_ptr, pbxsetting::XC::Config> configs;
+    ThreadPool pool(ThreadPool::DefaultThreadCount());
 
     /*
      * The root is a project, so it should be in the projects list.
@@ -317,12 +354,12 @@ Project(Filesystem const *filesystem, std::string const &userName, pbxsetting::E
     /*
      * Recursively load nested projects within the project.
      */
-    LoadNestedProjects(filesystem, &projects, &configs, baseEnvironment, projects);
+    LoadNestedProjects(filesystem, &pool, &projects, &configs, baseEnvironment, projects);
 
     /*
      * Load schemes for all projects, including the root and nested projects.
      */
-    LoadProjectSchemes(filesystem, userName, &schemeGroups, projects);
+    LoadProjectSchemes(filesystem, &pool, userName, &schemeGroups, projects);
 
     /*
      * Determine the DerivedData path for the root project.
@@ -0,0 +1,97 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+#include <pbxbuild/FileTypeResolver.h>
+#include <libutil/MemoryFilesystem.h>
+
+using pbxbuild::FileTypeResolver;
+using libutil::MemoryFilesystem;
+
+static std::vector<uint8_t>
+Contents(std::string const &string)
+{
+    return std::vector<uint8_t>(string.begin(), string.end());
+}
+
+static std::string const Specifications =
+    "("
+    "    { Identifier = file; Type = FileType; },"
+    "    { Identifier = folder; Type = FileType; IsFolder = YES; },"
+    "    { Identifier = text; Type = FileType; BasedOn = file; Extensions = (txt); },"
+    "    { Identifier = sourcecode.c; Type = FileType; BasedOn = text; },"
+    "    { Identifier = sourcecode.c.c; Type = FileType; BasedOn = sourcecode.c; Extensions = (c); },"
+    "    { Identifier = sourcecode.asm; Type = FileType; BasedOn = sourcecode.c; Extensions = (s); },"
+    "    { Identifier = text.script; Type = FileType; BasedOn = text; Prefix = (make); },"
+    "    { Identifier = text.plist; Type = FileType; BasedOn = text; FilenamePatterns = (\"*.plist\", \"Info.*\"); },"
+    "    { Identifier = wrapper.framework; Type = FileType; BasedOn = folder; IsFolder = YES; Extensions = (framework); },"
+    ")";
+
+TEST(FileTypeResolver, Resolve)
+{
+    auto filesystem = MemoryFilesystem({
+        MemoryFilesystem::Entry::Directory("specs", {
+            MemoryFilesystem::Entry::File("types.xcspec", Contents(Specifications)),
+        }),
+        MemoryFilesystem::Entry::File("main.c", Contents("int main() { }")),
+        MemoryFilesystem::Entry::File("start.S", Contents("")),
+        MemoryFilesystem::Entry::Directory("Foo.framework", { }),
+        MemoryFilesystem::Entry::Directory("Directory", { }),
+    });
+
+    auto specManager = std::make_shared<pbxspec::Manager>();
+    specManager->registerDomains(&filesystem, { { "default", filesystem.path("specs") } });
+    std::vector<std::string> const domains = { "default" };
+
+    auto resolve = [&](std::string const &path) -> std::string {
+        pbxspec::PBX::FileType::shared_ptr fileType = FileTypeResolver::Resolve(&filesystem, specManager, domains, filesystem.path(path));
+        return (fileType != nullptr ? fileType->identifier() : "");
+    };
+
+    /* Extensions match case-insensitively. */
+    EXPECT_EQ("sourcecode.c.c", resolve("main.c"));
+    EXPECT_EQ("sourcecode.asm", resolve("start.S"));
+
+    /* Types without extensions are checked for any path. */
+    EXPECT_EQ("text.script", resolve("makefile"));
+    EXPECT_EQ("text.plist", resolve("Info.plist"));
+    EXPECT_EQ("text.plist", resolve("Info.strings"));
+
+    /* Folders only match folder types. */
+    EXPECT_EQ("wrapper.framework", resolve("Foo.framework"));
+    EXPECT_EQ("folder", resolve("Directory"));
+    EXPECT_EQ("file", resolve("unknown.xyz"));
+
+    /* Results are the same when resolved again. */
+    EXPECT_EQ("sourcecode.c.c", resolve("main.c"));
+    EXPECT_EQ("wrapper.framework", resolve("Foo.framework"));
+}
+
+TEST(FileTypeResolver, CreatedPath)
+{
+    auto filesystem = MemoryFilesystem({
+        MemoryFilesystem::Entry::Directory("specs", {
+            MemoryFilesystem::Entry::File("types.xcspec", Contents(Specifications)),
+        }),
+    });
+
+    auto specManager = std::make_shared<pbxspec::Manager>();
+    specManager->registerDomains(&filesystem, { { "default", filesystem.path("specs") } });
+    std::vector<std::string> const domains = { "default" };
+
+    /* A path that doesn't exist yet resolves by name alone. */
+    pbxspec::PBX::FileType::shared_ptr missing = FileTypeResolver::Resolve(&filesystem, specManager, domains, filesystem.path("Output"));
+    ASSERT_NE(nullptr, missing);
+    EXPECT_EQ("file", missing->identifier());
+
+    /* Once created by the build, the path is examined again. */
+    ASSERT_TRUE(filesystem.createDirectory(filesystem.path("Output"), false));
+    pbxspec::PBX::FileType::shared_ptr created = FileTypeResolver::Resolve(&filesystem, specManager, domains, filesystem.path("Output"));
+    ASSERT_NE(nullptr, created);
+    EXPECT_EQ("folder", created->identifier());
+}
@@ -8,12 +8,17 @@
 
 #include <gtest/gtest.h>
 #include <pbxbuild/Tool/OptionsResult.h>
+#include <pbxbuild/Tool/Environment.h>
+#include <pbxspec/Manager.h>
 #include <pbxsetting/Environment.h>
 #include <pbxsetting/Level.h>
 #include <pbxsetting/Setting.h>
 #include <plist/Dictionary.h>
 #include <plist/Format/ASCII.h>
 #include <plist/Format/Encoding.h>
+#include <libutil/MemoryFilesystem.h>
+
+using libutil::MemoryFilesystem;
 
 namespace Tool = pbxbuild::Tool;
 
@@ -631,6 +636,80 @@ TEST(OptionsResult, Architectures)
     }));
 }
 
+/*
+ * Test options are shared between inputs unless they depend on the input.
+ */
+TEST(OptionsResult, Cache)
+{
+    std::string specifications =
+        "("
+        "    { Identifier = shared; Type = Tool; ExecPath = shared; Options = ("
+        "        { Name = FLAG; Type = String; CommandLineFlag = \"-flag\"; },"
+        "    ); },"
+        "    { Identifier = input; Type = Tool; ExecPath = input; Options = ("
+        "        { Name = FLAG; Type = String; CommandLineFlag = \"-flag\"; },"
+        "        { Name = INPUT_FLAG; Type = String; CommandLineFlag = \"-input\"; DefaultValue = \"$(InputFileBase)\"; },"
+        "    ); },"
+        "    { Identifier = operations; Type = Tool; ExecPath = operations; Options = ("
+        "        { Name = UPPER_FLAG; Type = String; CommandLineFlag = \"-upper\"; DefaultValue = \"$(InputFileBase:upper)\"; },"
+        "        { Name = IDENTIFIER_FLAG; Type = String; CommandLineFlag = \"-identifier\"; DefaultValue = \"$(InputFileName:identifier)\"; },"
+        "        { Name = RFC1034_FLAG; Type = String; CommandLineFlag = \"-rfc1034\"; DefaultValue = \"$(InputFileName:rfc1034identifier)\"; },"
+        "    ); },"
+        "    { Identifier = condition; Type = Tool; ExecPath = condition; Options = ("
+        "        { Name = FLAG; Type = String; CommandLineFlag = \"-flag\"; Condition = \"$(OutputFileBase:upper) == FIRST.C\"; },"
+        "    ); },"
+        ")";
+
+    auto filesystem = MemoryFilesystem({
+        MemoryFilesystem::Entry::Directory("specs", {
+            MemoryFilesystem::Entry::File("tools.xcspec", std::vector<uint8_t>(specifications.begin(), specifications.end())),
+        }),
+    });
+
+    auto specManager = std::make_shared<pbxspec::Manager>();
+    specManager->registerDomains(&filesystem, { { "default", filesystem.path("specs") } });
+
+    auto environment = Environment({
+        pbxsetting::Setting::Create("FLAG", "value"),
+    });
+
+    auto resolve = [&](Tool::OptionsResult::Cache *cache, std::string const &identifier, std::string const &path) -> std::shared_ptr<Tool::OptionsResult::ToolResult const> {
+        pbxspec::PBX::Tool::shared_ptr tool = specManager->tool(identifier, { "default" });
+        Tool::Input input = Tool::Input(path, FileType);
+        Tool::Environment toolEnvironment = Tool::Environment::Create(tool, environment, "/", { input }, { path + ".o" });
+        return cache->get(environment, toolEnvironment, "/", input);
+    };
+
+    /* Options that don't depend on the input are evaluated once. */
+    Tool::OptionsResult::Cache shared;
+    auto first = resolve(&shared, "shared", "/first.c");
+    auto second = resolve(&shared, "shared", "/second.c");
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(std::vector<std::string>({ "-flag", "value" }), second->options.arguments());
+    EXPECT_EQ("shared", second->tokens.executable());
+
+    /* Options that depend on the input are evaluated for each input. */
+    Tool::OptionsResult::Cache input;
+    first = resolve(&input, "input", "/first.c");
+    second = resolve(&input, "input", "/second.c");
+    EXPECT_EQ(std::vector<std::string>({ "-flag", "value", "-input", "first" }), first->options.arguments());
+    EXPECT_EQ(std::vector<std::string>({ "-flag", "value", "-input", "second" }), second->options.arguments());
+
+    /* Operations on input settings still make options depend on the input. */
+    Tool::OptionsResult::Cache operations;
+    first = resolve(&operations, "operations", "/first-file.c");
+    second = resolve(&operations, "operations", "/second-file.c");
+    EXPECT_EQ(std::vector<std::string>({ "-upper", "FIRST-FILE", "-identifier", "first_file_c", "-rfc1034", "first-file-c" }), first->options.arguments());
+    EXPECT_EQ(std::vector<std::string>({ "-upper", "SECOND-FILE", "-identifier", "second_file_c", "-rfc1034", "second-file-c" }), second->options.arguments());
+
+    /* So do conditions on output settings, even if their value isn't used. */
+    Tool::OptionsResult::Cache condition;
+    first = resolve(&condition, "condition", "/first.c");
+    second = resolve(&condition, "condition", "/second.c");
+    EXPECT_EQ(std::vector<std::string>({ "-flag", "value" }), first->options.arguments());
+    EXPECT_EQ(std::vector<std::string>(), second->options.arguments());
+}
+
 /*
 
 To test:
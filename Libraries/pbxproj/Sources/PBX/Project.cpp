@@ -203,8 +203,8 @@ Open(Filesystem const *filesystem, std::string const &path)
         return nullptr;
     }
 
-    std::vector<uint8_t> contents;
-    if (!filesystem->read(&contents, realPath)) {
+    std::unique_ptr<Filesystem::MappedFile> contents = filesystem->map(realPath);
+    if (contents == nullptr) {
         fprintf(stderr, "error: project file %s is not readable\n", projectFileName.c_str());
         return nullptr;
     }
@@ -212,7 +212,7 @@ Open(Filesystem const *filesystem, std::string const &path)
     //
     // Parse property list
     //
-    auto result = plist::Format::Any::Deserialize(contents);
+    auto result = plist::Format::Any::Deserialize(contents->contents());
     if (result.first == nullptr) {
         fprintf(stderr, "error: project file %s is not parseable: %s\n", projectFileName.c_str(), result.second.c_str());
         return nullptr;
@@ -13,19 +13,35 @@
 #include <pbxsetting/Level.h>
 
 #include <list>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 
 namespace pbxsetting {
 
 /*
  * Represents a hierarchical list of build settings (an ordered list of build
  * setting levels). Can use those levels to evaluate build setting values.
+ *
+ * Resolved settings are cached until a level is added. Copies share the cache
+ * until either is modified, since they have the same levels until then.
  */
 class Environment {
 private:
-    std::list<Level> _levels;
-    size_t           _offset;
+    using Values = std::unordered_map<std::string, std::string>;
+
+    struct Cache {
+        std::mutex                             mutex;
+        std::unordered_map<std::string, Values> values;
+    };
+
+private:
+    std::list<Level>       _levels;
+    size_t                 _offset;
+    std::shared_ptr<Cache> _cache;
+    std::unordered_set<std::string> *_tracked;
 
 public:
     explicit Environment();
@@ -74,6 +90,23 @@ public:
      */
     void insertBack(Level const &level, bool isDefault);
 
+public:
+    /*
+     * Notes the name of each setting evaluated, including settings only used by
+     * other settings, in a set; pass nullptr to stop. Copies note their settings
+     * in the same set. Resolved values aren't cached while tracking, since those
+     * wouldn't note what they were evaluated from. The set isn't locked.
+     */
+    void track(std::unordered_set<std::string> *settings);
+
+public:
+    /*
+     * An opaque token for the environment's levels. Environments with the same
+     * token have the same levels; adding a level gives the environment a new one.
+     */
+    std::shared_ptr<void const> identity() const
+    { return _cache; }
+
 public:
     /*
      * For debugging: print out the contents of all levels.
@@ -86,9 +119,10 @@ private:
         std::string setting;
         std::list<Level>::const_iterator it;
     };
-    std::string resolveValue(Condition const &condition, Value const &value, InheritanceContext const &context) const;
-    std::string resolveInheritance(Condition const &condition, InheritanceContext const &context) const;
-    std::string resolveAssignment(Condition const &condition, std::string const &setting) const;
+    Values *cachedValues(Condition const &condition) const;
+    void resolveValue(Condition const &condition, Values *values, Value const &value, InheritanceContext const &context, std::string *result) const;
+    void resolveInheritance(Condition const &condition, Values *values, InheritanceContext const &context, std::string *result) const;
+    void resolveAssignment(Condition const &condition, Values *values, std::string const &setting, std::string *result) const;
 };
 
 }
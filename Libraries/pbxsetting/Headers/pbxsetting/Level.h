@@ -13,6 +13,8 @@
 #include <pbxsetting/Setting.h>
 #include <pbxsetting/Value.h>
 
+#include <string>
+#include <unordered_map>
 #include <vector>
 #include <utility>
 #include <memory>
@@ -28,6 +30,13 @@ class Level {
 private:
     std::shared_ptr<std::vector<Setting>> _settings;
 
+private:
+    /*
+     * Index from setting name to the settings with that name, in order.
+     * Shared between copies of the level, as the settings are.
+     */
+    std::shared_ptr<std::unordered_map<std::string, std::vector<size_t>>> _index;
+
 public:
     /*
      * Creates a level with the given settings.
@@ -0,0 +1,78 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef __pbxsetting_Operation_h
+#define __pbxsetting_Operation_h
+
+#include <string>
+
+namespace pbxsetting {
+
+/*
+ * An operation applied to the value of a setting reference, written after
+ * the setting name and a colon:
+ *
+ *     $(PRODUCT_NAME:rfc1034identifier)
+ *
+ * Operations are parsed once, when the value containing them is parsed.
+ */
+class Operation {
+public:
+    enum class Type {
+        Identifier,
+        C99ExtIdentifier,
+        RFC1034Identifier,
+        Quote,
+        Lower,
+        Upper,
+        StandardizePath,
+        Base,
+        Dir,
+        File,
+        Suffix,
+        Unknown,
+    };
+
+private:
+    Type        _type;
+    std::string _name;
+
+public:
+    Operation(Type type, std::string const &name);
+
+public:
+    /*
+     * The kind of operation.
+     */
+    Type type() const
+    { return _type; }
+
+    /*
+     * The name of the operation, as written in the reference.
+     */
+    std::string const &name() const
+    { return _name; }
+
+public:
+    /*
+     * Apply the operation to a resolved value.
+     */
+    std::string
+    apply(std::string const &value) const;
+
+public:
+    /*
+     * Parses an operation name. Unknown operations leave values unchanged.
+     */
+    static Operation
+    Parse(std::string const &name);
+};
+
+}
+
+#endif  // !__pbxsetting_Operation_h
@@ -12,6 +12,8 @@
 #include <memory>
 #include <string>
 #include <vector>
+#include <pbxsetting/Operation.h>
+
 #include <ext/optional>
 
 namespace plist { class Object; }
@@ -29,6 +31,48 @@ namespace pbxsetting {
  * This class stores, not resolves, build setting value.
  */
 class Value {
+public:
+    /*
+     * A setting reference with a literal name, like `$(NAME:lower)`, split
+     * into the setting and the operations to apply to its value. Parsed once,
+     * so resolving the reference doesn't need to parse it again.
+     */
+    class Reference {
+    private:
+        std::string            _name;
+        std::string            _setting;
+        std::vector<Operation> _operations;
+
+    public:
+        Reference(std::string const &name, std::string const &setting, std::vector<Operation> const &operations);
+
+    public:
+        /*
+         * The full text of the reference, including operations.
+         */
+        std::string const &name() const
+        { return _name; }
+
+        /*
+         * The name of the setting referenced.
+         */
+        std::string const &setting() const
+        { return _setting; }
+
+        /*
+         * Operations to apply to the setting's value, in order.
+         */
+        std::vector<Operation> const &operations() const
+        { return _operations; }
+
+    public:
+        /*
+         * Parses the text of a reference.
+         */
+        static Reference
+        Parse(std::string const &name);
+    };
+
 public:
     /*
      * A node in the AST describing the value. Can be a literal
@@ -43,9 +87,10 @@ public:
         };
 
     private:
-        Type                       _type;
-        ext::optional<std::string> _string;
-        std::shared_ptr<Value>     _value;
+        Type                             _type;
+        ext::optional<std::string>       _string;
+        std::shared_ptr<Value>           _value;
+        std::shared_ptr<Reference const> _reference;
 
     public:
         Entry(std::string const &string);
@@ -62,6 +107,13 @@ public:
         { return _string; }
         std::shared_ptr<Value> const &value() const
         { return _value; }
+
+        /*
+         * For values with a literal name, the parsed reference. Null if the
+         * name itself contains references, so must be resolved first.
+         */
+        std::shared_ptr<Reference const> const &reference() const
+        { return _reference; }
     };
 
 private:
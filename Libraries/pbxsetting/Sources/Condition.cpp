@@ -26,7 +26,7 @@ Condition::
 bool Condition::
 match(Condition const &condition) const
 {
-    auto OV = condition._values;
+    auto const &OV = condition._values;
     for (auto const &TE : _values) {
         auto OE = OV.find(TE.first);
         if (OE == OV.end()) {
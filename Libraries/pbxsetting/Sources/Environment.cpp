@@ -7,192 +7,173 @@
  */
 
 #include <pbxsetting/Environment.h>
-#include <libutil/FSUtil.h>
 
 #include <algorithm>
-#include <sstream>
 
 using pbxsetting::Environment;
 using pbxsetting::Level;
 using pbxsetting::Condition;
+using pbxsetting::Operation;
 using pbxsetting::Setting;
 using pbxsetting::Value;
-using libutil::FSUtil;
 
 Environment::
 Environment() :
-    _offset(0)
+    _offset (0),
+    _cache  (std::make_shared<Cache>()),
+    _tracked(nullptr)
 {
 }
 
 static std::string
-ProcessOperation(std::string const &value, std::string const &operation)
+ConditionKey(Condition const &condition)
 {
-    const std::string alphabet = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
-    const std::string digits = "0123456789";
+    /* Sort the condition, since it is stored unordered. */
+    std::vector<std::pair<std::string, std::string>> values = std::vector<std::pair<std::string, std::string>>(condition.values().begin(), condition.values().end());
+    std::sort(values.begin(), values.end());
 
-    if (operation == "identifier" || operation == "c99extidentifier") {
-        // TODO(grp): Support c99extidentifier correctly. Requires Unicode handling.
-
-        const std::string begin = alphabet + "_";
-        const std::string subsequent = begin + digits;
-
-        std::string result = value;
-        std::string::size_type offset = result.find_first_not_of(begin);
-        while (offset != std::string::npos) {
-            result[offset] = '_';
-            offset = result.find_first_not_of(subsequent, offset);
-        }
-
-        return result;
-    } else if (operation == "rfc1034identifier") {
-        const std::string begin = alphabet;
-        const std::string subsequent = alphabet + digits + "-";
-        const std::string end = alphabet + digits;
-
-        std::string result = value;
-        for (std::string::iterator it = result.begin(), prev = result.end(), next = (it == result.end() ? it : std::next(it)); it != result.end(); prev = it, ++it, next = (it == result.end() ? it : std::next(it))) {
-            // Cannot start or end with a dot.
-            if (prev == result.end() || next == result.end()) {
-                if (*it == '.') {
-                    *it = '-';
-                }
-            }
-
-            // Cannot have digit or hyphen after dot, or hyphen before dot.
-            if (prev == result.end() || *prev == '.') {
-                if (begin.find(*it) == std::string::npos) {
-                    *it = '-';
-                }
-            } else if (next != result.end() && *next == '.') {
-                if (subsequent.find(*it) == std::string::npos) {
-                    *it = '-';
-                }
-            } else {
-                if (end.find(*it) == std::string::npos) {
-                    *it = '-';
-                }
-            }
-        }
+    std::string key;
+    for (auto const &value : values) {
+        key += value.first + '\0' + value.second + '\0';
+    }
+    return key;
+}
 
-        return result;
-    } else if (operation == "quote") {
-        // FIXME(grp): This is (probably) valid, but not necessarily compatible. Algorithm from Python's shlex.quote().
-        if (value.find_first_not_of(alphabet + digits + "@%_-+=:,./") == std::string::npos) {
-            return value;
-        } else {
-            std::string result = value;
-            std::string::size_type offset = 0;
-            while ((offset = result.find("'", offset)) != std::string::npos) {
-                result.replace(offset, 1, "'\"'\"'");
-                offset += 5;
-            }
-            return "'" + result + "'";
-        }
-    } else if (operation == "lower") {
-        std::string result = value;
-        std::transform(result.begin(), result.end(), result.begin(), ::tolower);
-        return result;
-    } else if (operation == "upper") {
-        std::string result = value;
-        std::transform(result.begin(), result.end(), result.begin(), ::toupper);
-        return result;
-    } else if (operation == "standardizepath") {
-        return FSUtil::NormalizePath(value);
-    } else if (operation == "base") {
-        return FSUtil::GetBaseNameWithoutExtension(value);
-    } else if (operation == "dir") {
-        return FSUtil::GetDirectoryName(value);
-    } else if (operation == "file") {
-        return FSUtil::GetBaseName(value);
-    } else if (operation == "suffix") {
-        return "." + FSUtil::GetFileExtension(value);
-    } else {
-        fprintf(stderr, "warning: unknown build setting operation '%s'\n", operation.c_str());
-        return value;
+Environment::Values *Environment::
+cachedValues(Condition const &condition) const
+{
+    if (_cache == nullptr || _tracked != nullptr) {
+        return nullptr;
     }
+
+    /* Values are stable in the map, so can be used without looking them up again. */
+    std::lock_guard<std::mutex> lock(_cache->mutex);
+    return &_cache->values[ConditionKey(condition)];
 }
 
-std::string Environment::
-resolveValue(Condition const &condition, Value const &value, InheritanceContext const &context) const
+void Environment::
+resolveValue(Condition const &condition, Values *values, Value const &value, InheritanceContext const &context, std::string *result) const
 {
-    std::string result;
     for (auto const &entry : value.entries()) {
         switch (entry.type()) {
             case Value::Entry::Type::String: {
-                result += *entry.string();
+                *result += *entry.string();
                 break;
             }
             case Value::Entry::Type::Value: {
-                std::string resolved = resolveValue(condition, *entry.value(), context);
-                if (context.valid && (resolved == context.setting || resolved == "inherited")) {
-                    result += resolveInheritance(condition, context);
-                } else {
-                    std::string setting = resolved;
+                /*
+                 * References with a literal name were parsed with the value. Otherwise,
+                 * the name needs to be resolved before it can be parsed.
+                 */
+                Value::Reference const *reference = entry.reference().get();
+                ext::optional<Value::Reference> resolvedReference;
+                if (reference == nullptr) {
+                    std::string resolved;
+                    resolveValue(condition, values, *entry.value(), context, &resolved);
+                    resolvedReference = Value::Reference::Parse(resolved);
+                    reference = &*resolvedReference;
+                }
 
-                    std::string::size_type colon = resolved.find(':');
-                    if (colon != std::string::npos) {
-                        setting = resolved.substr(0, colon);
+                if (context.valid && (reference->name() == context.setting || reference->name() == "inherited")) {
+                    resolveInheritance(condition, values, context, result);
+                } else if (reference->operations().empty()) {
+                    resolveAssignment(condition, values, reference->setting(), result);
+                } else {
+                    /*
+                     * Cache the value after operations under the full reference. It
+                     * can't conflict with a setting name, since those have no colon.
+                     */
+                    if (values != nullptr) {
+                        std::lock_guard<std::mutex> lock(_cache->mutex);
+                        auto it = values->find(reference->name());
+                        if (it != values->end()) {
+                            *result += it->second;
+                            break;
+                        }
                     }
 
-                    std::string value = resolveAssignment(condition, setting);
-
-                    while (colon != std::string::npos) {
-                        std::string::size_type next = resolved.find(':', colon + 1);
+                    std::string value;
+                    resolveAssignment(condition, values, reference->setting(), &value);
 
-                        std::string operation = resolved.substr(colon + 1, next == std::string::npos ? next : next - colon - 1);
-                        value = ProcessOperation(value, operation);
+                    for (Operation const &operation : reference->operations()) {
+                        value = operation.apply(value);
+                    }
 
-                        colon = next;
+                    if (values != nullptr) {
+                        std::lock_guard<std::mutex> lock(_cache->mutex);
+                        values->insert({ reference->name(), value });
                     }
 
-                    result += value;
+                    *result += value;
                 }
                 break;
             }
         }
     }
-    return result;
 }
 
-std::string Environment::
-resolveInheritance(Condition const &condition, InheritanceContext const &context) const
+void Environment::
+resolveInheritance(Condition const &condition, Values *values, InheritanceContext const &context, std::string *result) const
 {
     InheritanceContext ctx = context;
     for (++ctx.it; ctx.it != _levels.end(); ++ctx.it) {
-        auto result = ctx.it->get(ctx.setting, condition);
-        if (result.first) {
-            return resolveValue(condition, result.second, ctx);
+        auto level = ctx.it->get(ctx.setting, condition);
+        if (level.first) {
+            resolveValue(condition, values, level.second, ctx, result);
+            return;
         }
     }
-
-    return "";
 }
 
-std::string Environment::
-resolveAssignment(Condition const &condition, std::string const &setting) const
+void Environment::
+resolveAssignment(Condition const &condition, Values *values, std::string const &setting, std::string *result) const
 {
+    if (values != nullptr) {
+        std::lock_guard<std::mutex> lock(_cache->mutex);
+        auto it = values->find(setting);
+        if (it != values->end()) {
+            *result += it->second;
+            return;
+        }
+    }
+
+    if (_tracked != nullptr) {
+        _tracked->insert(setting);
+    }
+
+    std::string value;
+    bool found = false;
+
     InheritanceContext context = { true, setting };
 
     for (context.it = _levels.begin(); context.it != _levels.end(); ++context.it) {
         Level const &level = *context.it;
-        auto result = level.get(setting, condition);
-        if (result.first) {
-            return resolveValue(condition, result.second, context);
+        auto assignment = level.get(setting, condition);
+        if (assignment.first) {
+            resolveValue(condition, values, assignment.second, context, &value);
+            found = true;
+            break;
         }
     }
 
-    if (condition.values().empty()) {
-        return "";
-    } else {
-        return resolveAssignment(Condition::Empty(), setting);
+    if (!found && !condition.values().empty()) {
+        resolveAssignment(Condition::Empty(), cachedValues(Condition::Empty()), setting, &value);
     }
+
+    if (values != nullptr) {
+        std::lock_guard<std::mutex> lock(_cache->mutex);
+        values->insert({ setting, value });
+    }
+
+    *result += value;
 }
 
 std::string Environment::
 expand(Value const &value, Condition const &condition) const
 {
-    return resolveValue(condition, value, { false });
+    std::string result;
+    resolveValue(condition, cachedValues(condition), value, { false }, &result);
+    return result;
 }
 
 std::string Environment::
@@ -204,7 +185,9 @@ expand(Value const &value) const
 std::string Environment::
 resolve(std::string const &setting, Condition const &condition) const
 {
-    return resolveAssignment(condition, setting);
+    std::string result;
+    resolveAssignment(condition, cachedValues(condition), setting, &result);
+    return result;
 }
 
 std::string Environment::
@@ -232,6 +215,9 @@ computeValues(Condition const &condition) const
 void Environment::
 insertFront(Level const &level, bool isDefault)
 {
+    /* Resolved values may change; don't modify any copies' cache. */
+    _cache = std::make_shared<Cache>();
+
     if (!isDefault) {
         _levels.push_front(level);
         ++_offset;
@@ -243,6 +229,9 @@ insertFront(Level const &level, bool isDefault)
 void Environment::
 insertBack(Level const &level, bool isDefault)
 {
+    /* Resolved values may change; don't modify any copies' cache. */
+    _cache = std::make_shared<Cache>();
+
     if (!isDefault) {
         _levels.insert(std::next(_levels.begin(), _offset), level);
         ++_offset;
@@ -251,6 +240,12 @@ insertBack(Level const &level, bool isDefault)
     }
 }
 
+void Environment::
+track(std::unordered_set<std::string> *settings)
+{
+    _tracked = settings;
+}
+
 void Environment::
 dump() const
 {
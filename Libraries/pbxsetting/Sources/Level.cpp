@@ -15,8 +15,12 @@ using pbxsetting::Value;
 
 Level::
 Level(std::vector<Setting> const &settings) :
-    _settings(std::make_shared<std::vector<Setting>>(settings))
+    _settings(std::make_shared<std::vector<Setting>>(settings)),
+    _index   (std::make_shared<std::unordered_map<std::string, std::vector<size_t>>>())
 {
+    for (size_t index = 0; index < _settings->size(); index++) {
+        (*_index)[(*_settings)[index].name()].push_back(index);
+    }
 }
 
 Level::
@@ -27,9 +31,16 @@ Level::
 std::pair<bool, Value> Level::
 get(std::string const &setting, Condition const &condition) const
 {
-    for (auto it = _settings->rbegin(); it != _settings->rend(); ++it) {
-        if (it->match(setting, condition)) {
-            return std::make_pair(true, it->value());
+    auto indexes = _index->find(setting);
+    if (indexes == _index->end()) {
+        return std::make_pair(false, Value::Empty());
+    }
+
+    /* Later settings override earlier ones. */
+    for (auto it = indexes->second.rbegin(); it != indexes->second.rend(); ++it) {
+        Setting const &candidate = (*_settings)[*it];
+        if (candidate.condition().match(condition)) {
+            return std::make_pair(true, candidate.value());
         }
     }
 
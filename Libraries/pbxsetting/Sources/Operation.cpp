@@ -0,0 +1,157 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree.
+ */
+
+#include <pbxsetting/Operation.h>
+#include <libutil/FSUtil.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+using pbxsetting::Operation;
+using libutil::FSUtil;
+
+Operation::
+Operation(Type type, std::string const &name) :
+    _type(type),
+    _name(name)
+{
+}
+
+std::string Operation::
+apply(std::string const &value) const
+{
+    const std::string alphabet = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    const std::string digits = "0123456789";
+
+    switch (_type) {
+        case Type::Identifier:
+        case Type::C99ExtIdentifier: {
+            // TODO(grp): Support c99extidentifier correctly. Requires Unicode handling.
+
+            const std::string begin = alphabet + "_";
+            const std::string subsequent = begin + digits;
+
+            std::string result = value;
+            std::string::size_type offset = result.find_first_not_of(begin);
+            while (offset != std::string::npos) {
+                result[offset] = '_';
+                offset = result.find_first_not_of(subsequent, offset);
+            }
+
+            return result;
+        }
+        case Type::RFC1034Identifier: {
+            const std::string begin = alphabet;
+            const std::string subsequent = alphabet + digits + "-";
+            const std::string end = alphabet + digits;
+
+            std::string result = value;
+            for (std::string::iterator it = result.begin(), prev = result.end(), next = (it == result.end() ? it : std::next(it)); it != result.end(); prev = it, ++it, next = (it == result.end() ? it : std::next(it))) {
+                // Cannot start or end with a dot.
+                if (prev == result.end() || next == result.end()) {
+                    if (*it == '.') {
+                        *it = '-';
+                    }
+                }
+
+                // Cannot have digit or hyphen after dot, or hyphen before dot.
+                if (prev == result.end() || *prev == '.') {
+                    if (begin.find(*it) == std::string::npos) {
+                        *it = '-';
+                    }
+                } else if (next != result.end() && *next == '.') {
+                    if (subsequent.find(*it) == std::string::npos) {
+                        *it = '-';
+                    }
+                } else {
+                    if (end.find(*it) == std::string::npos) {
+                        *it = '-';
+                    }
+                }
+            }
+
+            return result;
+        }
+        case Type::Quote: {
+            // FIXME(grp): This is (probably) valid, but not necessarily compatible. Algorithm from Python's shlex.quote().
+            if (value.find_first_not_of(alphabet + digits + "@%_-+=:,./") == std::string::npos) {
+                return value;
+            } else {
+                std::string result = value;
+                std::string::size_type offset = 0;
+                while ((offset = result.find("'", offset)) != std::string::npos) {
+                    result.replace(offset, 1, "'\"'\"'");
+                    offset += 5;
+                }
+                return "'" + result + "'";
+            }
+        }
+        case Type::Lower: {
+            std::string result = value;
+            std::transform(result.begin(), result.end(), result.begin(), ::tolower);
+            return result;
+        }
+        case Type::Upper: {
+            std::string result = value;
+            std::transform(result.begin(), result.end(), result.begin(), ::toupper);
+            return result;
+        }
+        case Type::StandardizePath: {
+            return FSUtil::NormalizePath(value);
+        }
+        case Type::Base: {
+            return FSUtil::GetBaseNameWithoutExtension(value);
+        }
+        case Type::Dir: {
+            return FSUtil::GetDirectoryName(value);
+        }
+        case Type::File: {
+            return FSUtil::GetBaseName(value);
+        }
+        case Type::Suffix: {
+            return "." + FSUtil::GetFileExtension(value);
+        }
+        case Type::Unknown: {
+            fprintf(stderr, "warning: unknown build setting operation '%s'\n", _name.c_str());
+            return value;
+        }
+    }
+
+    abort();
+}
+
+Operation Operation::
+Parse(std::string const &name)
+{
+    if (name == "identifier") {
+        return Operation(Type::Identifier, name);
+    } else if (name == "c99extidentifier") {
+        return Operation(Type::C99ExtIdentifier, name);
+    } else if (name == "rfc1034identifier") {
+        return Operation(Type::RFC1034Identifier, name);
+    } else if (name == "quote") {
+        return Operation(Type::Quote, name);
+    } else if (name == "lower") {
+        return Operation(Type::Lower, name);
+    } else if (name == "upper") {
+        return Operation(Type::Upper, name);
+    } else if (name == "standardizepath") {
+        return Operation(Type::StandardizePath, name);
+    } else if (name == "base") {
+        return Operation(Type::Base, name);
+    } else if (name == "dir") {
+        return Operation(Type::Dir, name);
+    } else if (name == "file") {
+        return Operation(Type::File, name);
+    } else if (name == "suffix") {
+        return Operation(Type::Suffix, name);
+    } else {
+        return Operation(Type::Unknown, name);
+    }
+}
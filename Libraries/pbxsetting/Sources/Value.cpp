@@ -18,6 +18,32 @@
 
 using pbxsetting::Value;
 
+Value::Reference::
+Reference(std::string const &name, std::string const &setting, std::vector<Operation> const &operations) :
+    _name      (name),
+    _setting   (setting),
+    _operations(operations)
+{
+}
+
+Value::Reference Value::Reference::
+Parse(std::string const &name)
+{
+    std::string::size_type colon = name.find(':');
+    if (colon == std::string::npos) {
+        return Reference(name, name, { });
+    }
+
+    std::vector<Operation> operations;
+    while (colon != std::string::npos) {
+        std::string::size_type next = name.find(':', colon + 1);
+        operations.push_back(Operation::Parse(name.substr(colon + 1, next == std::string::npos ? next : next - colon - 1)));
+        colon = next;
+    }
+
+    return Reference(name, name.substr(0, name.find(':')), operations);
+}
+
 Value::Entry::
 Entry(std::string const &string) :
     _type  (Type::String),
@@ -30,6 +56,12 @@ Entry(std::shared_ptr<Value> const &value) :
     _type (Type::Value),
     _value(value)
 {
+    /* Parse references with a literal name up front. */
+    if (_value->entries().empty()) {
+        _reference = std::make_shared<Reference const>(Reference::Parse(std::string()));
+    } else if (_value->entries().size() == 1 && _value->entries().front().type() == Type::String) {
+        _reference = std::make_shared<Reference const>(Reference::Parse(*_value->entries().front().string()));
+    }
 }
 
 bool Value::Entry::
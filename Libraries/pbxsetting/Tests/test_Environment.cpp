@@ -179,3 +179,80 @@ TEST(Environment, Default)
     EXPECT_EQ(env.resolve("THREE"), "3");
 }
 
+
+TEST(Environment, Modified)
+{
+    Environment env;
+    env.insertBack(Level({
+        Setting::Parse("ONE", "one"),
+        Setting::Parse("TWO", "$(ONE)-two"),
+    }), false);
+    EXPECT_EQ(env.resolve("TWO"), "one-two");
+
+    /* Copies resolve the same until modified. */
+    Environment copy = Environment(env);
+    EXPECT_EQ(copy.resolve("TWO"), "one-two");
+
+    /* Adding a level changes resolved values, but not for copies. */
+    env.insertFront(Level({
+        Setting::Parse("ONE", "1"),
+    }), false);
+    EXPECT_EQ(env.resolve("TWO"), "1-two");
+    EXPECT_EQ(copy.resolve("TWO"), "one-two");
+
+    copy.insertBack(Level({
+        Setting::Parse("THREE", "3"),
+    }), false);
+    EXPECT_EQ(copy.resolve("THREE"), "3");
+    EXPECT_EQ(env.resolve("THREE"), "");
+}
+
+TEST(Environment, Conditions)
+{
+    pbxsetting::Condition condition = pbxsetting::Condition(std::unordered_map<std::string, std::string>({ { "sdk", "iphoneos10.0" } }));
+    pbxsetting::Condition sdk = pbxsetting::Condition(std::unordered_map<std::string, std::string>({ { "sdk", "iphoneos*" } }));
+
+    Environment env;
+    env.insertBack(Level({
+        Setting::Parse("ONE", "one"),
+        Setting("ONE", sdk, Value::String("ios")),
+        Setting::Parse("TWO", "$(ONE)"),
+    }), false);
+
+    EXPECT_EQ(env.resolve("TWO", condition), "ios");
+    EXPECT_EQ(env.resolve("TWO"), "one");
+    EXPECT_EQ(env.resolve("TWO", condition), "ios");
+}
+
+TEST(Environment, Track)
+{
+    Environment env;
+    env.insertBack(Level({
+        Setting::Parse("ONE", "one"),
+        Setting::Parse("TWO", "$(ONE:upper)"),
+        Setting::Parse("THREE", "$(TWO)-three"),
+        Setting::Parse("FOUR", "four"),
+    }), false);
+
+    /* Cached values still note the settings they were evaluated from. */
+    EXPECT_EQ(env.resolve("THREE"), "ONE-three");
+
+    std::unordered_set<std::string> settings;
+    env.track(&settings);
+    EXPECT_EQ(env.resolve("THREE"), "ONE-three");
+    EXPECT_EQ(settings, std::unordered_set<std::string>({ "THREE", "TWO", "ONE" }));
+
+    /* Copies note settings in the same set. */
+    settings.clear();
+    Environment copy = Environment(env);
+    copy.insertFront(Level({
+        Setting::Parse("FIVE", "$(FOUR)"),
+    }), false);
+    EXPECT_EQ(copy.resolve("FIVE"), "four");
+    EXPECT_EQ(settings, std::unordered_set<std::string>({ "FIVE", "FOUR" }));
+
+    settings.clear();
+    env.track(nullptr);
+    EXPECT_EQ(env.resolve("THREE"), "ONE-three");
+    EXPECT_TRUE(settings.empty());
+}
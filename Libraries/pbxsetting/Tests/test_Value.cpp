@@ -208,3 +208,34 @@ TEST(Value, Add)
     ASSERT_EQ(string_string.entries().at(0).type(), Value::Entry::Type::String);
     EXPECT_EQ(*string_string.entries().at(0).string(), "teststring");
 }
+
+TEST(Value, Reference)
+{
+    Value simple = Value::Parse("$(NAME)");
+    ASSERT_EQ(simple.entries().size(), 1);
+    ASSERT_NE(simple.entries().at(0).reference(), nullptr);
+    EXPECT_EQ(simple.entries().at(0).reference()->name(), "NAME");
+    EXPECT_EQ(simple.entries().at(0).reference()->setting(), "NAME");
+    EXPECT_TRUE(simple.entries().at(0).reference()->operations().empty());
+
+    Value operations = Value::Parse("$(NAME:lower:rfc1034identifier)");
+    ASSERT_EQ(operations.entries().size(), 1);
+    ASSERT_NE(operations.entries().at(0).reference(), nullptr);
+    EXPECT_EQ(operations.entries().at(0).reference()->name(), "NAME:lower:rfc1034identifier");
+    EXPECT_EQ(operations.entries().at(0).reference()->setting(), "NAME");
+    ASSERT_EQ(operations.entries().at(0).reference()->operations().size(), 2);
+    EXPECT_EQ(operations.entries().at(0).reference()->operations().at(0).type(), pbxsetting::Operation::Type::Lower);
+    EXPECT_EQ(operations.entries().at(0).reference()->operations().at(1).type(), pbxsetting::Operation::Type::RFC1034Identifier);
+
+    Value unknown = Value::Parse("$(NAME:unknown)");
+    ASSERT_EQ(unknown.entries().size(), 1);
+    ASSERT_NE(unknown.entries().at(0).reference(), nullptr);
+    ASSERT_EQ(unknown.entries().at(0).reference()->operations().size(), 1);
+    EXPECT_EQ(unknown.entries().at(0).reference()->operations().at(0).type(), pbxsetting::Operation::Type::Unknown);
+    EXPECT_EQ(unknown.entries().at(0).reference()->operations().at(0).name(), "unknown");
+
+    /* Nested references are resolved before parsing. */
+    Value nested = Value::Parse("$(NAME_$(INDEX):upper)");
+    ASSERT_EQ(nested.entries().size(), 1);
+    EXPECT_EQ(nested.entries().at(0).reference(), nullptr);
+}
@@ -0,0 +1,108 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree.
+ */
+
+#include <pbxsetting/DefaultSettings.h>
+#include <pbxsetting/Environment.h>
+#include <pbxsetting/Level.h>
+#include <pbxsetting/Setting.h>
+#include <pbxsetting/Value.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using pbxsetting::Condition;
+using pbxsetting::Environment;
+using pbxsetting::Level;
+using pbxsetting::Setting;
+using pbxsetting::Value;
+
+/*
+ * Creates an environment shaped like a target's: default levels, then many
+ * levels of settings referring to each other, to inherited values, and using
+ * operations and conditions.
+ */
+static Environment
+CreateEnvironment(size_t levels, size_t settings)
+{
+    Environment environment;
+    environment.insertBack(pbxsetting::DefaultSettings::Internal(), true);
+    environment.insertBack(pbxsetting::DefaultSettings::Local(), true);
+    environment.insertBack(pbxsetting::DefaultSettings::System(), true);
+    environment.insertBack(pbxsetting::DefaultSettings::Architecture(), true);
+    environment.insertBack(pbxsetting::DefaultSettings::Build(), true);
+
+    for (size_t l = 0; l < levels; l++) {
+        std::vector<Setting> level;
+        for (size_t s = 0; s < settings; s++) {
+            std::string name = "SETTING_" + std::to_string(s);
+            std::string previous = "SETTING_" + std::to_string(s > 0 ? s - 1 : 0);
+
+            if (s % 4 == 0) {
+                level.push_back(Setting::Create(name, Value::Parse("$(inherited) -level" + std::to_string(l))));
+            } else if (s % 4 == 1) {
+                level.push_back(Setting::Create(name, Value::Parse("$(" + previous + ":identifier)/$(CONFIGURATION)")));
+            } else if (s % 4 == 2) {
+                level.push_back(Setting::Create(name, Value::Parse("$(SETTING_$(CURRENT_INDEX)) $(" + previous + ")")));
+            } else {
+                Condition condition = Condition(std::unordered_map<std::string, std::string>({ { "sdk", "iphoneos*" } }));
+                level.push_back(Setting(name, condition, Value::Parse("$(" + previous + ":lower)")));
+                level.push_back(Setting::Create(name, Value::Parse("$(" + previous + ":upper)")));
+            }
+        }
+
+        level.push_back(Setting::Create("CURRENT_INDEX", std::to_string(l % 4 * 4)));
+        level.push_back(Setting::Create("CONFIGURATION", "Debug"));
+        environment.insertFront(Level(level), false);
+    }
+
+    return environment;
+}
+
+int
+main(int argc, char **argv)
+{
+    size_t levels = (argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 16);
+    size_t settings = (argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 64);
+    size_t iterations = (argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 10);
+
+    Condition condition = Condition(std::unordered_map<std::string, std::string>({ { "sdk", "iphoneos10.0" }, { "arch", "arm64" } }));
+
+    std::string searchPathsString;
+    for (size_t s = 0; s < settings; s++) {
+        searchPathsString += " -I$(SETTING_" + std::to_string(s) + ":standardizepath)/include -I$(CONFIGURATION)/" + std::to_string(s);
+    }
+    Value searchPaths = Value::Parse(searchPathsString);
+
+    auto start = std::chrono::steady_clock::now();
+    size_t total = 0;
+
+    for (size_t i = 0; i < iterations; i++) {
+        /* A new environment each time, as for each target. */
+        Environment environment = CreateEnvironment(levels, settings);
+        for (size_t s = 0; s < settings; s++) {
+            total += environment.resolve("SETTING_" + std::to_string(s), condition).size();
+        }
+        total += environment.computeValues(condition).size();
+
+        /* Expand a long search path list, as for each source file. */
+        for (size_t f = 0; f < settings; f++) {
+            total += environment.expand(searchPaths, condition).size();
+        }
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    double milliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+
+    printf("levels: %zu, settings: %zu, iterations: %zu\n", levels, settings, iterations);
+    printf("total: %.2f ms, per iteration: %.3f ms (checksum %zu)\n", milliseconds, milliseconds / iterations, total);
+    return 0;
+}
@@ -31,6 +31,7 @@
 #include <utility>
 
 namespace libutil { class Filesystem; }
+namespace process { class Context; class User; }
 
 namespace pbxspec {
 
@@ -42,6 +43,11 @@ private:
     std::unordered_set<std::string>                                                _domains;
     std::map<std::string, std::map<SpecificationType, PBX::Specification::vector>> _specifications;
     PBX::BuildRule::vector                                                         _buildRules;
+    std::vector<std::string>                                                       _inputs;
+
+private:
+    libutil::Filesystem                                                           *_cacheFilesystem;
+    std::string                                                                    _cacheDirectory;
 
 public:
     Manager();
@@ -124,6 +130,22 @@ public:
     { return _buildRules; }
     PBX::BuildRule::vector synthesizedBuildRules(std::vector<std::string> const &domains) const;
 
+public:
+    /*
+     * Cache the specifications from each set of domains registered in a
+     * directory. Cached specifications are used instead of finding and
+     * parsing their files again while none of those files have changed.
+     */
+    void setCacheDirectory(libutil::Filesystem *filesystem, std::string const &directory);
+
+public:
+    /*
+     * The files and directories registered specifications and build rules
+     * were read from. Changing any of them can change the specifications.
+     */
+    inline std::vector<std::string> const &inputs() const
+    { return _inputs; }
+
 public:
     void registerDomains(libutil::Filesystem const *filesystem, std::vector<std::pair<std::string, std::string>> const &domains);
     bool registerBuildRules(libutil::Filesystem const *filesystem, std::string const &path);
@@ -159,6 +181,15 @@ public:
 public:
     static std::vector<std::string>
     DeveloperBuildRules(std::string const &developerRoot);
+
+public:
+    /*
+     * The directory to cache specifications in, if any. Set the environment
+     * variable `XCBUILD_CACHE_DIR` to use another directory, or to an empty
+     * value to disable caching.
+     */
+    static ext::optional<std::string>
+    DefaultCacheDirectory(process::User const *user, process::Context const *processContext);
 };
 
 }
@@ -19,6 +19,7 @@
 
 namespace libutil { class Filesystem; }
 namespace plist { class Dictionary; }
+namespace plist { class Object; }
 namespace pbxspec { class Manager; }
 namespace pbxspec { class Context; }
 
@@ -102,6 +103,11 @@ public:
         Context *context,
         std::string const &filename,
         ext::optional<SpecificationType> defaultType = ext::nullopt);
+    static ext::optional<Specification::vector> Load(
+        Context *context,
+        plist::Object const *plist,
+        std::string const &filename,
+        ext::optional<SpecificationType> defaultType = ext::nullopt);
 
 private:
     static Specification::shared_ptr Parse(Context *context, plist::Dictionary const *dict, ext::optional<SpecificationType> defaultType);
@@ -0,0 +1,135 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef __pbxspec_Cache_h
+#define __pbxspec_Cache_h
+
+#include <pbxspec/SpecificationType.h>
+#include <plist/Object.h>
+#include <libutil/Filesystem.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include <ext/optional>
+
+namespace pbxspec {
+
+/*
+ * The specification files read for a set of domains, stored together so
+ * they can be used again without finding, reading, or parsing them. The
+ * cache is only valid while none of the files and directories it was read
+ * from have changed.
+ */
+class Cache {
+public:
+    /*
+     * A specification file's parsed contents.
+     */
+    class File {
+    private:
+        std::string                      _domain;
+        std::string                      _path;
+        ext::optional<SpecificationType> _defaultType;
+        plist::Object const             *_contents;
+
+    public:
+        File(std::string const &domain, std::string const &path, ext::optional<SpecificationType> defaultType, plist::Object const *contents);
+
+    public:
+        std::string const &domain() const
+        { return _domain; }
+        std::string const &path() const
+        { return _path; }
+        ext::optional<SpecificationType> const &defaultType() const
+        { return _defaultType; }
+        plist::Object const *contents() const
+        { return _contents; }
+    };
+
+    /*
+     * A file or directory read into the cache, and its status when it was
+     * read. Entries that didn't exist are included, so creating them will
+     * invalidate the cache.
+     */
+    class Dependency {
+    private:
+        std::string                                   _path;
+        ext::optional<libutil::Filesystem::Status>    _status;
+
+    public:
+        Dependency(std::string const &path, ext::optional<libutil::Filesystem::Status> const &status);
+
+    public:
+        std::string const &path() const
+        { return _path; }
+        ext::optional<libutil::Filesystem::Status> const &status() const
+        { return _status; }
+    };
+
+private:
+    std::vector<std::pair<std::string, std::string>> _domains;
+    std::vector<Dependency>                          _dependencies;
+    std::vector<File>                                _files;
+    std::vector<std::unique_ptr<plist::Object>>      _objects;
+
+public:
+    explicit Cache(std::vector<std::pair<std::string, std::string>> const &domains);
+
+public:
+    /*
+     * The domains the specifications are from, and where they were found.
+     */
+    std::vector<std::pair<std::string, std::string>> const &domains() const
+    { return _domains; }
+
+    /*
+     * The files and directories the cache depends on.
+     */
+    std::vector<Dependency> const &dependencies() const
+    { return _dependencies; }
+
+    /*
+     * The specification files, in the order they were found.
+     */
+    std::vector<File> const &files() const
+    { return _files; }
+
+public:
+    void addDependency(std::string const &path, ext::optional<libutil::Filesystem::Status> const &status);
+    void addFile(std::string const &domain, std::string const &path, ext::optional<SpecificationType> defaultType, std::unique_ptr<plist::Object> contents);
+
+public:
+    /*
+     * Write the cache to a path, replacing any existing cache there.
+     */
+    bool store(libutil::Filesystem *filesystem, std::string const &path) const;
+
+public:
+    /*
+     * Read a cache from a path, if it is for the same domains and nothing
+     * it depends on has changed in the specifications filesystem.
+     */
+    static ext::optional<Cache>
+    Load(
+        libutil::Filesystem const *cacheFilesystem,
+        std::string const &path,
+        libutil::Filesystem const *filesystem,
+        std::vector<std::pair<std::string, std::string>> const &domains);
+
+    /*
+     * The path to cache a set of domains at, in a cache directory.
+     */
+    static std::string
+    Path(std::string const &directory, std::vector<std::pair<std::string, std::string>> const &domains);
+};
+
+}
+
+#endif  // !__pbxspec_Cache_h
@@ -18,6 +18,29 @@ public:
     std::string domain;
 };
 
+/*
+ * Report a problem with a specification. While loading a file, problems are
+ * collected for that file; otherwise, they are printed immediately.
+ */
+void Diagnostic(char const *format, ...);
+
+/*
+ * Collects the problems reported on this thread while it exists, so files
+ * loaded on several threads at once can report their problems in order.
+ */
+class Diagnostics {
+private:
+    std::string *_previous;
+
+public:
+    explicit Diagnostics(std::string *output);
+    ~Diagnostics();
+
+private:
+    Diagnostics(Diagnostics const &) = delete;
+    Diagnostics &operator=(Diagnostics const &) = delete;
+};
+
 }
 
 using pbxspec::Context;
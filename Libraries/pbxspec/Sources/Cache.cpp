@@ -0,0 +1,215 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree.
+ */
+
+#include <pbxspec/Cache.h>
+#include <plist/Array.h>
+#include <plist/Dictionary.h>
+#include <plist/Integer.h>
+#include <plist/String.h>
+#include <plist/Format/Binary.h>
+#include <libutil/PersistentCache.h>
+
+using pbxspec::Cache;
+using pbxspec::SpecificationType;
+using pbxspec::SpecificationTypes;
+using libutil::Filesystem;
+using libutil::PersistentCache;
+
+/*
+ * Increment when the format of the cache changes.
+ */
+static int64_t const CacheVersion = 1;
+
+Cache::File::
+File(std::string const &domain, std::string const &path, ext::optional<SpecificationType> defaultType, plist::Object const *contents) :
+    _domain     (domain),
+    _path       (path),
+    _defaultType(defaultType),
+    _contents   (contents)
+{
+}
+
+Cache::Dependency::
+Dependency(std::string const &path, ext::optional<Filesystem::Status> const &status) :
+    _path  (path),
+    _status(status)
+{
+}
+
+Cache::
+Cache(std::vector<std::pair<std::string, std::string>> const &domains) :
+    _domains(domains)
+{
+}
+
+void Cache::
+addDependency(std::string const &path, ext::optional<Filesystem::Status> const &status)
+{
+    _dependencies.push_back(Dependency(path, status));
+}
+
+void Cache::
+addFile(std::string const &domain, std::string const &path, ext::optional<SpecificationType> defaultType, std::unique_ptr<plist::Object> contents)
+{
+    _files.push_back(File(domain, path, defaultType, contents.get()));
+    _objects.push_back(std::move(contents));
+}
+
+static std::unique_ptr<plist::Array>
+SerializeDomains(std::vector<std::pair<std::string, std::string>> const &domains)
+{
+    auto array = plist::Array::New();
+    for (auto const &domain : domains) {
+        array->append(plist::String::New(domain.first));
+        array->append(plist::String::New(domain.second));
+    }
+    return array;
+}
+
+bool Cache::
+store(Filesystem *filesystem, std::string const &path) const
+{
+    auto dependencies = plist::Array::New();
+    for (Dependency const &dependency : _dependencies) {
+        auto entry = plist::Dictionary::New();
+        entry->set("Path", plist::String::New(dependency.path()));
+        if (dependency.status()) {
+            entry->set("Type", plist::Integer::New(static_cast<int64_t>(dependency.status()->type())));
+            entry->set("Size", plist::Integer::New(static_cast<int64_t>(dependency.status()->size())));
+            entry->set("ModificationTime", plist::Integer::New(dependency.status()->modificationTime()));
+        }
+        dependencies->append(std::move(entry));
+    }
+
+    auto files = plist::Array::New();
+    for (File const &file : _files) {
+        auto entry = plist::Dictionary::New();
+        entry->set("Domain", plist::String::New(file.domain()));
+        entry->set("Path", plist::String::New(file.path()));
+        if (file.defaultType()) {
+            entry->set("DefaultType", plist::String::New(SpecificationTypes::Name(*file.defaultType())));
+        }
+        entry->set("Contents", file.contents()->copy());
+        files->append(std::move(entry));
+    }
+
+    auto root = plist::Dictionary::New();
+    root->set("Version", plist::Integer::New(CacheVersion));
+    root->set("Domains", SerializeDomains(_domains));
+    root->set("Dependencies", std::move(dependencies));
+    root->set("Files", std::move(files));
+
+    auto serialize = plist::Format::Binary::Serialize(root.get(), plist::Format::Binary::Create());
+    if (serialize.first == nullptr) {
+        return false;
+    }
+
+    return PersistentCache::Write(filesystem, *serialize.first, path);
+}
+
+ext::optional<Cache> Cache::
+Load(
+    Filesystem const *cacheFilesystem,
+    std::string const &path,
+    Filesystem const *filesystem,
+    std::vector<std::pair<std::string, std::string>> const &domains)
+{
+    if (!cacheFilesystem->exists(path)) {
+        return ext::nullopt;
+    }
+
+    std::unique_ptr<Filesystem::MappedFile> contents = cacheFilesystem->map(path);
+    if (contents == nullptr) {
+        return ext::nullopt;
+    }
+
+    auto deserialize = plist::Format::Binary::Deserialize(contents->contents(), plist::Format::Binary::Create());
+    auto root = plist::CastTo<plist::Dictionary>(deserialize.first.get());
+    if (root == nullptr) {
+        return ext::nullopt;
+    }
+
+    /*
+     * The domains are checked in case two sets of domains hash the same.
+     */
+    auto version = root->value<plist::Integer>("Version");
+    auto expected = SerializeDomains(domains);
+    if (version == nullptr || version->value() != CacheVersion || root->value("Domains") == nullptr || !root->value("Domains")->equals(expected.get())) {
+        return ext::nullopt;
+    }
+
+    auto dependencies = root->value<plist::Array>("Dependencies");
+    auto files = root->value<plist::Array>("Files");
+    if (dependencies == nullptr || files == nullptr) {
+        return ext::nullopt;
+    }
+
+    Cache cache = Cache(domains);
+
+    /*
+     * Check each dependency before using anything from the cache. This
+     * only reads each entry's status, much less than parsing its contents.
+     */
+    for (size_t n = 0; n < dependencies->count(); n++) {
+        auto entry = dependencies->value<plist::Dictionary>(n);
+        auto path = (entry != nullptr ? entry->value<plist::String>("Path") : nullptr);
+        if (path == nullptr) {
+            return ext::nullopt;
+        }
+
+        ext::optional<Filesystem::Status> status;
+        auto type = entry->value<plist::Integer>("Type");
+        auto size = entry->value<plist::Integer>("Size");
+        auto modificationTime = entry->value<plist::Integer>("ModificationTime");
+        if (type != nullptr && size != nullptr && modificationTime != nullptr) {
+            status = Filesystem::Status(static_cast<Filesystem::Type>(type->value()), static_cast<uint64_t>(size->value()), modificationTime->value());
+        }
+
+        if (!PersistentCache::StatusEqual(status, filesystem->stat(path->value()))) {
+            return ext::nullopt;
+        }
+
+        cache.addDependency(path->value(), status);
+    }
+
+    for (size_t n = 0; n < files->count(); n++) {
+        auto entry = files->value<plist::Dictionary>(n);
+        if (entry == nullptr) {
+            return ext::nullopt;
+        }
+
+        auto domain = entry->value<plist::String>("Domain");
+        auto path = entry->value<plist::String>("Path");
+        auto contents = entry->value("Contents");
+        if (domain == nullptr || path == nullptr || contents == nullptr) {
+            return ext::nullopt;
+        }
+
+        ext::optional<SpecificationType> defaultType;
+        if (auto type = entry->value<plist::String>("DefaultType")) {
+            defaultType = SpecificationTypes::Parse(type->value());
+        }
+
+        /* Files are used in place, in the cache's contents. */
+        cache._files.push_back(File(domain->value(), path->value(), defaultType, contents));
+    }
+
+    cache._objects.push_back(std::move(deserialize.first));
+    return cache;
+}
+
+std::string Cache::
+Path(std::string const &directory, std::vector<std::pair<std::string, std::string>> const &domains)
+{
+    std::string key;
+    for (auto const &domain : domains) {
+        key += domain.first + '\0' + domain.second + '\0';
+    }
+
+    return PersistentCache::Path(directory, key);
+}
@@ -0,0 +1,56 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree.
+ */
+
+#include <pbxspec/Context.h>
+
+#include <cstdarg>
+#include <cstdio>
+
+using pbxspec::Diagnostics;
+
+/*
+ * Where problems reported on this thread are collected, if anywhere.
+ */
+static thread_local std::string *CurrentDiagnostics = nullptr;
+
+void pbxspec::
+Diagnostic(char const *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+
+    if (CurrentDiagnostics == nullptr) {
+        vfprintf(stderr, format, args);
+    } else {
+        va_list sizeArgs;
+        va_copy(sizeArgs, args);
+        int size = vsnprintf(nullptr, 0, format, sizeArgs);
+        va_end(sizeArgs);
+
+        if (size > 0) {
+            std::string buffer = std::string(size + 1, '\0');
+            vsnprintf(&buffer[0], buffer.size(), format, args);
+            CurrentDiagnostics->append(buffer, 0, size);
+        }
+    }
+
+    va_end(args);
+}
+
+Diagnostics::
+Diagnostics(std::string *output) :
+    _previous(CurrentDiagnostics)
+{
+    CurrentDiagnostics = output;
+}
+
+Diagnostics::
+~Diagnostics()
+{
+    CurrentDiagnostics = _previous;
+}
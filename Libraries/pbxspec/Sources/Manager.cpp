@@ -7,6 +7,7 @@
  */
 
 #include <pbxspec/Manager.h>
+#include <pbxspec/Cache.h>
 #include <pbxspec/Context.h>
 #include <plist/Array.h>
 #include <plist/Dictionary.h>
@@ -14,17 +15,25 @@
 #include <plist/Format/Any.h>
 #include <libutil/Filesystem.h>
 #include <libutil/FSUtil.h>
+#include <libutil/PersistentCache.h>
+#include <libutil/ThreadPool.h>
+#include <process/Context.h>
+#include <process/User.h>
 
 using pbxspec::Manager;
+using pbxspec::Cache;
 using pbxspec::Context;
+using pbxspec::Diagnostics;
 using pbxspec::SpecificationType;
 using pbxspec::SpecificationTypes;
 namespace PBX = pbxspec::PBX;
 using libutil::Filesystem;
 using libutil::FSUtil;
+using libutil::ThreadPool;
 
 Manager::
-Manager()
+Manager() :
+    _cacheFilesystem(nullptr)
 {
 }
 
@@ -361,20 +370,51 @@ inheritSpecification(PBX::Specification::shared_ptr const &specification, std::v
 }
 
 void Manager::
-registerDomains(Filesystem const *filesystem, std::vector<std::pair<std::string, std::string>> const &domains)
+setCacheDirectory(Filesystem *filesystem, std::string const &directory)
 {
-    PBX::Specification::vector specifications;
+    _cacheFilesystem = filesystem;
+    _cacheDirectory = directory;
+}
 
-    for (auto const &domain : domains) {
+namespace {
+
+/*
+ * A specification file found in a domain, before it has been read.
+ */
+struct SpecificationFile {
+    std::string                      domain;
+    std::string                      path;
+    ext::optional<SpecificationType> defaultType;
+};
+
+}
+
+static std::unique_ptr<plist::Object>
+ReadSpecificationFile(Filesystem const *filesystem, std::string const &path)
+{
+#if 0
+    fprintf(stderr, "importing specification '%s'\n", path.c_str());
+#endif
+
+    std::unique_ptr<Filesystem::MappedFile> file = filesystem->map(path);
+    if (file == nullptr) {
+        return nullptr;
+    }
+
+    return plist::Format::Any::Deserialize(file->contents()).first;
+}
+
+static void
+ReadDomains(Filesystem const *filesystem, ThreadPool *pool, Cache *cache)
+{
+    std::vector<SpecificationFile> files;
+
+    for (auto const &domain : cache->domains()) {
         /*
-         * Avoid double domain registration. Unncessary and causes warnings.
+         * Depend on the domain path even if it doesn't exist, so creating it
+         * will invalidate the cache.
          */
-        if (_domains.find(domain.first) != _domains.end()) {
-            continue;
-        }
-
-        Context context;
-        context.domain = domain.first;
+        cache->addDependency(domain.second, filesystem->stat(domain.second));
 
         std::string realPath = filesystem->resolvePath(domain.second);
         if (realPath.empty()) {
@@ -391,6 +431,16 @@ registerDomains(Filesystem const *filesystem, std::vector<std::pair<std::string,
                 filesystem->readDirectory(realPath, true, [&](std::string const &filename) -> bool {
                     std::string path = realPath + "/" + filename;
 
+                    /*
+                     * Depend on every directory, since adding or removing a
+                     * specification changes the directory it's in.
+                     */
+                    ext::optional<Filesystem::Status> status = filesystem->stat(path);
+                    if (status && status->type() == Filesystem::Type::Directory) {
+                        cache->addDependency(path, status);
+                        return true;
+                    }
+
                     /* Support both *.xcspec and *.pbfilespec as a few of the latter remain in use. */
                     if (FSUtil::GetFileExtension(path) != "xcspec" && FSUtil::GetFileExtension(path) != "pbfilespec") {
                         return true;
@@ -402,38 +452,106 @@ registerDomains(Filesystem const *filesystem, std::vector<std::pair<std::string,
                         defaultType = SpecificationType::FileType;
                     }
 
-                    if (filesystem->type(path) != Filesystem::Type::Directory) {
-#if 0
-                        fprintf(stderr, "importing specification '%s'\n", path.c_str());
-#endif
-
-                        ext::optional<PBX::Specification::vector> fileSpecifications = PBX::Specification::Open(filesystem, &context, path, defaultType);
-                        if (fileSpecifications) {
-                            specifications.insert(specifications.end(), fileSpecifications->begin(), fileSpecifications->end());
-                        } else {
-                            fprintf(stderr, "warning: failed to import specification '%s'\n", path.c_str());
-                        }
-                    }
+                    cache->addDependency(path, status);
+                    files.push_back({ domain.first, path, defaultType });
                     return true;
                 });
                 break;
             }
             case Filesystem::Type::SymbolicLink:
             case Filesystem::Type::File: {
-#if 0
-                fprintf(stderr, "importing specification '%s'\n", realPath.c_str());
-#endif
-                ext::optional<PBX::Specification::vector> fileSpecifications = PBX::Specification::Open(filesystem, &context, realPath);
-                if (fileSpecifications) {
-                    specifications.insert(specifications.end(), fileSpecifications->begin(), fileSpecifications->end());
-                } else {
-                    fprintf(stderr, "warning: failed to import specification '%s'\n", realPath.c_str());
-                }
+                files.push_back({ domain.first, realPath, ext::nullopt });
                 break;
             }
         }
     }
 
+    /*
+     * Read the files in parallel, then add them in the order they were
+     * found, so the result is the same as reading them one at a time.
+     */
+    std::vector<std::unique_ptr<plist::Object>> contents = std::vector<std::unique_ptr<plist::Object>>(files.size());
+    pool->apply(files.size(), [&](size_t n) {
+        contents[n] = ReadSpecificationFile(filesystem, files[n].path);
+    });
+
+    for (size_t n = 0; n < files.size(); n++) {
+        if (contents[n] == nullptr) {
+            fprintf(stderr, "warning: failed to import specification '%s'\n", files[n].path.c_str());
+            continue;
+        }
+
+        cache->addFile(files[n].domain, files[n].path, files[n].defaultType, std::move(contents[n]));
+    }
+}
+
+void Manager::
+registerDomains(Filesystem const *filesystem, std::vector<std::pair<std::string, std::string>> const &domains)
+{
+    /*
+     * Avoid double domain registration. Unncessary and causes warnings.
+     */
+    std::vector<std::pair<std::string, std::string>> registering;
+    for (auto const &domain : domains) {
+        if (_domains.find(domain.first) == _domains.end()) {
+            registering.push_back(domain);
+        }
+    }
+
+    /*
+     * Find and read the specification files, unless they are all cached.
+     */
+    ThreadPool pool(ThreadPool::DefaultThreadCount());
+
+    ext::optional<Cache> cache;
+    std::string cachePath;
+    if (_cacheFilesystem != nullptr && !registering.empty()) {
+        cachePath = Cache::Path(_cacheDirectory, registering);
+        cache = Cache::Load(_cacheFilesystem, cachePath, filesystem, registering);
+    }
+
+    if (!cache) {
+        cache = Cache(registering);
+        ReadDomains(filesystem, &pool, &*cache);
+
+        if (_cacheFilesystem != nullptr && !registering.empty()) {
+            if (!cache->store(_cacheFilesystem, cachePath)) {
+                fprintf(stderr, "warning: failed to write specification cache '%s'\n", cachePath.c_str());
+            }
+        }
+    }
+
+    for (Cache::Dependency const &dependency : cache->dependencies()) {
+        _inputs.push_back(dependency.path());
+    }
+
+    /*
+     * Parse each file's specifications in parallel. They are collected in
+     * file order, so registration and inheritance below are deterministic,
+     * as are the problems reported while parsing them.
+     */
+    std::vector<Cache::File> const &files = cache->files();
+    std::vector<ext::optional<PBX::Specification::vector>> fileSpecifications = std::vector<ext::optional<PBX::Specification::vector>>(files.size());
+    std::vector<std::string> fileDiagnostics = std::vector<std::string>(files.size());
+    pool.apply(files.size(), [&](size_t n) {
+        Context context;
+        context.domain = files[n].domain();
+
+        Diagnostics diagnostics(&fileDiagnostics[n]);
+        fileSpecifications[n] = PBX::Specification::Load(&context, files[n].contents(), files[n].path(), files[n].defaultType());
+    });
+
+    PBX::Specification::vector specifications;
+    for (size_t n = 0; n < files.size(); n++) {
+        fputs(fileDiagnostics[n].c_str(), stderr);
+
+        if (fileSpecifications[n]) {
+            specifications.insert(specifications.end(), fileSpecifications[n]->begin(), fileSpecifications[n]->end());
+        } else {
+            fprintf(stderr, "warning: failed to import specification '%s'\n", files[n].path().c_str());
+        }
+    }
+
     /*
      * Mark all of the domains regsitered. This is after all of the inputs so the
      * same domain can be registered multiple times (loaded from multiple paths)
@@ -466,12 +584,14 @@ registerDomains(Filesystem const *filesystem, std::vector<std::pair<std::string,
 bool Manager::
 registerBuildRules(Filesystem const *filesystem, std::string const &path)
 {
-    std::vector<uint8_t> contents;
-    if (!filesystem->read(&contents, path)) {
+    _inputs.push_back(path);
+
+    std::unique_ptr<Filesystem::MappedFile> contents = filesystem->map(path);
+    if (contents == nullptr) {
         return false;
     }
 
-    std::unique_ptr<plist::Object> plist = plist::Format::Any::Deserialize(contents).first;
+    std::unique_ptr<plist::Object> plist = plist::Format::Any::Deserialize(contents->contents()).first;
     if (plist == nullptr) {
         return false;
     }
@@ -577,6 +697,12 @@ PlatformDependentDomains(std::string const &developerRoot)
     return domains;
 }
 
+ext::optional<std::string> Manager::
+DefaultCacheDirectory(process::User const *user, process::Context const *processContext)
+{
+    return libutil::PersistentCache::Directory(processContext->environmentVariable("XCBUILD_CACHE_DIR"), user->userCacheDirectory(processContext), "Specifications");
+}
+
 std::vector<std::string> Manager::
 DeveloperBuildRules(std::string const &developerRoot)
 {
@@ -50,7 +50,7 @@ parse(Context *context, plist::Dictionary const *dict, std::unordered_set<std::s
     auto unpack = plist::Keys::Unpack("BuildPhase", dict, seen);
 
     if (!unpack.complete(check)) {
-        fprintf(stderr, "%s", unpack.errorText().c_str());
+        pbxspec::Diagnostic("%s", unpack.errorText().c_str());
     }
 
     return true;
@@ -7,6 +7,7 @@
  */
 
 #include <pbxspec/PBX/BuildPhaseInjection.h>
+#include <pbxspec/Context.h>
 #include <plist/Boolean.h>
 #include <plist/Dictionary.h>
 #include <plist/Integer.h>
@@ -34,7 +35,7 @@ parse(plist::Dictionary const *dict)
     auto DP     = unpack.cast <plist::String> ("DstPath");
 
     if (!unpack.complete(true)) {
-        fprintf(stderr, "%s", unpack.errorText().c_str());
+        pbxspec::Diagnostic("%s", unpack.errorText().c_str());
     }
 
     if (BP != nullptr) {
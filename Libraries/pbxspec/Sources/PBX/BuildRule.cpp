@@ -37,7 +37,7 @@ parse(plist::Dictionary const *dict)
     auto CS = unpack.cast <plist::String> ("CompilerSpec");
 
     if (!unpack.complete(true)) {
-        fprintf(stderr, "%s", unpack.errorText().c_str());
+        pbxspec::Diagnostic("%s", unpack.errorText().c_str());
     }
 
     if (N != nullptr) {
@@ -78,7 +78,7 @@ parse(Context *context, plist::Dictionary const *dict, std::unordered_set<std::s
     auto DPs = unpack.cast <plist::Array> ("DeletedProperties");
 
     if (!unpack.complete(check)) {
-        fprintf(stderr, "%s", unpack.errorText().c_str());
+        pbxspec::Diagnostic("%s", unpack.errorText().c_str());
     }
 
     if (Os != nullptr) {
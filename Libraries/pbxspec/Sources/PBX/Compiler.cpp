@@ -166,7 +166,7 @@ parse(Context *context, plist::Dictionary const *dict, std::unordered_set<std::s
     auto IIUTD    = unpack.coerce <plist::Boolean> ("IncludeInUnionedToolDefaults");
 
     if (!unpack.complete(check)) {
-        fprintf(stderr, "%s", unpack.errorText().c_str());
+        pbxspec::Diagnostic("%s", unpack.errorText().c_str());
     }
 
     if (ECPPLP != nullptr) {
@@ -172,7 +172,7 @@ parse(Context *context, plist::Dictionary const *dict, std::unordered_set<std::s
     auto VOC   = unpack.coerce <plist::Boolean> ("ValidateOnCopy");
 
     if (!unpack.complete(check)) {
-        fprintf(stderr, "%s", unpack.errorText().c_str());
+        pbxspec::Diagnostic("%s", unpack.errorText().c_str());
     }
 
     if (U != nullptr) {
@@ -91,7 +91,7 @@ parse(Context *context, plist::Dictionary const *dict, std::unordered_set<std::s
     auto SIFL = unpack.coerce <plist::Boolean> ("SupportsInputFileList");
 
     if (!unpack.complete(check)) {
-        fprintf(stderr, "%s", unpack.errorText().c_str());
+        pbxspec::Diagnostic("%s", unpack.errorText().c_str());
     }
 
     if (BFs != nullptr) {
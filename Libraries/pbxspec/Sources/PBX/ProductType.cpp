@@ -87,7 +87,7 @@ parse(Context *context, plist::Dictionary const *dict, std::unordered_set<std::s
     auto IPAs   = unpack.cast <plist::Dictionary> ("InfoPlistAdditions");
 
     if (!unpack.complete(check)) {
-        fprintf(stderr, "%s", unpack.errorText().c_str());
+        pbxspec::Diagnostic("%s", unpack.errorText().c_str());
     }
 
     if (DTN != nullptr) {
@@ -341,7 +341,7 @@ parse(plist::Dictionary const *dict)
     auto Cs  = unpack.cast <plist::Dictionary> ("Checks");
 
     if (!unpack.complete(true)) {
-        fprintf(stderr, "%s", unpack.errorText().c_str());
+        pbxspec::Diagnostic("%s", unpack.errorText().c_str());
     }
 
     if (VTS != nullptr) {
@@ -383,7 +383,7 @@ parse(plist::Dictionary const *dict)
     auto P   = unpack.cast <plist::String> ("Path");
 
     if (!unpack.complete(true)) {
-        fprintf(stderr, "%s", unpack.errorText().c_str());
+        pbxspec::Diagnostic("%s", unpack.errorText().c_str());
     }
 
     if (RVN != nullptr) {
@@ -7,6 +7,7 @@
  */
 
 #include <pbxspec/PBX/PropertyOption.h>
+#include <pbxspec/Context.h>
 #include <pbxsetting/Setting.h>
 #include <plist/Array.h>
 #include <plist/Boolean.h>
@@ -102,7 +103,7 @@ parse(plist::Dictionary const *dict)
     auto As     = unpack.cast <plist::Array> ("Architectures");
 
     if (!unpack.complete(true)) {
-        fprintf(stderr, "%s", unpack.errorText().c_str());
+        pbxspec::Diagnostic("%s", unpack.errorText().c_str());
     }
 
     if (N != nullptr) {
@@ -82,7 +82,7 @@ parse(Context *context, plist::Dictionary const *dict, std::unordered_set<std::s
     auto V2 = unpack.cast <plist::String> ("Version");
 
     if (!unpack.complete(check)) {
-        fprintf(stderr, "%s", unpack.errorText().c_str());
+        pbxspec::Diagnostic("%s", unpack.errorText().c_str());
     }
 
     if (T != nullptr) {
@@ -159,13 +159,13 @@ Parse(Context *context, plist::Dictionary const *dict, ext::optional<Specificati
     if (auto T = dict->value<plist::String>("Type")) {
         type = SpecificationTypes::Parse(T->value());
         if (!type) {
-            fprintf(stderr, "error: specification type '%s' not supported\n", T->value().c_str());
+            pbxspec::Diagnostic("error: specification type '%s' not supported\n", T->value().c_str());
             return nullptr;
         }
     } else {
         type = defaultType;
         if (!type) {
-            fprintf(stderr, "error: no specification type\n");
+            pbxspec::Diagnostic("error: no specification type\n");
             return nullptr;
         }
     }
@@ -202,43 +202,49 @@ ext::optional<Specification::vector> Specification::
 Open(Filesystem const *filesystem, Context *context, std::string const &filename, ext::optional<SpecificationType> defaultType)
 {
     if (filename.empty()) {
-        fprintf(stderr, "error: empty specification path\n");
+        pbxspec::Diagnostic("error: empty specification path\n");
         return ext::nullopt;
     }
 
     std::string realPath = filesystem->resolvePath(filename);
     if (realPath.empty()) {
-        fprintf(stderr, "error: invalid specification path\n");
+        pbxspec::Diagnostic("error: invalid specification path\n");
         return ext::nullopt;
     }
 
-    std::vector<uint8_t> contents;
-    if (!filesystem->read(&contents, realPath)) {
-        fprintf(stderr, "error: unable to read specification plist\n");
+    std::unique_ptr<Filesystem::MappedFile> contents = filesystem->map(realPath);
+    if (contents == nullptr) {
+        pbxspec::Diagnostic("error: unable to read specification plist\n");
         return ext::nullopt;
     }
 
     //
     // Parse property list
     //
-    std::unique_ptr<plist::Object> plist = plist::Format::Any::Deserialize(contents).first;
+    std::unique_ptr<plist::Object> plist = plist::Format::Any::Deserialize(contents->contents()).first;
     if (plist == nullptr) {
-        fprintf(stderr, "error: unable to parse specification plist\n");
+        pbxspec::Diagnostic("error: unable to parse specification plist\n");
         return ext::nullopt;
     }
 
+    return Load(context, plist.get(), filename, defaultType);
+}
+
+ext::optional<Specification::vector> Specification::
+Load(Context *context, plist::Object const *plist, std::string const &filename, ext::optional<SpecificationType> defaultType)
+{
     //
     // If this is a dictionary, then it's a single specification,
     // if it's an array then multiple specifications are present.
     //
-    if (auto dict = plist::CastTo <plist::Dictionary> (plist.get())) {
+    if (auto dict = plist::CastTo <plist::Dictionary> (plist)) {
         if (auto spec = Parse(context, dict, defaultType)) {
             return Specification::vector({ spec });
         } else {
-            fprintf(stderr, "error: single specification failed to parse\n");
+            pbxspec::Diagnostic("error: single specification failed to parse\n");
             return ext::nullopt;
         }
-    } else if (auto array = plist::CastTo <plist::Array> (plist.get())) {
+    } else if (auto array = plist::CastTo <plist::Array> (plist)) {
         size_t errors = 0;
         Specification::vector specifications;
 
@@ -247,11 +253,11 @@ Open(Filesystem const *filesystem, Context *context, std::string const &filename
                 if (auto spec = Parse(context, dict, defaultType)) {
                     specifications.push_back(spec);
                 } else {
-                    fprintf(stderr, "error: specification failed to parse\n");
+                    pbxspec::Diagnostic("error: specification failed to parse\n");
                     errors++;
                 }
             } else {
-                fprintf(stderr, "error: specification entry was not a dictionary\n");
+                pbxspec::Diagnostic("error: specification entry was not a dictionary\n");
                 errors++;
             }
         }
@@ -259,12 +265,12 @@ Open(Filesystem const *filesystem, Context *context, std::string const &filename
         if (errors == 0 || array->count() == 0) {
             return specifications;
         } else {
-            fprintf(stderr, "error: specification failed to parse, errors %zu\n", errors);
+            pbxspec::Diagnostic("error: specification failed to parse, errors %zu\n", errors);
             return ext::nullopt;
         }
     }
 
-    fprintf(stderr, "error: specification file '%s' does not contain a dictionary nor an array", filename.c_str());
+    pbxspec::Diagnostic("error: specification file '%s' does not contain a dictionary nor an array", filename.c_str());
     return ext::nullopt;
 }
 
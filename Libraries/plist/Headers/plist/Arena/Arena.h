@@ -0,0 +1,91 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef __plist_Arena_Arena_h
+#define __plist_Arena_Arena_h
+
+#include <plist/Base.h>
+
+#include <memory>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace plist {
+namespace Arena {
+
+class String;
+
+/*
+ * Storage for read-only property lists. Objects deserialized into an arena
+ * are allocated from large blocks, and strings are interned so that equal
+ * keys and values are stored once. Nothing is freed individually: all of
+ * the objects are freed together when the arena is destroyed.
+ */
+class Arena {
+private:
+    std::vector<std::unique_ptr<uint8_t[]>> _blocks;
+    uint8_t                                *_next;
+    size_t                                  _remaining;
+    size_t                                  _size;
+
+private:
+    std::vector<String const *>             _strings;
+    size_t                                  _stringsCount;
+
+public:
+    Arena();
+    ~Arena();
+
+    Arena(Arena const &) = delete;
+    Arena &operator=(Arena const &) = delete;
+
+public:
+    /*
+     * The total number of bytes allocated from the arena.
+     */
+    inline size_t size() const
+    { return _size; }
+
+public:
+    /*
+     * Allocate uninitialized memory. It lives as long as the arena.
+     */
+    void *allocate(size_t size, size_t alignment);
+
+    /*
+     * Construct an object in the arena. The object is never destroyed, so
+     * it must not own anything outside of the arena.
+     */
+    template<typename T, typename... Args>
+    T *create(Args &&... args)
+    {
+        static_assert(std::is_trivially_destructible<T>::value, "arena objects are never destroyed");
+        return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+public:
+    /*
+     * Get the string with the given contents. Equal contents always
+     * return the same string.
+     */
+    String const *string(char const *value, size_t size);
+
+    inline String const *string(std::string const &value)
+    { return string(value.data(), value.size()); }
+
+private:
+    void rehash(size_t capacity);
+};
+
+}
+}
+
+#endif  // !__plist_Arena_Arena_h
@@ -0,0 +1,380 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef __plist_Arena_Objects_h
+#define __plist_Arena_Objects_h
+
+#include <plist/Base.h>
+#include <plist/Object.h>
+#include <plist/ObjectType.h>
+
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace plist {
+namespace Arena {
+
+class Arena;
+
+/*
+ * A read-only property list object allocated in an arena. The types mirror
+ * the mutable objects in plist, but are laid out as plain data: they are
+ * never destroyed, and stay valid for as long as their arena.
+ */
+class Object {
+private:
+    ObjectType _type;
+
+protected:
+    explicit Object(ObjectType type) :
+        _type(type)
+    {
+    }
+
+public:
+    inline ObjectType type() const
+    { return _type; }
+
+public:
+    /*
+     * Copy into a mutable object that is independent of the arena.
+     */
+    std::unique_ptr<plist::Object> copy() const;
+
+public:
+    static inline ObjectType Type()
+    {
+        return ObjectType::None;
+    }
+};
+
+template <typename T>
+static inline T const *CastTo(Object const *obj)
+{
+    return (obj != nullptr && (obj->type() == T::Type() || T::Type() == ObjectType())) ? static_cast <T const *> (obj) : nullptr;
+}
+
+class String : public Object {
+private:
+    char const *_value;
+    size_t      _size;
+    size_t      _hash;
+
+public:
+    String(char const *value, size_t size, size_t hash) :
+        Object(Type()),
+        _value(value),
+        _size (size),
+        _hash (hash)
+    {
+    }
+
+public:
+    /*
+     * The contents are always followed by a terminating null.
+     */
+    inline char const *c_str() const
+    { return _value; }
+    inline size_t size() const
+    { return _size; }
+    inline size_t hash() const
+    { return _hash; }
+
+    inline std::string value() const
+    { return std::string(_value, _size); }
+
+public:
+    inline bool equals(char const *value, size_t size) const
+    { return (_size == size && std::memcmp(_value, value, size) == 0); }
+    inline bool equals(std::string const &value) const
+    { return equals(value.data(), value.size()); }
+
+public:
+    static size_t Hash(char const *value, size_t size);
+
+public:
+    static inline ObjectType Type()
+    {
+        return ObjectType::String;
+    }
+};
+
+class Integer : public Object {
+private:
+    int64_t _value;
+
+public:
+    explicit Integer(int64_t value) :
+        Object(Type()),
+        _value(value)
+    {
+    }
+
+public:
+    inline int64_t value() const
+    { return _value; }
+
+public:
+    static inline ObjectType Type()
+    {
+        return ObjectType::Integer;
+    }
+};
+
+class Real : public Object {
+private:
+    double _value;
+
+public:
+    explicit Real(double value) :
+        Object(Type()),
+        _value(value)
+    {
+    }
+
+public:
+    inline double value() const
+    { return _value; }
+
+public:
+    static inline ObjectType Type()
+    {
+        return ObjectType::Real;
+    }
+};
+
+class Boolean : public Object {
+private:
+    bool _value;
+
+public:
+    explicit Boolean(bool value) :
+        Object(Type()),
+        _value(value)
+    {
+    }
+
+public:
+    inline bool value() const
+    { return _value; }
+
+public:
+    static inline ObjectType Type()
+    {
+        return ObjectType::Boolean;
+    }
+};
+
+class Null : public Object {
+public:
+    Null() :
+        Object(Type())
+    {
+    }
+
+public:
+    static inline ObjectType Type()
+    {
+        return ObjectType::Null;
+    }
+};
+
+class Data : public Object {
+private:
+    uint8_t const *_value;
+    size_t         _size;
+
+public:
+    Data(uint8_t const *value, size_t size) :
+        Object(Type()),
+        _value(value),
+        _size (size)
+    {
+    }
+
+public:
+    inline uint8_t const *data() const
+    { return _value; }
+    inline size_t size() const
+    { return _size; }
+
+    inline std::vector<uint8_t> value() const
+    { return std::vector<uint8_t>(_value, _value + _size); }
+
+public:
+    static inline ObjectType Type()
+    {
+        return ObjectType::Data;
+    }
+};
+
+class Date : public Object {
+private:
+    struct tm _value;
+
+public:
+    explicit Date(struct tm const &value) :
+        Object(Type()),
+        _value(value)
+    {
+    }
+
+public:
+    inline struct tm const &value() const
+    { return _value; }
+
+public:
+    static inline ObjectType Type()
+    {
+        return ObjectType::Date;
+    }
+};
+
+class UID : public Object {
+private:
+    uint32_t _value;
+
+public:
+    explicit UID(uint32_t value) :
+        Object(Type()),
+        _value(value)
+    {
+    }
+
+public:
+    inline uint32_t value() const
+    { return _value; }
+
+public:
+    static inline ObjectType Type()
+    {
+        return ObjectType::UID;
+    }
+};
+
+class Array : public Object {
+private:
+    Object const * const *_values;
+    size_t                _count;
+
+public:
+    Array(Object const * const *values, size_t count) :
+        Object(Type()),
+        _values(values),
+        _count (count)
+    {
+    }
+
+public:
+    /*
+     * Create an array in the arena, copying the values.
+     */
+    static Array const *New(Arena *arena, Object const * const *values, size_t count);
+
+public:
+    inline bool empty() const
+    { return _count == 0; }
+    inline size_t count() const
+    { return _count; }
+
+    inline Object const *value(size_t index) const
+    { return (index < _count) ? _values[index] : nullptr; }
+
+    template <typename T>
+    inline T const *value(size_t index) const
+    { return CastTo <T> (value(index)); }
+
+public:
+    inline Object const * const *begin() const
+    { return _values; }
+    inline Object const * const *end() const
+    { return _values + _count; }
+
+public:
+    static inline ObjectType Type()
+    {
+        return ObjectType::Array;
+    }
+};
+
+class Dictionary : public Object {
+public:
+    struct Entry {
+        String const *key;
+        Object const *value;
+    };
+
+private:
+    Entry const    *_entries;
+    size_t          _count;
+    uint32_t const *_index;
+    size_t          _indexSize;
+
+public:
+    Dictionary(Entry const *entries, size_t count, uint32_t const *index, size_t indexSize) :
+        Object    (Type()),
+        _entries  (entries),
+        _count    (count),
+        _index    (index),
+        _indexSize(indexSize)
+    {
+    }
+
+public:
+    /*
+     * Create a dictionary in the arena, copying the entries. As when
+     * setting a key on a mutable dictionary, a later entry replaces an
+     * earlier one with the same key.
+     */
+    static Dictionary const *New(Arena *arena, Entry const *entries, size_t count);
+
+public:
+    inline bool empty() const
+    { return _count == 0; }
+    inline size_t count() const
+    { return _count; }
+
+    inline String const *key(size_t index) const
+    { return (index < _count) ? _entries[index].key : nullptr; }
+
+    inline Object const *value(size_t index) const
+    { return (index < _count) ? _entries[index].value : nullptr; }
+
+    template <typename T>
+    inline T const *value(size_t index) const
+    { return CastTo <T> (value(index)); }
+
+    Object const *value(char const *key, size_t size) const;
+
+    inline Object const *value(std::string const &key) const
+    { return value(key.data(), key.size()); }
+
+    template <typename T>
+    inline T const *value(std::string const &key) const
+    { return CastTo <T> (value(key)); }
+
+public:
+    inline Entry const *begin() const
+    { return _entries; }
+    inline Entry const *end() const
+    { return _entries + _count; }
+
+public:
+    static inline ObjectType Type()
+    {
+        return ObjectType::Dictionary;
+    }
+};
+
+}
+}
+
+#endif  // !__plist_Arena_Objects_h
@@ -0,0 +1,139 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef __plist_Format_BinaryView_h
+#define __plist_Format_BinaryView_h
+
+#include <plist/Base.h>
+#include <plist/Object.h>
+
+#include <ext/span>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class ABPReader;
+
+namespace plist {
+namespace Format {
+
+/*
+ * Reads a binary property list in place, such as from a mapped file, and
+ * only reads the objects that are accessed. Looking up one key in a large
+ * dictionary does not read the rest of the dictionary's values, or any
+ * other part of the contents.
+ *
+ * The contents must outlive the view. Views cache what they read, so a
+ * view can't be used from more than one thread at a time.
+ */
+class BinaryView {
+public:
+    /*
+     * An object in the view. Objects are cheap to copy, and are only valid
+     * as long as their view. Corrupted contents produce invalid objects.
+     */
+    class Object {
+    private:
+        BinaryView const *_view;
+        uint64_t          _reference;
+        ObjectType        _type;
+
+    public:
+        Object();
+
+    private:
+        friend class BinaryView;
+        Object(BinaryView const *view, uint64_t reference, ObjectType type);
+
+    public:
+        bool valid() const
+        { return _view != nullptr; }
+        ObjectType type() const
+        { return _type; }
+
+    public:
+        /*
+         * Containers. The count of an array or dictionary, an array's value
+         * at an index, or a dictionary's key and value at an index. Keys are
+         * found without reading the values of any other keys.
+         */
+        size_t count() const;
+        Object value(size_t index) const;
+        std::string key(size_t index) const;
+        Object value(std::string const &key) const;
+
+    public:
+        /*
+         * Values. If the object is a different type, these are empty.
+         */
+        std::string string() const;
+        int64_t integer() const;
+        double real() const;
+        bool boolean() const;
+        std::vector<uint8_t> data() const;
+        struct tm date() const;
+        uint32_t uid() const;
+
+    public:
+        /*
+         * Read the object, including everything it contains.
+         */
+        std::unique_ptr<plist::Object> copy() const;
+    };
+
+private:
+    struct IndexEntry {
+        size_t hash;
+        size_t index;
+    };
+
+private:
+    std::unique_ptr<ABPReader> _reader;
+    Object                     _root;
+
+private:
+    mutable std::unordered_map<uint64_t, std::vector<IndexEntry>> _indexes;
+
+private:
+    explicit BinaryView(ext::span<uint8_t const> contents);
+
+public:
+    ~BinaryView();
+
+public:
+    /*
+     * The top level object.
+     */
+    Object const &root() const
+    { return _root; }
+
+    /*
+     * The last error reading the contents, if any.
+     */
+    std::string const &error() const;
+
+private:
+    Object object(uint64_t reference) const;
+    bool find(uint64_t reference, size_t count, std::string const &key, size_t *index) const;
+
+public:
+    /*
+     * Open a view on binary property list contents. Only the header and
+     * trailer are read here.
+     */
+    static std::pair<std::unique_ptr<BinaryView>, std::string>
+    Open(ext::span<uint8_t const> contents);
+};
+
+}
+}
+
+#endif  // !__plist_Format_BinaryView_h
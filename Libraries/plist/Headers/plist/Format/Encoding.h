@@ -11,6 +11,7 @@
 
 #include <plist/Base.h>
 
+#include <ext/span>
 #include <vector>
 
 namespace plist {
@@ -31,11 +32,18 @@ private:
 
 public:
     static Encoding
-    Detect(std::vector<uint8_t> const &contents);
+    Detect(ext::span<uint8_t const> contents);
 
 public:
     static std::vector<uint8_t>
-    Convert(std::vector<uint8_t> const &contents, Encoding from, Encoding to);
+    Convert(ext::span<uint8_t const> contents, Encoding from, Encoding to);
+
+    /*
+     * The contents without a leading byte order mark for the encoding. This
+     * does not copy, so contents already in the right encoding can be used as is.
+     */
+    static ext::span<uint8_t const>
+    RemoveBOM(ext::span<uint8_t const> contents, Encoding encoding);
 
 public:
     static std::vector<uint8_t>
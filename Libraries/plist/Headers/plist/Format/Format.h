@@ -11,7 +11,11 @@
 
 #include <plist/Base.h>
 #include <plist/Object.h>
+#include <plist/Arena/Arena.h>
+#include <plist/Arena/Objects.h>
+#include <plist/Format/Visitor.h>
 
+#include <ext/span>
 #include <vector>
 
 namespace plist {
@@ -25,14 +29,18 @@ protected:
 
 public:
     static std::unique_ptr<T>
-    Identify(std::vector<uint8_t> const &contents);
+    Identify(ext::span<uint8_t const> contents);
 
 public:
+    /*
+     * Deserialize contents in place. The contents can be in any memory, such
+     * as a mapped file; they are not copied unless they must be converted.
+     */
     static std::pair<std::unique_ptr<Object>, std::string>
-    Deserialize(std::vector<uint8_t> const &contents, T const &format);
+    Deserialize(ext::span<uint8_t const> contents, T const &format);
 
     static std::pair<std::unique_ptr<Object>, std::string>
-    Deserialize(std::vector<uint8_t> const &contents)
+    Deserialize(ext::span<uint8_t const> contents)
     {
         std::unique_ptr<T> format = Identify(contents);
         if (format == nullptr) {
@@ -42,6 +50,45 @@ public:
         return Deserialize(contents, *format);
     }
 
+public:
+    /*
+     * Deserialize contents into an arena. The result is read-only, and is
+     * valid for as long as the arena is; nothing needs to be freed.
+     */
+    static std::pair<Arena::Object const *, std::string>
+    Deserialize(ext::span<uint8_t const> contents, T const &format, Arena::Arena *arena);
+
+    static std::pair<Arena::Object const *, std::string>
+    Deserialize(ext::span<uint8_t const> contents, Arena::Arena *arena)
+    {
+        std::unique_ptr<T> format = Identify(contents);
+        if (format == nullptr) {
+            return std::make_pair(nullptr, "couldn't identify format");
+        }
+
+        return Deserialize(contents, *format, arena);
+    }
+
+public:
+    /*
+     * Read contents without creating objects, sending what is read to a
+     * visitor as it is read. Returns false and an error if the contents are
+     * invalid; the visitor may have seen some of the contents by then.
+     */
+    static std::pair<bool, std::string>
+    Visit(ext::span<uint8_t const> contents, T const &format, Visitor *visitor);
+
+    static std::pair<bool, std::string>
+    Visit(ext::span<uint8_t const> contents, Visitor *visitor)
+    {
+        std::unique_ptr<T> format = Identify(contents);
+        if (format == nullptr) {
+            return std::make_pair(false, "couldn't identify format");
+        }
+
+        return Visit(contents, *format, visitor);
+    }
+
 public:
     static std::pair<std::unique_ptr<std::vector<uint8_t>>, std::string>
     Serialize(Object const *object, T const &format);
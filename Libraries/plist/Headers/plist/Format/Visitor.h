@@ -0,0 +1,65 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef __plist_Format_Visitor_h
+#define __plist_Format_Visitor_h
+
+#include <plist/Base.h>
+
+#include <ctime>
+#include <string>
+#include <vector>
+
+namespace plist {
+namespace Format {
+
+/*
+ * Receives the contents of a property list as they are read, in document
+ * order, without any objects being created. By default, everything is
+ * ignored; override what is needed.
+ */
+class Visitor {
+public:
+    Visitor();
+    virtual ~Visitor();
+
+public:
+    /*
+     * Containers. Return false from a begin to skip the container: its
+     * contents and its end are not visited. Text formats still check the
+     * skipped contents for errors; binary contents are not read at all.
+     */
+    virtual bool beginArray();
+    virtual void endArray();
+    virtual bool beginDictionary();
+    virtual void endDictionary();
+
+    /*
+     * Each value in a dictionary follows its key. Return false to skip the
+     * value, including everything in it if it is a container.
+     */
+    virtual bool key(std::string const &key);
+
+public:
+    /*
+     * Values. A value outside of any container is the root.
+     */
+    virtual void string(std::string const &value);
+    virtual void integer(int64_t value);
+    virtual void real(double value);
+    virtual void boolean(bool value);
+    virtual void null();
+    virtual void data(std::vector<uint8_t> const &value);
+    virtual void date(struct tm const &value);
+    virtual void uid(uint32_t value);
+};
+
+}
+}
+
+#endif  // !__plist_Format_Visitor_h
@@ -10,27 +10,46 @@
 #define __plist_Format_ABPReader_h
 
 #include <plist/Format/ABPContext.h>
-#include <plist/Objects.h>
+#include <plist/Format/Builder.h>
 
+#include <ext/span>
 #include <string>
-#include <unordered_set>
+#include <vector>
 
 class ABPReader : public ABPContext {
-public:
-    plist::Object                       **_objects;
-    std::unordered_set<plist::Object *>   _seen;
+private:
+    ext::span<uint8_t const>              _contents;
+    off_t                                 _offsetTable;
+
+private:
+    std::vector<uint64_t>                 _reading;
     std::string                           _error;
 
 public:
-    ABPReader(std::vector<uint8_t> const *contents);
+    ABPReader(ext::span<uint8_t const> contents);
     ~ABPReader();
 
 public:
     bool open();
     bool close();
 
-    plist::Object *readTopLevelObject();
-    plist::Object *readObject(uint64_t reference);
+    bool readTopLevelObject(plist::Format::Builder *builder);
+    bool readObject(uint64_t reference, plist::Format::Builder *builder);
+
+public:
+    uint64_t topLevelObject() const
+    { return _trailer.topLevelObject; }
+
+public:
+    /*
+     * Random access to single objects, without reading what they contain.
+     * The type is an `ABPRecordType`, and the count is only set for arrays
+     * and dictionaries. A dictionary's references are its keys then values;
+     * `count` references are read starting at `index`.
+     */
+    bool readContainer(uint64_t reference, int *type, size_t *count);
+    bool readContainerReferences(uint64_t reference, size_t index, size_t count, uint64_t *result);
+    bool readKey(uint64_t reference, std::string *key);
 
 public:
     std::string const &error() const
@@ -39,6 +58,9 @@ public:
 private:
     void error(std::string const &error);
 
+private:
+    size_t contentsSize() const override;
+
 private:
     int read(void *data, size_t length);
     int readByte();
@@ -50,21 +72,20 @@ private:
     bool readHeader();
     bool readTrailer();
     bool readOffsetTable();
+    bool readObjectOffset(uint64_t reference);
     bool readReference(uint64_t *offset);
 
 private:
-    plist::Object *_readObject();
-    plist::Date *readDate();
-    plist::Integer *readInteger(size_t nbytes);
-    plist::Real *readReal(size_t nbytes);
-    plist::Data *readData(size_t nbytes);
-    plist::UID *readUid(size_t nbytes);
-    plist::String *readStringASCII(size_t nchars);
-    plist::String *readStringUnicode(size_t nchars);
-    plist::Array *readArray(size_t nitems);
-    plist::Dictionary *readDictionary(size_t nitems);
-    plist::Null *readNull();
-    plist::Boolean *readBool(bool value);
+    bool _readObject(plist::Format::Builder *builder);
+    bool readDate(plist::Format::Builder *builder);
+    bool readInteger(size_t nbytes, plist::Format::Builder *builder);
+    bool readReal(size_t nbytes, plist::Format::Builder *builder);
+    bool readData(size_t nbytes, plist::Format::Builder *builder);
+    bool readUid(size_t nbytes, plist::Format::Builder *builder);
+    bool readStringASCII(size_t nchars, std::string *string);
+    bool readStringUnicode(size_t nchars, std::string *string);
+    bool readArray(size_t nitems, plist::Format::Builder *builder);
+    bool readDictionary(size_t nitems, plist::Format::Builder *builder);
 };
 
 #endif  /* !__plist_Format_ABPReader_h */
@@ -40,6 +40,9 @@ public:
 public:
     int write(void const *data, size_t length);
 
+private:
+    size_t contentsSize() const override;
+
 private:
     bool writeByte(uint8_t byte);
     bool writeWord0(size_t nbytes, uint64_t value, bool swap);
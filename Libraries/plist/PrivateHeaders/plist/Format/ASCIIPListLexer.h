@@ -58,6 +58,11 @@ void ASCIIPListLexerInit(ASCIIPListLexer *lexer, char const *buffer,
         int length, int style);
 
 int ASCIIPListLexerReadToken(ASCIIPListLexer *lexer);
+/*
+ * If the current token has escapes or NUL bytes. If not, its contents can be
+ * used directly, without copying them with ASCIIPListCopyUnquotedString.
+ */
+int ASCIIPListLexerTokenNeedsUnquoting(ASCIIPListLexer const *lexer);
 char *ASCIIPListCopyUnquotedString(ASCIIPListLexer const *lexer, int lossByte);
 char *ASCIIPListCopyData(ASCIIPListLexer const *lexer);
 
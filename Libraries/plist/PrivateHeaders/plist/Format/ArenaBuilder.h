@@ -0,0 +1,75 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef __plist_Format_ArenaBuilder_h
+#define __plist_Format_ArenaBuilder_h
+
+#include <plist/Format/Builder.h>
+#include <plist/Arena/Arena.h>
+#include <plist/Arena/Objects.h>
+
+namespace plist {
+namespace Format {
+
+/*
+ * Builds read-only objects in an arena. The members of open containers are
+ * collected on a shared stack, then copied into the arena once the size of
+ * the container is known.
+ */
+class ArenaBuilder : public Builder {
+private:
+    struct Container {
+        size_t                      start;
+        Arena::String const        *key;
+    };
+
+private:
+    Arena::Arena                   *_arena;
+    Arena::Object const            *_root;
+    std::vector<Container>          _containers;
+    std::vector<Arena::Dictionary::Entry> _members;
+    Arena::String const            *_key;
+
+private:
+    std::vector<Arena::Object const *> _values;
+
+public:
+    explicit ArenaBuilder(Arena::Arena *arena);
+    ~ArenaBuilder();
+
+public:
+    Arena::Object const *root() const
+    { return _root; }
+
+public:
+    virtual void beginArray();
+    virtual void endArray();
+    virtual void beginDictionary();
+    virtual void endDictionary();
+    virtual void key(std::string &&key);
+
+public:
+    virtual void string(std::string &&value);
+    virtual void integer(int64_t value);
+    virtual void real(double value);
+    virtual void boolean(bool value);
+    virtual void null();
+    virtual void data(std::vector<uint8_t> &&value);
+    virtual void date(struct tm const &value);
+    virtual void uid(uint32_t value);
+
+private:
+    void begin();
+    bool end(size_t *start);
+    void add(Arena::Object const *value);
+};
+
+}
+}
+
+#endif  // !__plist_Format_ArenaBuilder_h
@@ -0,0 +1,78 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef __plist_Format_Builder_h
+#define __plist_Format_Builder_h
+
+#include <plist/Base.h>
+#include <plist/Object.h>
+
+#include <ctime>
+#include <string>
+#include <vector>
+
+namespace plist {
+namespace Format {
+
+/*
+ * Receives the contents of a property list from a parser, in document
+ * order. What the builder makes from them is up to the builder; parsers
+ * only validate the syntax and report what they find.
+ */
+class Builder {
+protected:
+    Builder();
+
+public:
+    virtual ~Builder();
+
+public:
+    /*
+     * Containers. Everything between a begin and its matching end is in
+     * that container. In a dictionary, each value is preceded by its key.
+     */
+    virtual void beginArray() = 0;
+    virtual void endArray() = 0;
+    virtual void beginDictionary() = 0;
+    virtual void endDictionary() = 0;
+    virtual void key(std::string &&key) = 0;
+
+public:
+    /*
+     * Values. A value outside of any container is the root.
+     */
+    virtual void string(std::string &&value) = 0;
+    virtual void integer(int64_t value) = 0;
+    virtual void real(double value) = 0;
+    virtual void boolean(bool value) = 0;
+    virtual void null() = 0;
+    virtual void data(std::vector<uint8_t> &&value) = 0;
+    virtual void date(struct tm const &value) = 0;
+    virtual void uid(uint32_t value) = 0;
+
+public:
+    /*
+     * If the builder will ignore what it is sent next: the contents of the
+     * container that was just begun, or the value for the key just sent.
+     * Parsers that can move past them without reading them, such as the
+     * binary reader, need not send them. The end of a container is always
+     * sent.
+     */
+    virtual bool skipping() const;
+
+public:
+    /*
+     * Send an existing object to a builder, as if it was parsed.
+     */
+    static void Visit(Object const *object, Builder *builder);
+};
+
+}
+}
+
+#endif  // !__plist_Format_Builder_h
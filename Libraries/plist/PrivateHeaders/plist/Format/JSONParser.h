@@ -10,8 +10,7 @@
 #define __plist_Format_JSONParser_h
 
 #include <plist/Format/ASCIIPListLexer.h>
-#include <plist/Object.h>
-#include <plist/String.h>
+#include <plist/Format/Builder.h>
 
 #include <stack>
 #include <string>
@@ -36,35 +35,26 @@ private:
     };
 
 private:
-    std::unique_ptr<plist::Object> _root;
+    Builder                       *_builder;
+    bool                           _root;
     int                            _level;
 
 private:
     ValueState                     _state;
     std::stack<ValueState>         _stateStack;
 
-private:
-    std::unique_ptr<plist::Object> _container;
-    std::stack<std::unique_ptr<plist::Object>> _containerStack;
-
-private:
-    std::unique_ptr<plist::String> _key;
-    std::stack<std::unique_ptr<plist::String>> _keyStack;
-
 private:
     ContextState                _contextState;
     std::string                 _error;
 
 public:
-    JSONParser();
+    explicit JSONParser(Builder *builder);
     ~JSONParser();
 
 public:
     bool parse(ASCIIPListLexer *lexer);
 
 public:
-    std::unique_ptr<plist::Object> &root()
-    { return _root; }
     std::string error() const
     { return _error; }
 
@@ -82,12 +72,12 @@ private:
     void decrementLevel();
 
 private:
-    bool push(ValueState state, std::unique_ptr<plist::Object> container, std::unique_ptr<plist::String> key);
+    bool push(ValueState state);
     bool pop();
 
 private:
-    bool beginContainer(std::unique_ptr<plist::Object> container);
-    bool storeKeyValue(std::unique_ptr<plist::String> key, std::unique_ptr<plist::Object> value);
+    bool beginValue();
+    bool beginContainer(bool isArray);
     bool endContainer(bool isArray);
 
 private:
@@ -101,8 +91,12 @@ private:
     bool endDictionary();
 
 private:
-    bool storeKey(std::unique_ptr<plist::String> key);
-    bool storeValue(std::unique_ptr<plist::Object> value);
+    bool storeKey(std::string &&key);
+    bool storeString(std::string &&value);
+    bool storeBoolean(bool value);
+    bool storeNull();
+    bool storeInteger(int64_t value);
+    bool storeReal(double value);
 };
 
 }
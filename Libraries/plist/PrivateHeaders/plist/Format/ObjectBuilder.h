@@ -0,0 +1,68 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef __plist_Format_ObjectBuilder_h
+#define __plist_Format_ObjectBuilder_h
+
+#include <plist/Format/Builder.h>
+
+#include <memory>
+
+namespace plist {
+namespace Format {
+
+/*
+ * Builds mutable objects, each allocated separately.
+ */
+class ObjectBuilder : public Builder {
+private:
+    struct Container {
+        std::unique_ptr<Object> object;
+        std::string             key;
+    };
+
+private:
+    std::unique_ptr<Object> _root;
+    std::vector<Container>  _containers;
+    std::string             _key;
+
+public:
+    ObjectBuilder();
+    ~ObjectBuilder();
+
+public:
+    std::unique_ptr<Object> &root()
+    { return _root; }
+
+public:
+    virtual void beginArray();
+    virtual void endArray();
+    virtual void beginDictionary();
+    virtual void endDictionary();
+    virtual void key(std::string &&key);
+
+public:
+    virtual void string(std::string &&value);
+    virtual void integer(int64_t value);
+    virtual void real(double value);
+    virtual void boolean(bool value);
+    virtual void null();
+    virtual void data(std::vector<uint8_t> &&value);
+    virtual void date(struct tm const &value);
+    virtual void uid(uint32_t value);
+
+private:
+    void begin(std::unique_ptr<Object> container);
+    void end();
+    void add(std::unique_ptr<Object> value);
+};
+
+}
+}
+
+#endif  // !__plist_Format_ObjectBuilder_h
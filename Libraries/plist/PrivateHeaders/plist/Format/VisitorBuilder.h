@@ -0,0 +1,60 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef __plist_Format_VisitorBuilder_h
+#define __plist_Format_VisitorBuilder_h
+
+#include <plist/Format/Builder.h>
+#include <plist/Format/Visitor.h>
+
+namespace plist {
+namespace Format {
+
+/*
+ * Passes what is parsed on to a visitor, leaving out what it skips.
+ */
+class VisitorBuilder : public Builder {
+private:
+    Visitor *_visitor;
+    size_t   _skip;
+    bool     _skipValue;
+
+public:
+    explicit VisitorBuilder(Visitor *visitor);
+    ~VisitorBuilder();
+
+public:
+    virtual void beginArray();
+    virtual void endArray();
+    virtual void beginDictionary();
+    virtual void endDictionary();
+    virtual void key(std::string &&key);
+
+public:
+    virtual void string(std::string &&value);
+    virtual void integer(int64_t value);
+    virtual void real(double value);
+    virtual void boolean(bool value);
+    virtual void null();
+    virtual void data(std::vector<uint8_t> &&value);
+    virtual void date(struct tm const &value);
+    virtual void uid(uint32_t value);
+
+public:
+    virtual bool skipping() const;
+
+private:
+    bool begin();
+    bool end();
+    bool value();
+};
+
+}
+}
+
+#endif  // !__plist_Format_VisitorBuilder_h
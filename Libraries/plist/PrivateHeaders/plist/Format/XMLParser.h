@@ -10,13 +10,37 @@
 #define __plist_Format_XMLParser_h
 
 #include <plist/Format/BaseXMLParser.h>
-#include <plist/Object.h>
+#include <plist/Format/Builder.h>
 
 namespace plist {
 namespace Format {
 
 class XMLParser : public BaseXMLParser {
 private:
+    enum class Element {
+        None,
+        Array,
+        Dictionary,
+        String,
+        Integer,
+        Real,
+        Boolean,
+        Null,
+        Data,
+        Date,
+    };
+
+    /*
+     * A dictionary with just an integer "CF$UID" is a UID. Dictionaries
+     * are only sent to the builder once they can't be one.
+     */
+    enum class UIDState {
+        None,
+        Empty,
+        Key,
+        Value,
+    };
+
     struct Key {
         std::string value;
         bool        valid;
@@ -26,21 +50,24 @@ private:
     struct State {
         typedef std::vector <State> vector;
 
-        Object *current;
-        Key     key;
+        Element  element;
+        Key      key;
+        UIDState uid;
+        uint32_t uidValue;
     };
 
 private:
-    Object        *_root;
+    Builder       *_builder;
+    bool           _root;
     State::vector  _stack;
     State          _state;
     std::string    _cdata;
 
 public:
-    XMLParser();
+    explicit XMLParser(Builder *builder);
 
 public:
-    Object *parse(std::vector<uint8_t> const &contents);
+    bool parse(ext::span<uint8_t const> contents);
 
 private:
     virtual void onBeginParse();
@@ -52,8 +79,9 @@ private:
     void onCharacterData(std::string const &cdata, size_t depth);
 
 private:
-    void push(Object *object);
+    void push(Element element);
     void pop();
+    void flushDictionary();
 
 private:
     inline bool inArray() const;
@@ -0,0 +1,111 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree.
+ */
+
+#include <plist/Arena/Arena.h>
+#include <plist/Arena/Objects.h>
+
+#include <cstring>
+
+using plist::Arena::Arena;
+using plist::Arena::String;
+
+/*
+ * Large enough that even big property lists only need a few blocks.
+ */
+static size_t const BlockSize = 64 * 1024;
+
+Arena::
+Arena() :
+    _next        (nullptr),
+    _remaining   (0),
+    _size        (0),
+    _stringsCount(0)
+{
+}
+
+Arena::
+~Arena()
+{
+}
+
+void *Arena::
+allocate(size_t size, size_t alignment)
+{
+    size_t padding = (alignment - (reinterpret_cast<uintptr_t>(_next) % alignment)) % alignment;
+
+    if (_next == nullptr || padding + size > _remaining) {
+        if (size + alignment > BlockSize / 4) {
+            /* Large allocations get their own block, so the current block can still be used. */
+            _blocks.push_back(std::unique_ptr<uint8_t[]>(new uint8_t[size + alignment]));
+            uint8_t *block = _blocks.back().get();
+            padding = (alignment - (reinterpret_cast<uintptr_t>(block) % alignment)) % alignment;
+
+            _size += size;
+            return block + padding;
+        }
+
+        _blocks.push_back(std::unique_ptr<uint8_t[]>(new uint8_t[BlockSize]));
+        _next = _blocks.back().get();
+        _remaining = BlockSize;
+        padding = (alignment - (reinterpret_cast<uintptr_t>(_next) % alignment)) % alignment;
+    }
+
+    void *result = _next + padding;
+    _next += padding + size;
+    _remaining -= padding + size;
+    _size += size;
+    return result;
+}
+
+void Arena::
+rehash(size_t capacity)
+{
+    std::vector<String const *> strings = std::vector<String const *>(capacity, nullptr);
+
+    for (String const *string : _strings) {
+        if (string != nullptr) {
+            size_t slot = string->hash() & (capacity - 1);
+            while (strings[slot] != nullptr) {
+                slot = (slot + 1) & (capacity - 1);
+            }
+            strings[slot] = string;
+        }
+    }
+
+    _strings = std::move(strings);
+}
+
+String const *Arena::
+string(char const *value, size_t size)
+{
+    /* Keep the table at most half full. */
+    if ((_stringsCount + 1) * 2 > _strings.size()) {
+        rehash(_strings.empty() ? 256 : _strings.size() * 2);
+    }
+
+    size_t hash = String::Hash(value, size);
+    size_t slot = hash & (_strings.size() - 1);
+    while (_strings[slot] != nullptr) {
+        String const *string = _strings[slot];
+        if (string->hash() == hash && string->equals(value, size)) {
+            return string;
+        }
+        slot = (slot + 1) & (_strings.size() - 1);
+    }
+
+    char *contents = static_cast<char *>(allocate(size + 1, 1));
+    if (size > 0) {
+        ::memcpy(contents, value, size);
+    }
+    contents[size] = '\0';
+
+    String const *string = create<String>(contents, size, hash);
+    _strings[slot] = string;
+    _stringsCount++;
+    return string;
+}
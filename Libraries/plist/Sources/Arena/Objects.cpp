@@ -0,0 +1,199 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree.
+ */
+
+#include <plist/Arena/Objects.h>
+#include <plist/Arena/Arena.h>
+#include <plist/Objects.h>
+
+#include <algorithm>
+#include <cstdlib>
+
+using plist::Arena::Arena;
+using plist::Arena::Object;
+using plist::Arena::String;
+using plist::Arena::Integer;
+using plist::Arena::Real;
+using plist::Arena::Boolean;
+using plist::Arena::Null;
+using plist::Arena::Data;
+using plist::Arena::Date;
+using plist::Arena::UID;
+using plist::Arena::Array;
+using plist::Arena::Dictionary;
+
+/*
+ * Dictionaries with more entries than this get a hash index; smaller ones
+ * are faster to search directly.
+ */
+static size_t const IndexThreshold = 8;
+
+size_t String::
+Hash(char const *value, size_t size)
+{
+    /* FNV-1a. */
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t n = 0; n < size; n++) {
+        hash ^= static_cast<uint8_t>(value[n]);
+        hash *= 1099511628211ULL;
+    }
+    return static_cast<size_t>(hash);
+}
+
+Array const *Array::
+New(Arena *arena, Object const * const *values, size_t count)
+{
+    Object const **copy = nullptr;
+    if (count > 0) {
+        copy = static_cast<Object const **>(arena->allocate(sizeof(Object const *) * count, alignof(Object const *)));
+        std::copy(values, values + count, copy);
+    }
+
+    return arena->create<Array>(copy, count);
+}
+
+static void
+Insert(uint32_t *index, size_t indexSize, Dictionary::Entry *entries, size_t n, bool *duplicate)
+{
+    size_t slot = entries[n].key->hash() & (indexSize - 1);
+    while (index[slot] != 0) {
+        Dictionary::Entry *existing = &entries[index[slot] - 1];
+        if (existing->key == entries[n].key) {
+            /* Keys are interned, so equal keys are the same string. */
+            existing->key = nullptr;
+            *duplicate = true;
+            break;
+        }
+        slot = (slot + 1) & (indexSize - 1);
+    }
+
+    index[slot] = static_cast<uint32_t>(n + 1);
+}
+
+Dictionary const *Dictionary::
+New(Arena *arena, Entry const *entries, size_t count)
+{
+    Entry *copy = nullptr;
+    if (count > 0) {
+        copy = static_cast<Entry *>(arena->allocate(sizeof(Entry) * count, alignof(Entry)));
+    }
+
+    if (count <= IndexThreshold) {
+        size_t size = 0;
+        for (size_t n = 0; n < count; n++) {
+            /* Replacing a key moves it to the end, as in a mutable dictionary. */
+            for (size_t m = 0; m < size; m++) {
+                if (copy[m].key == entries[n].key) {
+                    std::copy(copy + m + 1, copy + size, copy + m);
+                    size--;
+                    break;
+                }
+            }
+
+            copy[size++] = entries[n];
+        }
+
+        return arena->create<Dictionary>(copy, size, nullptr, 0);
+    }
+
+    size_t indexSize = 1;
+    while (indexSize < count * 2) {
+        indexSize <<= 1;
+    }
+
+    uint32_t *index = static_cast<uint32_t *>(arena->allocate(sizeof(uint32_t) * indexSize, alignof(uint32_t)));
+    std::fill(index, index + indexSize, 0);
+    std::copy(entries, entries + count, copy);
+
+    bool duplicate = false;
+    for (size_t n = 0; n < count; n++) {
+        Insert(index, indexSize, copy, n, &duplicate);
+    }
+
+    if (duplicate) {
+        /* Drop replaced entries, then index the remaining ones again. */
+        size_t size = 0;
+        for (size_t n = 0; n < count; n++) {
+            if (copy[n].key != nullptr) {
+                copy[size++] = copy[n];
+            }
+        }
+        count = size;
+
+        std::fill(index, index + indexSize, 0);
+        for (size_t n = 0; n < count; n++) {
+            Insert(index, indexSize, copy, n, &duplicate);
+        }
+    }
+
+    return arena->create<Dictionary>(copy, count, index, indexSize);
+}
+
+Object const *Dictionary::
+value(char const *key, size_t size) const
+{
+    if (_index == nullptr) {
+        for (size_t n = 0; n < _count; n++) {
+            if (_entries[n].key->equals(key, size)) {
+                return _entries[n].value;
+            }
+        }
+
+        return nullptr;
+    }
+
+    size_t hash = String::Hash(key, size);
+    for (size_t slot = hash & (_indexSize - 1); _index[slot] != 0; slot = (slot + 1) & (_indexSize - 1)) {
+        Entry const &entry = _entries[_index[slot] - 1];
+        if (entry.key->hash() == hash && entry.key->equals(key, size)) {
+            return entry.value;
+        }
+    }
+
+    return nullptr;
+}
+
+std::unique_ptr<plist::Object> Object::
+copy() const
+{
+    switch (_type) {
+        case ObjectType::String:
+            return plist::String::New(CastTo<String>(this)->value());
+        case ObjectType::Integer:
+            return plist::Integer::New(CastTo<Integer>(this)->value());
+        case ObjectType::Real:
+            return plist::Real::New(CastTo<Real>(this)->value());
+        case ObjectType::Boolean:
+            return plist::Boolean::New(CastTo<Boolean>(this)->value());
+        case ObjectType::Null:
+            return plist::Null::New();
+        case ObjectType::Data:
+            return plist::Data::New(CastTo<Data>(this)->value());
+        case ObjectType::Date:
+            return plist::Date::New(CastTo<Date>(this)->value());
+        case ObjectType::UID:
+            return plist::UID::New(CastTo<UID>(this)->value());
+        case ObjectType::Array: {
+            std::unique_ptr<plist::Array> array = plist::Array::New();
+            for (Object const *value : *CastTo<Array>(this)) {
+                array->append(value->copy());
+            }
+            return std::move(array);
+        }
+        case ObjectType::Dictionary: {
+            std::unique_ptr<plist::Dictionary> dict = plist::Dictionary::New();
+            for (Dictionary::Entry const &entry : *CastTo<Dictionary>(this)) {
+                dict->set(entry.key->value(), entry.value->copy());
+            }
+            return std::move(dict);
+        }
+        case ObjectType::None:
+            break;
+    }
+
+    abort();
+}
@@ -18,6 +18,7 @@ Decode(std::string const &in, std::vector<uint8_t> &out)
     size_t outsize = rfc4648_get_decoded_size(RFC4648_TYPE_BASE64_SAFE, in.size());
     out.resize(outsize);
     rfc4648_decode(RFC4648_TYPE_BASE64_SAFE, &in[0], in.size(), reinterpret_cast<char *>(&out[0]), &outsize, true);
+    out.resize(outsize);
 }
 
 std::string Base64::
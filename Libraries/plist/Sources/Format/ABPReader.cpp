@@ -9,7 +9,9 @@
 #include <plist/Format/ABPReader.h>
 #include <plist/Format/ABPRecordType.h>
 #include <plist/Format/Encoding.h>
+#include <plist/UnixTime.h>
 
+#include <algorithm>
 #include <cassert>
 
 #if 0
@@ -27,80 +29,94 @@ error(std::string const &error)
 bool ABPReader::
 readOffsetTable()
 {
-    off_t        offset;
-    uint64_t     n, *offsets;
-    plist::Object **objects;
-
-    offset = -static_cast<off_t>(sizeof(this->_trailer) + this->_trailer.offsetIntByteSize * this->_trailer.objectsCount);
+    /*
+     * Offsets are read as objects are, rather than all up front, so
+     * reading part of the contents only costs as much as that part.
+     */
+    size_t size = this->_trailer.offsetIntByteSize;
+    if (size == 0 || size > 8 || this->_trailer.objectsCount > (this->contentsSize() - sizeof(this->_trailer)) / size)
+        return false;
 
+    off_t offset = -static_cast<off_t>(sizeof(this->_trailer) + size * this->_trailer.objectsCount);
     if (this->seek(offset, SEEK_END) < 0)
         return false;
 
-    size_t objectsCount = static_cast<size_t>(this->_trailer.objectsCount);
-    offsets = new uint64_t[objectsCount];
-    objects = new plist::Object *[objectsCount];
+    this->_offsetTable = this->tell();
+    return true;
+}
 
-    for (n = 0; n < this->_trailer.objectsCount; n++) {
-        objects[n] = nullptr;
-        if (!this->readOffset(offsets + n)) {
-            delete[] objects;
-            delete[] offsets;
-            return false;
-        }
+bool ABPReader::
+readObjectOffset(uint64_t reference)
+{
+    if (reference >= this->_trailer.objectsCount) {
+        this->error("reference out of range");
+        return false;
+    }
 
-#if 1
-        dprintf("Object #%-5llu: %llx%s\n",
-                (unsigned long long)n,
-                (unsigned long long)offsets[n],
-                (n == this->_trailer.topLevelObject)
-                ? " [TOP LEVEL OBJECT]" : "");
-#endif
+    uint64_t offset;
+    this->seek(this->_offsetTable + static_cast<off_t>(reference * this->_trailer.offsetIntByteSize), SEEK_SET);
+    if (!this->readOffset(&offset)) {
+        this->error("corrupted offsets table");
+        return false;
     }
 
-    this->_offsets = offsets;
-    this->_objects = objects;
+    dprintf("Object #%-5llu: %llx%s\n",
+            (unsigned long long)reference,
+            (unsigned long long)offset,
+            (reference == this->_trailer.topLevelObject)
+            ? " [TOP LEVEL OBJECT]" : "");
+
+    if (this->seek(static_cast<off_t>(offset), SEEK_SET) < 0) {
+        this->error("object reference's offset out of range");
+        return false;
+    }
 
     return true;
 }
 
-plist::Date *ABPReader::
-readDate()
+bool ABPReader::
+readDate(plist::Format::Builder *builder)
 {
     uint64_t date;
     if (!this->readWord(8, &date)) {
         this->error("EOF reading date value");
-        return NULL;
+        return false;
     }
 
     /* Reference time is 2001/1/1 */
     static uint64_t const ReferenceTimestamp = 978307200;
-    return plist::Date::New(date - ReferenceTimestamp).release();
+
+    struct tm value = tm();
+    plist::UnixTime::Decode(date - ReferenceTimestamp, value);
+    builder->date(value);
+    return true;
 }
 
-plist::Integer *ABPReader::
-readInteger(size_t nbytes)
+bool ABPReader::
+readInteger(size_t nbytes, plist::Format::Builder *builder)
 {
     uint64_t value;
 
     if (!this->readWord(nbytes, &value)) {
         this->error("EOF reading integer value");
-        return NULL;
+        return false;
     }
 
     dprintf("int(%zu) - %llu\n", nbytes,
             (unsigned long long)value);
 
-    return plist::Integer::New(value).release();
+    builder->integer(value);
+    return true;
 }
 
-plist::Real *ABPReader::
-readReal(size_t nbytes)
+bool ABPReader::
+readReal(size_t nbytes, plist::Format::Builder *builder)
 {
     uint64_t value;
 
     if (!this->readWord(nbytes, &value)) {
         this->error("EOF reading real value");
-        return NULL;
+        return false;
     }
 
     dprintf("real(%zu) - %g\n", nbytes,
@@ -108,25 +124,32 @@ readReal(size_t nbytes)
 
     switch (nbytes) {
         case 4: {
+            uint32_t bits = static_cast<uint32_t>(value);
             float converted;
-            memcpy(&converted, &value, sizeof(converted));
-            return plist::Real::New(converted).release();
+            memcpy(&converted, &bits, sizeof(converted));
+            builder->real(converted);
+            break;
         }
         case 8: {
             double converted;
             memcpy(&converted, &value, sizeof(converted));
-            return plist::Real::New(converted).release();
+            builder->real(converted);
+            break;
         }
-        default: return plist::Real::New(0.0).release();
+        default:
+            builder->real(0.0);
+            break;
     }
+
+    return true;
 }
 
-plist::Data *ABPReader::
-readData(size_t nbytes)
+bool ABPReader::
+readData(size_t nbytes, plist::Format::Builder *builder)
 {
     if (!this->readLength(&nbytes)) {
         this->error("EOF reading data length value");
-        return NULL;
+        return false;
     }
 
     dprintf("data - %zu bytes\n", nbytes);
@@ -137,66 +160,68 @@ readData(size_t nbytes)
         bytes.resize(nbytes);
         size_t nread = this->read(bytes.data(), nbytes);
         if (nread < nbytes) {
-            return nullptr;
+            return false;
         }
     }
 
-    return plist::Data::New(std::move(bytes)).release();
+    builder->data(std::move(bytes));
+    return true;
 }
 
-plist::UID *ABPReader::
-readUid(size_t nbytes)
+bool ABPReader::
+readUid(size_t nbytes, plist::Format::Builder *builder)
 {
     uint64_t value = 0;
 
     if (!this->readLength(&nbytes))
-        return NULL;
+        return false;
 
     dprintf("uid - %lu bytes", nbytes);
 
     if (nbytes > 4) {
         this->error("too many bytes in UID");
-        return NULL;
+        return false;
     }
 
     if (nbytes > 0 && !this->readWord(nbytes, &value)) {
         this->error("error reading word for UID");
-        return NULL;
+        return false;
     }
 
-    return plist::UID::New(static_cast<uint32_t>(value)).release();
+    builder->uid(static_cast<uint32_t>(value));
+    return true;
 }
 
-plist::String *ABPReader::
-readStringASCII(size_t nchars)
+bool ABPReader::
+readStringASCII(size_t nchars, std::string *string)
 {
     if (!this->readLength(&nchars)) {
         this->error("EOF reading ASCII string length value");
-        return NULL;
+        return false;
     }
 
     dprintf("ascii string - %zu(0x%zx) chars\n", nchars, nchars);
 
-    std::string string;
+    string->clear();
 
     if (nchars > 0) {
         size_t nbytes = sizeof(char) * nchars;
-        string.resize(nbytes);
-        size_t nread = this->read(&string[0], nbytes);
+        string->resize(nbytes);
+        size_t nread = this->read(&(*string)[0], nbytes);
         if (nread < nbytes) {
-            return nullptr;
+            return false;
         }
     }
 
-    return plist::String::New(std::move(string)).release();
+    return true;
 }
 
-plist::String *ABPReader::
-readStringUnicode(size_t nchars)
+bool ABPReader::
+readStringUnicode(size_t nchars, std::string *string)
 {
     if (!this->readLength(&nchars)) {
         this->error("EOF reading Unicode string length value");
-        return NULL;
+        return false;
     }
 
     dprintf("unicode string - %zu chars\n", nchars);
@@ -205,81 +230,97 @@ readStringUnicode(size_t nchars)
 
     if (nchars > 0) {
         size_t nbytes = sizeof(uint16_t) * nchars;
-        buffer.resize(nbytes);
-        size_t nread = this->read(buffer.data(), nbytes);
-        if (nread < nbytes) {
-            return nullptr;
+        if (nbytes > this->_contents.size() - this->_offset) {
+            return false;
         }
-    }
 
-    buffer = plist::Format::Encodings::Convert(buffer, plist::Format::Encoding::UTF16BE, plist::Format::Encoding::UTF8);
+        /* Convert directly from the contents, without another copy. */
+        ext::span<uint8_t const> contents = this->_contents.subspan(this->_offset, nbytes);
+        this->_offset += nbytes;
 
-    std::string string = std::string(buffer.begin(), buffer.end());
-    return plist::String::New(std::move(string)).release();
+        buffer = plist::Format::Encodings::Convert(contents, plist::Format::Encoding::UTF16BE, plist::Format::Encoding::UTF8);
+    }
+
+    *string = std::string(buffer.begin(), buffer.end());
+    return true;
 }
 
-plist::Array *ABPReader::
-readArray(size_t nitems)
+bool ABPReader::
+readKey(uint64_t reference, std::string *key)
 {
-    std::unique_ptr<plist::Array> array;
+    if (!this->readObjectOffset(reference)) {
+        return false;
+    }
+
+    int byte = this->readByte();
+    if (byte == EOF) {
+        return false;
+    }
+
+    //
+    // Key must be of string type.
+    //
+    switch (__ABPByteToRecordType(byte)) {
+        case kABPRecordTypeStringASCII:
+            return this->readStringASCII(byte & 0x0f, key);
+        case kABPRecordTypeStringUnicode:
+            return this->readStringUnicode(byte & 0x0f, key);
+        default:
+            this->error("dictionary key is not a string");
+            return false;
+    }
+}
 
+bool ABPReader::
+readArray(size_t nitems, plist::Format::Builder *builder)
+{
     if (!this->readLength(&nitems)) {
         this->error("EOF reading array count value");
-        return NULL;
+        return false;
     }
 
     dprintf("array - %zu items\n", nitems);
 
-    auto objrefs = new uint64_t[nitems];
+    std::vector<uint64_t> objrefs;
+    objrefs.reserve(nitems);
     for (size_t n = 0; n < nitems; n++) {
         uint64_t objref;
         if (!this->readReference(&objref)) {
             this->error("corrupted array's object references table");
-            goto fail;
+            return false;
         }
 
         dprintf("\titem #%zu: obj ref %llu\n", n,
                 (unsigned long long)objref);
 
-        objrefs[n] = objref;
+        objrefs.push_back(objref);
     }
 
-    array = plist::Array::New();
-    for (size_t n = 0; n < nitems; n++) {
-        uint64_t objref = objrefs[n];
-        auto object = this->readObject(objref);
-        if (object == nullptr) {
-            goto fail;
-        }
+    builder->beginArray();
+    if (builder->skipping()) {
+        /* Skipped contents are never read. */
+        objrefs.clear();
+    }
 
-        //
-        // Due to the memory layout of the `plist' objects,
-        // we must always copy objects.
-        //
-        if (this->_seen.find(object) != this->_seen.end()) {
-            this->_seen.insert(object);
+    for (uint64_t objref : objrefs) {
+        if (!this->readObject(objref, builder)) {
+            return false;
         }
-        object = object->copy().release();
-
-        array->append(std::unique_ptr<plist::Object>(object));
     }
+    builder->endArray();
 
-fail:
-    delete[] objrefs;
-    return array.release();
+    return true;
 }
 
-plist::Dictionary *ABPReader::
-readDictionary(size_t nitems)
+bool ABPReader::
+readDictionary(size_t nitems, plist::Format::Builder *builder)
 {
-    std::unique_ptr<plist::Dictionary> dict;
-
     if (!this->readLength(&nitems)) {
         this->error("EOF reading dictionary count value");
-        return NULL;
+        return false;
     }
 
-    uint64_t *kvrefs = new uint64_t[nitems * 2];
+    std::vector<uint64_t> kvrefs = std::vector<uint64_t>(nitems * 2);
     dprintf("dictionary - %zu items\n", nitems);
 
     for (size_t n = 0; n < nitems; n++) {
@@ -287,7 +328,7 @@ readDictionary(size_t nitems)
 
         if (!this->readReference(&keyref)) {
             this->error("corrupted dictionary's key references table");
-            goto fail;
+            return false;
         }
 
         kvrefs[n * 2 + 0] = keyref;
@@ -298,124 +339,110 @@ readDictionary(size_t nitems)
 
         if (!this->readReference(&objref)) {
             this->error("corrupted dictionary's object references table");
-            goto fail;
+            return false;
         }
 
         kvrefs[n * 2 + 1] = objref;
     }
 
-    dict = plist::Dictionary::New();
+    builder->beginDictionary();
+    if (builder->skipping()) {
+        /* Skipped contents are never read. */
+        nitems = 0;
+    }
+
     for (size_t n = 0; n < nitems; n++) {
-        auto keyObject = this->readObject(kvrefs[n * 2 + 0]);
-        if (keyObject == nullptr) {
-            goto fail;
+        std::string key;
+        if (!this->readKey(kvrefs[n * 2 + 0], &key)) {
+            return false;
         }
 
-        auto object = this->readObject(kvrefs[n * 2 + 1]);
-        if (object == nullptr) {
-            goto fail;
-        }
+        builder->key(std::move(key));
 
-        //
-        // Key must be of string type.
-        //
-        auto keyString = plist::CastTo<plist::String>(keyObject);
-        if (keyString == nullptr) {
-            goto fail;
+        if (builder->skipping()) {
+            continue;
         }
 
-        //
-        // Due to the memory layout of the `plist' objects,
-        // we must always copy objects.
-        //
-        if (this->_seen.find(object) != this->_seen.end()) {
-            this->_seen.insert(object);
+        if (!this->readObject(kvrefs[n * 2 + 1], builder)) {
+            return false;
         }
-        object = object->copy().release();
-
-        dict->set(keyString->value(), std::unique_ptr<plist::Object>(object));
     }
+    builder->endDictionary();
 
-fail:
-    delete[] kvrefs;
-    return dict.release();
-}
-
-plist::Null *ABPReader::
-readNull()
-{
-    return plist::Null::New().release();
-}
-
-plist::Boolean *ABPReader::
-readBool(bool value)
-{
-    return plist::Boolean::New(value).release();
+    return true;
 }
 
-plist::Object *ABPReader::
-_readObject()
+bool ABPReader::
+_readObject(plist::Format::Builder *builder)
 {
     int byte;
 
     for (;;) {
         byte = this->readByte();
         if (byte == EOF) {
-            return NULL;
+            return false;
         }
 
         switch (__ABPByteToRecordType(byte)) {
             case kABPRecordTypeNull:
-                return this->readNull();
+                builder->null();
+                return true;
             case kABPRecordTypeBoolFalse:
-                return this->readBool(false);
+                builder->boolean(false);
+                return true;
             case kABPRecordTypeBoolTrue:
-                return this->readBool(true);
+                builder->boolean(true);
+                return true;
             case kABPRecordTypeFill:
                 break;
             case kABPRecordTypeDate:
-                return this->readDate();
+                return this->readDate(builder);
             case kABPRecordTypeInteger:
-                return this->readInteger(1 << (byte & 0x0f));
+                return this->readInteger(1 << (byte & 0x0f), builder);
             case kABPRecordTypeReal:
-                return this->readReal(1 << (byte & 0x0f));
+                return this->readReal(1 << (byte & 0x0f), builder);
             case kABPRecordTypeData:
-                return this->readData(byte & 0x0f);
-            case kABPRecordTypeStringASCII:
-                return this->readStringASCII(byte & 0x0f);
-            case kABPRecordTypeStringUnicode:
-                return this->readStringUnicode(byte & 0x0f);
+                return this->readData(byte & 0x0f, builder);
+            case kABPRecordTypeStringASCII: {
+                std::string string;
+                if (!this->readStringASCII(byte & 0x0f, &string)) {
+                    return false;
+                }
+                builder->string(std::move(string));
+                return true;
+            }
+            case kABPRecordTypeStringUnicode: {
+                std::string string;
+                if (!this->readStringUnicode(byte & 0x0f, &string)) {
+                    return false;
+                }
+                builder->string(std::move(string));
+                return true;
+            }
             case kABPRecordTypeUid:
-                return this->readUid((byte & 0x0f) + 1);
+                return this->readUid((byte & 0x0f) + 1, builder);
             case kABPRecordTypeArray:
-                return this->readArray(byte & 0x0f);
+                return this->readArray(byte & 0x0f, builder);
             case kABPRecordTypeDictionary:
-                return this->readDictionary(byte & 0x0f);
+                return this->readDictionary(byte & 0x0f, builder);
             default:
                 this->error("unsupported type id");
-                return NULL;
+                return false;
         }
     }
 }
 
 ABPReader::
-ABPReader(std::vector<uint8_t> const *contents) :
-    ABPContext(contents),
-    _objects (nullptr)
+ABPReader(ext::span<uint8_t const> contents) :
+    ABPContext(),
+    _contents   (contents),
+    _offsetTable(0)
 {
 }
 
 ABPReader::
 ~ABPReader()
 {
-    if (this->_objects != NULL) {
-        for (size_t n = 0; n < this->_trailer.objectsCount; n++) {
-            if (this->_objects[n] != NULL) {
-                this->_objects[n]->release();
-            }
-        }
-        delete[] this->_objects;
-    }
 }
 
 bool ABPReader::
@@ -454,57 +481,137 @@ close()
     return true;
 }
 
-plist::Object *ABPReader::
-readObject(uint64_t reference)
+bool ABPReader::
+readObject(uint64_t reference, plist::Format::Builder *builder)
+{
+    /* Fail if complete, or not opened. */
+    if ((this->_flags & kABPContextComplete) != 0 ||
+        (this->_flags & kABPContextOpened) == 0)
+        return false;
+
+    /*
+     * Objects can be referenced more than once, and are read each time.
+     * But an object that contains itself would never finish. Only the
+     * containers being read are tracked, which is as deep as the nesting.
+     */
+    if (std::find(this->_reading.begin(), this->_reading.end(), reference) != this->_reading.end()) {
+        this->error("object contains itself");
+        return false;
+    }
+
+    if (!this->readObjectOffset(reference)) {
+        return false;
+    }
+
+    this->_reading.push_back(reference);
+    bool success = this->_readObject(builder);
+    this->_reading.pop_back();
+
+    if (!success) {
+        if (this->_error.empty()) {
+            this->error("failed to create object");
+        }
+        return false;
+    }
+
+    return true;
+}
+
+bool ABPReader::
+readTopLevelObject(plist::Format::Builder *builder)
 {
-    plist::Object *object;
+    return this->readObject(this->_trailer.topLevelObject, builder);
+}
 
+bool ABPReader::
+readContainer(uint64_t reference, int *type, size_t *count)
+{
     /* Fail if complete, or not opened. */
     if ((this->_flags & kABPContextComplete) != 0 ||
         (this->_flags & kABPContextOpened) == 0)
-        return NULL;
+        return false;
 
-    if (reference >= this->_trailer.objectsCount) {
-        this->error("reference out of range");
-        return NULL;
+    if (!this->readObjectOffset(reference)) {
+        return false;
     }
 
-    object = this->_objects[reference];
-    if (object == NULL) {
-        if (this->seek(static_cast<size_t>(this->_offsets[reference]), SEEK_SET) < 0) {
-            this->error("object reference's offset out of range");
-            return NULL;
+    int byte;
+    do {
+        byte = this->readByte();
+        if (byte == EOF) {
+            this->error("EOF reading object type");
+            return false;
         }
+    } while (__ABPByteToRecordType(byte) == kABPRecordTypeFill);
 
-        object = this->_readObject();
-        if (object == NULL) {
-            this->error("failed to create object");
-            return NULL;
+    *type = __ABPByteToRecordType(byte);
+    *count = 0;
+
+    if (*type == kABPRecordTypeArray || *type == kABPRecordTypeDictionary) {
+        size_t nitems = byte & 0x0f;
+        if (!this->readLength(&nitems)) {
+            this->error("EOF reading container count value");
+            return false;
         }
 
-        this->_objects[reference] = object;
+        /* All of the references must be in the contents. */
+        size_t nrefs = (*type == kABPRecordTypeDictionary ? 2 : 1);
+        size_t remaining = this->_contents.size() - this->_offset;
+        if (nitems > remaining / (nrefs * std::max<size_t>(this->_trailer.objectRefByteSize, 1))) {
+            this->error("corrupted container's object references table");
+            return false;
+        }
+
+        *count = nitems;
     }
 
-    return object;
+    return true;
+}
+
+bool ABPReader::
+readContainerReferences(uint64_t reference, size_t index, size_t count, uint64_t *result)
+{
+    int    type;
+    size_t nitems;
+    if (!this->readContainer(reference, &type, &nitems)) {
+        return false;
+    }
+
+    /* Dictionaries have all of their keys, then all of their values. */
+    size_t nrefs = (type == kABPRecordTypeDictionary ? 2 : type == kABPRecordTypeArray ? 1 : 0);
+    if (index > nitems * nrefs || count > nitems * nrefs - index) {
+        this->error("container index out of range");
+        return false;
+    }
+
+    this->seek(static_cast<off_t>(index * this->_trailer.objectRefByteSize), SEEK_CUR);
+    for (size_t n = 0; n < count; n++) {
+        if (!this->readReference(&result[n])) {
+            this->error("corrupted container's object references table");
+            return false;
+        }
+    }
+
+    return true;
 }
 
-plist::Object *ABPReader::
-readTopLevelObject()
+size_t ABPReader::
+contentsSize() const
 {
-    return this->readObject(this->_trailer.topLevelObject);
+    return this->_contents.size();
 }
 
 int ABPReader::
 read(void *data, size_t length)
 {
     /* Adjust size for remaining contents. */
-    size_t remaining = this->_contents->size() - this->_offset;
+    size_t remaining = this->_contents.size() - this->_offset;
     if (remaining < length) {
         length = remaining;
     }
 
     /* Copy into read buffer. */
-    ::memcpy(data, this->_contents->data() + this->_offset, length);
+    ::memcpy(data, this->_contents.data() + this->_offset, length);
 
     this->_offset += length;
     return length;
@@ -548,11 +548,17 @@ writeObject(Object const *object, uint32_t flags)
 
 ABPWriter::
 ABPWriter(std::vector<uint8_t> *contents) :
-    ABPContext      (contents),
+    ABPContext      (),
     _mutableContents(contents)
 {
 }
 
+size_t ABPWriter::
+contentsSize() const
+{
+    return this->_mutableContents->size();
+}
+
 bool ABPWriter::
 open()
 {
@@ -650,7 +656,7 @@ writeTopLevelObject(Object const *object)
         }
 
         /* Allocate enough space for the offsets table. */
-        this->_offsets = static_cast<uint64_t *>(calloc(static_cast<size_t>(this->_trailer.objectsCount), sizeof(uint64_t)));
+        this->_offsets = new uint64_t[static_cast<size_t>(this->_trailer.objectsCount)]();
         if (this->_offsets == NULL)
             return false;
 
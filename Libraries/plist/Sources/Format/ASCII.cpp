@@ -9,12 +9,20 @@
 #include <plist/Format/ASCII.h>
 #include <plist/Format/ASCIIParser.h>
 #include <plist/Format/ASCIIWriter.h>
+#include <plist/Format/ObjectBuilder.h>
+#include <plist/Format/ArenaBuilder.h>
+#include <plist/Format/VisitorBuilder.h>
 #include <plist/Objects.h>
 
 using plist::Format::Type;
 using plist::Format::Encoding;
 using plist::Format::Format;
 using plist::Format::ASCII;
+using plist::Format::Builder;
+using plist::Format::ObjectBuilder;
+using plist::Format::ArenaBuilder;
+using plist::Format::VisitorBuilder;
+using plist::Format::Visitor;
 using plist::Object;
 
 ASCII::
@@ -34,7 +42,7 @@ namespace plist { namespace Format {
 
 template<>
 std::unique_ptr<ASCII> Format<ASCII>::
-Identify(std::vector<uint8_t> const &contents)
+Identify(ext::span<uint8_t const> contents)
 {
     Encoding encoding = Encodings::Detect(contents);
 
@@ -217,28 +225,71 @@ Identify(std::vector<uint8_t> const &contents)
     return nullptr;
 }
 
-template<>
-std::pair<std::unique_ptr<Object>, std::string> Format<ASCII>::
-Deserialize(std::vector<uint8_t> const &contents, ASCII const &format)
+static bool
+Parse(ext::span<uint8_t const> contents, ASCII const &format, Builder *builder, std::string *error)
 {
-    std::unique_ptr<Object> root = nullptr;
-    std::string             error;
-
-    std::vector<uint8_t> const data = Encodings::Convert(contents, format.encoding(), Encoding::UTF8);
+    /* Parse UTF-8 contents in place; only other encodings need a copy. */
+    std::vector<uint8_t> converted;
+    ext::span<uint8_t const> data = Encodings::RemoveBOM(contents, Encoding::UTF8);
+    if (format.encoding() != Encoding::UTF8) {
+        converted = Encodings::Convert(contents, format.encoding(), Encoding::UTF8);
+        data = converted;
+    }
 
     /* Create lexer. */
     ASCIIPListLexer lexer;
     ASCIIPListLexerInit(&lexer, reinterpret_cast<char const *>(data.data()), data.size(), kASCIIPListLexerStyleASCII);
 
     /* Parse contents. */
-    ASCIIParser parser;
-    if (parser.parse(&lexer, format.strings())) {
-        root = std::move(parser.root());
-    } else {
-        error = parser.error();
+    ASCIIParser parser = ASCIIParser(builder);
+    if (!parser.parse(&lexer, format.strings())) {
+        *error = parser.error();
+        return false;
+    }
+
+    return true;
+}
+
+template<>
+std::pair<std::unique_ptr<Object>, std::string> Format<ASCII>::
+Deserialize(ext::span<uint8_t const> contents, ASCII const &format)
+{
+    ObjectBuilder builder;
+    std::string   error;
+
+    if (!Parse(contents, format, &builder, &error)) {
+        return std::make_pair(nullptr, error);
+    }
+
+    return std::make_pair(std::move(builder.root()), std::string());
+}
+
+template<>
+std::pair<Arena::Object const *, std::string> Format<ASCII>::
+Deserialize(ext::span<uint8_t const> contents, ASCII const &format, Arena::Arena *arena)
+{
+    ArenaBuilder builder = ArenaBuilder(arena);
+    std::string  error;
+
+    if (!Parse(contents, format, &builder, &error)) {
+        return std::make_pair(nullptr, error);
+    }
+
+    return std::make_pair(builder.root(), std::string());
+}
+
+template<>
+std::pair<bool, std::string> Format<ASCII>::
+Visit(ext::span<uint8_t const> contents, ASCII const &format, Visitor *visitor)
+{
+    VisitorBuilder builder = VisitorBuilder(visitor);
+    std::string    error;
+
+    if (!Parse(contents, format, &builder, &error)) {
+        return std::make_pair(false, error);
     }
 
-    return std::make_pair(std::move(root), error);
+    return std::make_pair(true, std::string());
 }
 
 template<>
@@ -13,6 +13,14 @@
 #include <string.h>
 #include <stdlib.h>
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 /*
  * Syntax:
  *
@@ -65,8 +73,228 @@
  *  ASCII:    Not strictly ASCII 7-bit clean - can decode unicode.
  */
 
+/** Block Scanning **/
+
+/*
+ * Long runs of characters that don't end a token are skipped a block at a
+ * time where vector instructions are available. Each block is compared
+ * against the characters of interest, giving a mask with a set bit (or, on
+ * NEON, a set nibble) for each matching byte. Blocks are never read past
+ * the end of the buffer; the rest is scanned a byte at a time.
+ */
+
+#if defined(__AVX2__)
+
+#define BLOCK_SIZE 32
+#define BLOCK_BITS 1
+
+typedef __m256i Block;
+
+static inline Block block_load(char const *p)
+{ return _mm256_loadu_si256(reinterpret_cast<__m256i const *>(p)); }
+static inline Block block_eq(Block v, char c)
+{ return _mm256_cmpeq_epi8(v, _mm256_set1_epi8(c)); }
+static inline Block block_or(Block a, Block b)
+{ return _mm256_or_si256(a, b); }
+static inline Block block_range(Block v, char lo, char hi)
+{
+    /* Unsigned lo <= v <= hi: v - lo saturates to zero past hi - lo. */
+    Block offset = _mm256_sub_epi8(v, _mm256_set1_epi8(lo));
+    Block over   = _mm256_subs_epu8(offset, _mm256_set1_epi8(hi - lo));
+    return _mm256_cmpeq_epi8(over, _mm256_setzero_si256());
+}
+static inline uint64_t block_mask(Block v)
+{ return static_cast<uint32_t>(_mm256_movemask_epi8(v)); }
+
+#elif defined(__SSE2__)
+
+#define BLOCK_SIZE 16
+#define BLOCK_BITS 1
+
+typedef __m128i Block;
+
+static inline Block block_load(char const *p)
+{ return _mm_loadu_si128(reinterpret_cast<__m128i const *>(p)); }
+static inline Block block_eq(Block v, char c)
+{ return _mm_cmpeq_epi8(v, _mm_set1_epi8(c)); }
+static inline Block block_or(Block a, Block b)
+{ return _mm_or_si128(a, b); }
+static inline Block block_range(Block v, char lo, char hi)
+{
+    /* Unsigned lo <= v <= hi: v - lo saturates to zero past hi - lo. */
+    Block offset = _mm_sub_epi8(v, _mm_set1_epi8(lo));
+    Block over   = _mm_subs_epu8(offset, _mm_set1_epi8(hi - lo));
+    return _mm_cmpeq_epi8(over, _mm_setzero_si128());
+}
+static inline uint64_t block_mask(Block v)
+{ return static_cast<uint32_t>(_mm_movemask_epi8(v)); }
+
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+
+#define BLOCK_SIZE 16
+#define BLOCK_BITS 4
+
+typedef uint8x16_t Block;
+
+static inline Block block_load(char const *p)
+{ return vld1q_u8(reinterpret_cast<uint8_t const *>(p)); }
+static inline Block block_eq(Block v, char c)
+{ return vceqq_u8(v, vdupq_n_u8(static_cast<uint8_t>(c))); }
+static inline Block block_or(Block a, Block b)
+{ return vorrq_u8(a, b); }
+static inline Block block_range(Block v, char lo, char hi)
+{
+    Block offset = vsubq_u8(v, vdupq_n_u8(static_cast<uint8_t>(lo)));
+    return vcleq_u8(offset, vdupq_n_u8(static_cast<uint8_t>(hi - lo)));
+}
+static inline uint64_t block_mask(Block v)
+{
+    /* No movemask on NEON: narrow each byte to a nibble instead. */
+    uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(v), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0);
+}
+
+#endif
+
+#if defined(BLOCK_SIZE)
+
+#define BLOCK_ALL (BLOCK_SIZE * BLOCK_BITS == 64 ? ~static_cast<uint64_t>(0) : (static_cast<uint64_t>(1) << (BLOCK_SIZE * BLOCK_BITS)) - 1)
+
+static inline int
+mask_first(uint64_t mask)
+{ return __builtin_ctzll(mask) / BLOCK_BITS; }
+
+static inline int
+mask_last(uint64_t mask)
+{ return (63 - __builtin_clzll(mask)) / BLOCK_BITS; }
+
+static inline int
+mask_count(uint64_t mask)
+{ return __builtin_popcountll(mask) / BLOCK_BITS; }
+
+static inline uint64_t
+mask_before(uint64_t mask, int index)
+{ return mask & ((static_cast<uint64_t>(1) << (index * BLOCK_BITS)) - 1); }
+
+#endif
+
+/*
+ * Find the first of up to four characters (repeat one to look for fewer),
+ * or the end of the buffer.
+ */
+static inline char const *
+scan_any(char const *p, char const *end, char a, char b, char c, char d)
+{
+#if defined(BLOCK_SIZE)
+    for (; end - p >= BLOCK_SIZE; p += BLOCK_SIZE) {
+        Block v = block_load(p);
+        uint64_t mask = block_mask(block_or(block_or(block_eq(v, a), block_eq(v, b)),
+                                            block_or(block_eq(v, c), block_eq(v, d))));
+        if (mask != 0) {
+            return p + mask_first(mask);
+        }
+    }
+#endif
+
+    for (; p < end; p++) {
+        if (*p == a || *p == b || *p == c || *p == d) {
+            break;
+        }
+    }
+
+    return p;
+}
+
+/*
+ * Skip spaces, tabs, form feeds, and line ends, counting lines.
+ */
+static inline char const *
+scan_space(ASCIIPListLexer *lexer, char const *p)
+{
+    char const *end = lexer->endBuffer;
+
+    /* Most runs are a single space or a line end and indentation. */
+    for (char const *prefix = p + 8; p < prefix && p < end; p++) {
+        if (*p == '\n') {
+            lexer->line++;
+            lexer->lineStart = p + 1;
+        } else if (*p != ' ' && *p != '\t' && *p != '\f' && *p != '\r') {
+            return p;
+        }
+    }
+
+#if defined(BLOCK_SIZE)
+    for (; end - p >= BLOCK_SIZE; p += BLOCK_SIZE) {
+        Block v = block_load(p);
+        Block newline = block_eq(v, '\n');
+        Block space = block_or(block_or(block_eq(v, ' '), block_eq(v, '\t')),
+                               block_or(block_or(block_eq(v, '\f'), block_eq(v, '\r')), newline));
+
+        uint64_t lines = block_mask(newline);
+        uint64_t other = ~block_mask(space) & BLOCK_ALL;
+        if (other != 0) {
+            int index = mask_first(other);
+            lines = mask_before(lines, index);
+            if (lines != 0) {
+                lexer->line += mask_count(lines);
+                lexer->lineStart = p + mask_last(lines) + 1;
+            }
+            return p + index;
+        }
+
+        if (lines != 0) {
+            lexer->line += mask_count(lines);
+            lexer->lineStart = p + mask_last(lines) + 1;
+        }
+    }
+#endif
+
+    for (; p < end; p++) {
+        if (*p == '\n') {
+            lexer->line++;
+            lexer->lineStart = p + 1;
+        } else if (*p != ' ' && *p != '\t' && *p != '\f' && *p != '\r') {
+            break;
+        }
+    }
+
+    return p;
+}
+
+/*
+ * Skip the ASCII characters allowed in unquoted strings. Object identifiers
+ * and most other unquoted strings in project files fit in a block or two.
+ */
+static inline char const *
+scan_unquoted(char const *p, char const *end)
+{
+#if defined(BLOCK_SIZE)
+    for (; end - p >= BLOCK_SIZE; p += BLOCK_SIZE) {
+        Block v = block_load(p);
+        /* '-', '.', '/', digits, and ':' are contiguous. */
+        Block allowed = block_or(block_or(block_range(v, '-', ':'), block_range(v, 'A', 'Z')),
+                                 block_or(block_range(v, 'a', 'z'), block_or(block_eq(v, '_'), block_eq(v, '$'))));
+
+        uint64_t other = ~block_mask(allowed) & BLOCK_ALL;
+        if (other != 0) {
+            return p + mask_first(other);
+        }
+    }
+#endif
+
+    return p;
+}
+
 /** Helpers **/
 
+/*
+ * The character at a position, or NUL past the end of the buffer. The buffer
+ * need not be NUL-terminated.
+ */
+static inline char
+peek(ASCIIPListLexer const *lexer, char const *p)
+{ return (p < lexer->endBuffer ? *p : '\0'); }
+
 static inline bool
 istokenseparator(char ch, ASCIIPListLexer *lexer)
 {
@@ -106,8 +334,8 @@ ASCIIPListLexerReadInlineComment(ASCIIPListLexer *lexer)
     char const *b, *p = lexer->pointer + 2;
 
     lexer->tokenBegin = (p - lexer->inputBuffer);
-    for (b = p; *p != '\0' && *p != '\n' && *p != '\r'; p++)
-        ;
+    b = p;
+    p = scan_any(p, lexer->endBuffer, '\0', '\n', '\r', '\r');
     lexer->tokenLength = p - b;
     lexer->pointer = p;
 
@@ -120,11 +348,11 @@ ASCIIPListLexerReadLongComment(ASCIIPListLexer *lexer)
     char const *b, *p = lexer->pointer + 2;
 
     lexer->tokenBegin = (p - lexer->inputBuffer);
-    for (b = p; *p != '\0'; p++) {
+    for (b = p; (p = scan_any(p, lexer->endBuffer, '\0', '\n', '*', '*')) < lexer->endBuffer && *p != '\0'; p++) {
         if (p[0] == '\n') {
             lexer->line++;
             lexer->lineStart = p + 1;
-        } else if (p[0] == '*' && p[1] == '/') {
+        } else if (p[0] == '*' && peek(lexer, p + 1) == '/') {
             lexer->tokenLength = p - b;
             lexer->pointer = p + 2;
             return kASCIIPListLexerTokenLongComment;
@@ -140,14 +368,14 @@ ASCIIPListLexerReadSingleQuotedString(ASCIIPListLexer *lexer)
     char const *b, *p = lexer->pointer + 1;
 
     lexer->tokenBegin = (p - lexer->inputBuffer);
-    for (b = p; *p != '\'' && *p != '\0'; p++) {
+    for (b = p; (p = scan_any(p, lexer->endBuffer, '\'', '\0', '\n', '\n')) < lexer->endBuffer && *p != '\'' && *p != '\0'; p++) {
         if (*p == '\n') {
             lexer->line++;
             lexer->lineStart = p + 1;
         }
     }
 
-    if (*p != '\'') {
+    if (peek(lexer, p) != '\'') {
         return kASCIIPListLexerUnterminatedQuotedString;
     }
 
@@ -163,16 +391,19 @@ ASCIIPListLexerReadDoubleQuotedString(ASCIIPListLexer *lexer)
     char const *b, *p = lexer->pointer + 1;
 
     lexer->tokenBegin = (p - lexer->inputBuffer);
-    for (b = p; *p != '\"' && *p != '\0'; p++) {
+    for (b = p; (p = scan_any(p, lexer->endBuffer, '\"', '\0', '\n', '\\')) < lexer->endBuffer && *p != '\"' && *p != '\0'; p++) {
         if (*p == '\n') {
             lexer->line++;
             lexer->lineStart = p + 1;
         } else if (*p == '\\') {
+            if (p + 1 == lexer->endBuffer) {
+                break;
+            }
             p++;
         }
     }
 
-    if (*p != '\"') {
+    if (peek(lexer, p) != '\"') {
         return kASCIIPListLexerUnterminatedQuotedString;
     }
 
@@ -188,7 +419,7 @@ ASCIIPListLexerReadData(ASCIIPListLexer *lexer)
     char const *b, *p = lexer->pointer + 1;
 
     lexer->tokenBegin = (p - lexer->inputBuffer);
-    for (b = p; *p != '>' && *p != '\0'; p++) {
+    for (b = p; peek(lexer, p) != '>' && peek(lexer, p) != '\0'; p++) {
         if (*p == '\n') {
             lexer->line++;
             lexer->lineStart = p + 1;
@@ -202,7 +433,7 @@ ASCIIPListLexerReadData(ASCIIPListLexer *lexer)
         }
     }
 
-    if (*p != '>')
+    if (peek(lexer, p) != '>')
         return kASCIIPListLexerUnterminatedData;
 
     lexer->tokenLength = p - b;
@@ -232,53 +463,53 @@ ASCIIPListLexerReadJSONNumber(ASCIIPListLexer *lexer)
 
     lexer->tokenBegin = (p - lexer->inputBuffer);
 
-    if (*p == '-') {
+    if (peek(lexer, p) == '-') {
         p++;
     }
 
-    if (!isdigit(*p)) {
+    if (!isdigit(peek(lexer, p))) {
         return kASCIIPListLexerInvalidToken;
     }
-    bool zero = (*p == '0');
-    while (isdigit(*p)) {
+    bool zero = (peek(lexer, p) == '0');
+    while (isdigit(peek(lexer, p))) {
         /* Numbers cannot start with zero. */
-        if (zero && *p != '0') {
+        if (zero && peek(lexer, p) != '0') {
             return kASCIIPListLexerInvalidToken;
         }
 
         p++;
     }
 
-    if (*p == '.') {
+    if (peek(lexer, p) == '.') {
         integer = false;
 
         p++;
 
-        if (!isdigit(*p)) {
+        if (!isdigit(peek(lexer, p))) {
             return kASCIIPListLexerInvalidToken;
         }
-        while (isdigit(*p)) {
+        while (isdigit(peek(lexer, p))) {
             p++;
         }
     }
 
-    if (*p == 'e' || *p == 'E') {
+    if (peek(lexer, p) == 'e' || peek(lexer, p) == 'E') {
         integer = false;
 
         p++;
-        if (*p == '+' || *p == '-') {
+        if (peek(lexer, p) == '+' || peek(lexer, p) == '-') {
             p++;
         }
 
-        if (!isdigit(*p)) {
+        if (!isdigit(peek(lexer, p))) {
             return kASCIIPListLexerInvalidToken;
         }
-        while (isdigit(*p)) {
+        while (isdigit(peek(lexer, p))) {
             p++;
         }
     }
 
-    if (istokenseparator(*p, lexer)) {
+    if (istokenseparator(peek(lexer, p), lexer)) {
         lexer->tokenLength = p - b;
         lexer->pointer = p;
         return (integer ? kASCIIPListLexerTokenNumberInteger : kASCIIPListLexerTokenNumberReal);
@@ -297,26 +528,29 @@ ASCIIPListLexerReadKeyword(ASCIIPListLexer *lexer)
     lexer->tokenBegin = p - lexer->inputBuffer;
 
     if (lexer->style == kASCIIPListLexerStyleJSON) {
-        if (*p == 't' && strncmp(p, "true", 4) == 0 &&
-            istokenseparator(*(p + 4), lexer)) {
+        size_t avail = lexer->endBuffer - p;
+        if (avail >= 4 && strncmp(p, "true", 4) == 0 &&
+            istokenseparator(peek(lexer, p + 4), lexer)) {
             p += 4;
             rc = kASCIIPListLexerTokenBoolTrue;
-        } else if (*p == 'f' && strncmp(p, "false", 5) == 0 &&
-                   istokenseparator(*(p + 5), lexer)) {
+        } else if (avail >= 5 && strncmp(p, "false", 5) == 0 &&
+                   istokenseparator(peek(lexer, p + 5), lexer)) {
             p += 5;
             rc = kASCIIPListLexerTokenBoolFalse;
-        } else if (*p == 'n' && strncmp(p, "null", 4) == 0 &&
-                   istokenseparator(*(p + 4), lexer)) {
+        } else if (avail >= 4 && strncmp(p, "null", 4) == 0 &&
+                   istokenseparator(peek(lexer, p + 4), lexer)) {
             p += 4;
             rc = kASCIIPListLexerTokenNull;
         }
     } else if (lexer->style == kASCIIPListLexerStyleASCII) {
         rc = kASCIIPListLexerTokenUnquotedString;
+        p = scan_unquoted(p, lexer->endBuffer);
         /*
             * '$' is encountered in pbxproj files.
             */
-        while (isalnum(*p) || *p == '_' || *p == '.' || *p == '$' ||
-                              *p == '-' || *p == ':' || *p == '/') {
+        while (p < lexer->endBuffer &&
+               (isalnum(*p) || *p == '_' || *p == '.' || *p == '$' ||
+                               *p == '-' || *p == ':' || *p == '/')) {
             if (*p & 0x80) {
                 rc = kASCIIPListLexerInvalidToken;
                 break;
@@ -340,10 +574,10 @@ ASCIIPListLexerReadToken(ASCIIPListLexer *lexer)
     while (p < lexer->endBuffer) {
         switch (*p) {
             case '/': /* Comments */
-                if (p[1] == '/') {
+                if (peek(lexer, p + 1) == '/') {
                     lexer->pointer = p;
                     return ASCIIPListLexerReadInlineComment(lexer);
-                } else if (p[1] == '*') {
+                } else if (peek(lexer, p + 1) == '*') {
                     lexer->pointer = p;
                     return ASCIIPListLexerReadLongComment(lexer);
                 } else {
@@ -441,12 +675,8 @@ ASCIIPListLexerReadToken(ASCIIPListLexer *lexer)
                 lexer->pointer = p;
                 return ASCIIPListLexerReadKeyword(lexer);
 
-            case ' ': case '\f': case '\t': case '\r':
-                 p++;
-                 break;
-
-            case '\n':
-                 p++, lexer->line++; lexer->lineStart = p;
+            case ' ': case '\f': case '\t': case '\r': case '\n':
+                 p = scan_space(lexer, p);
                  break;
 
             default:
@@ -627,6 +857,14 @@ deunicodify(char **pp, int avail, int *eat)
 
 /* Unquoted string copy */
 
+int
+ASCIIPListLexerTokenNeedsUnquoting(ASCIIPListLexer const *lexer)
+{
+    char const *p   = lexer->inputBuffer + lexer->tokenBegin;
+    char const *end = p + lexer->tokenLength;
+    return (scan_any(p, end, '\\', '\0', '\0', '\0') != end);
+}
+
 char *
 ASCIIPListCopyUnquotedString(ASCIIPListLexer const *lexer, int lossByte)
 {
@@ -7,24 +7,18 @@
  */
 
 #include <plist/Format/ASCIIParser.h>
-#include <plist/Objects.h>
 
 #include <cstdlib>
 
 using plist::Format::ASCIIParser;
-using plist::Object;
-using plist::String;
-using plist::Data;
-using plist::Array;
-using plist::Dictionary;
+using plist::Format::Builder;
 
 ASCIIParser::
-ASCIIParser() :
-    _root(nullptr),
+ASCIIParser(Builder *builder) :
+    _builder(builder),
+    _root(false),
     _level(0),
     _state(ValueState::Init),
-    _container(nullptr),
-    _key(nullptr),
     _contextState(ContextState::Parsing)
 {
 }
@@ -77,7 +71,7 @@ abort(std::string const &error, int line)
 }
 
 bool ASCIIParser::
-push(ValueState state, std::unique_ptr<plist::Object> container, std::unique_ptr<plist::String> key)
+push(ValueState state)
 {
     if (isAborted()) {
         return false;
@@ -86,25 +80,10 @@ push(ValueState state, std::unique_ptr<plist::Object> container, std::unique_ptr
     /* If valid state, push, otherwise just set the new state. */
     if (_state != ValueState::Init) {
         /* Push the old state */
-        _containerStack.push(std::move(_container));
-        _keyStack.push(std::move(_key));
         _stateStack.push(_state);
     }
 
     _state = state;
-
-    if (container != nullptr) {
-        _container = std::move(container);
-    } else {
-        _container = nullptr;
-    }
-
-    if (key != nullptr) {
-        _key = std::move(key);
-    } else {
-        _key = nullptr;
-    }
-
     return true;
 }
 
@@ -118,9 +97,6 @@ pop()
             return false; /* Underflow! */
 
         /* Reset current state. */
-        _container = nullptr;
-        _key = nullptr;
-
         _state = ValueState::Init;
         return true;
     }
@@ -129,76 +105,60 @@ pop()
     _state = std::move(_stateStack.top());
     _stateStack.pop();
 
-    _container = std::move(_containerStack.top());
-    _containerStack.pop();
-
-    _key = std::move(_keyStack.top());
-    _keyStack.pop();
-
     return true;
 }
 
 /*
- * Generic container handling.
+ * Check that a value can be stored in the current state.
  */
 bool ASCIIParser::
-beginContainer(std::unique_ptr<plist::Object> object)
+beginValue()
 {
-    ValueState state;
+    switch (_state) {
+        case ValueState::Init:
+            /* Value is the root. */
+            if (_root) {
+                abort("Double root.");
+                return false;
+            }
 
-    if (object->type() == Array::Type()) {
-        state = ValueState::Array;
-    } else {
-        state = ValueState::Dictionary;
-    }
+            _root = true;
+            return true;
 
-    if (!push(state, std::move(object), nullptr)) {
-        abort("Cannot push the current state.");
-        return false;
+        case ValueState::DictionaryValue:
+            _state = ValueState::Dictionary;
+            return true;
+
+        case ValueState::Array:
+            return true;
+
+        case ValueState::Dictionary:
+            abort("Storing value with no array container.");
+            return false;
     }
 
-    return true;
+    return false;
 }
 
+/*
+ * Generic container handling.
+ */
 bool ASCIIParser::
-storeKeyValue(std::unique_ptr<plist::String> key, std::unique_ptr<plist::Object> value)
+beginContainer(bool isArray)
 {
-    if (_container == nullptr) {
-        if (_key != nullptr) {
-            abort("Storing key/value pair with no container.");
-            return false;
-        }
-
-        /* Make current value the root. */
-        if (_root != nullptr) {
-            abort("Double root.");
-            return false;
-        }
-
-        _root = std::move(value);
-        return true;
+    if (!beginValue()) {
+        return false;
     }
 
-    if (key != nullptr) {
-        if (_container->type() != Dictionary::Type()) {
-            abort("Storing key/value with no dictionary container.");
-            return false;
-        }
-
-        plist::Dictionary *dict = static_cast<plist::Dictionary *>(_container.get());
-        dict->set(key->value(), std::move(value));
+    if (!push(isArray ? ValueState::Array : ValueState::Dictionary)) {
+        abort("Cannot push the current state.");
+        return false;
+    }
 
-        _state = ValueState::Dictionary;
+    if (isArray) {
+        _builder->beginArray();
     } else {
-        if (_container->type() != Array::Type()) {
-            abort("Storing value with no array container.");
-            return false;
-        }
-
-        plist::Array *array = static_cast<plist::Array *>(_container.get());
-        array->append(std::move(value));
-
-        _state = ValueState::Array;
+        _builder->beginDictionary();
     }
 
     return true;
@@ -207,58 +167,30 @@ storeKeyValue(std::unique_ptr<plist::String> key, std::unique_ptr<plist::Object>
 bool ASCIIParser::
 endContainer(bool isArray)
 {
-    std::unique_ptr<plist::String> key;
-    std::unique_ptr<plist::Object> value;
-    bool success;
-
     /* Check state is consistant. */
     if (_state != (isArray ? ValueState::Array : ValueState::Dictionary)) {
         abort("Closing array/dictionary in wrong state.");
         return false;
     }
 
-    if (_container == nullptr) {
-        abort("Closing non-opened container.");
-        return false;
-    }
-
-    value = std::move(_container);
-    if (value == nullptr) {
-        abort("Couldn't copy container.");
-        return false;
-    }
-
-    /* Is this the right type of container? */
-    if (value->type() != (isArray ? Array::Type() : Dictionary::Type())) {
-        abort("Closing wrong kind of container.");
-        return false;
-    }
-
     if (!pop()) {
         abort("Parser stack underflow.");
         return false;
     }
 
-    /* Take ownership of the saved key. */
-    key = std::move(_key);
-    _key = nullptr;
-
-    success = storeKeyValue(std::move(key), std::move(value));
+    if (isArray) {
+        _builder->endArray();
+    } else {
+        _builder->endDictionary();
+    }
 
-    return success;
+    return true;
 }
 
 bool ASCIIParser::
 beginArray()
 {
-    std::unique_ptr<plist::Array> array = Array::New();
-    if (array == nullptr) {
-        abort("Cannot create an array.");
-        return false;
-    }
-
-    bool success = beginContainer(std::move(array));
-    return success;
+    return beginContainer(true);
 }
 
 bool ASCIIParser::
@@ -270,14 +202,7 @@ endArray()
 bool ASCIIParser::
 beginDictionary()
 {
-    std::unique_ptr<plist::Dictionary> dict = Dictionary::New();
-    if (dict == nullptr) {
-        abort("Cannot create a dictionary.");
-        return false;
-    }
-
-    bool success = beginContainer(std::move(dict));
-    return success;
+    return beginContainer(false);
 }
 
 bool ASCIIParser::
@@ -290,41 +215,39 @@ endDictionary()
  * Store the key of the current dictionary.
  */
 bool ASCIIParser::
-storeKey(std::unique_ptr<plist::String> key)
+storeKey(std::string &&key)
 {
-    if (key == nullptr) {
-        key = String::New();
-
-        if (key == nullptr) {
-            abort("Cannot create empty key.");
-            return false;
-        }
-    }
-
     if (_state != ValueState::Dictionary) {
         abort("Storing key in wrong state.");
         return false;
     }
 
-    _key = std::move(key);
+    _builder->key(std::move(key));
 
     _state = ValueState::DictionaryValue;
     return true;
 }
 
 bool ASCIIParser::
-storeValue(std::unique_ptr<plist::Object> value)
+storeString(std::string &&value)
 {
-    bool success;
+    if (!beginValue()) {
+        return false;
+    }
 
-    success = storeKeyValue(std::move(_key), std::move(value));
-    _key = nullptr;
+    _builder->string(std::move(value));
+    return true;
+}
 
-    if (_state == ValueState::DictionaryValue) {
-        _state = ValueState::Dictionary;
+bool ASCIIParser::
+storeData(std::vector<uint8_t> &&value)
+{
+    if (!beginValue()) {
+        return false;
     }
 
-    return success;
+    _builder->data(std::move(value));
+    return true;
 }
 
 bool ASCIIParser::
@@ -505,24 +428,30 @@ parse(ASCIIPListLexer *lexer, bool strings)
 
                     if (token == kASCIIPListLexerTokenUnquotedString ||
                         token == kASCIIPListLexerTokenQuotedString) {
-                        char *contents = ASCIIPListCopyUnquotedString(lexer, '?');
-                        std::unique_ptr<String> string = String::New(std::string(contents));
-                        free(contents);
+                        std::string string;
+                        if (!ASCIIPListLexerTokenNeedsUnquoting(lexer)) {
+                            /* Most strings have no escapes; take them directly. */
+                            string = std::string(lexer->inputBuffer + lexer->tokenBegin, lexer->tokenLength);
+                        } else {
+                            char *contents = ASCIIPListCopyUnquotedString(lexer, '?');
+                            if (contents == NULL) {
+                                abort("OOM when copying string", lexer->line);
+                                return false;
+                            }
 
-                        if (string == NULL) {
-                            abort("OOM when copying string", lexer->line);
-                            return false;
+                            string = std::string(contents);
+                            free(contents);
                         }
 
                         /* Container context */
                         if (isDictionary) {
-                            ASCIIDebug("Storing string %s as key", string->value().c_str());
+                            ASCIIDebug("Storing string %s as key", string.c_str());
                             if (!storeKey(std::move(string))) {
                                 return false;
                             }
                         } else {
-                            ASCIIDebug("Storing string %s", string->value().c_str());
-                            if (!storeValue(std::move(string))) {
+                            ASCIIDebug("Storing string %s", string.c_str());
+                            if (!storeString(std::move(string))) {
                                 return false;
                             }
                         }
@@ -541,16 +470,10 @@ parse(ASCIIPListLexer *lexer, bool strings)
                             bytes[n >> 1] = hex_to_bin(contents + n);
                         }
 
-                        std::unique_ptr<Data> data = Data::New(bytes);
                         free(contents);
 
-                        if (data == NULL) {
-                            abort("OOM when copying data", lexer->line);
-                            return false;
-                        }
-
                         ASCIIDebug("Storing string as data");
-                        if (!storeValue(std::move(data))) {
+                        if (!storeData(std::move(bytes))) {
                             return false;
                         }
                     } else {
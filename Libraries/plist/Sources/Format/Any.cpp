@@ -56,7 +56,7 @@ namespace plist { namespace Format {
 
 template<typename T>
 static std::unique_ptr<Any>
-IdentifyImpl(std::vector<uint8_t> const &contents)
+IdentifyImpl(ext::span<uint8_t const> contents)
 {
     std::unique_ptr<T> format = T::Identify(contents);
     if (format != nullptr) {
@@ -68,7 +68,7 @@ IdentifyImpl(std::vector<uint8_t> const &contents)
 
 template<>
 std::unique_ptr<Any> Format<Any>::
-Identify(std::vector<uint8_t> const &contents)
+Identify(ext::span<uint8_t const> contents)
 {
 #define FORMAT(T) \
     { \
@@ -89,14 +89,14 @@ Identify(std::vector<uint8_t> const &contents)
 
 template<typename T>
 static std::pair<std::unique_ptr<Object>, std::string>
-DeserializeImpl(std::vector<uint8_t> const &contents, Any const &format)
+DeserializeImpl(ext::span<uint8_t const> contents, Any const &format)
 {
     return T::Deserialize(contents, *format.format<T>());
 }
 
 template<>
 std::pair<std::unique_ptr<Object>, std::string> Format<Any>::
-Deserialize(std::vector<uint8_t> const &contents, Any const &format)
+Deserialize(ext::span<uint8_t const> contents, Any const &format)
 {
     switch (format.type()) {
         case Type::Binary:
@@ -110,6 +110,52 @@ Deserialize(std::vector<uint8_t> const &contents, Any const &format)
     abort();
 }
 
+template<typename T>
+static std::pair<Arena::Object const *, std::string>
+DeserializeImpl(ext::span<uint8_t const> contents, Any const &format, Arena::Arena *arena)
+{
+    return T::Deserialize(contents, *format.format<T>(), arena);
+}
+
+template<>
+std::pair<Arena::Object const *, std::string> Format<Any>::
+Deserialize(ext::span<uint8_t const> contents, Any const &format, Arena::Arena *arena)
+{
+    switch (format.type()) {
+        case Type::Binary:
+            return DeserializeImpl<Binary>(contents, format, arena);
+        case Type::XML:
+            return DeserializeImpl<XML>(contents, format, arena);
+        case Type::ASCII:
+            return DeserializeImpl<ASCII>(contents, format, arena);
+    }
+
+    abort();
+}
+
+template<typename T>
+static std::pair<bool, std::string>
+VisitImpl(ext::span<uint8_t const> contents, Any const &format, Visitor *visitor)
+{
+    return T::Visit(contents, *format.format<T>(), visitor);
+}
+
+template<>
+std::pair<bool, std::string> Format<Any>::
+Visit(ext::span<uint8_t const> contents, Any const &format, Visitor *visitor)
+{
+    switch (format.type()) {
+        case Type::Binary:
+            return VisitImpl<Binary>(contents, format, visitor);
+        case Type::XML:
+            return VisitImpl<XML>(contents, format, visitor);
+        case Type::ASCII:
+            return VisitImpl<ASCII>(contents, format, visitor);
+    }
+
+    abort();
+}
+
 template<typename T>
 static std::pair<std::unique_ptr<std::vector<uint8_t>>, std::string>
 SerializeImpl(Object const *object, Any const &format)
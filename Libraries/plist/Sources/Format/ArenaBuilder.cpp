@@ -0,0 +1,163 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree.
+ */
+
+#include <plist/Format/ArenaBuilder.h>
+
+#include <cstring>
+
+using plist::Format::ArenaBuilder;
+
+ArenaBuilder::
+ArenaBuilder(Arena::Arena *arena) :
+    _arena(arena),
+    _root (nullptr),
+    _key  (nullptr)
+{
+}
+
+ArenaBuilder::
+~ArenaBuilder()
+{
+}
+
+void ArenaBuilder::
+add(Arena::Object const *value)
+{
+    if (_containers.empty()) {
+        _root = value;
+    } else {
+        _members.push_back({ _key, value });
+        _key = nullptr;
+    }
+}
+
+void ArenaBuilder::
+begin()
+{
+    /* Save the key for the container itself until it ends. */
+    _containers.push_back({ _members.size(), _key });
+    _key = nullptr;
+}
+
+bool ArenaBuilder::
+end(size_t *start)
+{
+    if (_containers.empty()) {
+        return false;
+    }
+
+    Container container = _containers.back();
+    _containers.pop_back();
+
+    *start = container.start;
+    _key = container.key;
+    return true;
+}
+
+void ArenaBuilder::
+beginArray()
+{
+    begin();
+}
+
+void ArenaBuilder::
+endArray()
+{
+    size_t start;
+    if (!end(&start)) {
+        return;
+    }
+
+    _values.clear();
+    for (auto it = _members.begin() + start; it != _members.end(); ++it) {
+        _values.push_back(it->value);
+    }
+    _members.resize(start);
+
+    add(Arena::Array::New(_arena, _values.data(), _values.size()));
+}
+
+void ArenaBuilder::
+beginDictionary()
+{
+    begin();
+}
+
+void ArenaBuilder::
+endDictionary()
+{
+    size_t start;
+    if (!end(&start)) {
+        return;
+    }
+
+    Arena::Dictionary const *dict = Arena::Dictionary::New(_arena, _members.data() + start, _members.size() - start);
+    _members.resize(start);
+
+    add(dict);
+}
+
+void ArenaBuilder::
+key(std::string &&key)
+{
+    _key = _arena->string(key);
+}
+
+void ArenaBuilder::
+string(std::string &&value)
+{
+    add(_arena->string(value));
+}
+
+void ArenaBuilder::
+integer(int64_t value)
+{
+    add(_arena->create<Arena::Integer>(value));
+}
+
+void ArenaBuilder::
+real(double value)
+{
+    add(_arena->create<Arena::Real>(value));
+}
+
+void ArenaBuilder::
+boolean(bool value)
+{
+    add(_arena->create<Arena::Boolean>(value));
+}
+
+void ArenaBuilder::
+null()
+{
+    add(_arena->create<Arena::Null>());
+}
+
+void ArenaBuilder::
+data(std::vector<uint8_t> &&value)
+{
+    uint8_t *bytes = nullptr;
+    if (!value.empty()) {
+        bytes = static_cast<uint8_t *>(_arena->allocate(value.size(), 1));
+        ::memcpy(bytes, value.data(), value.size());
+    }
+
+    add(_arena->create<Arena::Data>(bytes, value.size()));
+}
+
+void ArenaBuilder::
+date(struct tm const &value)
+{
+    add(_arena->create<Arena::Date>(value));
+}
+
+void ArenaBuilder::
+uid(uint32_t value)
+{
+    add(_arena->create<Arena::UID>(value));
+}
@@ -53,7 +53,7 @@ CreateXmlReaderImpl(IMalloc *pMalloc)
 
 #if __MINGW32__
     /* MinGW is missing the library to link against XmlLite. */
-    std::once_flag flag;
+    static std::once_flag flag;
     std::call_once(flag, []{
         HMODULE module = LoadLibraryA("XmlLite.dll");
         if (module == nullptr) {
@@ -79,15 +79,28 @@ CreateXmlReaderImpl(IMalloc *pMalloc)
 
     return reader;
 }
+#else
+/*
+ * libxml2 sets up its global state the first time it parses, which isn't
+ * safe to do from several threads at once. Do it once before any parsing.
+ */
+static void
+InitializeParser()
+{
+    static std::once_flag flag;
+    std::call_once(flag, [] {
+        ::xmlInitParser();
+    });
+}
 #endif
 
 bool BaseXMLParser::
-parse(std::vector<uint8_t> const &contents)
+parse(ext::span<uint8_t const> contents)
 {
     _errored = false;
 
 #if _WIN32
-    std::vector<uint8_t> contents_ = contents;
+    std::vector<uint8_t> contents_ = std::vector<uint8_t>(contents.begin(), contents.end());
 
     bool wine = (GetProcAddress(GetModuleHandle("ntdll.dll"), "wine_get_version") != nullptr);
     if (wine) {
@@ -286,6 +299,8 @@ parse(std::vector<uint8_t> const &contents)
 
     return (ret == S_FALSE);
 #else
+    InitializeParser();
+
     _parser = ::xmlReaderForMemory(reinterpret_cast<char const *>(contents.data()), contents.size(), nullptr, nullptr, XML_PARSE_NOENT | XML_PARSE_NONET);
     if (_parser == nullptr) {
         return false;
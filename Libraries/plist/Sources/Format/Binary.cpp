@@ -10,6 +10,9 @@
 #include <plist/Format/ABPContext.h>
 #include <plist/Format/ABPReader.h>
 #include <plist/Format/ABPWriter.h>
+#include <plist/Format/ObjectBuilder.h>
+#include <plist/Format/ArenaBuilder.h>
+#include <plist/Format/VisitorBuilder.h>
 #include <plist/Objects.h>
 
 #include <cerrno>
@@ -18,6 +21,11 @@
 using plist::Format::Type;
 using plist::Format::Format;
 using plist::Format::Binary;
+using plist::Format::Builder;
+using plist::Format::ObjectBuilder;
+using plist::Format::ArenaBuilder;
+using plist::Format::VisitorBuilder;
+using plist::Format::Visitor;
 using plist::Object;
 
 Binary::
@@ -35,7 +43,7 @@ namespace plist { namespace Format {
 
 template<>
 std::unique_ptr<Binary> Format<Binary>::
-Identify(std::vector<uint8_t> const &contents)
+Identify(ext::span<uint8_t const> contents)
 {
     size_t length = strlen(ABPLIST_MAGIC ABPLIST_VERSION);
 
@@ -50,22 +58,64 @@ Identify(std::vector<uint8_t> const &contents)
     return nullptr;
 }
 
-template<>
-std::pair<std::unique_ptr<Object>, std::string> Format<Binary>::
-Deserialize(std::vector<uint8_t> const &contents, Binary const &format)
+static bool
+Parse(ext::span<uint8_t const> contents, Builder *builder, std::string *error)
 {
-    ABPReader reader = ABPReader(&contents);
+    ABPReader reader = ABPReader(contents);
 
-    std::unique_ptr<Object> object = nullptr;
+    bool success = false;
     if (reader.open()) {
-        Object *topObject = reader.readTopLevelObject();
-        if (topObject != nullptr) {
-            object = topObject->copy();
-        }
+        success = reader.readTopLevelObject(builder);
         reader.close();
     }
 
-    return std::make_pair(std::move(object), reader.error());
+    if (!success) {
+        *error = reader.error();
+    }
+
+    return success;
+}
+
+template<>
+std::pair<std::unique_ptr<Object>, std::string> Format<Binary>::
+Deserialize(ext::span<uint8_t const> contents, Binary const &format)
+{
+    ObjectBuilder builder;
+    std::string   error;
+
+    if (!Parse(contents, &builder, &error)) {
+        return std::make_pair(nullptr, error);
+    }
+
+    return std::make_pair(std::move(builder.root()), std::string());
+}
+
+template<>
+std::pair<Arena::Object const *, std::string> Format<Binary>::
+Deserialize(ext::span<uint8_t const> contents, Binary const &format, Arena::Arena *arena)
+{
+    ArenaBuilder builder = ArenaBuilder(arena);
+    std::string  error;
+
+    if (!Parse(contents, &builder, &error)) {
+        return std::make_pair(nullptr, error);
+    }
+
+    return std::make_pair(builder.root(), std::string());
+}
+
+template<>
+std::pair<bool, std::string> Format<Binary>::
+Visit(ext::span<uint8_t const> contents, Binary const &format, Visitor *visitor)
+{
+    VisitorBuilder builder = VisitorBuilder(visitor);
+    std::string    error;
+
+    if (!Parse(contents, &builder, &error)) {
+        return std::make_pair(false, error);
+    }
+
+    return std::make_pair(true, std::string());
 }
 
 template<>
@@ -0,0 +1,429 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree.
+ */
+
+#include <plist/Format/BinaryView.h>
+#include <plist/Format/ABPReader.h>
+#include <plist/Format/ABPRecordType.h>
+#include <plist/Format/ObjectBuilder.h>
+
+#include <algorithm>
+#include <functional>
+
+using plist::Format::BinaryView;
+using plist::Format::Builder;
+using plist::Format::ObjectBuilder;
+using plist::ObjectType;
+
+/*
+ * Dictionaries with more keys than this are indexed on their first lookup;
+ * smaller ones are cheaper to search directly.
+ */
+static size_t const IndexThreshold = 8;
+
+namespace {
+
+/*
+ * Receives a single value. Containers are never read into it.
+ */
+class ValueBuilder : public Builder {
+private:
+    std::string          _string;
+    int64_t              _integer;
+    double               _real;
+    bool                 _boolean;
+    std::vector<uint8_t> _data;
+    struct tm            _date;
+    uint32_t             _uid;
+
+public:
+    ValueBuilder() :
+        _integer(0),
+        _real   (0.0),
+        _boolean(false),
+        _date   (tm()),
+        _uid    (0)
+    {
+    }
+
+public:
+    void beginArray() override { }
+    void endArray() override { }
+    void beginDictionary() override { }
+    void endDictionary() override { }
+    void key(std::string &&key) override { }
+
+public:
+    void string(std::string &&value) override
+    { _string = std::move(value); }
+    void integer(int64_t value) override
+    { _integer = value; }
+    void real(double value) override
+    { _real = value; }
+    void boolean(bool value) override
+    { _boolean = value; }
+    void null() override { }
+    void data(std::vector<uint8_t> &&value) override
+    { _data = std::move(value); }
+    void date(struct tm const &value) override
+    { _date = value; }
+    void uid(uint32_t value) override
+    { _uid = value; }
+
+public:
+    std::string &string()
+    { return _string; }
+    int64_t integer() const
+    { return _integer; }
+    double real() const
+    { return _real; }
+    bool boolean() const
+    { return _boolean; }
+    std::vector<uint8_t> &data()
+    { return _data; }
+    struct tm const &date() const
+    { return _date; }
+    uint32_t uid() const
+    { return _uid; }
+};
+
+}
+
+static ObjectType
+RecordObjectType(int type)
+{
+    switch (type) {
+        case kABPRecordTypeNull:
+            return ObjectType::Null;
+        case kABPRecordTypeBoolTrue:
+        case kABPRecordTypeBoolFalse:
+            return ObjectType::Boolean;
+        case kABPRecordTypeDate:
+            return ObjectType::Date;
+        case kABPRecordTypeInteger:
+            return ObjectType::Integer;
+        case kABPRecordTypeReal:
+            return ObjectType::Real;
+        case kABPRecordTypeData:
+            return ObjectType::Data;
+        case kABPRecordTypeStringASCII:
+        case kABPRecordTypeStringUnicode:
+            return ObjectType::String;
+        case kABPRecordTypeUid:
+            return ObjectType::UID;
+        case kABPRecordTypeArray:
+            return ObjectType::Array;
+        case kABPRecordTypeDictionary:
+            return ObjectType::Dictionary;
+        default:
+            return ObjectType::None;
+    }
+}
+
+BinaryView::Object::
+Object() :
+    _view     (nullptr),
+    _reference(0),
+    _type     (ObjectType::None)
+{
+}
+
+BinaryView::Object::
+Object(BinaryView const *view, uint64_t reference, ObjectType type) :
+    _view     (view),
+    _reference(reference),
+    _type     (type)
+{
+}
+
+size_t BinaryView::Object::
+count() const
+{
+    if (_type != ObjectType::Array && _type != ObjectType::Dictionary) {
+        return 0;
+    }
+
+    int    type;
+    size_t count;
+    if (!_view->_reader->readContainer(_reference, &type, &count)) {
+        return 0;
+    }
+
+    return count;
+}
+
+BinaryView::Object BinaryView::Object::
+value(size_t index) const
+{
+    if (_type != ObjectType::Array && _type != ObjectType::Dictionary) {
+        return Object();
+    }
+
+    /* A dictionary's values follow all of its keys. */
+    if (_type == ObjectType::Dictionary) {
+        index += this->count();
+    }
+
+    uint64_t reference;
+    if (!_view->_reader->readContainerReferences(_reference, index, 1, &reference)) {
+        return Object();
+    }
+
+    return _view->object(reference);
+}
+
+std::string BinaryView::Object::
+key(size_t index) const
+{
+    if (_type != ObjectType::Dictionary) {
+        return std::string();
+    }
+
+    uint64_t reference;
+    if (!_view->_reader->readContainerReferences(_reference, index, 1, &reference)) {
+        return std::string();
+    }
+
+    std::string key;
+    if (!_view->_reader->readKey(reference, &key)) {
+        return std::string();
+    }
+
+    return key;
+}
+
+BinaryView::Object BinaryView::Object::
+value(std::string const &key) const
+{
+    if (_type != ObjectType::Dictionary) {
+        return Object();
+    }
+
+    size_t index;
+    if (!_view->find(_reference, this->count(), key, &index)) {
+        return Object();
+    }
+
+    return this->value(index);
+}
+
+std::string BinaryView::Object::
+string() const
+{
+    ValueBuilder builder;
+    if (_type == ObjectType::String) {
+        _view->_reader->readObject(_reference, &builder);
+    }
+    return std::move(builder.string());
+}
+
+int64_t BinaryView::Object::
+integer() const
+{
+    ValueBuilder builder;
+    if (_type == ObjectType::Integer) {
+        _view->_reader->readObject(_reference, &builder);
+    }
+    return builder.integer();
+}
+
+double BinaryView::Object::
+real() const
+{
+    ValueBuilder builder;
+    if (_type == ObjectType::Real) {
+        _view->_reader->readObject(_reference, &builder);
+    }
+    return builder.real();
+}
+
+bool BinaryView::Object::
+boolean() const
+{
+    ValueBuilder builder;
+    if (_type == ObjectType::Boolean) {
+        _view->_reader->readObject(_reference, &builder);
+    }
+    return builder.boolean();
+}
+
+std::vector<uint8_t> BinaryView::Object::
+data() const
+{
+    ValueBuilder builder;
+    if (_type == ObjectType::Data) {
+        _view->_reader->readObject(_reference, &builder);
+    }
+    return std::move(builder.data());
+}
+
+struct tm BinaryView::Object::
+date() const
+{
+    ValueBuilder builder;
+    if (_type == ObjectType::Date) {
+        _view->_reader->readObject(_reference, &builder);
+    }
+    return builder.date();
+}
+
+uint32_t BinaryView::Object::
+uid() const
+{
+    ValueBuilder builder;
+    if (_type == ObjectType::UID) {
+        _view->_reader->readObject(_reference, &builder);
+    }
+    return builder.uid();
+}
+
+std::unique_ptr<plist::Object> BinaryView::Object::
+copy() const
+{
+    if (_view == nullptr) {
+        return nullptr;
+    }
+
+    ObjectBuilder builder;
+    if (!_view->_reader->readObject(_reference, &builder)) {
+        return nullptr;
+    }
+
+    return std::move(builder.root());
+}
+
+BinaryView::
+BinaryView(ext::span<uint8_t const> contents) :
+    _reader(new ABPReader(contents))
+{
+}
+
+BinaryView::
+~BinaryView()
+{
+}
+
+std::string const &BinaryView::
+error() const
+{
+    return _reader->error();
+}
+
+BinaryView::Object BinaryView::
+object(uint64_t reference) const
+{
+    int    type;
+    size_t count;
+    if (!_reader->readContainer(reference, &type, &count)) {
+        return Object();
+    }
+
+    ObjectType objectType = RecordObjectType(type);
+    if (objectType == ObjectType::None) {
+        return Object();
+    }
+
+    return Object(this, reference, objectType);
+}
+
+bool BinaryView::
+find(uint64_t reference, size_t count, std::string const &key, size_t *index) const
+{
+    std::string found;
+
+    /*
+     * Dictionaries are searched from the end, so that if a key is repeated
+     * the last value is found, the same as when reading the dictionary.
+     */
+    if (count <= IndexThreshold) {
+        uint64_t keys[IndexThreshold];
+        if (!_reader->readContainerReferences(reference, 0, count, keys)) {
+            return false;
+        }
+
+        for (size_t n = count; n-- > 0;) {
+            if (!_reader->readKey(keys[n], &found)) {
+                return false;
+            }
+
+            if (found == key) {
+                *index = n;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /*
+     * Larger dictionaries read each key once, to index it by its hash. Later
+     * lookups only read the keys with a matching hash.
+     */
+    auto it = _indexes.find(reference);
+    if (it == _indexes.end()) {
+        std::vector<uint64_t> keys = std::vector<uint64_t>(count);
+        if (!_reader->readContainerReferences(reference, 0, count, keys.data())) {
+            return false;
+        }
+
+        std::vector<IndexEntry> entries;
+        entries.reserve(count);
+
+        for (size_t n = 0; n < count; n++) {
+            if (!_reader->readKey(keys[n], &found)) {
+                return false;
+            }
+
+            entries.push_back({ std::hash<std::string>()(found), n });
+        }
+
+        std::sort(entries.begin(), entries.end(), [](IndexEntry const &a, IndexEntry const &b) {
+            return a.hash < b.hash || (a.hash == b.hash && a.index < b.index);
+        });
+
+        it = _indexes.insert({ reference, std::move(entries) }).first;
+    }
+
+    std::vector<IndexEntry> const &entries = it->second;
+    size_t hash = std::hash<std::string>()(key);
+
+    auto range = std::equal_range(entries.begin(), entries.end(), IndexEntry({ hash, 0 }), [](IndexEntry const &a, IndexEntry const &b) {
+        return a.hash < b.hash;
+    });
+
+    for (auto rit = range.second; rit != range.first;) {
+        --rit;
+
+        uint64_t keyReference;
+        if (!_reader->readContainerReferences(reference, rit->index, 1, &keyReference) || !_reader->readKey(keyReference, &found)) {
+            return false;
+        }
+
+        if (found == key) {
+            *index = rit->index;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+std::pair<std::unique_ptr<BinaryView>, std::string> BinaryView::
+Open(ext::span<uint8_t const> contents)
+{
+    std::unique_ptr<BinaryView> view = std::unique_ptr<BinaryView>(new BinaryView(contents));
+    if (!view->_reader->open()) {
+        return std::make_pair(nullptr, view->_reader->error());
+    }
+
+    view->_root = view->object(view->_reader->topLevelObject());
+    if (!view->_root.valid()) {
+        return std::make_pair(nullptr, view->_reader->error());
+    }
+
+    return std::make_pair(std::move(view), std::string());
+}
@@ -0,0 +1,92 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree.
+ */
+
+#include <plist/Format/Builder.h>
+#include <plist/Objects.h>
+
+using plist::Format::Builder;
+using plist::ObjectType;
+using plist::Object;
+using plist::String;
+using plist::Integer;
+using plist::Real;
+using plist::Boolean;
+using plist::Data;
+using plist::Date;
+using plist::UID;
+using plist::Array;
+using plist::Dictionary;
+using plist::CastTo;
+
+Builder::
+Builder()
+{
+}
+
+Builder::
+~Builder()
+{
+}
+
+bool Builder::
+skipping() const
+{
+    return false;
+}
+
+void Builder::
+Visit(Object const *object, Builder *builder)
+{
+    switch (object->type()) {
+        case ObjectType::String:
+            builder->string(std::string(CastTo<String>(object)->value()));
+            break;
+        case ObjectType::Integer:
+            builder->integer(CastTo<Integer>(object)->value());
+            break;
+        case ObjectType::Real:
+            builder->real(CastTo<Real>(object)->value());
+            break;
+        case ObjectType::Boolean:
+            builder->boolean(CastTo<Boolean>(object)->value());
+            break;
+        case ObjectType::Null:
+            builder->null();
+            break;
+        case ObjectType::Data:
+            builder->data(std::vector<uint8_t>(CastTo<Data>(object)->value()));
+            break;
+        case ObjectType::Date:
+            builder->date(CastTo<Date>(object)->value());
+            break;
+        case ObjectType::UID:
+            builder->uid(CastTo<UID>(object)->value());
+            break;
+        case ObjectType::Array: {
+            Array const *array = CastTo<Array>(object);
+            builder->beginArray();
+            for (size_t n = 0; n < array->count(); n++) {
+                Visit(array->value(n), builder);
+            }
+            builder->endArray();
+            break;
+        }
+        case ObjectType::Dictionary: {
+            Dictionary const *dict = CastTo<Dictionary>(object);
+            builder->beginDictionary();
+            for (size_t n = 0; n < dict->count(); n++) {
+                builder->key(std::string(dict->key(n)));
+                Visit(dict->value(n), builder);
+            }
+            builder->endDictionary();
+            break;
+        }
+        case ObjectType::None:
+            break;
+    }
+}
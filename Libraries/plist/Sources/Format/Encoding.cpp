@@ -19,7 +19,7 @@ using plist::Format::Encoding;
 using plist::Format::Encodings;
 
 Encoding Encodings::
-Detect(std::vector<uint8_t> const &contents)
+Detect(ext::span<uint8_t const> contents)
 {
     /*
      * Check for a UTF-32 BOM. First as bytes overlap with UTF-16 LE.
@@ -131,16 +131,23 @@ EndianSwapBuffer(std::vector<uint8_t> *buffer, Endian src, Endian dest)
     }
 }
 
-std::vector<uint8_t> Encodings::
-Convert(std::vector<uint8_t> const &contents, Encoding from, Encoding to)
+ext::span<uint8_t const> Encodings::
+RemoveBOM(ext::span<uint8_t const> contents, Encoding encoding)
 {
-    std::vector<uint8_t> input = contents;
+    std::vector<uint8_t> BOM = Encodings::BOM(encoding);
+    if (contents.size() >= BOM.size() && std::equal(BOM.begin(), BOM.end(), contents.begin())) {
+        return contents.subspan(BOM.size());
+    }
+
+    return contents;
+}
 
+std::vector<uint8_t> Encodings::
+Convert(ext::span<uint8_t const> contents, Encoding from, Encoding to)
+{
     /* Remove any BOM at the start. */
-    std::vector<uint8_t> BOM = Encodings::BOM(from);
-    if (input.size() >= BOM.size() && std::equal(BOM.begin(), BOM.end(), contents.begin())) {
-        input.erase(input.begin(), input.begin() + BOM.size());
-    }
+    ext::span<uint8_t const> withoutBOM = RemoveBOM(contents, from);
+    std::vector<uint8_t> input = std::vector<uint8_t>(withoutBOM.begin(), withoutBOM.end());
 
     /* No conversion needed, just byte swap if necessary. */
     if (from == to) {
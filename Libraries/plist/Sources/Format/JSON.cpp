@@ -9,12 +9,20 @@
 #include <plist/Format/JSON.h>
 #include <plist/Format/JSONParser.h>
 #include <plist/Format/JSONWriter.h>
+#include <plist/Format/ObjectBuilder.h>
+#include <plist/Format/ArenaBuilder.h>
+#include <plist/Format/VisitorBuilder.h>
 
 using plist::Format::Encoding;
 using plist::Format::Format;
 using plist::Format::JSON;
 using plist::Format::JSONParser;
 using plist::Format::JSONWriter;
+using plist::Format::Builder;
+using plist::Format::ObjectBuilder;
+using plist::Format::ArenaBuilder;
+using plist::Format::VisitorBuilder;
+using plist::Format::Visitor;
 using plist::Object;
 
 JSON::
@@ -26,32 +34,69 @@ namespace plist { namespace Format {
 
 template<>
 std::unique_ptr<JSON> Format<JSON>::
-Identify(std::vector<uint8_t> const &contents)
+Identify(ext::span<uint8_t const> contents)
 {
     /* JSON is not a standard format. */
     return nullptr;
 }
 
-template<>
-std::pair<std::unique_ptr<Object>, std::string> Format<JSON>::
-Deserialize(std::vector<uint8_t> const &contents, JSON const &format)
+static bool
+Parse(ext::span<uint8_t const> contents, Builder *builder, std::string *error)
 {
-    std::unique_ptr<Object> root = nullptr;
-    std::string             error;
-
     /* Create lexer. */
     ASCIIPListLexer lexer;
     ASCIIPListLexerInit(&lexer, reinterpret_cast<char const *>(contents.data()), contents.size(), kASCIIPListLexerStyleJSON);
 
     /* Parse contents. */
-    JSONParser parser;
-    if (parser.parse(&lexer)) {
-        root = std::move(parser.root());
-    } else {
-        error = parser.error();
+    JSONParser parser = JSONParser(builder);
+    if (!parser.parse(&lexer)) {
+        *error = parser.error();
+        return false;
+    }
+
+    return true;
+}
+
+template<>
+std::pair<std::unique_ptr<Object>, std::string> Format<JSON>::
+Deserialize(ext::span<uint8_t const> contents, JSON const &format)
+{
+    ObjectBuilder builder;
+    std::string   error;
+
+    if (!Parse(contents, &builder, &error)) {
+        return std::make_pair(nullptr, error);
+    }
+
+    return std::make_pair(std::move(builder.root()), std::string());
+}
+
+template<>
+std::pair<Arena::Object const *, std::string> Format<JSON>::
+Deserialize(ext::span<uint8_t const> contents, JSON const &format, Arena::Arena *arena)
+{
+    ArenaBuilder builder = ArenaBuilder(arena);
+    std::string  error;
+
+    if (!Parse(contents, &builder, &error)) {
+        return std::make_pair(nullptr, error);
+    }
+
+    return std::make_pair(builder.root(), std::string());
+}
+
+template<>
+std::pair<bool, std::string> Format<JSON>::
+Visit(ext::span<uint8_t const> contents, JSON const &format, Visitor *visitor)
+{
+    VisitorBuilder builder = VisitorBuilder(visitor);
+    std::string    error;
+
+    if (!Parse(contents, &builder, &error)) {
+        return std::make_pair(false, error);
     }
 
-    return std::make_pair(std::move(root), error);
+    return std::make_pair(true, std::string());
 }
 
 template<>
@@ -7,18 +7,11 @@
  */
 
 #include <plist/Format/JSONParser.h>
-#include <plist/Objects.h>
 
 #include <cstdlib>
 
 using plist::Format::JSONParser;
-using plist::Object;
-using plist::String;
-using plist::Boolean;
-using plist::Real;
-using plist::Integer;
-using plist::Array;
-using plist::Dictionary;
+using plist::Format::Builder;
 
 #if 0
 #define JSONDebug(...) do { fprintf(stderr, __VA_ARGS__); fprintf(stderr, "\n"); } while (0)
@@ -27,12 +20,11 @@ using plist::Dictionary;
 #endif
 
 JSONParser::
-JSONParser() :
-    _root(nullptr),
+JSONParser(Builder *builder) :
+    _builder(builder),
+    _root(false),
     _level(0),
     _state(ValueState::Init),
-    _container(nullptr),
-    _key(nullptr),
     _contextState(ContextState::Parsing)
 {
 }
@@ -84,7 +76,7 @@ abort(std::string const &error)
 }
 
 bool JSONParser::
-push(ValueState state, std::unique_ptr<plist::Object> container, std::unique_ptr<plist::String> key)
+push(ValueState state)
 {
     if (isAborted()) {
         return false;
@@ -93,25 +85,10 @@ push(ValueState state, std::unique_ptr<plist::Object> container, std::unique_ptr
     /* If valid state, push, otherwise just set the new state. */
     if (_state != ValueState::Init) {
         /* Push the old state */
-        _containerStack.push(std::move(_container));
-        _keyStack.push(std::move(_key));
         _stateStack.push(_state);
     }
 
     _state = state;
-
-    if (container != nullptr) {
-        _container = std::move(container);
-    } else {
-        _container = nullptr;
-    }
-
-    if (key != nullptr) {
-        _key = std::move(key);
-    } else {
-        _key = nullptr;
-    }
-
     return true;
 }
 
@@ -125,9 +102,6 @@ pop()
             return false; /* Underflow! */
 
         /* Reset current state. */
-        _container = nullptr;
-        _key = nullptr;
-
         _state = ValueState::Init;
         return true;
     }
@@ -136,76 +110,60 @@ pop()
     _state = std::move(_stateStack.top());
     _stateStack.pop();
 
-    _container = std::move(_containerStack.top());
-    _containerStack.pop();
-
-    _key = std::move(_keyStack.top());
-    _keyStack.pop();
-
     return true;
 }
 
 /*
- * Generic container handling.
+ * Check that a value can be stored in the current state.
  */
 bool JSONParser::
-beginContainer(std::unique_ptr<plist::Object> object)
+beginValue()
 {
-    ValueState state;
+    switch (_state) {
+        case ValueState::Init:
+            /* Value is the root. */
+            if (_root) {
+                abort("Double root.");
+                return false;
+            }
 
-    if (object->type() == Array::Type()) {
-        state = ValueState::Array;
-    } else {
-        state = ValueState::Dictionary;
-    }
+            _root = true;
+            return true;
 
-    if (!push(state, std::move(object), nullptr)) {
-        abort("Cannot push the current state.");
-        return false;
+        case ValueState::DictionaryValue:
+            _state = ValueState::Dictionary;
+            return true;
+
+        case ValueState::Array:
+            return true;
+
+        case ValueState::Dictionary:
+            abort("Storing value with no array container.");
+            return false;
     }
 
-    return true;
+    return false;
 }
 
+/*
+ * Generic container handling.
+ */
 bool JSONParser::
-storeKeyValue(std::unique_ptr<plist::String> key, std::unique_ptr<plist::Object> value)
+beginContainer(bool isArray)
 {
-    if (_container == nullptr) {
-        if (_key != nullptr) {
-            abort("Storing key/value pair with no container.");
-            return false;
-        }
-
-        /* Make current value the root. */
-        if (_root != nullptr) {
-            abort("Double root.");
-            return false;
-        }
-
-        _root = std::move(value);
-        return true;
+    if (!beginValue()) {
+        return false;
     }
 
-    if (key != nullptr) {
-        if (_container->type() != Dictionary::Type()) {
-            abort("Storing key/value with no dictionary container.");
-            return false;
-        }
-
-        plist::Dictionary *dict = static_cast<plist::Dictionary *>(_container.get());
-        dict->set(key->value(), std::move(value));
+    if (!push(isArray ? ValueState::Array : ValueState::Dictionary)) {
+        abort("Cannot push the current state.");
+        return false;
+    }
 
-        _state = ValueState::Dictionary;
+    if (isArray) {
+        _builder->beginArray();
     } else {
-        if (_container->type() != Array::Type()) {
-            abort("Storing value with no array container.");
-            return false;
-        }
-
-        plist::Array *array = static_cast<plist::Array *>(_container.get());
-        array->append(std::move(value));
-
-        _state = ValueState::Array;
+        _builder->beginDictionary();
     }
 
     return true;
@@ -214,58 +172,30 @@ storeKeyValue(std::unique_ptr<plist::String> key, std::unique_ptr<plist::Object>
 bool JSONParser::
 endContainer(bool isArray)
 {
-    std::unique_ptr<plist::String> key;
-    std::unique_ptr<plist::Object> value;
-    bool success;
-
     /* Check state is consistant. */
     if (_state != (isArray ? ValueState::Array : ValueState::Dictionary)) {
         abort("Closing array/dictionary in wrong state.");
         return false;
     }
 
-    if (_container == nullptr) {
-        abort("Closing non-opened container.");
-        return false;
-    }
-
-    value = std::move(_container);
-    if (value == nullptr) {
-        abort("Couldn't copy container.");
-        return false;
-    }
-
-    /* Is this the right type of container? */
-    if (value->type() != (isArray ? Array::Type() : Dictionary::Type())) {
-        abort("Closing wrong kind of container.");
-        return false;
-    }
-
     if (!pop()) {
         abort("Parser stack underflow.");
         return false;
     }
 
-    /* Take ownership of the saved key. */
-    key = std::move(_key);
-    _key = nullptr;
-
-    success = storeKeyValue(std::move(key), std::move(value));
+    if (isArray) {
+        _builder->endArray();
+    } else {
+        _builder->endDictionary();
+    }
 
-    return success;
+    return true;
 }
 
 bool JSONParser::
 beginArray()
 {
-    std::unique_ptr<plist::Array> array = Array::New();
-    if (array == nullptr) {
-        abort("Cannot create an array.");
-        return false;
-    }
-
-    bool success = beginContainer(std::move(array));
-    return success;
+    return beginContainer(true);
 }
 
 bool JSONParser::
@@ -277,14 +207,7 @@ endArray()
 bool JSONParser::
 beginDictionary()
 {
-    std::unique_ptr<plist::Dictionary> dict = Dictionary::New();
-    if (dict == nullptr) {
-        abort("Cannot create a dictionary.");
-        return false;
-    }
-
-    bool success = beginContainer(std::move(dict));
-    return success;
+    return beginContainer(false);
 }
 
 bool JSONParser::
@@ -297,41 +220,72 @@ endDictionary()
  * Store the key of the current dictionary.
  */
 bool JSONParser::
-storeKey(std::unique_ptr<plist::String> key)
+storeKey(std::string &&key)
 {
-    if (key == nullptr) {
-        key = String::New();
-
-        if (key == nullptr) {
-            abort("Cannot create empty key.");
-            return false;
-        }
-    }
-
     if (_state != ValueState::Dictionary) {
         abort("Storing key in wrong state.");
         return false;
     }
 
-    _key = std::move(key);
+    _builder->key(std::move(key));
 
     _state = ValueState::DictionaryValue;
     return true;
 }
 
 bool JSONParser::
-storeValue(std::unique_ptr<plist::Object> value)
+storeString(std::string &&value)
 {
-    bool success;
+    if (!beginValue()) {
+        return false;
+    }
 
-    success = storeKeyValue(std::move(_key), std::move(value));
-    _key = nullptr;
+    _builder->string(std::move(value));
+    return true;
+}
 
-    if (_state == ValueState::DictionaryValue) {
-        _state = ValueState::Dictionary;
+bool JSONParser::
+storeBoolean(bool value)
+{
+    if (!beginValue()) {
+        return false;
     }
 
-    return success;
+    _builder->boolean(value);
+    return true;
+}
+
+bool JSONParser::
+storeNull()
+{
+    if (!beginValue()) {
+        return false;
+    }
+
+    _builder->null();
+    return true;
+}
+
+bool JSONParser::
+storeInteger(int64_t value)
+{
+    if (!beginValue()) {
+        return false;
+    }
+
+    _builder->integer(value);
+    return true;
+}
+
+bool JSONParser::
+storeReal(double value)
+{
+    if (!beginValue()) {
+        return false;
+    }
+
+    _builder->real(value);
+    return true;
 }
 
 bool JSONParser::
@@ -452,10 +406,9 @@ parse(ASCIIPListLexer *lexer)
                         }
 
                         bool value = (token == kASCIIPListLexerTokenBoolTrue);
-                        std::unique_ptr<Boolean> boolean = Boolean::New(value);
 
                         JSONDebug("Storing boolean");
-                        if (!storeValue(std::move(boolean))) {
+                        if (!storeBoolean(value)) {
                             return false;
                         }
                     } else if (token == kASCIIPListLexerTokenNull) {
@@ -464,10 +417,8 @@ parse(ASCIIPListLexer *lexer)
                             return false;
                         }
 
-                        std::unique_ptr<Null> null = Null::New();
-
                         JSONDebug("Storing null");
-                        if (!storeValue(std::move(null))) {
+                        if (!storeNull()) {
                             return false;
                         }
                     } else if (token == kASCIIPListLexerTokenNumberInteger) {
@@ -483,10 +434,8 @@ parse(ASCIIPListLexer *lexer)
                         free(contents);
 
                         if (success) {
-                            std::unique_ptr<Integer> integer = Integer::New(value);
-
                             JSONDebug("Storing integer");
-                            if (!storeValue(std::move(integer))) {
+                            if (!storeInteger(value)) {
                                 return false;
                             }
                         } else {
@@ -506,10 +455,8 @@ parse(ASCIIPListLexer *lexer)
                         free(contents);
 
                         if (success) {
-                            std::unique_ptr<Real> real = Real::New(value);
-
                             JSONDebug("Storing real");
-                            if (!storeValue(std::move(real))) {
+                            if (!storeReal(value)) {
                                 return false;
                             }
                         } else {
@@ -517,24 +464,30 @@ parse(ASCIIPListLexer *lexer)
                             return false;
                         }
                     } else if (token == kASCIIPListLexerTokenQuotedString) {
-                        char *contents = ASCIIPListCopyUnquotedString(lexer, '?');
-                        std::unique_ptr<String> string = String::New(std::string(contents));
-                        free(contents);
+                        std::string string;
+                        if (!ASCIIPListLexerTokenNeedsUnquoting(lexer)) {
+                            /* Most strings have no escapes; take them directly. */
+                            string = std::string(lexer->inputBuffer + lexer->tokenBegin, lexer->tokenLength);
+                        } else {
+                            char *contents = ASCIIPListCopyUnquotedString(lexer, '?');
+                            if (contents == NULL) {
+                                abort("OOM when copying string");
+                                return false;
+                            }
 
-                        if (string == NULL) {
-                            abort("OOM when copying string");
-                            return false;
+                            string = std::string(contents);
+                            free(contents);
                         }
 
                         /* Container context */
                         if (isDictionary) {
-                            JSONDebug("Storing string %s as key", string->value().c_str());
+                            JSONDebug("Storing string %s as key", string.c_str());
                             if (!storeKey(std::move(string))) {
                                 return false;
                             }
                         } else {
-                            JSONDebug("Storing string %s", string->value().c_str());
-                            if (!storeValue(std::move(string))) {
+                            JSONDebug("Storing string %s", string.c_str());
+                            if (!storeString(std::move(string))) {
                                 return false;
                             }
                         }
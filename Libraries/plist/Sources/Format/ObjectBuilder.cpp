@@ -0,0 +1,146 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree.
+ */
+
+#include <plist/Format/ObjectBuilder.h>
+#include <plist/Objects.h>
+
+using plist::Format::ObjectBuilder;
+using plist::Object;
+using plist::String;
+using plist::Integer;
+using plist::Real;
+using plist::Boolean;
+using plist::Null;
+using plist::Data;
+using plist::Date;
+using plist::UID;
+using plist::Array;
+using plist::Dictionary;
+using plist::CastTo;
+
+ObjectBuilder::
+ObjectBuilder()
+{
+}
+
+ObjectBuilder::
+~ObjectBuilder()
+{
+}
+
+void ObjectBuilder::
+add(std::unique_ptr<Object> value)
+{
+    if (_containers.empty()) {
+        _root = std::move(value);
+    } else if (Array *array = CastTo<Array>(_containers.back().object.get())) {
+        array->append(std::move(value));
+    } else if (Dictionary *dict = CastTo<Dictionary>(_containers.back().object.get())) {
+        dict->set(_key, std::move(value));
+    }
+}
+
+void ObjectBuilder::
+begin(std::unique_ptr<Object> container)
+{
+    /* Save the key for the container itself until it ends. */
+    _containers.push_back({ std::move(container), std::move(_key) });
+    _key.clear();
+}
+
+void ObjectBuilder::
+end()
+{
+    if (_containers.empty()) {
+        return;
+    }
+
+    Container container = std::move(_containers.back());
+    _containers.pop_back();
+
+    _key = std::move(container.key);
+    add(std::move(container.object));
+}
+
+void ObjectBuilder::
+beginArray()
+{
+    begin(Array::New());
+}
+
+void ObjectBuilder::
+endArray()
+{
+    end();
+}
+
+void ObjectBuilder::
+beginDictionary()
+{
+    begin(Dictionary::New());
+}
+
+void ObjectBuilder::
+endDictionary()
+{
+    end();
+}
+
+void ObjectBuilder::
+key(std::string &&key)
+{
+    _key = std::move(key);
+}
+
+void ObjectBuilder::
+string(std::string &&value)
+{
+    add(String::New(std::move(value)));
+}
+
+void ObjectBuilder::
+integer(int64_t value)
+{
+    add(Integer::New(value));
+}
+
+void ObjectBuilder::
+real(double value)
+{
+    add(Real::New(value));
+}
+
+void ObjectBuilder::
+boolean(bool value)
+{
+    add(Boolean::New(value));
+}
+
+void ObjectBuilder::
+null()
+{
+    add(Null::New());
+}
+
+void ObjectBuilder::
+data(std::vector<uint8_t> &&value)
+{
+    add(Data::New(std::move(value)));
+}
+
+void ObjectBuilder::
+date(struct tm const &value)
+{
+    add(Date::New(value));
+}
+
+void ObjectBuilder::
+uid(uint32_t value)
+{
+    add(UID::New(value));
+}
@@ -8,11 +8,17 @@
 
 #include <plist/Format/SimpleXML.h>
 #include <plist/Format/SimpleXMLParser.h>
+#include <plist/Format/ArenaBuilder.h>
+#include <plist/Format/VisitorBuilder.h>
 
 using plist::Format::Encoding;
 using plist::Format::Format;
 using plist::Format::SimpleXML;
 using plist::Format::SimpleXMLParser;
+using plist::Format::Builder;
+using plist::Format::ArenaBuilder;
+using plist::Format::VisitorBuilder;
+using plist::Format::Visitor;
 using plist::Object;
 
 SimpleXML::
@@ -25,7 +31,7 @@ namespace plist { namespace Format {
 
 template<>
 std::unique_ptr<SimpleXML> Format<SimpleXML>::
-Identify(std::vector<uint8_t> const &contents)
+Identify(ext::span<uint8_t const> contents)
 {
     /*
      * To identify XML document, we look for a <? or <!, ignoring
@@ -73,9 +79,15 @@ Identify(std::vector<uint8_t> const &contents)
 
 template<>
 std::pair<std::unique_ptr<Object>, std::string> Format<SimpleXML>::
-Deserialize(std::vector<uint8_t> const &contents, SimpleXML const &format)
+Deserialize(ext::span<uint8_t const> contents, SimpleXML const &format)
 {
-    std::vector<uint8_t> const data = Encodings::Convert(contents, format.encoding(), Encoding::UTF8);
+    /* Parse UTF-8 contents in place; only other encodings need a copy. */
+    std::vector<uint8_t> converted;
+    ext::span<uint8_t const> data = Encodings::RemoveBOM(contents, Encoding::UTF8);
+    if (format.encoding() != Encoding::UTF8) {
+        converted = Encodings::Convert(contents, format.encoding(), Encoding::UTF8);
+        data = converted;
+    }
 
     SimpleXMLParser parser;
     std::unique_ptr<Object> root = std::unique_ptr<Object>(parser.parse(data));
@@ -86,6 +98,35 @@ Deserialize(std::vector<uint8_t> const &contents, SimpleXML const &format)
     return std::make_pair(std::move(root), std::string());
 }
 
+template<>
+std::pair<Arena::Object const *, std::string> Format<SimpleXML>::
+Deserialize(ext::span<uint8_t const> contents, SimpleXML const &format, Arena::Arena *arena)
+{
+    /* Simple XML is restructured as it's parsed, so build it normally first. */
+    auto result = Deserialize(contents, format);
+    if (result.first == nullptr) {
+        return std::make_pair(nullptr, result.second);
+    }
+
+    ArenaBuilder builder = ArenaBuilder(arena);
+    Builder::Visit(result.first.get(), &builder);
+    return std::make_pair(builder.root(), std::string());
+}
+
+template<>
+std::pair<bool, std::string> Format<SimpleXML>::
+Visit(ext::span<uint8_t const> contents, SimpleXML const &format, Visitor *visitor)
+{
+    auto result = Deserialize(contents, format);
+    if (result.first == nullptr) {
+        return std::make_pair(false, result.second);
+    }
+
+    VisitorBuilder builder = VisitorBuilder(visitor);
+    Builder::Visit(result.first.get(), &builder);
+    return std::make_pair(true, std::string());
+}
+
 template<>
 std::pair<std::unique_ptr<std::vector<uint8_t>>, std::string> Format<SimpleXML>::
 Serialize(Object const *object, SimpleXML const &format)
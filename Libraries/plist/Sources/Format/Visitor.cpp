@@ -0,0 +1,89 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree.
+ */
+
+#include <plist/Format/Visitor.h>
+
+using plist::Format::Visitor;
+
+Visitor::
+Visitor()
+{
+}
+
+Visitor::
+~Visitor()
+{
+}
+
+bool Visitor::
+beginArray()
+{
+    return true;
+}
+
+void Visitor::
+endArray()
+{
+}
+
+bool Visitor::
+beginDictionary()
+{
+    return true;
+}
+
+void Visitor::
+endDictionary()
+{
+}
+
+bool Visitor::
+key(std::string const &key)
+{
+    return true;
+}
+
+void Visitor::
+string(std::string const &value)
+{
+}
+
+void Visitor::
+integer(int64_t value)
+{
+}
+
+void Visitor::
+real(double value)
+{
+}
+
+void Visitor::
+boolean(bool value)
+{
+}
+
+void Visitor::
+null()
+{
+}
+
+void Visitor::
+data(std::vector<uint8_t> const &value)
+{
+}
+
+void Visitor::
+date(struct tm const &value)
+{
+}
+
+void Visitor::
+uid(uint32_t value)
+{
+}
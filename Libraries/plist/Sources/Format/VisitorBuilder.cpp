@@ -0,0 +1,180 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree.
+ */
+
+#include <plist/Format/VisitorBuilder.h>
+
+using plist::Format::VisitorBuilder;
+using plist::Format::Visitor;
+
+VisitorBuilder::
+VisitorBuilder(Visitor *visitor) :
+    _visitor  (visitor),
+    _skip     (0),
+    _skipValue(false)
+{
+}
+
+VisitorBuilder::
+~VisitorBuilder()
+{
+}
+
+bool VisitorBuilder::
+begin()
+{
+    if (_skip > 0) {
+        _skip++;
+        return false;
+    } else if (_skipValue) {
+        _skipValue = false;
+        _skip = 1;
+        return false;
+    } else {
+        return true;
+    }
+}
+
+bool VisitorBuilder::
+end()
+{
+    /* A skipped value might not have been sent at all. */
+    _skipValue = false;
+
+    if (_skip > 0) {
+        _skip--;
+        return false;
+    } else {
+        return true;
+    }
+}
+
+bool VisitorBuilder::
+value()
+{
+    if (_skip > 0) {
+        return false;
+    } else if (_skipValue) {
+        _skipValue = false;
+        return false;
+    } else {
+        return true;
+    }
+}
+
+void VisitorBuilder::
+beginArray()
+{
+    if (begin() && !_visitor->beginArray()) {
+        _skip = 1;
+    }
+}
+
+void VisitorBuilder::
+endArray()
+{
+    if (end()) {
+        _visitor->endArray();
+    }
+}
+
+void VisitorBuilder::
+beginDictionary()
+{
+    if (begin() && !_visitor->beginDictionary()) {
+        _skip = 1;
+    }
+}
+
+void VisitorBuilder::
+endDictionary()
+{
+    if (end()) {
+        _visitor->endDictionary();
+    }
+}
+
+void VisitorBuilder::
+key(std::string &&key)
+{
+    /* A skipped value might not have been sent at all. */
+    _skipValue = false;
+
+    if (_skip == 0 && !_visitor->key(key)) {
+        _skipValue = true;
+    }
+}
+
+void VisitorBuilder::
+string(std::string &&value)
+{
+    if (this->value()) {
+        _visitor->string(value);
+    }
+}
+
+void VisitorBuilder::
+integer(int64_t value)
+{
+    if (this->value()) {
+        _visitor->integer(value);
+    }
+}
+
+void VisitorBuilder::
+real(double value)
+{
+    if (this->value()) {
+        _visitor->real(value);
+    }
+}
+
+void VisitorBuilder::
+boolean(bool value)
+{
+    if (this->value()) {
+        _visitor->boolean(value);
+    }
+}
+
+void VisitorBuilder::
+null()
+{
+    if (this->value()) {
+        _visitor->null();
+    }
+}
+
+void VisitorBuilder::
+data(std::vector<uint8_t> &&value)
+{
+    if (this->value()) {
+        _visitor->data(value);
+    }
+}
+
+void VisitorBuilder::
+date(struct tm const &value)
+{
+    if (this->value()) {
+        _visitor->date(value);
+    }
+}
+
+void VisitorBuilder::
+uid(uint32_t value)
+{
+    if (this->value()) {
+        _visitor->uid(value);
+    }
+}
+
+bool VisitorBuilder::
+skipping() const
+{
+    return _skip > 0 || _skipValue;
+}
@@ -9,6 +9,9 @@
 #include <plist/Format/XML.h>
 #include <plist/Format/XMLParser.h>
 #include <plist/Format/XMLWriter.h>
+#include <plist/Format/ObjectBuilder.h>
+#include <plist/Format/ArenaBuilder.h>
+#include <plist/Format/VisitorBuilder.h>
 
 using plist::Format::Type;
 using plist::Format::Encoding;
@@ -16,6 +19,11 @@ using plist::Format::Format;
 using plist::Format::XML;
 using plist::Format::XMLParser;
 using plist::Format::XMLWriter;
+using plist::Format::Builder;
+using plist::Format::ObjectBuilder;
+using plist::Format::ArenaBuilder;
+using plist::Format::VisitorBuilder;
+using plist::Format::Visitor;
 using plist::Object;
 
 XML::
@@ -34,7 +42,7 @@ namespace plist { namespace Format {
 
 template<>
 std::unique_ptr<XML> Format<XML>::
-Identify(std::vector<uint8_t> const &contents)
+Identify(ext::span<uint8_t const> contents)
 {
     /*
      * To identify XML document, we look for a <? or <!, ignoring
@@ -80,19 +88,66 @@ Identify(std::vector<uint8_t> const &contents)
     return nullptr;
 }
 
+static bool
+Parse(ext::span<uint8_t const> contents, XML const &format, Builder *builder, std::string *error)
+{
+    /* Parse UTF-8 contents in place; only other encodings need a copy. */
+    std::vector<uint8_t> converted;
+    ext::span<uint8_t const> data = Encodings::RemoveBOM(contents, Encoding::UTF8);
+    if (format.encoding() != Encoding::UTF8) {
+        converted = Encodings::Convert(contents, format.encoding(), Encoding::UTF8);
+        data = converted;
+    }
+
+    XMLParser parser = XMLParser(builder);
+    if (!parser.parse(data)) {
+        *error = parser.error();
+        return false;
+    }
+
+    return true;
+}
+
 template<>
 std::pair<std::unique_ptr<Object>, std::string> Format<XML>::
-Deserialize(std::vector<uint8_t> const &contents, XML const &format)
+Deserialize(ext::span<uint8_t const> contents, XML const &format)
+{
+    ObjectBuilder builder;
+    std::string   error;
+
+    if (!Parse(contents, format, &builder, &error)) {
+        return std::make_pair(nullptr, error);
+    }
+
+    return std::make_pair(std::move(builder.root()), std::string());
+}
+
+template<>
+std::pair<Arena::Object const *, std::string> Format<XML>::
+Deserialize(ext::span<uint8_t const> contents, XML const &format, Arena::Arena *arena)
+{
+    ArenaBuilder builder = ArenaBuilder(arena);
+    std::string  error;
+
+    if (!Parse(contents, format, &builder, &error)) {
+        return std::make_pair(nullptr, error);
+    }
+
+    return std::make_pair(builder.root(), std::string());
+}
+
+template<>
+std::pair<bool, std::string> Format<XML>::
+Visit(ext::span<uint8_t const> contents, XML const &format, Visitor *visitor)
 {
-    std::vector<uint8_t> const data = Encodings::Convert(contents, format.encoding(), Encoding::UTF8);
+    VisitorBuilder builder = VisitorBuilder(visitor);
+    std::string    error;
 
-    XMLParser parser;
-    std::unique_ptr<Object> root = std::unique_ptr<Object>(parser.parse(data));
-    if (root == nullptr) {
-        return std::make_pair(nullptr, parser.error());
+    if (!Parse(contents, format, &builder, &error)) {
+        return std::make_pair(false, error);
     }
 
-    return std::make_pair(std::move(root), std::string());
+    return std::make_pair(true, std::string());
 }
 
 template<>
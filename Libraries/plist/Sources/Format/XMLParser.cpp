@@ -7,60 +7,48 @@
  */
 
 #include <plist/Format/XMLParser.h>
-
-#include <plist/Objects.h>
+#include <plist/ISODate.h>
+#include <plist/Base64.h>
 
 using plist::Format::XMLParser;
-using plist::Object;
+using plist::Format::Builder;
+using plist::ISODate;
+using plist::Base64;
 
-XMLParser::XMLParser() :
+XMLParser::XMLParser(Builder *builder) :
     BaseXMLParser(),
-    _root        (nullptr)
+    _builder     (builder),
+    _root        (false)
 {
 }
 
-Object *XMLParser::
-parse(std::vector<uint8_t> const &contents)
+bool XMLParser::
+parse(ext::span<uint8_t const> contents)
 {
-    if (_root != nullptr)
-        return nullptr;
-
-    if (!BaseXMLParser::parse(contents))
-        return nullptr;
+    if (_root)
+        return false;
 
-    return _root;
+    return BaseXMLParser::parse(contents);
 }
 
 void XMLParser::
 onBeginParse()
 {
-    _root             = nullptr;
-    _state.current    = nullptr;
+    _root             = false;
+    _state.element    = Element::None;
     _state.key.valid  = false;
     _state.key.active = false;
+    _state.uid        = UIDState::None;
 }
 
 void XMLParser::
 onEndParse(bool success)
 {
-    if (!success) {
-        if (_state.current != nullptr && _state.current != _root) {
-            _state.current->release();
-        }
-        for (auto const &s : _stack) {
-            if (s.current != _state.current && s.current != _root) {
-                s.current->release();
-            }
-        }
-        _stack.clear();
-        if (_root != nullptr) {
-            _root->release();
-            _root = nullptr;
-        }
-    }
-    _state.current    = nullptr;
+    _stack.clear();
+    _state.element    = Element::None;
     _state.key.valid  = false;
     _state.key.active = false;
+    _state.uid        = UIDState::None;
     _cdata.clear();
 }
 
@@ -78,7 +66,7 @@ onStartElement(std::string const &name, std::unordered_map<std::string, std::str
     // If we have a root, and depth == 1 there's an extra
     // entry after the first element, bail out.
     //
-    if (depth == 1 && _root != nullptr) {
+    if (depth == 1 && _root) {
         error("unexpected element '%s' after root element", name.c_str());
         return;
     }
@@ -120,13 +108,13 @@ inContainer(size_t depth) const
 inline bool XMLParser::
 inArray() const
 {
-    return (CastTo <Array> (_state.current) != nullptr);
+    return (_state.element == Element::Array);
 }
 
 inline bool XMLParser::
 inDictionary() const
 {
-    return (CastTo <Dictionary> (_state.current) != nullptr);
+    return (_state.element == Element::Dictionary);
 }
 
 inline bool XMLParser::
@@ -138,11 +126,11 @@ isExpectingKey() const
 inline bool XMLParser::
 isExpectingCDATA() const
 {
-    return (CastTo <Integer> (_state.current) != nullptr ||
-            CastTo <Real> (_state.current) != nullptr ||
-            CastTo <String> (_state.current) != nullptr ||
-            CastTo <Data> (_state.current) != nullptr ||
-            CastTo <Date> (_state.current) != nullptr ||
+    return (_state.element == Element::Integer ||
+            _state.element == Element::Real ||
+            _state.element == Element::String ||
+            _state.element == Element::Data ||
+            _state.element == Element::Date ||
             (inDictionary() && _state.key.active));
 }
 
@@ -164,6 +152,11 @@ beginObject(std::string const &name, size_t depth)
                     name.c_str());
             return false;
         }
+
+        /* Only an integer can be the value of a UID. */
+        if (_state.uid != UIDState::Key || name != "integer") {
+            flushDictionary();
+        }
     }
 
     if (!inContainer(depth)) {
@@ -231,50 +224,65 @@ endObject(std::string const &name)
 }
 
 void XMLParser::
-push(Object *object)
+push(Element element)
 {
-    if (_state.current != nullptr) {
+    if (_state.element != Element::None) {
         _stack.push_back(_state);
     }
-    _state.current    = object;
+    _state.element    = element;
     _state.key.valid  = false;
     _state.key.active = false;
-    if (_root == nullptr) {
-        _root = _state.current;
-    }
+    _state.uid        = UIDState::None;
+    _root             = true;
 }
 
 void XMLParser::
 pop()
 {
-    if (_stack.empty() && _state.current == nullptr) {
+    if (_stack.empty() && _state.element == Element::None) {
         error("stack underflow");
         return;
     }
 
-    if (_state.current != _root) {
-        State old = _state;
+    if (!_stack.empty()) {
         _state = _stack.back();
         _stack.pop_back();
 
-        if (auto array = CastTo <Array> (_state.current)) {
-            array->append(std::unique_ptr<Object>(old.current));
-        } else if (auto dict = CastTo <Dictionary> (_state.current)) {
-            if (!isExpectingKey()) {
-                dict->set(_state.key.value, std::unique_ptr<Object>(old.current));
-                _state.key.valid  = false;
-                _state.key.active = false;
-            }
+        if (inDictionary() && !isExpectingKey()) {
+            _state.key.valid  = false;
+            _state.key.active = false;
         }
+    } else {
+        _state.element = Element::None;
     }
 
     _cdata.clear();
 }
 
+void XMLParser::
+flushDictionary()
+{
+    UIDState uid = _state.uid;
+    if (uid == UIDState::None) {
+        return;
+    }
+
+    /* Not a UID after all, so send what was held back. */
+    _state.uid = UIDState::None;
+    _builder->beginDictionary();
+    if (uid == UIDState::Key || uid == UIDState::Value) {
+        _builder->key("CF$UID");
+    }
+    if (uid == UIDState::Value) {
+        _builder->integer(_state.uidValue);
+    }
+}
+
 bool XMLParser::
 beginArray()
 {
-    push(Array::New().release());
+    push(Element::Array);
+    _builder->beginArray();
     return true;
 }
 
@@ -282,44 +290,42 @@ bool XMLParser::
 endArray()
 {
     pop();
+    _builder->endArray();
     return true;
 }
 
 bool XMLParser::
 beginDictionary()
 {
-    push(Dictionary::New().release());
-    _state.key.valid  = false;
-    _state.key.active = false;
+    push(Element::Dictionary);
+    _state.uid = UIDState::Empty;
     return true;
 }
 
 bool XMLParser::
 endDictionary()
 {
-    if (auto dict = CastTo<Dictionary>(_state.current)) {
-        /* Convert CF$UID dictionaries into UID objects. */
-        if (dict->count() == 1) {
-            std::string const &key = dict->key(0);
-            Object const *value = dict->value(0);
-            if (key == "CF$UID" && value->type() == Integer::Type()) {
-                Integer const *integer = CastTo<Integer>(value);
-
-                uint32_t value = static_cast<uint32_t>(integer->value());
-                _state.current->release();
-                _state.current = UID::New(value).release();
-            }
-        }
+    /* Convert CF$UID dictionaries into UID objects. */
+    UIDState uid = _state.uid;
+    uint32_t uidValue = _state.uidValue;
+    if (uid != UIDState::Value) {
+        flushDictionary();
     }
 
     pop();
+
+    if (uid == UIDState::Value) {
+        _builder->uid(uidValue);
+    } else {
+        _builder->endDictionary();
+    }
     return true;
 }
 
 bool XMLParser::
 beginString()
 {
-    push(String::New().release());
+    push(Element::String);
     _cdata.clear();
     return true;
 }
@@ -327,15 +333,16 @@ beginString()
 bool XMLParser::
 endString()
 {
-    CastTo <String> (_state.current)->setValue(_cdata);
+    std::string value = std::move(_cdata);
     pop();
+    _builder->string(std::move(value));
     return true;
 }
 
 bool XMLParser::
 beginInteger()
 {
-    push(Integer::New().release());
+    push(Element::Integer);
     _cdata.clear();
     return true;
 }
@@ -346,8 +353,13 @@ endInteger()
     char *end = NULL;
     long long integer = ::strtoll(_cdata.c_str(), &end, 0);
     if (end != _cdata.c_str()) {
-        CastTo <Integer> (_state.current)->setValue(integer);
         pop();
+        if (_state.uid == UIDState::Key) {
+            _state.uid = UIDState::Value;
+            _state.uidValue = static_cast<uint32_t>(integer);
+        } else {
+            _builder->integer(integer);
+        }
         return true;
     } else {
         pop();
@@ -358,7 +370,7 @@ endInteger()
 bool XMLParser::
 beginReal()
 {
-    push(Real::New().release());
+    push(Element::Real);
     _cdata.clear();
     return true;
 }
@@ -369,8 +381,8 @@ endReal()
     char *end = NULL;
     double real = ::strtod(_cdata.c_str(), &end);
     if (end != _cdata.c_str()) {
-        CastTo <Real> (_state.current)->setValue(real);
         pop();
+        _builder->real(real);
         return true;
     } else {
         pop();
@@ -381,7 +393,7 @@ endReal()
 bool XMLParser::
 beginNull()
 {
-    push(Null::New().release());
+    push(Element::Null);
     return true;
 }
 
@@ -389,13 +401,15 @@ bool XMLParser::
 endNull()
 {
     pop();
+    _builder->null();
     return true;
 }
 
 bool XMLParser::
 beginBoolean(bool value)
 {
-    push(Boolean::New(value).release());
+    push(Element::Boolean);
+    _builder->boolean(value);
     return true;
 }
 
@@ -409,7 +423,7 @@ endBoolean()
 bool XMLParser::
 beginData()
 {
-    push(Data::New().release());
+    push(Element::Data);
     _cdata.clear();
     return true;
 }
@@ -417,15 +431,17 @@ beginData()
 bool XMLParser::
 endData()
 {
-    CastTo <Data> (_state.current)->setBase64Value(_cdata);
+    std::vector<uint8_t> value;
+    Base64::Decode(_cdata, value);
     pop();
+    _builder->data(std::move(value));
     return true;
 }
 
 bool XMLParser::
 beginDate()
 {
-    push(Date::New().release());
+    push(Element::Date);
     _cdata.clear();
     return true;
 }
@@ -433,14 +449,20 @@ beginDate()
 bool XMLParser::
 endDate()
 {
-    CastTo <Date> (_state.current)->setStringValue(_cdata);
+    struct tm value = tm();
+    ISODate::Decode(_cdata, value);
     pop();
+    _builder->date(value);
     return true;
 }
 
 bool XMLParser::
 beginKey()
 {
+    if (_state.uid == UIDState::Value) {
+        flushDictionary();
+    }
+
     _state.key.valid = false;
     _state.key.active = true;
     _cdata.clear();
@@ -454,5 +476,12 @@ endKey()
     _state.key.valid = true;
     _state.key.value = _cdata;
     _cdata.clear();
+
+    if (_state.uid == UIDState::Empty && _state.key.value == "CF$UID") {
+        _state.uid = UIDState::Key;
+    } else {
+        flushDictionary();
+        _builder->key(std::string(_state.key.value));
+    }
     return true;
 }
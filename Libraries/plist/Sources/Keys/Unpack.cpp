@@ -23,8 +23,12 @@ Unpack(std::string const &name, Dictionary const *dict, std::unordered_set<std::
 Object const *Unpack::
 value(std::string const &key)
 {
-    _seen->insert(key);
-    return _dict->value(key);
+    /* Only keys in the dictionary can be unhandled, so only they are tracked. */
+    Object const *object = _dict->value(key);
+    if (object != nullptr) {
+        _seen->insert(key);
+    }
+    return object;
 }
 
 bool Unpack::
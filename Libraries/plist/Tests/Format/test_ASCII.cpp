@@ -10,6 +10,11 @@
 #include <plist/Format/ASCII.h>
 #include <plist/Objects.h>
 
+#if !_WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 using plist::Format::ASCII;
 using plist::Format::Encoding;
 using plist::String;
@@ -145,3 +150,105 @@ TEST(ASCII, CommentWithStarAndSlash)
     dictionary->set("key", String::New("value"));
     EXPECT_TRUE(deserialize.first->equals(dictionary.get()));
 }
+
+TEST(ASCII, Subrange)
+{
+    /* Only the middle of the buffer is a valid plist. */
+    auto buffer = Contents("xxx{ key = value; }yyy");
+    ext::span<uint8_t const> contents = ext::span<uint8_t const>(buffer).subspan(3, buffer.size() - 6);
+
+    auto deserialize = ASCII::Deserialize(contents, ASCII::Create(false, Encoding::UTF8));
+    ASSERT_NE(deserialize.first, nullptr);
+
+    auto dictionary = Dictionary::New();
+    dictionary->set("key", String::New("value"));
+    EXPECT_TRUE(deserialize.first->equals(dictionary.get()));
+}
+
+TEST(ASCII, LongTokens)
+{
+    /* Tokens of every length around the sizes scanned at once. */
+    for (size_t length = 0; length < 80; length++) {
+        std::string unquoted;
+        std::string quoted;
+        for (size_t n = 0; n < length; n++) {
+            unquoted += "aZ09_$.-:/"[n % 10];
+            quoted += "a b\t{;"[n % 6];
+        }
+
+        std::string space = std::string(length, ' ') + std::string(length, '\n');
+        std::string comment = "/* " + quoted + " * / " + unquoted + " */";
+        auto contents = Contents(space + "{" + comment + "k" + unquoted + " = \"" + quoted + "\\\"\"; k = (" + space + "'" + quoted + "'); }" + space);
+
+        auto deserialize = ASCII::Deserialize(contents, ASCII::Create(false, Encoding::UTF8));
+        ASSERT_NE(deserialize.first, nullptr) << deserialize.second;
+
+        auto dictionary = Dictionary::New();
+        dictionary->set("k" + unquoted, String::New(quoted + "\""));
+        auto array = Array::New();
+        array->append(String::New(quoted));
+        dictionary->set("k", std::move(array));
+        EXPECT_TRUE(deserialize.first->equals(dictionary.get()));
+    }
+}
+
+TEST(ASCII, LineNumbers)
+{
+    /* Lines are counted in whitespace, comments, and quoted strings. */
+    std::string lines = std::string(50, '\n');
+    auto contents = Contents("{" + lines + "/*" + lines + "*/ a = \"" + lines + "\"; " + lines + "b = ; }");
+
+    auto deserialize = ASCII::Deserialize(contents, ASCII::Create(false, Encoding::UTF8));
+    EXPECT_EQ(deserialize.first, nullptr);
+    EXPECT_EQ(deserialize.second.find("[line 201]"), 0);
+}
+
+TEST(ASCII, Unterminated)
+{
+    /* Nothing past the end of the contents is read. */
+    std::vector<std::string> tokens = { "\"quoted", "\"escape\\", "'quoted", "/* comment", "<0102" };
+    for (std::string const &token : tokens) {
+        auto buffer = Contents("(" + token + "\"' */>)");
+        ext::span<uint8_t const> contents = ext::span<uint8_t const>(buffer).subspan(0, token.size() + 1);
+
+        auto deserialize = ASCII::Deserialize(contents, ASCII::Create(false, Encoding::UTF8));
+        EXPECT_EQ(deserialize.first, nullptr) << token;
+    }
+}
+
+#if !_WIN32
+TEST(ASCII, UnterminatedBuffer)
+{
+    /*
+     * Mapped files aren't NUL-terminated. Put each input right before an
+     * inaccessible page, so reading past the end of the input crashes.
+     */
+    size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    void *mapping = ::mmap(nullptr, page * 2, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    ASSERT_NE(mapping, MAP_FAILED);
+    ASSERT_EQ(0, ::mprotect(static_cast<uint8_t *>(mapping) + page, page, PROT_NONE));
+
+    std::vector<std::pair<std::string, bool>> inputs = {
+        { "{ key = value; }", true },
+        { "( 1, \"two\", <0a0b> )", true },
+        { "unquoted", true },
+        { "\"unterminated", false },
+        { "'unterminated", false },
+        { "/* unterminated", false },
+        { "// comment", false },
+        { "<0a0b", false },
+        { "{ key = value", false },
+        { "( 1, ", false },
+    };
+
+    for (auto const &input : inputs) {
+        uint8_t *data = static_cast<uint8_t *>(mapping) + page - input.first.size();
+        memcpy(data, input.first.data(), input.first.size());
+
+        auto deserialize = ASCII::Deserialize(ext::span<uint8_t const>(data, input.first.size()), ASCII::Create(false, Encoding::UTF8));
+        EXPECT_EQ(input.second, deserialize.first != nullptr) << input.first;
+    }
+
+    ::munmap(mapping, page * 2);
+}
+#endif
@@ -0,0 +1,161 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+#include <plist/Format/Binary.h>
+#include <plist/Format/BinaryView.h>
+#include <plist/Objects.h>
+
+using plist::Format::Binary;
+using plist::Format::BinaryView;
+using plist::ObjectType;
+using plist::String;
+using plist::Integer;
+using plist::Real;
+using plist::Boolean;
+using plist::Data;
+using plist::UID;
+using plist::Array;
+using plist::Dictionary;
+
+static std::vector<uint8_t>
+Serialize(plist::Object const *object)
+{
+    auto serialize = Binary::Serialize(object, Binary::Create());
+    EXPECT_NE(serialize.first, nullptr);
+    return *serialize.first;
+}
+
+TEST(BinaryView, Values)
+{
+    auto dictionary = Dictionary::New();
+    dictionary->set("string", String::New("value"));
+    dictionary->set("unicode", String::New("\xe2\x98\x83"));
+    dictionary->set("integer", Integer::New(-42));
+    dictionary->set("real", Real::New(1.5));
+    dictionary->set("boolean", Boolean::New(true));
+    dictionary->set("data", Data::New(std::vector<uint8_t>({ 0x01, 0x02 })));
+    dictionary->set("uid", UID::New(7));
+
+    std::vector<uint8_t> contents = Serialize(dictionary.get());
+    auto open = BinaryView::Open(contents);
+    ASSERT_NE(open.first, nullptr);
+
+    BinaryView::Object root = open.first->root();
+    ASSERT_TRUE(root.valid());
+    EXPECT_EQ(root.type(), ObjectType::Dictionary);
+    EXPECT_EQ(root.count(), 7);
+
+    EXPECT_EQ(root.value("string").type(), ObjectType::String);
+    EXPECT_EQ(root.value("string").string(), "value");
+    EXPECT_EQ(root.value("unicode").string(), "\xe2\x98\x83");
+    EXPECT_EQ(root.value("integer").integer(), -42);
+    EXPECT_EQ(root.value("real").real(), 1.5);
+    EXPECT_TRUE(root.value("boolean").boolean());
+    EXPECT_EQ(root.value("data").data(), std::vector<uint8_t>({ 0x01, 0x02 }));
+    EXPECT_EQ(root.value("uid").uid(), 7);
+
+    /* Other types are empty. */
+    EXPECT_EQ(root.value("string").integer(), 0);
+    EXPECT_EQ(root.value("integer").string(), "");
+    EXPECT_EQ(root.value("string").count(), 0);
+
+    /* Missing keys are invalid. */
+    EXPECT_FALSE(root.value("missing").valid());
+    EXPECT_FALSE(root.value("missing").value("deeper").valid());
+
+    EXPECT_TRUE(root.copy()->equals(dictionary.get()));
+}
+
+TEST(BinaryView, Containers)
+{
+    auto inner = Dictionary::New();
+    inner->set("\xe2\x98\x83", String::New("snowman"));
+
+    auto array = Array::New();
+    array->append(String::New("one"));
+    array->append(std::move(inner));
+    array->append(Array::New());
+
+    auto dictionary = Dictionary::New();
+    dictionary->set("array", std::move(array));
+
+    std::vector<uint8_t> contents = Serialize(dictionary.get());
+    auto open = BinaryView::Open(contents);
+    ASSERT_NE(open.first, nullptr);
+
+    BinaryView::Object values = open.first->root().value("array");
+    ASSERT_EQ(values.type(), ObjectType::Array);
+    ASSERT_EQ(values.count(), 3);
+    EXPECT_EQ(values.value(0).string(), "one");
+    EXPECT_EQ(values.value(1).key(0), "\xe2\x98\x83");
+    EXPECT_EQ(values.value(1).value("\xe2\x98\x83").string(), "snowman");
+    EXPECT_EQ(values.value(2).count(), 0);
+    EXPECT_FALSE(values.value(3).valid());
+
+    EXPECT_EQ(open.first->root().key(0), "array");
+    EXPECT_EQ(open.first->root().value(0).count(), 3);
+    EXPECT_FALSE(open.first->root().value(1).valid());
+}
+
+TEST(BinaryView, LargeDictionary)
+{
+    /* Enough keys to index the dictionary. */
+    auto dictionary = Dictionary::New();
+    for (int n = 0; n < 1000; n++) {
+        dictionary->set("key" + std::to_string(n), Integer::New(n));
+    }
+
+    std::vector<uint8_t> contents = Serialize(dictionary.get());
+    auto open = BinaryView::Open(contents);
+    ASSERT_NE(open.first, nullptr);
+
+    BinaryView::Object root = open.first->root();
+    ASSERT_EQ(root.count(), 1000);
+
+    for (int n = 0; n < 1000; n++) {
+        EXPECT_EQ(root.value("key" + std::to_string(n)).integer(), n);
+    }
+    EXPECT_FALSE(root.value("key1000").valid());
+    EXPECT_FALSE(root.value("").valid());
+}
+
+TEST(BinaryView, Invalid)
+{
+    std::vector<uint8_t> contents = Serialize(String::New("value").get());
+
+    /* Not a binary property list. */
+    auto open = BinaryView::Open(std::vector<uint8_t>({ '(', ')' }));
+    EXPECT_EQ(open.first, nullptr);
+    EXPECT_FALSE(open.second.empty());
+
+    /* Truncated contents. */
+    open = BinaryView::Open(ext::span<uint8_t const>(contents).subspan(0, contents.size() - 1));
+    EXPECT_EQ(open.first, nullptr);
+
+    /*
+     * An array that contains itself: bplist00, array of one referencing
+     * object 0, then the offset table and trailer.
+     */
+    std::vector<uint8_t> recursive = {
+        0x62, 0x70, 0x6c, 0x69, 0x73, 0x74, 0x30, 0x30, 0xa1, 0x00, 0x08,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x01,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0a,
+    };
+
+    open = BinaryView::Open(recursive);
+    ASSERT_NE(open.first, nullptr);
+
+    /* Following the references is fine; reading everything is not. */
+    BinaryView::Object root = open.first->root();
+    EXPECT_EQ(root.value(0).value(0).count(), 1);
+    EXPECT_EQ(root.copy(), nullptr);
+    EXPECT_FALSE(open.first->error().empty());
+}
@@ -121,9 +121,9 @@ TEST(Encoding, Detect)
     EXPECT_EQ(Encodings::Detect(Content_UTF32BE), Encoding::UTF8);
     EXPECT_EQ(Encodings::Detect(Content_UTF16LE), Encoding::UTF8);
     EXPECT_EQ(Encodings::Detect(std::vector<uint8_t>()), Encoding::UTF8);
-    EXPECT_EQ(Encodings::Detect({ 0xFF }), Encoding::UTF8);
-    EXPECT_EQ(Encodings::Detect({ 0xFE }), Encoding::UTF8);
-    EXPECT_EQ(Encodings::Detect({ 0xFF, 0xFF, 0xFF }), Encoding::UTF8);
+    EXPECT_EQ(Encodings::Detect(std::vector<uint8_t>({ 0xFF })), Encoding::UTF8);
+    EXPECT_EQ(Encodings::Detect(std::vector<uint8_t>({ 0xFE })), Encoding::UTF8);
+    EXPECT_EQ(Encodings::Detect(std::vector<uint8_t>({ 0xFF, 0xFF, 0xFF })), Encoding::UTF8);
 
     /* Just a BOM should detect as that encoding. */
     for (Encoding encoding : AllEncodings) {
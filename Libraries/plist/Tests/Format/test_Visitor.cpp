@@ -0,0 +1,162 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+#include <plist/Format/ASCII.h>
+#include <plist/Format/Any.h>
+#include <plist/Format/Binary.h>
+#include <plist/Format/JSON.h>
+#include <plist/Format/Visitor.h>
+#include <plist/Format/XML.h>
+#include <plist/Objects.h>
+
+using plist::Format::Visitor;
+using plist::Format::ASCII;
+using plist::Format::Any;
+using plist::Format::Binary;
+using plist::Format::JSON;
+using plist::Format::XML;
+using plist::Format::Encoding;
+
+static std::vector<uint8_t>
+Contents(std::string const &string)
+{
+    return std::vector<uint8_t>(string.begin(), string.end());
+}
+
+/*
+ * Records what it visits, skipping the value of any key named "skip" and
+ * any array after the first.
+ */
+class RecordingVisitor : public Visitor {
+public:
+    std::string result;
+    size_t      arrays;
+
+public:
+    RecordingVisitor() :
+        arrays(0)
+    {
+    }
+
+public:
+    virtual bool beginArray()
+    {
+        if (arrays++ > 0) {
+            return false;
+        }
+
+        result += "( ";
+        return true;
+    }
+
+    virtual void endArray()
+    { result += ") "; }
+
+    virtual bool beginDictionary()
+    {
+        result += "{ ";
+        return true;
+    }
+
+    virtual void endDictionary()
+    { result += "} "; }
+
+    virtual bool key(std::string const &key)
+    {
+        if (key == "skip") {
+            return false;
+        }
+
+        result += key + "= ";
+        return true;
+    }
+
+    virtual void string(std::string const &value)
+    { result += "'" + value + "' "; }
+
+    virtual void integer(int64_t value)
+    { result += std::to_string(value) + " "; }
+
+    virtual void boolean(bool value)
+    { result += (value ? "true " : "false "); }
+};
+
+static std::string const Expected = "{ a= 'one' b= ( 'two' { c= 'three' } ) e= d= { } } ";
+
+TEST(Visitor, ASCII)
+{
+    auto contents = Contents("{ a = one; skip = { x = ( y ); }; b = ( two, { c = three; skip = z; } ); skip = w; e = ( four ); d = { }; }");
+
+    RecordingVisitor visitor;
+    auto result = ASCII::Visit(contents, ASCII::Create(false, Encoding::UTF8), &visitor);
+    ASSERT_TRUE(result.first);
+    EXPECT_EQ(Expected, visitor.result);
+}
+
+TEST(Visitor, JSON)
+{
+    auto contents = Contents("{ \"a\": \"one\", \"skip\": { \"x\": [ \"y\" ] }, \"b\": [ \"two\", { \"c\": \"three\", \"skip\": \"z\" } ], \"skip\": \"w\", \"e\": [ \"four\" ], \"d\": { } }");
+
+    RecordingVisitor visitor;
+    auto result = JSON::Visit(contents, JSON::Create(), &visitor);
+    ASSERT_TRUE(result.first);
+    EXPECT_EQ(Expected, visitor.result);
+}
+
+TEST(Visitor, XML)
+{
+    auto contents = Contents(
+        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        "<plist version=\"1.0\">\n"
+        "<dict>\n"
+        "\t<key>a</key><string>one</string>\n"
+        "\t<key>skip</key><dict><key>x</key><array><string>y</string></array></dict>\n"
+        "\t<key>b</key><array><string>two</string><dict><key>c</key><string>three</string><key>skip</key><string>z</string></dict></array>\n"
+        "\t<key>skip</key><string>w</string>\n"
+        "\t<key>e</key><array><string>four</string></array>\n"
+        "\t<key>d</key><dict/>\n"
+        "</dict>\n"
+        "</plist>\n");
+
+    RecordingVisitor visitor;
+    auto result = XML::Visit(contents, XML::Create(Encoding::UTF8), &visitor);
+    ASSERT_TRUE(result.first);
+    EXPECT_EQ(Expected, visitor.result);
+}
+
+TEST(Visitor, Binary)
+{
+    auto contents = Contents("{ a = one; skip = { x = ( y ); }; b = ( two, { c = three; skip = z; } ); e = ( four ); d = { }; }");
+    auto deserialize = ASCII::Deserialize(contents, ASCII::Create(false, Encoding::UTF8));
+    ASSERT_NE(nullptr, deserialize.first);
+
+    auto serialize = Binary::Serialize(deserialize.first.get(), Binary::Create());
+    ASSERT_NE(nullptr, serialize.first);
+
+    RecordingVisitor visitor;
+    auto result = Any::Visit(*serialize.first, &visitor);
+    ASSERT_TRUE(result.first);
+    EXPECT_EQ(Expected, visitor.result);
+}
+
+TEST(Visitor, Invalid)
+{
+    RecordingVisitor visitor;
+    auto result = ASCII::Visit(Contents("{ a = one; b = "), ASCII::Create(false, Encoding::UTF8), &visitor);
+    EXPECT_FALSE(result.first);
+    EXPECT_FALSE(result.second.empty());
+}
+
+TEST(Visitor, Default)
+{
+    /* Everything is ignored unless overridden. */
+    Visitor visitor;
+    auto result = XML::Visit(Contents("<plist><array><integer>1</integer><data>AQI=</data></array></plist>"), XML::Create(Encoding::UTF8), &visitor);
+    EXPECT_TRUE(result.first);
+}
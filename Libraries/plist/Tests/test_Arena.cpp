@@ -0,0 +1,196 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+#include <plist/Arena/Arena.h>
+#include <plist/Arena/Objects.h>
+#include <plist/Format/ASCII.h>
+#include <plist/Format/Binary.h>
+#include <plist/Format/JSON.h>
+#include <plist/Format/XML.h>
+#include <plist/Objects.h>
+
+namespace Arena = plist::Arena;
+using plist::Format::ASCII;
+using plist::Format::Binary;
+using plist::Format::JSON;
+using plist::Format::XML;
+using plist::Format::Encoding;
+using plist::String;
+using plist::Integer;
+using plist::Data;
+using plist::UID;
+using plist::Array;
+using plist::Dictionary;
+
+static std::vector<uint8_t>
+Contents(std::string const &string)
+{
+    return std::vector<uint8_t>(string.begin(), string.end());
+}
+
+TEST(Arena, String)
+{
+    Arena::Arena arena;
+
+    /* Equal strings are the same string. */
+    Arena::String const *string = arena.string("value");
+    EXPECT_EQ(string, arena.string(std::string("value")));
+    EXPECT_NE(string, arena.string("other"));
+
+    EXPECT_EQ(string->value(), "value");
+    EXPECT_EQ(string->size(), 5);
+    EXPECT_STREQ(string->c_str(), "value");
+    EXPECT_TRUE(string->equals("value"));
+
+    /* Strings stay valid as more are added. */
+    for (int n = 0; n < 10000; n++) {
+        arena.string("string" + std::to_string(n));
+    }
+    EXPECT_EQ(string, arena.string("value"));
+    EXPECT_STREQ(string->c_str(), "value");
+}
+
+TEST(Arena, Dictionary)
+{
+    Arena::Arena arena;
+
+    /* Enough keys to index the dictionary. */
+    std::string contents = "{ ";
+    for (int n = 0; n < 32; n++) {
+        contents += "key" + std::to_string(n) + " = value" + std::to_string(n) + "; ";
+    }
+    contents += "key3 = replaced; }";
+
+    auto deserialize = ASCII::Deserialize(Contents(contents), ASCII::Create(false, Encoding::UTF8), &arena);
+    ASSERT_NE(deserialize.first, nullptr);
+
+    Arena::Dictionary const *dictionary = Arena::CastTo<Arena::Dictionary>(deserialize.first);
+    ASSERT_NE(dictionary, nullptr);
+    EXPECT_EQ(dictionary->count(), 32);
+
+    Arena::String const *value = dictionary->value<Arena::String>("key10");
+    ASSERT_NE(value, nullptr);
+    EXPECT_EQ(value->value(), "value10");
+    EXPECT_EQ(dictionary->value("missing"), nullptr);
+
+    /* A replaced key moves to the end. */
+    EXPECT_EQ(dictionary->key(31)->value(), "key3");
+    EXPECT_EQ(dictionary->value<Arena::String>("key3")->value(), "replaced");
+    EXPECT_EQ(dictionary->key(3)->value(), "key4");
+
+    /* Keys and values are shared. */
+    EXPECT_EQ(dictionary->key(0), arena.string("key0"));
+    EXPECT_EQ(dictionary->value(0), arena.string("value0"));
+}
+
+TEST(Arena, ASCII)
+{
+    auto contents = Contents("{ string = value; array = ( one, two ); data = <0102>; empty = { }; }");
+
+    Arena::Arena arena;
+    auto deserialize = ASCII::Deserialize(contents, ASCII::Create(false, Encoding::UTF8), &arena);
+    ASSERT_NE(deserialize.first, nullptr);
+
+    auto expected = ASCII::Deserialize(contents, ASCII::Create(false, Encoding::UTF8));
+    ASSERT_NE(expected.first, nullptr);
+    EXPECT_TRUE(deserialize.first->copy()->equals(expected.first.get()));
+
+    Arena::Array const *array = Arena::CastTo<Arena::Dictionary>(deserialize.first)->value<Arena::Array>("array");
+    ASSERT_NE(array, nullptr);
+    EXPECT_EQ(array->count(), 2);
+    EXPECT_EQ(array->value<Arena::String>(1)->value(), "two");
+
+    /* Errors are reported the same way. */
+    auto invalid = ASCII::Deserialize(Contents("{ key = "), ASCII::Create(false, Encoding::UTF8), &arena);
+    EXPECT_EQ(invalid.first, nullptr);
+    EXPECT_FALSE(invalid.second.empty());
+}
+
+TEST(Arena, XML)
+{
+    auto contents = Contents(
+        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        "<plist version=\"1.0\">\n"
+        "<dict>\n"
+        "\t<key>object</key>\n"
+        "\t<dict>\n\t\t<key>CF$UID</key>\n\t\t<integer>4</integer>\n\t</dict>\n"
+        "\t<key>notUID</key>\n"
+        "\t<dict>\n\t\t<key>CF$UID</key>\n\t\t<integer>5</integer>\n\t\t<key>other</key>\n\t\t<true/>\n\t</dict>\n"
+        "\t<key>data</key>\n"
+        "\t<data>AQI=</data>\n"
+        "\t<key>array</key>\n"
+        "\t<array>\n\t\t<real>1.5</real>\n\t\t<string>two</string>\n\t\t<dict/>\n\t</array>\n"
+        "</dict>\n"
+        "</plist>\n");
+
+    Arena::Arena arena;
+    auto deserialize = XML::Deserialize(contents, XML::Create(Encoding::UTF8), &arena);
+    ASSERT_NE(deserialize.first, nullptr);
+
+    auto expected = XML::Deserialize(contents, XML::Create(Encoding::UTF8));
+    ASSERT_NE(expected.first, nullptr);
+    EXPECT_TRUE(deserialize.first->copy()->equals(expected.first.get()));
+
+    Arena::Dictionary const *dictionary = Arena::CastTo<Arena::Dictionary>(deserialize.first);
+    ASSERT_NE(dictionary, nullptr);
+
+    Arena::UID const *uid = dictionary->value<Arena::UID>("object");
+    ASSERT_NE(uid, nullptr);
+    EXPECT_EQ(uid->value(), 4);
+
+    Arena::Dictionary const *notUID = dictionary->value<Arena::Dictionary>("notUID");
+    ASSERT_NE(notUID, nullptr);
+    EXPECT_EQ(notUID->count(), 2);
+
+    Arena::Data const *data = dictionary->value<Arena::Data>("data");
+    ASSERT_NE(data, nullptr);
+    EXPECT_EQ(data->value(), std::vector<uint8_t>({ 0x01, 0x02 }));
+}
+
+TEST(Arena, JSON)
+{
+    auto contents = Contents("{ \"string\": \"value\", \"array\": [ 1, 2.5, true ], \"null\": null }");
+
+    Arena::Arena arena;
+    auto deserialize = JSON::Deserialize(contents, JSON::Create(), &arena);
+    ASSERT_NE(deserialize.first, nullptr);
+
+    Arena::Dictionary const *dictionary = Arena::CastTo<Arena::Dictionary>(deserialize.first);
+    ASSERT_NE(dictionary, nullptr);
+    EXPECT_NE(dictionary->value<Arena::Null>("null"), nullptr);
+
+    Arena::Array const *array = dictionary->value<Arena::Array>("array");
+    ASSERT_NE(array, nullptr);
+    ASSERT_EQ(array->count(), 3);
+    EXPECT_EQ(array->value<Arena::Integer>(0)->value(), 1);
+    EXPECT_EQ(array->value<Arena::Real>(1)->value(), 2.5);
+    EXPECT_TRUE(array->value<Arena::Boolean>(2)->value());
+}
+
+TEST(Arena, Binary)
+{
+    auto dictionary = Dictionary::New();
+    dictionary->set("string", String::New("value"));
+    dictionary->set("integer", Integer::New(42));
+    dictionary->set("uid", UID::New(7));
+    dictionary->set("data", Data::New(std::vector<uint8_t>({ 0x01, 0x02 })));
+
+    auto array = Array::New();
+    array->append(String::New("value"));
+    array->append(String::New("value"));
+    dictionary->set("array", std::move(array));
+
+    auto serialize = Binary::Serialize(dictionary.get(), Binary::Create());
+    ASSERT_NE(serialize.first, nullptr);
+
+    Arena::Arena arena;
+    auto deserialize = Binary::Deserialize(*serialize.first, Binary::Create(), &arena);
+    ASSERT_NE(deserialize.first, nullptr);
+    EXPECT_TRUE(deserialize.first->copy()->equals(dictionary.get()));
+}
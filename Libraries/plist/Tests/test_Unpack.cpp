@@ -0,0 +1,49 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+#include <plist/Objects.h>
+#include <plist/Keys/Unpack.h>
+
+using plist::String;
+using plist::Dictionary;
+using plist::Keys::Unpack;
+
+TEST(Unpack, Complete)
+{
+    auto dict = Dictionary::New();
+    dict->set("Handled", String::New("value"));
+    dict->set("Unhandled", String::New("value"));
+
+    std::unordered_set<std::string> seen;
+    Unpack unpack = Unpack("Test", dict.get(), &seen);
+    EXPECT_NE(nullptr, unpack.cast<String>("Handled"));
+    EXPECT_EQ(nullptr, unpack.cast<String>("Missing"));
+
+    /* Only keys in the dictionary are reported as unhandled. */
+    EXPECT_FALSE(unpack.complete(true));
+    ASSERT_EQ(1, unpack.errors().size());
+    EXPECT_EQ("unhandled Test key Unhandled", unpack.errors().front());
+}
+
+TEST(Unpack, Subtype)
+{
+    auto dict = Dictionary::New();
+    dict->set("Base", String::New("value"));
+    dict->set("Derived", String::New("value"));
+
+    /* Keys unpacked by another type sharing the seen set are handled. */
+    std::unordered_set<std::string> seen;
+    Unpack base = Unpack("Base", dict.get(), &seen);
+    EXPECT_NE(nullptr, base.cast<String>("Base"));
+    EXPECT_TRUE(base.complete(false));
+
+    Unpack derived = Unpack("Derived", dict.get(), &seen);
+    EXPECT_NE(nullptr, derived.cast<String>("Derived"));
+    EXPECT_TRUE(derived.complete(true));
+}
@@ -0,0 +1,357 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree.
+ */
+
+#include <plist/Format/Any.h>
+#include <plist/Format/ASCII.h>
+#include <plist/Format/Binary.h>
+#include <plist/Format/BinaryView.h>
+#include <plist/Format/Visitor.h>
+#include <plist/Format/XML.h>
+#include <plist/Format/ASCIIPListLexer.h>
+#include <plist/Objects.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using plist::Format::Any;
+using plist::Format::ASCII;
+using plist::Format::Binary;
+using plist::Format::BinaryView;
+using plist::Format::XML;
+using plist::Format::Encoding;
+using plist::Format::Visitor;
+
+/*
+ * Track allocated memory, so the peak used by each way of reading can be
+ * compared. Each allocation is prefixed with its size.
+ */
+static size_t AllocatedCurrent = 0;
+static size_t AllocatedPeak = 0;
+
+static size_t const AllocationHeader = 16;
+
+void *
+operator new(size_t size)
+{
+    uint8_t *allocation = static_cast<uint8_t *>(malloc(size + AllocationHeader));
+    if (allocation == nullptr) {
+        abort();
+    }
+
+    *reinterpret_cast<size_t *>(allocation) = size;
+    AllocatedCurrent += size;
+    if (AllocatedCurrent > AllocatedPeak) {
+        AllocatedPeak = AllocatedCurrent;
+    }
+
+    return allocation + AllocationHeader;
+}
+
+void
+operator delete(void *pointer) noexcept
+{
+    if (pointer != nullptr) {
+        uint8_t *allocation = static_cast<uint8_t *>(pointer) - AllocationHeader;
+        AllocatedCurrent -= *reinterpret_cast<size_t *>(allocation);
+        free(allocation);
+    }
+}
+
+void *
+operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void
+operator delete[](void *pointer) noexcept
+{
+    operator delete(pointer);
+}
+
+void
+operator delete(void *pointer, size_t size) noexcept
+{
+    operator delete(pointer);
+}
+
+void
+operator delete[](void *pointer, size_t size) noexcept
+{
+    operator delete(pointer);
+}
+
+/*
+ * Counts everything in the contents, as a consumer reading all of it would.
+ */
+class CountingVisitor : public Visitor {
+public:
+    size_t count;
+
+public:
+    CountingVisitor() :
+        count(0)
+    {
+    }
+
+public:
+    virtual bool beginArray()
+    { count++; return true; }
+    virtual bool beginDictionary()
+    { count++; return true; }
+    virtual bool key(std::string const &key)
+    { count++; return true; }
+    virtual void string(std::string const &value)
+    { count++; }
+    virtual void integer(int64_t value)
+    { count++; }
+    virtual void real(double value)
+    { count++; }
+    virtual void boolean(bool value)
+    { count++; }
+    virtual void data(std::vector<uint8_t> const &value)
+    { count++; }
+};
+
+/*
+ * Reads only the values directly in the root, skipping any nested
+ * containers, as a consumer looking for a few keys would.
+ */
+class TopLevelVisitor : public Visitor {
+public:
+    size_t count;
+    size_t depth;
+
+public:
+    TopLevelVisitor() :
+        count(0),
+        depth(0)
+    {
+    }
+
+public:
+    virtual bool beginArray()
+    { return depth++ == 0; }
+    virtual void endArray()
+    { depth--; }
+    virtual bool beginDictionary()
+    { return depth++ == 0; }
+    virtual void endDictionary()
+    { depth--; }
+    virtual void string(std::string const &value)
+    { count++; }
+    virtual void integer(int64_t value)
+    { count++; }
+};
+
+/*
+ * Creates a project file shaped like a large project's: a flat table of
+ * objects referring to each other by identifier.
+ */
+static std::vector<uint8_t>
+CreateProject(size_t files)
+{
+    std::string contents = "// !$*UTF8*$!\n{\n\tarchiveVersion = 1;\n\tclasses = {\n\t};\n\tobjectVersion = 46;\n\tobjects = {\n";
+
+    std::string children;
+    for (size_t n = 0; n < files; n++) {
+        char identifier[25];
+        snprintf(identifier, sizeof(identifier), "%024zX", n * 2);
+        char buildIdentifier[25];
+        snprintf(buildIdentifier, sizeof(buildIdentifier), "%024zX", n * 2 + 1);
+
+        std::string name = "Source" + std::to_string(n) + ".m";
+        contents += "\t\t" + std::string(identifier) + " /* " + name + " */ = {isa = PBXFileReference; fileEncoding = 4; lastKnownFileType = sourcecode.c.objc; path = " + name + "; sourceTree = \"<group>\"; };\n";
+        contents += "\t\t" + std::string(buildIdentifier) + " /* " + name + " in Sources */ = {isa = PBXBuildFile; fileRef = " + identifier + " /* " + name + " */; settings = {COMPILER_FLAGS = \"-fno-objc-arc -DSOURCE=" + std::to_string(n) + "\"; }; };\n";
+        children += "\t\t\t\t" + std::string(identifier) + " /* " + name + " */,\n";
+    }
+
+    contents += "\t\tFFFFFFFFFFFFFFFFFFFFFFFF /* Sources */ = {\n\t\t\tisa = PBXGroup;\n\t\t\tchildren = (\n" + children + "\t\t\t);\n\t\t\tpath = Sources;\n\t\t\tsourceTree = \"<group>\";\n\t\t};\n";
+    contents += "\t};\n\trootObject = FFFFFFFFFFFFFFFFFFFFFFFF /* Sources */;\n}\n";
+    return std::vector<uint8_t>(contents.begin(), contents.end());
+}
+
+/*
+ * Creates an Info.plist with many document types and nested values.
+ */
+static std::vector<uint8_t>
+CreateInfo(size_t types)
+{
+    std::string contents =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        "<!DOCTYPE plist PUBLIC \"-//Apple//DTD PLIST 1.0//EN\" \"http://www.apple.com/DTDs/PropertyList-1.0.dtd\">\n"
+        "<plist version=\"1.0\">\n<dict>\n"
+        "\t<key>CFBundleIdentifier</key>\n\t<string>com.example.benchmark</string>\n"
+        "\t<key>CFBundleVersion</key>\n\t<string>1.0</string>\n"
+        "\t<key>CFBundleDocumentTypes</key>\n\t<array>\n";
+
+    for (size_t n = 0; n < types; n++) {
+        std::string type = "com.example.type" + std::to_string(n);
+        contents +=
+            "\t\t<dict>\n"
+            "\t\t\t<key>CFBundleTypeName</key>\n\t\t\t<string>Document Type " + std::to_string(n) + "</string>\n"
+            "\t\t\t<key>CFBundleTypeRole</key>\n\t\t\t<string>Editor</string>\n"
+            "\t\t\t<key>LSHandlerRank</key>\n\t\t\t<string>Owner</string>\n"
+            "\t\t\t<key>LSItemContentTypes</key>\n\t\t\t<array>\n\t\t\t\t<string>" + type + "</string>\n\t\t\t\t<string>" + type + ".legacy</string>\n\t\t\t</array>\n"
+            "\t\t\t<key>LSIsAppleDefaultForType</key>\n\t\t\t<true/>\n"
+            "\t\t</dict>\n";
+    }
+
+    contents += "\t</array>\n</dict>\n</plist>\n";
+    return std::vector<uint8_t>(contents.begin(), contents.end());
+}
+
+template<typename F>
+static void
+Measure(char const *name, size_t size, size_t iterations, F const &function)
+{
+    size_t baseline = AllocatedCurrent;
+    AllocatedPeak = AllocatedCurrent;
+
+    auto start = std::chrono::steady_clock::now();
+    size_t checksum = 0;
+    for (size_t i = 0; i < iterations; i++) {
+        checksum += function();
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double milliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+    double throughput = (size * iterations) / (milliseconds / 1000.0) / (1024.0 * 1024.0);
+    printf("  %-22s %10.3f ms %9.1f MB/s %12zu bytes peak (checksum %zu)\n", name, milliseconds / iterations, throughput, AllocatedPeak - baseline, checksum);
+}
+
+static void
+Benchmark(std::string const &name, std::vector<uint8_t> const &contents, size_t iterations)
+{
+    std::unique_ptr<Any> format = Any::Identify(contents);
+    if (format == nullptr) {
+        fprintf(stderr, "error: %s: couldn't identify format\n", name.c_str());
+        return;
+    }
+
+    printf("%s (%zu bytes):\n", name.c_str(), contents.size());
+
+    if (format->type() == plist::Format::Type::ASCII && format->format<ASCII>()->encoding() == Encoding::UTF8) {
+        /* Only tokenize, to separate the lexer from the parser. */
+        Measure("lex", contents.size(), iterations, [&]() -> size_t {
+            ASCIIPListLexer lexer;
+            ASCIIPListLexerInit(&lexer, reinterpret_cast<char const *>(contents.data()), contents.size(), kASCIIPListLexerStyleASCII);
+
+            size_t count = 0;
+            while (ASCIIPListLexerReadToken(&lexer) >= 0) {
+                count++;
+            }
+            return count;
+        });
+    }
+
+    Measure("objects", contents.size(), iterations, [&]() -> size_t {
+        auto result = Any::Deserialize(contents, *format);
+        return result.first != nullptr ? 1 : 0;
+    });
+
+    Measure("arena", contents.size(), iterations, [&]() -> size_t {
+        plist::Arena::Arena arena;
+        auto result = Any::Deserialize(contents, *format, &arena);
+        return result.first != nullptr ? arena.size() : 0;
+    });
+
+    Measure("visit all", contents.size(), iterations, [&]() -> size_t {
+        CountingVisitor visitor;
+        auto result = Any::Visit(contents, *format, &visitor);
+        return result.first ? visitor.count : 0;
+    });
+
+    Measure("visit top level", contents.size(), iterations, [&]() -> size_t {
+        TopLevelVisitor visitor;
+        auto result = Any::Visit(contents, *format, &visitor);
+        return result.first ? visitor.count : 0;
+    });
+
+    if (format->type() == plist::Format::Type::Binary) {
+        /* The same values as visiting the top level, read in place. */
+        Measure("view top level", contents.size(), iterations, [&]() -> size_t {
+            auto view = BinaryView::Open(contents);
+            if (view.first == nullptr) {
+                return 0;
+            }
+
+            BinaryView::Object const &root = view.first->root();
+            size_t count = 0;
+            for (size_t n = 0; n < root.count(); n++) {
+                BinaryView::Object value = root.value(n);
+                if (value.type() == plist::ObjectType::String || value.type() == plist::ObjectType::Integer) {
+                    count++;
+                }
+            }
+            return count;
+        });
+
+        Measure("view lookup", contents.size(), iterations, [&]() -> size_t {
+            auto view = BinaryView::Open(contents);
+            if (view.first == nullptr) {
+                return 0;
+            }
+
+            /* Find the root object, as a project file is read. */
+            BinaryView::Object const &root = view.first->root();
+            BinaryView::Object object = root.value("objects").value(root.value("rootObject").string());
+            return object.count();
+        });
+    }
+}
+
+static std::vector<uint8_t>
+ToBinary(std::vector<uint8_t> const &contents)
+{
+    auto deserialize = Any::Deserialize(contents);
+    if (deserialize.first == nullptr) {
+        return std::vector<uint8_t>();
+    }
+
+    auto serialize = Binary::Serialize(deserialize.first.get(), Binary::Create());
+    return serialize.first != nullptr ? *serialize.first : std::vector<uint8_t>();
+}
+
+int
+main(int argc, char **argv)
+{
+    size_t iterations = (argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10);
+    if (iterations == 0) {
+        fprintf(stderr, "usage: %s [iterations [file ...]]\n", argv[0]);
+        return 1;
+    }
+
+    if (argc > 2) {
+        for (int n = 2; n < argc; n++) {
+            std::ifstream file = std::ifstream(argv[n], std::ios::binary);
+            if (file.fail()) {
+                fprintf(stderr, "error: %s: couldn't read file\n", argv[n]);
+                return 1;
+            }
+
+            std::vector<uint8_t> contents = std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+            Benchmark(argv[n], contents, iterations);
+        }
+    } else {
+        std::vector<uint8_t> project = CreateProject(20000);
+        Benchmark("project.pbxproj (generated)", project, iterations);
+        Benchmark("project.pbxproj (generated, binary)", ToBinary(project), iterations);
+
+        std::vector<uint8_t> info = CreateInfo(5000);
+        Benchmark("Info.plist (generated)", info, iterations);
+        Benchmark("Info.plist (generated, binary)", ToBinary(info), iterations);
+    }
+
+    return 0;
+}
@@ -11,6 +11,10 @@
 
 #include <process/Launcher.h>
 
+#include <memory>
+#include <mutex>
+#include <vector>
+
 namespace libutil { class Filesystem; }
 
 namespace process {
@@ -19,12 +23,24 @@ namespace process {
  * Abstract process launcher.
  */
 class DefaultLauncher : public Launcher {
+private:
+    class Running;
+
+private:
+    std::mutex                            _mutex;
+    std::vector<std::unique_ptr<Running>> _running;
+
 public:
     DefaultLauncher();
+    DefaultLauncher(DefaultLauncher &&launcher);
     ~DefaultLauncher();
 
 public:
-    virtual ext::optional<int> launch(libutil::Filesystem *filesystem, Context const *context);
+    virtual ext::optional<int> launch(libutil::Filesystem *filesystem, Context const *context, std::string *output);
+
+public:
+    virtual ext::optional<Handle> start(libutil::Filesystem *filesystem, Context const *context);
+    virtual ext::optional<Result> wait(bool block);
 };
 
 }
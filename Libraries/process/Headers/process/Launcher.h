@@ -9,6 +9,12 @@
 #ifndef __process_Launcher_h
 #define __process_Launcher_h
 
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
 #include <ext/optional>
 
 namespace libutil { class Filesystem; }
@@ -21,18 +27,99 @@ class Context;
  * Abstract process launcher.
  */
 class Launcher {
+public:
+    /*
+     * Identifies a process started without waiting for it.
+     */
+    using Handle = uint64_t;
+
+    /*
+     * A started process, once it has finished.
+     */
+    class Result {
+    private:
+        Handle             _handle;
+        ext::optional<int> _exitCode;
+        std::string        _standardOutput;
+        std::string        _standardError;
+
+    public:
+        Result(Handle handle, ext::optional<int> const &exitCode, std::string const &standardOutput, std::string const &standardError);
+
+    public:
+        /*
+         * The process that finished.
+         */
+        Handle handle() const
+        { return _handle; }
+
+        /*
+         * The exit code of the process, if it exited normally.
+         */
+        ext::optional<int> const &exitCode() const
+        { return _exitCode; }
+
+    public:
+        /*
+         * Everything the process wrote to standard output before it exited.
+         */
+        std::string const &standardOutput() const
+        { return _standardOutput; }
+
+        /*
+         * Everything the process wrote to standard error before it exited.
+         */
+        std::string const &standardError() const
+        { return _standardError; }
+    };
+
+private:
+    std::mutex                                     _mutex;
+    Handle                                         _nextHandle;
+    std::deque<std::pair<std::thread::id, Result>> _finished;
+
 protected:
     Launcher();
+    Launcher(Launcher const &launcher);
     ~Launcher();
 
+protected:
+    /*
+     * A handle not yet used for any process.
+     */
+    Handle nextHandle();
+
 public:
     /*
      * Launch and wait for a process. The filesystem is symbolic, to note
      * that launching a process could arbitrarily affect the filesystem.
+     *
+     * If `output` is provided, the combined standard output and error of
+     * the process is appended to it rather than written to standard output.
      */
-    virtual ext::optional<int> launch(libutil::Filesystem *filesystem, Context const *context) = 0;
-};
+    virtual ext::optional<int> launch(libutil::Filesystem *filesystem, Context const *context, std::string *output) = 0;
+
+public:
+    /*
+     * Start a process without waiting for it to finish, capturing its
+     * standard output and error separately. Returns nullopt if the process
+     * couldn't be started. Use `wait` to find out when it finishes.
+     *
+     * By default, the process is launched and finishes before returning,
+     * with its combined output captured as standard output.
+     */
+    virtual ext::optional<Handle> start(libutil::Filesystem *filesystem, Context const *context);
 
+    /*
+     * Wait for any process started on this thread to finish, and return its
+     * result. If `block` is false, returns nullopt instead of waiting if none
+     * have finished yet. Also returns nullopt if there are no such processes.
+     *
+     * Each thread waits only for the processes it started, so any number of
+     * threads can each drive many processes at once with one launcher.
+     */
+    virtual ext::optional<Result> wait(bool block);
+};
 }
 
 #endif  // !__process_Launcher_h
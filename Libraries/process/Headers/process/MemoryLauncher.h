@@ -36,7 +36,7 @@ public:
     ~MemoryLauncher();
 
 public:
-    virtual ext::optional<int> launch(libutil::Filesystem *filesystem, Context const *context);
+    virtual ext::optional<int> launch(libutil::Filesystem *filesystem, Context const *context, std::string *output);
 };
 
 }
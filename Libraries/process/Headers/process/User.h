@@ -14,6 +14,8 @@
 
 namespace process {
 
+class Context;
+
 /*
  * The information passed into a launched process.
  */
@@ -49,6 +51,14 @@ public:
      * The home directory from the environment.
      */
     virtual ext::optional<std::string> userHomeDirectory() const = 0;
+
+    /*
+     * The directory for the user's caches, usually inside the home directory.
+     * Except on Windows and macOS, `XDG_CACHE_HOME` is used instead if it is
+     * an absolute path.
+     * Anything in it can be removed at any time.
+     */
+    ext::optional<std::string> userCacheDirectory(Context const *context) const;
 };
 
 }
@@ -10,21 +10,49 @@
 #include <process/Context.h>
 #include <libutil/Filesystem.h>
 
+#include <algorithm>
+#include <thread>
+
 #if _WIN32
 #include <windows.h>
 #else
+#include <cerrno>
+#include <cstring>
+#include <mutex>
 #include <fcntl.h>
+#include <poll.h>
+#include <spawn.h>
 #include <sys/wait.h>
 #include <unistd.h>
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
 #endif
 
 // In most cases, size of pipe will be greater than one page,
 #define PIPE_BUFFER_SIZE 4096
 
 using process::DefaultLauncher;
+using process::Launcher;
 using process::Context;
 using libutil::Filesystem;
 
+#if !_WIN32
+extern char **environ;
+
+/*
+ * Spawning can only change the directory of the new process with an
+ * extension to posix_spawn; without it, fall back to vfork().
+ */
+#if defined(__APPLE__)
+#define HAVE_POSIX_SPAWN_CHDIR 1
+#elif defined(__GLIBC__)
+#if __GLIBC_PREREQ(2, 29)
+#define HAVE_POSIX_SPAWN_CHDIR 1
+#endif
+#endif
+#endif
+
 #if _WIN32
 using WideString = std::basic_string<std::remove_const<std::remove_pointer<LPCWSTR>::type>::type>;
 
@@ -91,19 +119,304 @@ EscapedToken(const WideString &token)
 }
 #endif
 
+#if !_WIN32
+/*
+ * Create a pipe that isn't inherited by other processes, which would
+ * keep it open after the process it's for exits.
+ */
+static bool
+CreatePipe(int fds[2])
+{
+#if defined(__linux__)
+    return ::pipe2(fds, O_CLOEXEC) == 0;
+#else
+    if (::pipe(fds) != 0) {
+        return false;
+    }
+
+    ::fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+    ::fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+    return true;
+#endif
+}
+
+/*
+ * Without pipe2(), pipes are only marked not to be inherited after they are
+ * created, so a process started by another thread in between would inherit
+ * them. When spawning can't limit what is inherited, hold this lock from
+ * creating pipes until the process using them has been started.
+ */
+static std::unique_lock<std::mutex>
+LockSpawn()
+{
+#if HAVE_POSIX_SPAWN_CHDIR
+    return std::unique_lock<std::mutex>();
+#else
+    static std::mutex mutex;
+    return std::unique_lock<std::mutex>(mutex);
+#endif
+}
+
+/*
+ * Wait for a process to exit, and find its exit code. A process killed
+ * by a signal has no exit code.
+ */
+static ext::optional<int>
+Reap(pid_t pid)
+{
+    int status;
+    while (::waitpid(pid, &status, 0) < 0) {
+        if (errno != EINTR) {
+            return ext::nullopt;
+        }
+    }
+
+    if (!WIFEXITED(status)) {
+        return ext::nullopt;
+    }
+
+    return WEXITSTATUS(status);
+}
+
+/*
+ * Start a process with its standard output and error redirected. Spawning
+ * avoids copying the page tables of this process, which can be large, like
+ * fork() would just to replace them immediately after.
+ */
+static ext::optional<pid_t>
+Spawn(Context const *context, std::string const &path, int outputFD, int errorFD)
+{
+    /*
+     * Extract input data for exec, so no C++ is required in the child.
+     */
+    char const *cPath = path.c_str();
+
+    std::string directory = context->currentDirectory();
+    char const *cDirectory = directory.c_str();
+
+    /* Compute command-line arguments. */
+    std::vector<char const *> execArgs;
+    execArgs.push_back(cPath);
+
+    std::vector<std::string> arguments = context->commandLineArguments();
+    for (std::string const &argument : arguments) {
+        execArgs.push_back(argument.c_str());
+    }
+
+    execArgs.push_back(nullptr);
+    char *const *cExecArgs = const_cast<char *const *>(execArgs.data());
+
+    /* Compute environment variables. */
+    std::vector<std::string> envValues;
+    for (auto const &value : context->environmentVariables()) {
+        envValues.push_back(value.first + "=" + value.second);
+    }
+
+    std::vector<char const *> execEnv;
+    for (auto const &value : envValues) {
+        execEnv.push_back(value.c_str());
+    }
+    execEnv.push_back(nullptr);
+    char *const *cExecEnv = const_cast<char *const *>(execEnv.data());
+
+#if HAVE_POSIX_SPAWN_CHDIR
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, outputFD, STDOUT_FILENO);
+    posix_spawn_file_actions_adddup2(&actions, errorFD, STDERR_FILENO);
+    posix_spawn_file_actions_addchdir_np(&actions, cDirectory);
+
+    posix_spawnattr_t attributes;
+    posix_spawnattr_init(&attributes);
+#if defined(__APPLE__)
+    /* Only inherit the descriptors set up above, even if not yet marked otherwise. */
+    posix_spawnattr_setflags(&attributes, POSIX_SPAWN_CLOEXEC_DEFAULT);
+    posix_spawn_file_actions_addinherit_np(&actions, STDIN_FILENO);
+#endif
+
+    pid_t pid;
+    int error = ::posix_spawn(&pid, cPath, &actions, &attributes, cExecArgs, cExecEnv);
+    posix_spawnattr_destroy(&attributes);
+    posix_spawn_file_actions_destroy(&actions);
+
+    if (error != 0) {
+        /* Spawn failed, including if the directory or executable could not be used. */
+        fprintf(stderr, "error: unable to run %s in %s: %s\n", cPath, cDirectory, strerror(error));
+        return ext::nullopt;
+    }
+
+    return pid;
+#else
+    /*
+     * The new process reports why it couldn't change directory or run the
+     * executable through this pipe; it's closed without a report on exec.
+     */
+    int errorPipe[2];
+    if (!CreatePipe(errorPipe)) {
+        ::perror("pipe");
+        return ext::nullopt;
+    }
+
+    /*
+     * The new process shares memory with this one until it calls exec, so
+     * it can only make system calls. This process waits until then.
+     */
+    pid_t pid = ::vfork();
+    if (pid < 0) {
+        /* Fork failed. */
+        ::perror("vfork");
+        ::close(errorPipe[0]);
+        ::close(errorPipe[1]);
+        return ext::nullopt;
+    } else if (pid == 0) {
+        /* Fork succeeded, new process. */
+        ::dup2(outputFD, STDOUT_FILENO);
+        ::dup2(errorFD, STDERR_FILENO);
+
+        int failure[2];
+        if (::chdir(cDirectory) == -1) {
+            failure[0] = 0;
+            failure[1] = errno;
+            ssize_t written = ::write(errorPipe[1], failure, sizeof(failure));
+            (void)written;
+            ::_exit(1);
+        }
+
+        ::execve(cPath, cExecArgs, cExecEnv);
+        failure[0] = 1;
+        failure[1] = errno;
+        ssize_t written = ::write(errorPipe[1], failure, sizeof(failure));
+        (void)written;
+        ::_exit(-1);
+    }
+
+    ::close(errorPipe[1]);
+
+    int failure[2];
+    ssize_t size;
+    do {
+        size = ::read(errorPipe[0], failure, sizeof(failure));
+    } while (size < 0 && errno == EINTR);
+    ::close(errorPipe[0]);
+
+    if (size == sizeof(failure)) {
+        if (failure[0] == 0) {
+            fprintf(stderr, "error: unable to change directory to %s: %s\n", cDirectory, strerror(failure[1]));
+        } else {
+            fprintf(stderr, "error: unable to run %s: %s\n", cPath, strerror(failure[1]));
+        }
+
+        Reap(pid);
+        return ext::nullopt;
+    }
+
+    return pid;
+#endif
+}
+
+/*
+ * Check if a process has exited without waiting for it, and find its exit
+ * code if so. A process killed by a signal has no exit code.
+ */
+static bool
+Exited(pid_t pid, ext::optional<int> *exitCode)
+{
+    int status;
+    pid_t result;
+    do {
+        result = ::waitpid(pid, &status, WNOHANG);
+    } while (result < 0 && errno == EINTR);
+
+    if (result == 0) {
+        return false;
+    } else if (result < 0 || !WIFEXITED(status)) {
+        *exitCode = ext::nullopt;
+        return true;
+    }
+
+    *exitCode = WEXITSTATUS(status);
+    return true;
+}
+
+/*
+ * Open a descriptor that becomes readable when a process exits, so waiting
+ * for it can be combined with waiting for its output. Not available on all
+ * systems; without it, processes are checked for exit periodically.
+ */
+static int
+OpenProcess(pid_t pid)
+{
+#if defined(__linux__) && defined(SYS_pidfd_open)
+    int fd = static_cast<int>(::syscall(SYS_pidfd_open, pid, 0));
+    if (fd != -1) {
+        ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+    }
+    return fd;
+#else
+    (void)pid;
+    return -1;
+#endif
+}
+
+/*
+ * How often to check if processes have exited, in milliseconds, when
+ * they can't be waited for along with their output.
+ */
+static int const ExitPollInterval = 10;
+#endif
+
+/*
+ * A process started but not yet waited for.
+ */
+class DefaultLauncher::Running {
+public:
+    Handle          handle;
+    std::thread::id thread;
+#if !_WIN32
+    pid_t           pid;
+    int             processFD;
+    int             outputFD;
+    int             errorFD;
+#endif
+    std::string     standardOutput;
+    std::string     standardError;
+};
+
 DefaultLauncher::
 DefaultLauncher() :
     Launcher()
 {
 }
 
+DefaultLauncher::
+DefaultLauncher(DefaultLauncher &&launcher) :
+    Launcher(launcher),
+    _running(std::move(launcher._running))
+{
+}
+
 DefaultLauncher::
 ~DefaultLauncher()
 {
+#if !_WIN32
+    /* Don't leave behind processes that were never waited for. */
+    for (std::unique_ptr<Running> const &running : _running) {
+        if (running->outputFD != -1) {
+            ::close(running->outputFD);
+        }
+        if (running->errorFD != -1) {
+            ::close(running->errorFD);
+        }
+        if (running->processFD != -1) {
+            ::close(running->processFD);
+        }
+        Reap(running->pid);
+    }
+#endif
 }
 
 ext::optional<int> DefaultLauncher::
-launch(Filesystem *filesystem, Context const *context)
+launch(Filesystem *filesystem, Context const *context, std::string *output)
 {
 #if _WIN32
     WideString executablePath = StringToWideString(context->executablePath());
@@ -124,25 +437,76 @@ launch(Filesystem *filesystem, Context const *context)
 
     WideString currentDirectory = StringToWideString(context->currentDirectory());
 
+    /*
+     * Setup parent-child stdout/stderr pipe. Only the child's end is
+     * inherited; if it kept the parent's end, the pipe would never close.
+     */
+    SECURITY_ATTRIBUTES attributes;
+    memset(&attributes, 0, sizeof(attributes));
+    attributes.nLength = sizeof(attributes);
+    attributes.bInheritHandle = TRUE;
+
+    HANDLE readPipe;
+    HANDLE writePipe;
+    if (!CreatePipe(&readPipe, &writePipe, &attributes, 0)) {
+        return ext::nullopt;
+    }
+
+    if (!SetHandleInformation(readPipe, HANDLE_FLAG_INHERIT, 0)) {
+        CloseHandle(readPipe);
+        CloseHandle(writePipe);
+        return ext::nullopt;
+    }
+
+    /* Redirect both stdout and stderr into the pipe. */
     STARTUPINFOW startup;
     memset(&startup, 0, sizeof(startup));
     startup.cb = sizeof(startup);
+    startup.dwFlags = STARTF_USESTDHANDLES;
+    startup.hStdInput = GetStdHandle(STD_INPUT_HANDLE);
+    startup.hStdOutput = writePipe;
+    startup.hStdError = writePipe;
 
     PROCESS_INFORMATION process;
-    if (!CreateProcessW(
+    BOOL created = CreateProcessW(
         executablePath.c_str(),
         &arguments[0],
         nullptr,
         nullptr,
-        FALSE,
+        TRUE,
         CREATE_UNICODE_ENVIRONMENT,
         static_cast<LPVOID>(&environment[0]),
         currentDirectory.c_str(),
         &startup,
-        &process)) {
+        &process);
+    CloseHandle(writePipe);
+    if (!created) {
+        CloseHandle(readPipe);
         return ext::nullopt;
     }
 
+    /* Read child's stdout/stderr through pipe until it's closed. */
+    while (true) {
+        char pin[PIPE_BUFFER_SIZE];
+        DWORD readlen;
+        if (!ReadFile(readPipe, pin, sizeof(pin), &readlen, nullptr)) {
+            DWORD error = GetLastError();
+            if (error != ERROR_BROKEN_PIPE) {
+                fprintf(stderr, "error: unable to read process output (%lu)\n", static_cast<unsigned long>(error));
+            }
+            break;
+        } else if (readlen == 0) {
+            continue;
+        }
+
+        if (output != nullptr) {
+            output->append(pin, readlen);
+        } else {
+            fwrite(pin, readlen, 1, stdout);
+        }
+    }
+    CloseHandle(readPipe);
+
     /* Wait until the spawned process finishes */
     WaitForSingleObject(process.hProcess, INFINITE);
 
@@ -160,110 +524,245 @@ launch(Filesystem *filesystem, Context const *context)
         return ext::nullopt;
     }
 #else
-    /*
-     * Extract input data for exec, so no C++ is required after fork.
-     */
     std::string path = context->executablePath();
     if (!filesystem->isExecutable(path)) {
         return ext::nullopt;
     }
-    char const *cPath = path.c_str();
 
-    std::string directory = context->currentDirectory();
-    char const *cDirectory = directory.c_str();
+    std::unique_lock<std::mutex> lock = LockSpawn();
 
-    /* Compute command-line arguments. */
-    std::vector<char const *> execArgs;
-    execArgs.push_back(cPath);
+    /* Setup parent-child stdout/stderr pipe. */
+    int pfd[2];
+    if (!CreatePipe(pfd)) {
+        ::perror("pipe");
+        return ext::nullopt;
+    }
 
-    std::vector<std::string> arguments = context->commandLineArguments();
-    for (std::string const &argument : arguments) {
-        execArgs.push_back(argument.c_str());
+    /* Redirect both stdout and stderr into the pipe. */
+    ext::optional<pid_t> pid = Spawn(context, path, pfd[1], pfd[1]);
+    ::close(pfd[1]);
+    lock = std::unique_lock<std::mutex>();
+    if (!pid) {
+        ::close(pfd[0]);
+        return ext::nullopt;
     }
 
-    execArgs.push_back(nullptr);
-    char *const *cExecArgs = const_cast<char *const *>(execArgs.data());
+    /* Read child's stdout/stderr through pipe, and output stdout */
+    while (true) {
+        char pin[PIPE_BUFFER_SIZE];
+        ssize_t readlen = ::read(pfd[0], &pin, sizeof(pin));
+        if (readlen > 0) {
+            if (output != nullptr) {
+                output->append(pin, readlen);
+            } else {
+                fwrite(pin, readlen, 1, stdout);
+            }
+        } else if (readlen < 0 && errno == EINTR) {
+            continue;
+        } else {
+            if (readlen != 0) {
+                ::perror("read");
+            }
+            break;
+        }
+    }
+    ::close(pfd[0]);
 
-    /* Compute environment variables. */
-    std::vector<std::string> envValues;
-    for (auto const &value : context->environmentVariables()) {
-        envValues.push_back(value.first + "=" + value.second);
+    return Reap(*pid);
+#endif
+}
+
+ext::optional<Launcher::Handle> DefaultLauncher::
+start(Filesystem *filesystem, Context const *context)
+{
+#if _WIN32
+    return Launcher::start(filesystem, context);
+#else
+    std::string path = context->executablePath();
+    if (!filesystem->isExecutable(path)) {
+        return ext::nullopt;
     }
 
-    std::vector<char const *> execEnv;
-    for (auto const &value : envValues) {
-        execEnv.push_back(value.c_str());
+    std::unique_lock<std::mutex> lock = LockSpawn();
+
+    /* Capture stdout and stderr separately. */
+    int outputPipe[2];
+    if (!CreatePipe(outputPipe)) {
+        ::perror("pipe");
+        return ext::nullopt;
     }
-    execEnv.push_back(nullptr);
-    char *const *cExecEnv = const_cast<char *const *>(execEnv.data());
 
-    /* Setup parent-child stdout/stderr pipe. */
-    int pfd[2];
-    bool pipe_setup_success = true;
-    if (pipe(pfd) == -1) {
+    int errorPipe[2];
+    if (!CreatePipe(errorPipe)) {
         ::perror("pipe");
-        pipe_setup_success = false;
+        ::close(outputPipe[0]);
+        ::close(outputPipe[1]);
+        return ext::nullopt;
+    }
+
+    ext::optional<pid_t> pid = Spawn(context, path, outputPipe[1], errorPipe[1]);
+    ::close(outputPipe[1]);
+    ::close(errorPipe[1]);
+    lock = std::unique_lock<std::mutex>();
+    if (!pid) {
+        ::close(outputPipe[0]);
+        ::close(errorPipe[0]);
+        return ext::nullopt;
+    }
+
+    /* Output is read as it's available, without waiting for more. */
+    ::fcntl(outputPipe[0], F_SETFL, ::fcntl(outputPipe[0], F_GETFL) | O_NONBLOCK);
+    ::fcntl(errorPipe[0], F_SETFL, ::fcntl(errorPipe[0], F_GETFL) | O_NONBLOCK);
+
+    std::unique_ptr<Running> running = std::unique_ptr<Running>(new Running());
+    running->handle = nextHandle();
+    running->thread = std::this_thread::get_id();
+    running->pid = *pid;
+    running->processFD = OpenProcess(*pid);
+    running->outputFD = outputPipe[0];
+    running->errorFD = errorPipe[0];
+
+    Handle handle = running->handle;
+
+    std::unique_lock<std::mutex> runningLock(_mutex);
+    _running.push_back(std::move(running));
+    return handle;
+#endif
+}
+
+#if !_WIN32
+/*
+ * Read what's available from a process's output. Closes the output once
+ * the process has closed its end. Returns if there could be more to read.
+ */
+static bool
+ReadOutput(int *fd, std::string *output)
+{
+    char buffer[PIPE_BUFFER_SIZE];
+    ssize_t size = ::read(*fd, buffer, sizeof(buffer));
+    if (size > 0) {
+        output->append(buffer, size);
+        return true;
+    } else if (size < 0 && errno == EINTR) {
+        return true;
+    } else if (size < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+        return false;
+    }
+
+    ::close(*fd);
+    *fd = -1;
+    return false;
+}
+
+/*
+ * Read everything a process that exited left in its output, then close
+ * it. Other processes it started could still have the output open and
+ * write to it later, but that's no longer part of this process's output.
+ */
+static void
+FinishOutput(int *fd, std::string *output)
+{
+    while (*fd != -1 && ReadOutput(fd, output)) {
     }
 
+    if (*fd != -1) {
+        ::close(*fd);
+        *fd = -1;
+    }
+}
+#endif
+
+ext::optional<Launcher::Result> DefaultLauncher::
+wait(bool block)
+{
+#if _WIN32
+    return Launcher::wait(block);
+#else
     /*
-     * Fork new process.
+     * Only this thread removes the processes it started, so they can be used
+     * without holding the lock while other threads start or finish theirs.
      */
-    pid_t pid = fork();
-    if (pid < 0) {
-        /* Fork failed. */
-        return ext::nullopt;
-    } else if (pid == 0) {
-        /* Fork succeeded, new process. */
-        if (pipe_setup_success) {
-            /* Setup pipe to parent, redirecting both stdout and stderr */
-            dup2(pfd[1], STDOUT_FILENO);
-            dup2(pfd[1], STDERR_FILENO);
-            close(pfd[0]);
-            close(pfd[1]);
-        } else {
-            /* No parent-child pipe setup, just ignore outputs from child */
-            int nullfd = open("/dev/null", O_WRONLY);
-            if (nullfd == -1) {
-                ::perror("open");
-                ::_exit(1);
+    std::vector<Running *> started;
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        for (std::unique_ptr<Running> const &running : _running) {
+            if (running->thread == std::this_thread::get_id()) {
+                started.push_back(running.get());
             }
-            dup2(nullfd, STDOUT_FILENO);
-            dup2(nullfd, STDERR_FILENO);
-            close(nullfd);
         }
+    }
 
-        if (::chdir(cDirectory) == -1) {
-            ::perror("chdir");
-            ::_exit(1);
+    if (started.empty()) {
+        return ext::nullopt;
+    }
+
+    while (true) {
+        /*
+         * A process is done once it exits, not when it closes its output: it
+         * could close its output and keep running, or leave processes it
+         * started running with its output still open.
+         */
+        for (Running *running : started) {
+            ext::optional<int> exitCode;
+            if (Exited(running->pid, &exitCode)) {
+                FinishOutput(&running->outputFD, &running->standardOutput);
+                FinishOutput(&running->errorFD, &running->standardError);
+                if (running->processFD != -1) {
+                    ::close(running->processFD);
+                }
+
+                Result result = Result(running->handle, exitCode, running->standardOutput, running->standardError);
+
+                std::unique_lock<std::mutex> lock(_mutex);
+                _running.erase(std::find_if(_running.begin(), _running.end(), [running](std::unique_ptr<Running> const &other) {
+                    return other.get() == running;
+                }));
+                return result;
+            }
         }
 
-        ::execve(cPath, cExecArgs, cExecEnv);
-        ::_exit(-1);
+        /*
+         * Wait for output from, or the exit of, any of the processes, all on
+         * this thread. If an exit can't be waited for, check again shortly.
+         */
+        std::vector<struct pollfd> fds;
+        std::vector<std::pair<int *, std::string *>> outputs;
+        int timeout = (block ? -1 : 0);
+        for (Running *running : started) {
+            if (running->processFD != -1) {
+                fds.push_back({ running->processFD, POLLIN, 0 });
+                outputs.push_back({ nullptr, nullptr });
+            } else if (block) {
+                timeout = ExitPollInterval;
+            }
+            if (running->outputFD != -1) {
+                fds.push_back({ running->outputFD, POLLIN, 0 });
+                outputs.push_back({ &running->outputFD, &running->standardOutput });
+            }
+            if (running->errorFD != -1) {
+                fds.push_back({ running->errorFD, POLLIN, 0 });
+                outputs.push_back({ &running->errorFD, &running->standardError });
+            }
+        }
 
-        return ext::nullopt;
-    } else {
-        /* Fork succeeded, existing process. */
-        if (pipe_setup_success) {
-            close(pfd[1]);
-            /* Read child's stdout/stderr through pipe, and output stdout */
-            while (true) {
-                char pin[PIPE_BUFFER_SIZE];
-                int readlen = read(pfd[0], &pin, sizeof(pin));
-                if (readlen > 0) {
-                    fwrite(pin, readlen, 1, stdout);
-                } else {
-                    if (readlen != 0) {
-                        ::perror("read");
-                    }
-                    break;
-                }
+        int ready = ::poll(fds.data(), fds.size(), timeout);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
             }
-            close(pfd[0]);
+
+            ::perror("poll");
+            return ext::nullopt;
+        } else if (ready == 0 && !block) {
+            /* Nothing finished yet and not waiting. */
+            return ext::nullopt;
         }
 
-        int status;
-        ::waitpid(pid, &status, 0);
-        return WEXITSTATUS(status);
+        for (size_t n = 0; n < fds.size(); n++) {
+            if (fds[n].revents != 0 && outputs[n].first != nullptr) {
+                ReadOutput(outputs[n].first, outputs[n].second);
+            }
+        }
     }
 #endif
 }
@@ -9,9 +9,28 @@
 #include <process/Launcher.h>
 
 using process::Launcher;
+using process::Context;
+using libutil::Filesystem;
+
+Launcher::Result::
+Result(Handle handle, ext::optional<int> const &exitCode, std::string const &standardOutput, std::string const &standardError) :
+    _handle        (handle),
+    _exitCode      (exitCode),
+    _standardOutput(standardOutput),
+    _standardError (standardError)
+{
+}
+
+Launcher::
+Launcher() :
+    _nextHandle(0)
+{
+}
 
 Launcher::
-Launcher()
+Launcher(Launcher const &launcher) :
+    _nextHandle(launcher._nextHandle),
+    _finished  (launcher._finished)
 {
 }
 
@@ -20,3 +39,38 @@ Launcher::
 {
 }
 
+Launcher::Handle Launcher::
+nextHandle()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    return _nextHandle++;
+}
+
+ext::optional<Launcher::Handle> Launcher::
+start(Filesystem *filesystem, Context const *context)
+{
+    std::string output;
+    ext::optional<int> exitCode = this->launch(filesystem, context, &output);
+
+    Handle handle = nextHandle();
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    _finished.push_back({ std::this_thread::get_id(), Result(handle, exitCode, output, std::string()) });
+    return handle;
+}
+
+ext::optional<Launcher::Result> Launcher::
+wait(bool block)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    for (auto it = _finished.begin(); it != _finished.end(); ++it) {
+        if (it->first == std::this_thread::get_id()) {
+            Result result = it->second;
+            _finished.erase(it);
+            return result;
+        }
+    }
+
+    return ext::nullopt;
+}
@@ -7,8 +7,12 @@
  */
 
 #include <process/User.h>
+#include <process/Context.h>
+#include <libutil/FSUtil.h>
 
 using process::User;
+using process::Context;
+using libutil::FSUtil;
 
 User::
 User()
@@ -20,3 +24,29 @@ User::
 {
 }
 
+ext::optional<std::string> User::
+userCacheDirectory(Context const *context) const
+{
+#if !_WIN32 && !defined(__APPLE__)
+    /* A relative path is invalid, so it's ignored. */
+    ext::optional<std::string> cache = context->environmentVariable("XDG_CACHE_HOME");
+    if (cache && FSUtil::IsAbsolutePath(*cache)) {
+        return *cache;
+    }
+#else
+    (void)context;
+#endif
+
+    ext::optional<std::string> home = this->userHomeDirectory();
+    if (!home) {
+        return ext::nullopt;
+    }
+
+#if _WIN32
+    return *home + "\\AppData\\Local";
+#elif defined(__APPLE__)
+    return *home + "/Library/Caches";
+#else
+    return *home + "/.cache";
+#endif
+}
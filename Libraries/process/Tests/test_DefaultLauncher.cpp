@@ -0,0 +1,166 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+#include <process/DefaultLauncher.h>
+#include <process/MemoryContext.h>
+#include <libutil/DefaultFilesystem.h>
+
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <thread>
+
+using process::DefaultLauncher;
+using process::Launcher;
+using process::MemoryContext;
+using libutil::DefaultFilesystem;
+
+static MemoryContext
+Shell(std::string const &script)
+{
+    return MemoryContext("/bin/sh", "/", { "-c", script }, { { "PATH", "/bin:/usr/bin" } });
+}
+
+TEST(DefaultLauncher, Launch)
+{
+    DefaultFilesystem filesystem;
+    DefaultLauncher launcher;
+
+    MemoryContext context = Shell("echo out; echo err >&2; exit 3");
+    std::string output;
+    EXPECT_EQ(3, launcher.launch(&filesystem, &context, &output));
+    EXPECT_EQ("out\nerr\n", output);
+}
+
+TEST(DefaultLauncher, StartWait)
+{
+    DefaultFilesystem filesystem;
+    DefaultLauncher launcher;
+
+    /* Nothing to wait for. */
+    EXPECT_FALSE(launcher.wait(true));
+
+    MemoryContext first = Shell("echo out; echo err >&2; exit 3");
+    ext::optional<Launcher::Handle> firstHandle = launcher.start(&filesystem, &first);
+    ASSERT_TRUE(firstHandle);
+
+    MemoryContext second = Shell("echo second");
+    ext::optional<Launcher::Handle> secondHandle = launcher.start(&filesystem, &second);
+    ASSERT_TRUE(secondHandle);
+    EXPECT_NE(*firstHandle, *secondHandle);
+
+    /* Output is kept separate, for each process and each stream. */
+    for (int n = 0; n < 2; n++) {
+        ext::optional<Launcher::Result> result = launcher.wait(true);
+        ASSERT_TRUE(result);
+
+        if (result->handle() == *firstHandle) {
+            EXPECT_EQ(3, result->exitCode());
+            EXPECT_EQ("out\n", result->standardOutput());
+            EXPECT_EQ("err\n", result->standardError());
+        } else {
+            EXPECT_EQ(*secondHandle, result->handle());
+            EXPECT_EQ(0, result->exitCode());
+            EXPECT_EQ("second\n", result->standardOutput());
+            EXPECT_EQ("", result->standardError());
+        }
+    }
+
+    EXPECT_FALSE(launcher.wait(true));
+}
+
+TEST(DefaultLauncher, WaitOnThread)
+{
+    DefaultFilesystem filesystem;
+    DefaultLauncher launcher;
+
+    MemoryContext first = Shell("exit 5");
+    ASSERT_TRUE(launcher.start(&filesystem, &first));
+
+    /* Processes started on another thread are waited for by that thread. */
+    std::thread thread = std::thread([&launcher, &filesystem] {
+        EXPECT_FALSE(launcher.wait(true));
+
+        MemoryContext second = Shell("exit 6");
+        ASSERT_TRUE(launcher.start(&filesystem, &second));
+
+        ext::optional<Launcher::Result> result = launcher.wait(true);
+        ASSERT_TRUE(result);
+        EXPECT_EQ(6, result->exitCode());
+    });
+    thread.join();
+
+    ext::optional<Launcher::Result> result = launcher.wait(true);
+    ASSERT_TRUE(result);
+    EXPECT_EQ(5, result->exitCode());
+    EXPECT_FALSE(launcher.wait(true));
+}
+
+TEST(DefaultLauncher, MissingDirectory)
+{
+    DefaultFilesystem filesystem;
+    DefaultLauncher launcher;
+
+    /* Not started in a directory that doesn't exist. */
+    MemoryContext context = MemoryContext("/bin/sh", "/nonexistent/directory", { "-c", "exit 0" }, { });
+    EXPECT_FALSE(launcher.launch(&filesystem, &context, nullptr));
+    EXPECT_FALSE(launcher.start(&filesystem, &context));
+}
+
+TEST(DefaultLauncher, Signal)
+{
+    DefaultFilesystem filesystem;
+    DefaultLauncher launcher;
+
+    /* Killed by a signal, so there's no exit code. */
+    MemoryContext context = Shell("kill -9 $$");
+    ASSERT_TRUE(launcher.start(&filesystem, &context));
+
+    ext::optional<Launcher::Result> result = launcher.wait(true);
+    ASSERT_TRUE(result);
+    EXPECT_FALSE(result->exitCode());
+}
+
+TEST(DefaultLauncher, ClosedOutput)
+{
+    DefaultFilesystem filesystem;
+    DefaultLauncher launcher;
+
+    /* Closing output doesn't finish the process. */
+    MemoryContext context = Shell("exec >&- 2>&-; sleep 1; exit 4");
+    ASSERT_TRUE(launcher.start(&filesystem, &context));
+
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(launcher.wait(false));
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(500));
+
+    ext::optional<Launcher::Result> result = launcher.wait(true);
+    ASSERT_TRUE(result);
+    EXPECT_EQ(4, result->exitCode());
+}
+
+TEST(DefaultLauncher, BackgroundProcess)
+{
+    DefaultFilesystem filesystem;
+    DefaultLauncher launcher;
+
+    /* A process left running keeps the output open, but the process is finished. */
+    MemoryContext context = Shell("sleep 30 & echo $!; exit 2");
+    ASSERT_TRUE(launcher.start(&filesystem, &context));
+
+    auto start = std::chrono::steady_clock::now();
+    ext::optional<Launcher::Result> result = launcher.wait(true);
+    ASSERT_TRUE(result);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(10));
+    EXPECT_EQ(2, result->exitCode());
+
+    pid_t background = static_cast<pid_t>(std::atoi(result->standardOutput().c_str()));
+    ASSERT_GT(background, 0);
+    ::kill(background, SIGKILL);
+}
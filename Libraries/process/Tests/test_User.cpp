@@ -0,0 +1,69 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+#include <process/User.h>
+#include <process/MemoryContext.h>
+
+using process::User;
+using process::MemoryContext;
+
+class HomeUser : public User {
+private:
+    std::string _empty;
+
+public:
+    virtual std::string const &userID() const
+    { return _empty; }
+    virtual std::string const &groupID() const
+    { return _empty; }
+    virtual std::string const &userName() const
+    { return _empty; }
+    virtual std::string const &groupName() const
+    { return _empty; }
+
+    virtual ext::optional<std::string> userHomeDirectory() const
+    { return std::string("/home/user"); }
+};
+
+static MemoryContext
+Environment(std::unordered_map<std::string, std::string> const &environment)
+{
+    return MemoryContext("/bin/true", "/", { }, environment);
+}
+
+TEST(User, CacheDirectory)
+{
+    HomeUser user;
+
+#if _WIN32
+    std::string home = "/home/user\\AppData\\Local";
+#elif defined(__APPLE__)
+    std::string home = "/home/user/Library/Caches";
+#else
+    std::string home = "/home/user/.cache";
+#endif
+
+    MemoryContext unset = Environment({ });
+    EXPECT_EQ(home, user.userCacheDirectory(&unset));
+
+    /* Not used on Windows or macOS. */
+    MemoryContext absolute = Environment({ { "XDG_CACHE_HOME", "/var/cache/user" } });
+#if !_WIN32 && !defined(__APPLE__)
+    EXPECT_EQ(std::string("/var/cache/user"), user.userCacheDirectory(&absolute));
+#else
+    EXPECT_EQ(home, user.userCacheDirectory(&absolute));
+#endif
+
+    /* Relative and empty paths are ignored. */
+    MemoryContext relative = Environment({ { "XDG_CACHE_HOME", "cache" } });
+    EXPECT_EQ(home, user.userCacheDirectory(&relative));
+
+    MemoryContext empty = Environment({ { "XDG_CACHE_HOME", "" } });
+    EXPECT_EQ(home, user.userCacheDirectory(&empty));
+}
@@ -16,6 +16,7 @@
 #include <builtin/Registry.h>
 #include <libutil/Base.h>
 #include <libutil/Filesystem.h>
+#include <libutil/ThreadPool.h>
 #include <process/Context.h>
 
 #if !_WIN32
@@ -63,14 +64,18 @@ CreateExecutor(
     ext::optional<std::string> const &executor,
     std::shared_ptr<xcformatter::Formatter> const &formatter,
     bool dryRun,
-    bool generate)
+    bool generate,
+    bool verbose,
+    size_t jobs,
+    bool parallelizeTargets)
 {
     if (!executor || *executor == "simple") {
         auto registry = builtin::Registry::Default();
-        auto executor = xcexecution::SimpleExecutor::Create(formatter, dryRun, registry);
+        auto executor = xcexecution::SimpleExecutor::Create(formatter, dryRun, jobs, parallelizeTargets, registry);
         return libutil::static_unique_pointer_cast<xcexecution::Executor>(std::move(executor));
     } else if (*executor == "ninja") {
-        auto executor = xcexecution::NinjaExecutor::Create(formatter, dryRun, generate);
+        auto registry = builtin::Registry::Default();
+        auto executor = xcexecution::NinjaExecutor::Create(formatter, dryRun, generate, verbose, registry);
         return libutil::static_unique_pointer_cast<xcexecution::Executor>(std::move(executor));
     }
 
@@ -92,8 +97,9 @@ VerifySupportedOptions(Options const &options)
         fprintf(stderr, "warning: destination option not implemented\n");
     }
 
-    if (options.parallelizeTargets() || options.jobs()) {
-        fprintf(stderr, "warning: job control option not implemented\n");
+    if (options.jobs() && *options.jobs() <= 0) {
+        fprintf(stderr, "error: number of jobs must be positive\n");
+        return false;
     }
 
     if (options.enableAddressSanitizer() || options.enableThreadSanitizer() || options.enableCodeCoverage()) {
@@ -144,9 +150,11 @@ Run(process::User const *user, process::Context const *processContext, process::
     }
 
     /*
-     * Create the executor used to perform the build.
+     * Create the executor used to perform the build. Like xcodebuild, run as
+     * many jobs as there are processors unless told otherwise.
      */
-    std::unique_ptr<xcexecution::Executor> executor = CreateExecutor(options.executor(), formatter, options.dryRun(), options.generate());
+    size_t jobs = (options.jobs() ? static_cast<size_t>(*options.jobs()) : libutil::ThreadPool::DefaultThreadCount());
+    std::unique_ptr<xcexecution::Executor> executor = CreateExecutor(options.executor(), formatter, options.dryRun(), options.generate(), options.verbose(), jobs, options.parallelizeTargets());
     if (executor == nullptr) {
         fprintf(stderr, "error: unknown executor '%s'\n", options.executor()->c_str());
         return -1;
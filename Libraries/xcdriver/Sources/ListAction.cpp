@@ -29,7 +29,7 @@ ListAction::
 }
 
 int ListAction::
-Run(process::User const *user, process::Context const *processContext, Filesystem const *filesystem, Options const &options)
+Run(process::User const *user, process::Context const *processContext, Filesystem *filesystem, Options const &options)
 {
     ext::optional<pbxbuild::Build::Environment> buildEnvironment = pbxbuild::Build::Environment::Default(user, processContext, filesystem);
     if (!buildEnvironment) {
@@ -0,0 +1,105 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef __xcexecution_BuildLog_h
+#define __xcexecution_BuildLog_h
+
+#include <pbxbuild/Tool/Invocation.h>
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <ext/optional>
+
+namespace libutil { class Filesystem; }
+
+namespace xcexecution {
+
+/*
+ * Persistent record of the invocations run by previous builds. For each
+ * output, stores a hash of the command that produced it and a hash of the
+ * contents of every input to that command, including inputs discovered from
+ * the invocation's dependency info. An invocation is up to date when all of
+ * its outputs exist and both hashes still match.
+ *
+ * Inputs are compared by contents rather than modification time, so files
+ * rewritten with identical contents (like auxiliary files) don't cause a
+ * rebuild. Contents are hashed at most once per build unless they change.
+ *
+ * Safe to use from multiple threads at once.
+ */
+class BuildLog {
+private:
+    struct Record {
+        std::string commandHash;
+        std::string inputsHash;
+    };
+
+private:
+    std::string                                  _path;
+    std::unordered_map<std::string, Record>      _records;
+    std::unordered_map<std::string, std::string> _contentHashes;
+    std::mutex                                   _mutex;
+
+public:
+    explicit BuildLog(std::string const &path);
+    ~BuildLog();
+
+public:
+    /*
+     * Where the build log is stored.
+     */
+    std::string const &path() const
+    { return _path; }
+
+public:
+    /*
+     * If the outputs of an invocation are up to date with its inputs and
+     * command, as of when the invocation was last recorded.
+     */
+    bool upToDate(libutil::Filesystem const *filesystem, pbxbuild::Tool::Invocation const &invocation);
+
+    /*
+     * Hash the inputs an invocation declares. Take this before running the
+     * invocation and pass it to record(), so inputs changed while it runs
+     * leave its outputs out of date.
+     */
+    ext::optional<std::string> declaredInputsHash(libutil::Filesystem const *filesystem, pbxbuild::Tool::Invocation const &invocation);
+
+    /*
+     * Record that an invocation finished, with the hash of its declared inputs
+     * from before it ran. Inputs discovered from its dependency info are read
+     * now. If it failed, its outputs are no longer considered up to date.
+     */
+    void record(libutil::Filesystem const *filesystem, pbxbuild::Tool::Invocation const &invocation, ext::optional<std::string> const &declaredInputs, bool success);
+
+public:
+    /*
+     * Write out the build log to its path.
+     */
+    bool write(libutil::Filesystem *filesystem);
+
+public:
+    /*
+     * Load a build log. If it does not exist or is invalid, the log is empty.
+     */
+    static std::unique_ptr<BuildLog>
+    Open(libutil::Filesystem const *filesystem, std::string const &path);
+
+private:
+    std::string commandHash(pbxbuild::Tool::Invocation const &invocation) const;
+    ext::optional<std::string> discoveredInputsHash(libutil::Filesystem const *filesystem, pbxbuild::Tool::Invocation const &invocation);
+    std::string inputsHash(std::string const &declaredInputs, std::string const &discoveredInputs) const;
+    ext::optional<std::string> hashInputs(libutil::Filesystem const *filesystem, std::vector<std::string> const &inputs);
+    ext::optional<std::string> contentHash(libutil::Filesystem const *filesystem, std::string const &path);
+};
+
+}
+
+#endif // !__xcexecution_BuildLog_h
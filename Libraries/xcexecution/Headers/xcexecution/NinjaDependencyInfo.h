@@ -0,0 +1,58 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef __xcexecution_NinjaDependencyInfo_h
+#define __xcexecution_NinjaDependencyInfo_h
+
+#include <pbxbuild/Tool/Invocation.h>
+
+#include <string>
+
+namespace libutil { class Filesystem; }
+
+namespace xcexecution {
+
+/*
+ * Turns the dependency info written by invocations into depfiles for Ninja.
+ * Ninja loads depfiles when it next starts, so rather than a separate process
+ * after each invocation, the conversions are recorded while generating the
+ * Ninja files and all performed after the build.
+ */
+class NinjaDependencyInfo {
+public:
+    /*
+     * If Ninja can read an invocation's dependency info directly as a depfile:
+     * when it writes a single Makefile dependency info. Ninja resolves relative
+     * paths in depfiles from its own directory, not the invocation's, but tools
+     * writing Makefile dependency info are passed absolute paths, so they write
+     * absolute paths.
+     */
+    static bool Native(pbxbuild::Tool::Invocation const &invocation);
+
+    /*
+     * Record converting an invocation's dependency info into a depfile for an
+     * output. Stored one per line, with tab-separated fields: the output, the
+     * path of the depfile, the working directory, then each dependency info
+     * as `format:path`. Invocations that can't be recorded are skipped, so
+     * Ninja always runs them.
+     */
+    static bool Conversion(pbxbuild::Tool::Invocation const &invocation, std::string const &output, std::string const &depfile, std::string *conversions);
+
+    /*
+     * Convert dependency info written by the last build into depfiles, as
+     * recorded in a file. Relative paths are resolved against the working
+     * directory of the invocation. Only dependency info modified since its
+     * depfile was written is read, and no depfile is written if the invocation
+     * hasn't run.
+     */
+    static bool Convert(libutil::Filesystem *filesystem, std::string const &conversionsPath);
+};
+
+}
+
+#endif // !__xcexecution_NinjaDependencyInfo_h
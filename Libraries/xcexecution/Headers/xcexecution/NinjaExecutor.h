@@ -13,6 +13,7 @@
 #include <pbxbuild/Tool/AuxiliaryFile.h>
 #include <pbxbuild/Tool/Invocation.h>
 #include <pbxbuild/DirectedGraph.h>
+#include <builtin/Registry.h>
 
 namespace ninja { class Writer; }
 
@@ -22,8 +23,12 @@ namespace xcexecution {
  * Concrete executor that generates Ninja files.
  */
 class NinjaExecutor : public Executor {
+private:
+    bool              _verbose;
+    builtin::Registry _builtins;
+
 public:
-    NinjaExecutor(std::shared_ptr<xcformatter::Formatter> const &formatter, bool dryRun, bool generate);
+    NinjaExecutor(std::shared_ptr<xcformatter::Formatter> const &formatter, bool dryRun, bool generate, bool verbose, builtin::Registry const &builtins);
     ~NinjaExecutor();
 
 public:
@@ -43,10 +48,11 @@ private:
         pbxbuild::Build::Environment const &buildEnvironment,
         pbxbuild::Build::Context const &buildContext,
         pbxbuild::DirectedGraph<pbxproj::PBX::Target::shared_ptr> const &targetGraph,
-        std::string const &dependencyInfoToolPath,
         std::string const &ninjaPath,
         std::string const &configurationHashPath,
-        std::string const &intermediatesDirectory);
+        std::string const &dependencyInfoConversionsPath,
+        std::string const &intermediatesDirectory,
+        std::string const &builtinSocketPath);
     bool buildOutputDirectories(
         ninja::Writer *writer,
         std::vector<pbxbuild::Tool::Invocation> const &invocations,
@@ -54,11 +60,14 @@ private:
     bool buildTargetInvocations(
         process::Context const *processContext,
         libutil::Filesystem *filesystem,
-        std::string const &dependencyInfoToolPath,
         pbxproj::PBX::Target::shared_ptr const &target,
         pbxbuild::Target::Environment const &targetEnvironment,
         std::vector<pbxbuild::Tool::AuxiliaryFile> const &auxiliaryFiles,
-        std::vector<pbxbuild::Tool::Invocation> const &invocations);
+        std::vector<pbxbuild::Tool::Invocation> const &invocations,
+        std::vector<std::string> const &builtinClient,
+        std::string *targetNinja,
+        std::map<std::string, std::vector<uint8_t>> *auxiliaryFileContents,
+        std::string *dependencyInfoConversions);
 
 private:
     bool buildAuxiliaryFile(
@@ -70,14 +79,14 @@ private:
     bool buildInvocation(
         ninja::Writer *writer,
         pbxbuild::Tool::Invocation const &invocation,
-        std::string const &executablePath,
-        std::string const &dependencyInfoToolPath,
+        std::vector<std::string> const &command,
         std::string const &temporaryDirectory,
-        std::string const &after);
+        std::string const &after,
+        std::string *dependencyInfoConversions);
 
 public:
     static std::unique_ptr<NinjaExecutor>
-    Create(std::shared_ptr<xcformatter::Formatter> const &formatter, bool dryRun, bool generate);
+    Create(std::shared_ptr<xcformatter::Formatter> const &formatter, bool dryRun, bool generate, bool verbose, builtin::Registry const &builtins);
 };
 
 }
@@ -0,0 +1,93 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef __xcexecution_NinjaTargetCache_h
+#define __xcexecution_NinjaTargetCache_h
+
+#include <pbxbuild/DirectedGraph.h>
+#include <pbxproj/PBX/Target.h>
+
+#include <string>
+#include <unordered_map>
+
+namespace libutil { class Filesystem; }
+namespace pbxspec { class Manager; }
+namespace process { class Context; }
+
+namespace pbxbuild {
+namespace Build { class Context; }
+namespace Build { class Environment; }
+}
+
+namespace xcexecution {
+
+class Parameters;
+
+/*
+ * Stores what was generated for each target, so targets whose inputs haven't
+ * changed don't need to be generated again.
+ */
+class NinjaTargetCache {
+public:
+    /*
+     * Fingerprint the inputs to generating each target's Ninja: the build
+     * parameters, the generator, the specifications, the SDKs, the target's
+     * project file and configuration files, and the fingerprints of the
+     * targets it depends on. When a target's fingerprint is unchanged, the
+     * Ninja previously generated for it is still valid.
+     */
+    static std::unordered_map<pbxproj::PBX::Target::shared_ptr, std::string>
+    Fingerprints(
+        process::Context const *processContext,
+        libutil::Filesystem const *filesystem,
+        Parameters const &buildParameters,
+        pbxbuild::Build::Environment const &buildEnvironment,
+        pbxbuild::Build::Context const &buildContext,
+        pbxbuild::DirectedGraph<pbxproj::PBX::Target::shared_ptr> const &targetGraph);
+
+    /*
+     * Fingerprint the files the specifications were loaded from.
+     */
+    static std::string
+    SpecificationsFingerprint(libutil::Filesystem const *filesystem, pbxspec::Manager const &specManager);
+
+public:
+    /*
+     * Where the cache for a target is stored.
+     */
+    static std::string
+    Path(std::string const &intermediatesDirectory, pbxproj::PBX::Target::shared_ptr const &target);
+
+    /*
+     * Store what was generated for a target with its fingerprint.
+     */
+    static bool
+    Write(
+        libutil::Filesystem *filesystem,
+        std::string const &path,
+        std::string const &fingerprint,
+        std::string const &targetNinjaPath,
+        std::string const &targetNinja,
+        std::string const &dependencyInfoConversions);
+
+    /*
+     * Load what was generated for a target, if its fingerprint matches and
+     * the target's Ninja file still exists.
+     */
+    static bool
+    Load(
+        libutil::Filesystem const *filesystem,
+        std::string const &path,
+        std::string const &fingerprint,
+        std::string *targetNinja,
+        std::string *dependencyInfoConversions);
+};
+
+}
+
+#endif // !__xcexecution_NinjaTargetCache_h
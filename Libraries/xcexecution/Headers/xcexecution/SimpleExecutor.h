@@ -13,18 +13,27 @@
 #include <pbxbuild/Tool/AuxiliaryFile.h>
 #include <builtin/Registry.h>
 
+namespace libutil { class ThreadPool; }
+
 namespace xcexecution {
 
+class BuildLog;
+
 /*
- * Simple executor that simply runs invocations in sequence. Advanced features
- * like incremental builds, dependency info, and such are not supported.
+ * Simple executor that runs invocations as soon as their inputs are ready,
+ * up to `jobs` at once. With `parallelizeTargets`, independent targets also
+ * build at the same time, sharing the same jobs. Invocations that are up to
+ * date according to the build log in OBJROOT are skipped.
  */
 class SimpleExecutor : public Executor {
 private:
-    builtin::Registry _builtins;
+    size_t                               _jobs;
+    bool                                 _parallelizeTargets;
+    std::shared_ptr<libutil::ThreadPool> _jobPool;
+    builtin::Registry                    _builtins;
 
 public:
-    SimpleExecutor(std::shared_ptr<xcformatter::Formatter> const &formatter, bool dryRun, builtin::Registry const &builtins);
+    SimpleExecutor(std::shared_ptr<xcformatter::Formatter> const &formatter, bool dryRun, size_t jobs, bool parallelizeTargets, builtin::Registry const &builtins);
     ~SimpleExecutor();
 
 public:
@@ -39,14 +48,17 @@ public:
 public:
     bool writeAuxiliaryFiles(
         libutil::Filesystem *filesystem,
-        std::vector<pbxbuild::Tool::AuxiliaryFile> const &auxiliaryFiles);
+        std::vector<pbxbuild::Tool::AuxiliaryFile> const &auxiliaryFiles,
+        std::string *output = nullptr);
     std::pair<bool, std::vector<pbxbuild::Tool::Invocation>> performInvocations(
         process::Context const *processContext,
         process::Launcher *processLauncher,
         libutil::Filesystem *filesystem,
         std::vector<std::string> const &executablePaths,
         std::vector<pbxbuild::Tool::Invocation> const &orderedInvocations,
-        bool createProductStructure);
+        bool createProductStructure,
+        BuildLog *buildLog,
+        std::string *output = nullptr);
     std::pair<bool, std::vector<pbxbuild::Tool::Invocation>> buildTarget(
         process::Context const *processContext,
         process::Launcher *processLauncher,
@@ -54,11 +66,24 @@ public:
         pbxproj::PBX::Target::shared_ptr const &target,
         pbxbuild::Target::Environment const &targetEnvironment,
         std::vector<pbxbuild::Tool::AuxiliaryFile> const &auxiliaryFiles,
-        std::vector<pbxbuild::Tool::Invocation> const &invocations);
+        std::vector<pbxbuild::Tool::Invocation> const &invocations,
+        BuildLog *buildLog,
+        std::string *output = nullptr);
+
+private:
+    std::pair<bool, std::vector<pbxbuild::Tool::Invocation>> resolveAndBuildTarget(
+        process::Context const *processContext,
+        process::Launcher *processLauncher,
+        libutil::Filesystem *filesystem,
+        pbxbuild::Build::Environment const &buildEnvironment,
+        pbxbuild::Build::Context const &buildContext,
+        pbxproj::PBX::Target::shared_ptr const &target,
+        BuildLog *buildLog,
+        std::string *output);
 
 public:
     static std::unique_ptr<SimpleExecutor>
-    Create(std::shared_ptr<xcformatter::Formatter> const &formatter, bool dryRun, builtin::Registry const &builtins);
+    Create(std::shared_ptr<xcformatter::Formatter> const &formatter, bool dryRun, size_t jobs, bool parallelizeTargets, builtin::Registry const &builtins);
 };
 
 }
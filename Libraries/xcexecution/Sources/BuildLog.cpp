@@ -0,0 +1,351 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree.
+ */
+
+#include <xcexecution/BuildLog.h>
+
+#include <dependency/DependencyInfo.h>
+#include <libutil/Filesystem.h>
+#include <libutil/FSUtil.h>
+#include <libutil/md5.h>
+
+#include <algorithm>
+#include <sstream>
+#include <iomanip>
+
+using xcexecution::BuildLog;
+using libutil::Filesystem;
+using libutil::FSUtil;
+
+/*
+ * Identifies the format of the build log. Change if the format or the
+ * meaning of the hashes changes, to invalidate existing logs.
+ */
+static std::string const BuildLogHeader = "# xcbuild log v2";
+
+BuildLog::
+BuildLog(std::string const &path) :
+    _path(path)
+{
+}
+
+BuildLog::
+~BuildLog()
+{
+}
+
+namespace {
+
+class Hasher {
+private:
+    md5_state_t _state;
+
+public:
+    Hasher()
+    {
+        md5_init(&_state);
+    }
+
+public:
+    /*
+     * Add a string to the hash. Includes the trailing NUL to separate values.
+     */
+    void append(std::string const &value)
+    {
+        md5_append(&_state, reinterpret_cast<const md5_byte_t *>(value.c_str()), value.size() + 1);
+    }
+
+    void append(std::vector<uint8_t> const &value)
+    {
+        md5_append(&_state, reinterpret_cast<const md5_byte_t *>(value.data()), value.size());
+    }
+
+public:
+    std::string finish()
+    {
+        uint8_t digest[16];
+        md5_finish(&_state, reinterpret_cast<md5_byte_t *>(&digest));
+
+        std::ostringstream ss;
+        ss << std::hex << std::setfill('0');
+        for (uint8_t c : digest) {
+            ss << std::setw(2) << static_cast<int>(c);
+        }
+        return ss.str();
+    }
+};
+
+}
+
+std::string BuildLog::
+commandHash(pbxbuild::Tool::Invocation const &invocation) const
+{
+    Hasher hasher;
+
+    if (invocation.executable()) {
+        hasher.append(invocation.executable()->builtin().value_or(std::string()));
+        hasher.append(invocation.executable()->external().value_or(std::string()));
+    }
+
+    hasher.append(invocation.workingDirectory());
+
+    for (std::string const &argument : invocation.arguments()) {
+        hasher.append(argument);
+    }
+
+    /* Sort the environment, since it is stored unordered. */
+    std::vector<std::string> environment;
+    for (auto const &entry : invocation.environment()) {
+        environment.push_back(entry.first + "=" + entry.second);
+    }
+    std::sort(environment.begin(), environment.end());
+    for (std::string const &entry : environment) {
+        hasher.append(entry);
+    }
+
+    return hasher.finish();
+}
+
+ext::optional<std::string> BuildLog::
+contentHash(Filesystem const *filesystem, std::string const &path)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _contentHashes.find(path);
+        if (it != _contentHashes.end()) {
+            return it->second;
+        }
+    }
+
+    std::string hash;
+
+    ext::optional<Filesystem::Type> type = filesystem->type(path);
+    if (!type) {
+        /* Missing inputs are consistent as long as they stay missing. */
+        hash = "-";
+    } else if (*type == Filesystem::Type::Directory) {
+        /* Directories are only tracked by existence; their contents are separate inputs. */
+        hash = "/";
+    } else {
+        std::vector<uint8_t> contents;
+        if (!filesystem->read(&contents, path)) {
+            return ext::nullopt;
+        }
+
+        Hasher hasher;
+        hasher.append(contents);
+        hash = hasher.finish();
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _contentHashes.insert({ path, hash });
+    return hash;
+}
+
+ext::optional<std::string> BuildLog::
+hashInputs(Filesystem const *filesystem, std::vector<std::string> const &inputs)
+{
+    Hasher hasher;
+    for (std::string const &input : inputs) {
+        ext::optional<std::string> hash = contentHash(filesystem, input);
+        if (!hash) {
+            return ext::nullopt;
+        }
+
+        hasher.append(input);
+        hasher.append(*hash);
+    }
+    return hasher.finish();
+}
+
+ext::optional<std::string> BuildLog::
+declaredInputsHash(Filesystem const *filesystem, pbxbuild::Tool::Invocation const &invocation)
+{
+    std::vector<std::string> inputs;
+    inputs.insert(inputs.end(), invocation.inputs().begin(), invocation.inputs().end());
+    inputs.insert(inputs.end(), invocation.phonyInputs().begin(), invocation.phonyInputs().end());
+    inputs.insert(inputs.end(), invocation.inputDependencies().begin(), invocation.inputDependencies().end());
+    return hashInputs(filesystem, inputs);
+}
+
+ext::optional<std::string> BuildLog::
+discoveredInputsHash(Filesystem const *filesystem, pbxbuild::Tool::Invocation const &invocation)
+{
+    std::vector<std::string> inputs;
+
+    /*
+     * Inputs discovered when the invocation last ran, like included headers.
+     * If the dependency info is missing, the invocation needs to run again.
+     */
+    for (pbxbuild::Tool::Invocation::DependencyInfo const &dependencyInfo : invocation.dependencyInfo()) {
+        ext::optional<std::vector<dependency::DependencyInfo>> info = dependency::DependencyInfo::Load(filesystem, dependencyInfo.format(), dependencyInfo.path());
+        if (!info) {
+            return ext::nullopt;
+        }
+
+        for (dependency::DependencyInfo const &entry : *info) {
+            for (std::string const &input : entry.inputs()) {
+                inputs.push_back(FSUtil::ResolveRelativePath(input, invocation.workingDirectory()));
+            }
+        }
+    }
+
+    return hashInputs(filesystem, inputs);
+}
+
+std::string BuildLog::
+inputsHash(std::string const &declaredInputs, std::string const &discoveredInputs) const
+{
+    Hasher hasher;
+    hasher.append(declaredInputs);
+    hasher.append(discoveredInputs);
+    return hasher.finish();
+}
+
+bool BuildLog::
+upToDate(Filesystem const *filesystem, pbxbuild::Tool::Invocation const &invocation)
+{
+    /* Without outputs, there's no way to tell if the invocation needs to run. */
+    if (invocation.outputs().empty()) {
+        return false;
+    }
+
+    std::string command = commandHash(invocation);
+    std::vector<Record> records;
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (std::string const &output : invocation.outputs()) {
+            auto it = _records.find(output);
+            if (it == _records.end() || it->second.commandHash != command) {
+                return false;
+            }
+
+            records.push_back(it->second);
+        }
+    }
+
+    for (std::string const &output : invocation.outputs()) {
+        if (!filesystem->exists(output)) {
+            return false;
+        }
+    }
+
+    ext::optional<std::string> declaredInputs = declaredInputsHash(filesystem, invocation);
+    if (!declaredInputs) {
+        return false;
+    }
+
+    ext::optional<std::string> discoveredInputs = discoveredInputsHash(filesystem, invocation);
+    if (!discoveredInputs) {
+        return false;
+    }
+
+    std::string inputs = inputsHash(*declaredInputs, *discoveredInputs);
+    for (Record const &record : records) {
+        if (record.inputsHash != inputs) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void BuildLog::
+record(Filesystem const *filesystem, pbxbuild::Tool::Invocation const &invocation, ext::optional<std::string> const &declaredInputs, bool success)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        /* The outputs were just written, so any hashes of them are stale. */
+        for (std::string const &output : invocation.outputs()) {
+            _contentHashes.erase(output);
+            _records.erase(output);
+        }
+    }
+
+    if (!success || !declaredInputs) {
+        return;
+    }
+
+    /*
+     * Inputs the invocation declared were hashed before it ran. If they
+     * changed while it ran, it's out of date next time. The inputs it
+     * discovered can only be known now.
+     */
+    ext::optional<std::string> discoveredInputs = discoveredInputsHash(filesystem, invocation);
+    if (!discoveredInputs) {
+        return;
+    }
+
+    Record record;
+    record.commandHash = commandHash(invocation);
+    record.inputsHash = inputsHash(*declaredInputs, *discoveredInputs);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (std::string const &output : invocation.outputs()) {
+        _records[output] = record;
+    }
+}
+
+bool BuildLog::
+write(Filesystem *filesystem)
+{
+    std::string contents = BuildLogHeader + "\n";
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (auto const &entry : _records) {
+            /* Paths are stored to the end of the line, so can't contain newlines. */
+            if (entry.first.find('\n') != std::string::npos) {
+                continue;
+            }
+
+            contents += entry.second.commandHash + " " + entry.second.inputsHash + " " + entry.first + "\n";
+        }
+    }
+
+    if (!filesystem->createDirectory(FSUtil::GetDirectoryName(_path), true)) {
+        return false;
+    }
+
+    return filesystem->write(std::vector<uint8_t>(contents.begin(), contents.end()), _path);
+}
+
+std::unique_ptr<BuildLog> BuildLog::
+Open(Filesystem const *filesystem, std::string const &path)
+{
+    std::unique_ptr<BuildLog> buildLog = std::unique_ptr<BuildLog>(new BuildLog(path));
+
+    std::vector<uint8_t> contents;
+    if (!filesystem->exists(path) || !filesystem->read(&contents, path)) {
+        return buildLog;
+    }
+
+    std::istringstream stream = std::istringstream(std::string(contents.begin(), contents.end()));
+
+    std::string line;
+    if (!std::getline(stream, line) || line != BuildLogHeader) {
+        /* Unknown format, start over. */
+        return buildLog;
+    }
+
+    while (std::getline(stream, line)) {
+        std::string::size_type first = line.find(' ');
+        std::string::size_type second = (first != std::string::npos ? line.find(' ', first + 1) : std::string::npos);
+        if (second == std::string::npos) {
+            continue;
+        }
+
+        Record record;
+        record.commandHash = line.substr(0, first);
+        record.inputsHash = line.substr(first + 1, second - first - 1);
+        buildLog->_records[line.substr(second + 1)] = record;
+    }
+
+    return buildLog;
+}
@@ -0,0 +1,154 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree.
+ */
+
+#include <xcexecution/NinjaDependencyInfo.h>
+#include <dependency/DependencyInfo.h>
+#include <dependency/MakefileDependencyInfo.h>
+#include <libutil/Filesystem.h>
+#include <libutil/FSUtil.h>
+
+#include <sstream>
+
+using xcexecution::NinjaDependencyInfo;
+using libutil::Filesystem;
+using libutil::FSUtil;
+
+bool NinjaDependencyInfo::
+Native(pbxbuild::Tool::Invocation const &invocation)
+{
+    return (invocation.dependencyInfo().size() == 1 && invocation.dependencyInfo().front().format() == dependency::DependencyInfoFormat::Makefile);
+}
+
+bool NinjaDependencyInfo::
+Conversion(pbxbuild::Tool::Invocation const &invocation, std::string const &output, std::string const &depfile, std::string *conversions)
+{
+    std::vector<std::string> fields = { output, depfile, invocation.workingDirectory() };
+    for (pbxbuild::Tool::Invocation::DependencyInfo const &dependencyInfo : invocation.dependencyInfo()) {
+        std::string formatName;
+        if (!dependency::DependencyInfoFormats::Name(dependencyInfo.format(), &formatName)) {
+            return false;
+        }
+
+        fields.push_back(formatName + ":" + dependencyInfo.path());
+    }
+
+    for (std::string const &field : fields) {
+        if (field.find_first_of("\t\n") != std::string::npos) {
+            /* Can't be represented; the depfile will be missing, so Ninja always runs the invocation. */
+            return true;
+        }
+    }
+
+    for (auto it = fields.begin(); it != fields.end(); ++it) {
+        *conversions += (it != fields.begin() ? "\t" : "") + *it;
+    }
+    *conversions += "\n";
+    return true;
+}
+
+bool NinjaDependencyInfo::
+Convert(Filesystem *filesystem, std::string const &conversionsPath)
+{
+    std::vector<uint8_t> contents;
+    if (!filesystem->exists(conversionsPath) || !filesystem->read(&contents, conversionsPath)) {
+        /* Nothing to convert. */
+        return true;
+    }
+
+    bool success = true;
+
+    std::istringstream stream = std::istringstream(std::string(contents.begin(), contents.end()));
+    std::string line;
+    while (std::getline(stream, line)) {
+        std::vector<std::string> fields;
+        std::istringstream lineStream = std::istringstream(line);
+        std::string field;
+        while (std::getline(lineStream, field, '\t')) {
+            fields.push_back(field);
+        }
+        if (fields.size() < 4) {
+            continue;
+        }
+
+        /*
+         * Most invocations didn't run in the last build: their dependency info
+         * is older than their depfile, so there's nothing new to convert. If a
+         * dependency info is missing, the invocation hasn't run yet, so leave
+         * the depfile missing for Ninja to run it next time.
+         */
+        std::vector<std::pair<dependency::DependencyInfoFormat, std::string>> paths;
+        ext::optional<Filesystem::Status> depfileStatus = filesystem->stat(fields[1]);
+        bool modified = (!depfileStatus || depfileStatus->modificationTime() == 0);
+
+        bool loaded = true;
+        for (auto it = fields.begin() + 3; it != fields.end(); ++it) {
+            std::string::size_type offset = it->find(':');
+            dependency::DependencyInfoFormat format;
+            if (offset == std::string::npos || !dependency::DependencyInfoFormats::Parse(it->substr(0, offset), &format)) {
+                loaded = false;
+                break;
+            }
+
+            std::string path = it->substr(offset + 1);
+            ext::optional<Filesystem::Status> status = filesystem->stat(path);
+            if (!status) {
+                loaded = false;
+                break;
+            }
+
+            /* Modified in the same tick as the depfile could be after it was written. */
+            if (!modified && status->modificationTime() >= depfileStatus->modificationTime()) {
+                modified = true;
+            }
+
+            paths.push_back({ format, path });
+        }
+        if (!loaded || !modified) {
+            continue;
+        }
+
+        dependency::DependencyInfo dependencyInfo;
+        dependencyInfo.outputs() = { fields[0] };
+
+        for (auto const &formatPath : paths) {
+            dependency::DependencyInfoFormat format = formatPath.first;
+            std::string const &path = formatPath.second;
+
+            std::string error;
+            ext::optional<std::vector<dependency::DependencyInfo>> info = dependency::DependencyInfo::Load(filesystem, format, path, &error);
+            if (!info) {
+                fprintf(stderr, "warning: %s\n", error.c_str());
+                loaded = false;
+                break;
+            }
+
+            /* Normalize path as Ninja requires matching paths. */
+            for (dependency::DependencyInfo const &entry : *info) {
+                for (std::string const &input : entry.inputs()) {
+                    dependencyInfo.inputs().push_back(FSUtil::ResolveRelativePath(input, fields[2]));
+                }
+            }
+        }
+        if (!loaded) {
+            continue;
+        }
+
+        dependency::MakefileDependencyInfo makefileInfo;
+        makefileInfo.dependencyInfo() = { dependencyInfo };
+        std::string serialized = makefileInfo.serialize();
+        std::vector<uint8_t> makefileContents = std::vector<uint8_t>(serialized.begin(), serialized.end());
+
+        /* Written even if unchanged, so it's newer than the dependency info. */
+        if (!filesystem->write(makefileContents, fields[1])) {
+            fprintf(stderr, "error: unable to write dependency info %s\n", fields[1].c_str());
+            success = false;
+        }
+    }
+
+    return success;
+}
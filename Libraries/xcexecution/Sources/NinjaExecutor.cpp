@@ -8,12 +8,16 @@
 
 #include <xcexecution/NinjaExecutor.h>
 
+#include <xcexecution/NinjaDependencyInfo.h>
+#include <xcexecution/NinjaTargetCache.h>
 #include <xcexecution/Parameters.h>
+#include <builtin/Server.h>
 #include <pbxbuild/Phase/Environment.h>
 #include <pbxbuild/Phase/PhaseInvocations.h>
 #include <ninja/Writer.h>
 #include <ninja/Value.h>
 #include <plist/Data.h>
+#include <libutil/CachingFilesystem.h>
 #include <libutil/Escape.h>
 #include <libutil/Filesystem.h>
 #include <libutil/FSUtil.h>
@@ -22,7 +26,10 @@
 #include <process/Launcher.h>
 #include <process/User.h>
 #include <libutil/md5.h>
+#include <libutil/ThreadPool.h>
 
+#include <algorithm>
+#include <cstdlib>
 #include <sstream>
 #include <iomanip>
 
@@ -30,14 +37,19 @@
 #include <sys/stat.h>
 
 using xcexecution::NinjaExecutor;
+using xcexecution::NinjaDependencyInfo;
+using xcexecution::NinjaTargetCache;
 using xcexecution::Parameters;
+using libutil::CachingFilesystem;
 using libutil::Escape;
 using libutil::Filesystem;
 using libutil::FSUtil;
 
 NinjaExecutor::
-NinjaExecutor(std::shared_ptr<xcformatter::Formatter> const &formatter, bool dryRun, bool generate) :
-    Executor(formatter, dryRun, generate)
+NinjaExecutor(std::shared_ptr<xcformatter::Formatter> const &formatter, bool dryRun, bool generate, bool verbose, builtin::Registry const &builtins) :
+    Executor (formatter, dryRun, generate),
+    _verbose (verbose),
+    _builtins(builtins)
 {
 }
 
@@ -126,6 +138,23 @@ NinjaHash(char const *data, size_t size)
     return ss.str();
 }
 
+/*
+ * The socket the builtin server listens on during a build. Socket paths are
+ * limited to a short length, so rather than inside the build directory, it's
+ * named by a hash of the build directory inside a temporary directory.
+ */
+static std::string
+NinjaBuiltinSocketPath(process::Context const *processContext, process::User const *user, std::string const &intermediatesDirectory)
+{
+    std::string temporaryDirectory = processContext->environmentVariable("TMPDIR").value_or("/tmp");
+    while (temporaryDirectory.size() > 1 && temporaryDirectory.back() == '/') {
+        temporaryDirectory.pop_back();
+    }
+
+    std::string hash = NinjaHash(intermediatesDirectory.data(), intermediatesDirectory.size()).substr(0, 16);
+    return temporaryDirectory + "/" + "xcbuild-" + user->userID() + "/" + hash + ".sock";
+}
+
 static ext::optional<std::string>
 NinjaBuiltinExecutablePath(
     process::Context const *processContext,
@@ -274,20 +303,31 @@ WriteNinjaRegenerate(
         /* This command regenerates the Ninja files. */
         { "generator", ninja::Value::String("1") },
 
+        /* Unchanged Ninja files are not rewritten, so check if it was. */
+        { "restat", ninja::Value::String("1") },
+
         /* Use the console pool to pass through terminal settings. */
         { "pool", ninja::Value::String("console") },
     });
 }
 
 static bool
-WriteNinja(Filesystem *filesystem, ninja::Writer const &writer, std::string const &path)
+WriteNinja(Filesystem *filesystem, std::string const &contents, std::string const &path)
 {
     if (!filesystem->createDirectory(FSUtil::GetDirectoryName(path), true)) {
         return false;
     }
 
-    std::string contents = writer.serialize();
     std::vector<uint8_t> copy = std::vector<uint8_t>(contents.begin(), contents.end());
+
+    /*
+     * Leave unchanged files alone, so Ninja doesn't need to reload them.
+     */
+    std::vector<uint8_t> existing;
+    if (filesystem->exists(path) && filesystem->read(&existing, path) && existing == copy) {
+        return true;
+    }
+
     if (!filesystem->write(copy, path)) {
         return false;
     }
@@ -296,14 +336,14 @@ WriteNinja(Filesystem *filesystem, ninja::Writer const &writer, std::string cons
 }
 
 static bool
-WriteAuxiliaryFiles(Filesystem *filesystem, std::map<std::string, pbxbuild::Tool::AuxiliaryFile::Chunk const *> &auxiliaryFileChunks)
+WriteAuxiliaryFiles(Filesystem *filesystem, std::map<std::string, std::vector<uint8_t>> const &auxiliaryFileContents)
 {
-    for (auto it : auxiliaryFileChunks) {
+    for (auto const &it : auxiliaryFileContents) {
         if (!filesystem->createDirectory(FSUtil::GetDirectoryName(it.first), true)) {
             return false;
         }
 
-        if (!filesystem->write(*it.second->data(), it.first)) {
+        if (!filesystem->write(it.second, it.first)) {
             return false;
         }
     }
@@ -387,12 +427,8 @@ build(
     std::string intermediatesDirectory = environment.resolve("OBJROOT");
     std::string ninjaPath = intermediatesDirectory + "/" + "build.ninja";
     std::string configurationHashPath = intermediatesDirectory + "/" + ".ninja-configuration";
-
-    /*
-     * Find the dependency info tool.
-     */
-    std::string executableRoot = FSUtil::GetDirectoryName(processContext->executablePath());
-    std::string dependencyInfoToolPath = *NinjaBuiltinExecutablePath(processContext, filesystem, "dependency-info-tool");
+    std::string dependencyInfoConversionsPath = intermediatesDirectory + "/" + ".ninja-dependency-info";
+    std::string builtinSocketPath = NinjaBuiltinSocketPath(processContext, user, intermediatesDirectory);
 
     /*
      * If the Ninja file needs to be generated, generate it.
@@ -400,11 +436,17 @@ build(
     if (ShouldGenerateNinja(filesystem, _generate, buildParameters, ninjaPath, configurationHashPath)) {
         fprintf(stderr, "Generating Ninja files...\n");
 
+        /*
+         * Generating asks about the same paths many times over, and nothing else changes
+         * the filesystem until Ninja runs, so cache what's found for the generation.
+         */
+        CachingFilesystem generateFilesystem(filesystem);
+
         /*
          * Load the workspace. This can be quite slow, so only do it if it's needed to generate
          * the Ninja file. Similarly, only resolve dependencies in that case.
          */
-        ext::optional<pbxbuild::WorkspaceContext> workspaceContext = buildParameters.loadWorkspace(filesystem, user->userName(), buildEnvironment, processContext->currentDirectory());
+        ext::optional<pbxbuild::WorkspaceContext> workspaceContext = buildParameters.loadWorkspace(&generateFilesystem, user->userName(), buildEnvironment, processContext->currentDirectory());
         if (!workspaceContext) {
             fprintf(stderr, "error: unable to load workspace\n");
             return false;
@@ -427,15 +469,16 @@ build(
          */
         bool result = buildAction(
             processContext,
-            filesystem,
+            &generateFilesystem,
             buildParameters,
             buildEnvironment,
             *buildContext,
             *targetGraph,
-            dependencyInfoToolPath,
             ninjaPath,
             configurationHashPath,
-            intermediatesDirectory);
+            dependencyInfoConversionsPath,
+            intermediatesDirectory,
+            builtinSocketPath);
 
         if (!result) {
             fprintf(stderr, "error: failed to generate build.ninja\n");
@@ -447,10 +490,16 @@ build(
          */
         std::string hashContents = buildParameters.canonicalHash();
         auto contents = std::vector<uint8_t>(hashContents.begin(), hashContents.end());
-        if (!filesystem->write(contents, configurationHashPath)) {
+        if (!generateFilesystem.write(contents, configurationHashPath)) {
             fprintf(stderr, "error: failed to generate ninja configuration hash\n");
             return false;
         }
+
+        if (_verbose) {
+            fprintf(stderr, "Filesystem cache: %llu hits, %llu misses\n",
+                static_cast<unsigned long long>(generateFilesystem.hits()),
+                static_cast<unsigned long long>(generateFilesystem.misses()));
+        }
     }
 
     /*
@@ -497,6 +546,15 @@ build(
 
         // TODO(grp): Pass number of jobs if specified.
 
+        /*
+         * Run builtin tools for Ninja in this process while it builds. If the server
+         * can't start, the builtin client runs the tools itself instead.
+         */
+        builtin::Server builtinServer(_builtins, filesystem);
+        if (!_dryRun) {
+            builtinServer.start(builtinSocketPath);
+        }
+
         /*
          * Run Ninja and return if it failed. Ninja itself does the build.
          */
@@ -505,7 +563,16 @@ build(
             intermediatesDirectory,
             arguments,
             processContext->environmentVariables());
-        ext::optional<int> exitCode = processLauncher->launch(filesystem, &ninja);
+        ext::optional<int> exitCode = processLauncher->launch(filesystem, &ninja, nullptr);
+
+        /*
+         * Convert the dependency info from the invocations that ran, even if
+         * the build failed, so the next build knows their dependencies.
+         */
+        if (!_dryRun && !NinjaDependencyInfo::Convert(filesystem, dependencyInfoConversionsPath)) {
+            return false;
+        }
+
         if (!exitCode || *exitCode != 0) {
             return false;
         }
@@ -522,10 +589,11 @@ buildAction(
     pbxbuild::Build::Environment const &buildEnvironment,
     pbxbuild::Build::Context const &buildContext,
     pbxbuild::DirectedGraph<pbxproj::PBX::Target::shared_ptr> const &targetGraph,
-    std::string const &dependencyInfoToolPath,
     std::string const &ninjaPath,
     std::string const &configurationHashPath,
-    std::string const &intermediatesDirectory)
+    std::string const &dependencyInfoConversionsPath,
+    std::string const &intermediatesDirectory,
+    std::string const &builtinSocketPath)
 {
     /*
      * Write out a Ninja file for the build as a whole. Note each target will have a separate
@@ -556,13 +624,53 @@ buildAction(
      * rules at the Ninja level. Instead, add a single rule that just passes through from
      * the build command that calls it.
      */
-    writer.rule(NinjaRuleName(), ninja::Value::Expression("cd $dir && env $env $exec && $depexec"));
+    writer.rule(NinjaRuleName(), ninja::Value::Expression("cd $dir && env $env $exec"));
+
+    /*
+     * Fingerprint the inputs to each target. Targets with the same fingerprint as
+     * when last generated reuse their Ninja, rather than resolving them again.
+     */
+    std::vector<pbxproj::PBX::Target::shared_ptr> targets = std::vector<pbxproj::PBX::Target::shared_ptr>(targetGraph.nodes().begin(), targetGraph.nodes().end());
+    std::unordered_map<pbxproj::PBX::Target::shared_ptr, std::string> fingerprints = NinjaTargetCache::Fingerprints(processContext, filesystem, buildParameters, buildEnvironment, buildContext, targetGraph);
+
+    std::vector<std::string> targetCachePaths = std::vector<std::string>(targets.size());
+    std::vector<std::string> targetNinjas = std::vector<std::string>(targets.size());
+    std::vector<std::string> targetDependencyInfoConversions = std::vector<std::string>(targets.size());
+    std::vector<std::string> targetSubninjaPaths = std::vector<std::string>(targets.size());
+    std::vector<std::string> targetSubninjas = std::vector<std::string>(targets.size());
+    std::vector<std::map<std::string, std::vector<uint8_t>>> targetAuxiliaryFiles = std::vector<std::map<std::string, std::vector<uint8_t>>>(targets.size());
+    std::vector<char> targetResults = std::vector<char>(targets.size(), false);
+
+    std::vector<size_t> changedTargets;
+    for (size_t index = 0; index < targets.size(); index++) {
+        targetCachePaths[index] = NinjaTargetCache::Path(intermediatesDirectory, targets[index]);
+
+        auto it = fingerprints.find(targets[index]);
+        if (it != fingerprints.end() && NinjaTargetCache::Load(filesystem, targetCachePaths[index], it->second, &targetNinjas[index], &targetDependencyInfoConversions[index])) {
+            targetResults[index] = true;
+        } else {
+            changedTargets.push_back(index);
+        }
+    }
 
     /*
-     * Go over each target and write out Ninja targets for the start and end of each.
-     * Don't bother topologically sorting the targets now, since Ninja will do that for us.
+     * Builtin tools run through the builtin client, which asks the server
+     * started for the build to run them, rather than starting a process.
      */
-    for (pbxproj::PBX::Target::shared_ptr const &target : targetGraph.nodes()) {
+    std::vector<std::string> builtinClient;
+    if (ext::optional<std::string> builtinClientPath = NinjaBuiltinExecutablePath(processContext, filesystem, "builtin-client")) {
+        builtinClient = { *builtinClientPath, builtinSocketPath };
+    }
+
+    /*
+     * Resolve each changed target and generate its Ninja file. Targets are independent
+     * at this point, so they are resolved at the same time. The results are kept in the
+     * order of the targets to write the top-level Ninja file below.
+     */
+    libutil::ThreadPool pool(libutil::ThreadPool::DefaultThreadCount());
+    pool.apply(changedTargets.size(), [&](size_t changedIndex) {
+        size_t index = changedTargets[changedIndex];
+        pbxproj::PBX::Target::shared_ptr const &target = targets[index];
 
         /*
          * Beginning target depends on finishing the targets before that. This is implemented
@@ -587,12 +695,26 @@ buildAction(
         ext::optional<pbxbuild::Target::Environment> targetEnvironment = buildContext.targetEnvironment(buildEnvironment, target);
         if (!targetEnvironment) {
             fprintf(stderr, "error: couldn't create target environment for %s\n", target->name().c_str());
-            continue;
+            targetResults[index] = true;
+            return;
         }
 
         pbxbuild::Phase::Environment phaseEnvironment = pbxbuild::Phase::Environment(buildEnvironment, buildContext, target, *targetEnvironment);
         pbxbuild::Phase::PhaseInvocations phaseInvocations = pbxbuild::Phase::PhaseInvocations::Create(phaseEnvironment, target);
 
+        /*
+         * Generate the Ninja file to build this target.
+         */
+        if (!buildTargetInvocations(processContext, filesystem, target, *targetEnvironment, phaseInvocations.auxiliaryFiles(), phaseInvocations.invocations(), builtinClient, &targetSubninjas[index], &targetAuxiliaryFiles[index], &targetDependencyInfoConversions[index])) {
+            fprintf(stderr, "error: failed to build target ninja\n");
+            return;
+        }
+
+        /*
+         * Write this target's section of the top-level Ninja file.
+         */
+        ninja::Writer targetWriter;
+
         /*
          * As described above, the target's begin depends on all of the target dependencies.
          */
@@ -606,7 +728,7 @@ buildAction(
          * Add the phony target for beginning this target's build.
          */
         std::string targetBegin = TargetNinjaBegin(target);
-        writer.build({ ninja::Value::String(targetBegin) }, "phony", dependenciesFinished);
+        targetWriter.build({ ninja::Value::String(targetBegin) }, "phony", dependenciesFinished);
 
         /*
          * Add the phony target for the checkpoint after writing auxiliary files.
@@ -616,21 +738,14 @@ buildAction(
         for (pbxbuild::Tool::AuxiliaryFile const &auxiliaryFile : phaseInvocations.auxiliaryFiles()) {
             auxiliaryFileOutputs.push_back(ninja::Value::String(auxiliaryFile.path()));
         }
-        writer.build({ ninja::Value::String(targetWriteAuxiliaryFiles) }, "phony", auxiliaryFileOutputs);
-
-        /*
-         * Write out the Ninja file to build this target.
-         */
-        if (!buildTargetInvocations(processContext, filesystem, dependencyInfoToolPath, target, *targetEnvironment, phaseInvocations.auxiliaryFiles(), phaseInvocations.invocations())) {
-            fprintf(stderr, "error: failed to build target ninja\n");
-            return false;
-        }
+        targetWriter.build({ ninja::Value::String(targetWriteAuxiliaryFiles) }, "phony", auxiliaryFileOutputs);
 
         /*
          * Load the Ninja file generated for this target.
          */
         std::string targetPath = TargetNinjaPath(target, *targetEnvironment);
-        writer.subninja(ninja::Value::String(targetPath));
+        targetWriter.subninja(ninja::Value::String(targetPath));
+        targetSubninjaPaths[index] = targetPath;
 
         /*
          * As described above, the target's finish depends on all of the invocation outputs.
@@ -655,7 +770,7 @@ buildAction(
         for (pbxbuild::Tool::Invocation const &invocation : phaseInvocations.invocations()) {
             for (std::string const &phonyInput : invocation.phonyInputs()) {
                 if (invocationOutputs.find(phonyInput) == invocationOutputs.end()) {
-                    writer.build({ ninja::Value::String(phonyInput) }, "phony", { });
+                    targetWriter.build({ ninja::Value::String(phonyInput) }, "phony", { });
                 }
             }
         }
@@ -668,7 +783,57 @@ buildAction(
             maxInvocationPriority = std::max(maxInvocationPriority, invocation.priority());
         }
         std::string targetFinish = TargetNinjaFinish(target);
-        writer.build({ ninja::Value::String(targetFinish) }, "phony", { ninja::Value::String(TargetPhaseNinjaFinish(target, maxInvocationPriority)) });
+        targetWriter.build({ ninja::Value::String(targetFinish) }, "phony", { ninja::Value::String(TargetPhaseNinjaFinish(target, maxInvocationPriority)) });
+
+        targetNinjas[index] = targetWriter.serialize();
+        targetResults[index] = true;
+    });
+
+    /*
+     * Write out the files generated for the changed targets. Targets share output
+     * directories, so write them one at a time rather than racing to create those.
+     */
+    for (size_t index : changedTargets) {
+        if (targetSubninjaPaths[index].empty()) {
+            /* Not generated. */
+            continue;
+        }
+
+        if (!WriteNinja(filesystem, targetSubninjas[index], targetSubninjaPaths[index])) {
+            fprintf(stderr, "error: unable to write target ninja: %s\n", targetSubninjaPaths[index].c_str());
+            return false;
+        }
+
+        if (!WriteAuxiliaryFiles(filesystem, targetAuxiliaryFiles[index])) {
+            fprintf(stderr, "error: unable to write auxiliary files\n");
+            return false;
+        }
+
+        /*
+         * Record what was generated to reuse if the target is unchanged next time.
+         */
+        auto it = fingerprints.find(targets[index]);
+        if (it != fingerprints.end()) {
+            if (!NinjaTargetCache::Write(filesystem, targetCachePaths[index], it->second, targetSubninjaPaths[index], targetNinjas[index], targetDependencyInfoConversions[index])) {
+                fprintf(stderr, "warning: unable to write target cache %s\n", targetCachePaths[index].c_str());
+            }
+        }
+    }
+
+    /*
+     * Go over each target and add its section of the top-level Ninja file. Don't bother
+     * topologically sorting the targets now, since Ninja will do that for us. Also collect
+     * the dependency info that needs conversion for Ninja after the build.
+     */
+    std::string contents = writer.serialize();
+    std::string dependencyInfoConversions;
+    for (size_t index = 0; index < targets.size(); index++) {
+        if (!targetResults[index]) {
+            return false;
+        }
+
+        contents += targetNinjas[index];
+        dependencyInfoConversions += targetDependencyInfoConversions[index];
     }
 
     /*
@@ -679,23 +844,35 @@ buildAction(
     /*
      * Add a Ninja rule to regenerate the build.ninja file itself.
      */
+    ninja::Writer regenerateWriter;
     WriteNinjaRegenerate(
-        &writer,
+        &regenerateWriter,
         buildParameters,
         processContext->executablePath(),
         processContext->currentDirectory(),
         ninjaPath,
         configurationHashPath,
         inputPaths);
+    contents += regenerateWriter.serialize();
 
     /*
-     * Serialize the Ninja file into the build root.
+     * Serialize the Ninja file into the build root. If no targets changed, it is
+     * the same as before and is left as-is.
      */
-    if (!WriteNinja(filesystem, writer, ninjaPath)) {
+    if (!WriteNinja(filesystem, contents, ninjaPath)) {
         fprintf(stderr, "error: failed to write Ninja to %s\n", ninjaPath.c_str());
         return false;
     }
 
+    /*
+     * Write out the dependency info to convert after building.
+     */
+    std::vector<uint8_t> dependencyInfoContents = std::vector<uint8_t>(dependencyInfoConversions.begin(), dependencyInfoConversions.end());
+    if (!filesystem->write(dependencyInfoContents, dependencyInfoConversionsPath)) {
+        fprintf(stderr, "error: failed to write dependency info conversions to %s\n", dependencyInfoConversionsPath.c_str());
+        return false;
+    }
+
     /*
      * Note where the Ninja file is written.
      */
@@ -708,11 +885,14 @@ bool NinjaExecutor::
 buildTargetInvocations(
     process::Context const *processContext,
     Filesystem *filesystem,
-    std::string const &dependencyInfoToolPath,
     pbxproj::PBX::Target::shared_ptr const &target,
     pbxbuild::Target::Environment const &targetEnvironment,
     std::vector<pbxbuild::Tool::AuxiliaryFile> const &auxiliaryFiles,
-    std::vector<pbxbuild::Tool::Invocation> const &invocations)
+    std::vector<pbxbuild::Tool::Invocation> const &invocations,
+    std::vector<std::string> const &builtinClient,
+    std::string *targetNinja,
+    std::map<std::string, std::vector<uint8_t>> *auxiliaryFileContents,
+    std::string *dependencyInfoConversions)
 {
     /*
      * Start building the Ninja file for this target.
@@ -788,24 +968,25 @@ buildTargetInvocations(
                 return false;
             }
 
+            /* Run builtin tools through the builtin client, if available. */
+            std::vector<std::string> command = { *executablePath };
+            if (invocation.executable()->builtin() && !builtinClient.empty()) {
+                command.insert(command.begin(), builtinClient.begin(), builtinClient.end());
+            }
+
             /* Write invocations to run after auxiliary files. */
-            if (!buildInvocation(&writer, invocation, *executablePath, dependencyInfoToolPath, temporaryDirectory, TargetPhaseNinjaBegin(target, invocation.priority()))) {
+            if (!buildInvocation(&writer, invocation, command, temporaryDirectory, TargetPhaseNinjaBegin(target, invocation.priority()), dependencyInfoConversions)) {
                 return false;
             }
         }
     }
 
     /*
-     * Serialize the Ninja file into the build root.
+     * Serialize the Ninja file. It's written out by the caller.
      */
-    std::string path = TargetNinjaPath(target, targetEnvironment);
-    if (!WriteNinja(filesystem, writer, path)) {
-        fprintf(stderr, "error: unable to write target ninja: %s\n", path.c_str());
-        return false;
-    }
-    if (!WriteAuxiliaryFiles(filesystem, auxiliaryFileChunks)) {
-        fprintf(stderr, "error: unable to write auxiliary files\n");
-        return false;
+    *targetNinja = writer.serialize();
+    for (auto const &it : auxiliaryFileChunks) {
+        (*auxiliaryFileContents)[it.first] = *it.second->data();
     }
 
     return true;
@@ -866,7 +1047,6 @@ buildAuxiliaryFile(
         { "description", ninja::Value::String(description) },
         { "dir", ninja::Value::String("/") },
         { "exec", ninja::Value::String(exec) },
-        { "depexec", ninja::Value::String("true") },
     };
     writer->build(outputs, NinjaRuleName(), inputs, bindings, { }, orderDependencies);
 
@@ -877,16 +1057,22 @@ bool NinjaExecutor::
 buildInvocation(
     ninja::Writer *writer,
     pbxbuild::Tool::Invocation const &invocation,
-    std::string const &executablePath,
-    std::string const &dependencyInfoToolPath,
+    std::vector<std::string> const &command,
     std::string const &temporaryDirectory,
-    std::string const &after)
+    std::string const &after,
+    std::string *dependencyInfoConversions)
 {
     /*
      * Build the invocation arguments. Must escape for shell arguments as Ninja passes
      * the command string directly to the shell, which would interpret spaces, etc as meaningful.
      */
-    std::string exec = Escape::Shell(executablePath);
+    std::string exec;
+    for (std::string const &arg : command) {
+        if (!exec.empty()) {
+            exec += " ";
+        }
+        exec += Escape::Shell(arg);
+    }
     for (std::string const &arg : invocation.arguments()) {
         exec += " " + Escape::Shell(arg);
     }
@@ -907,46 +1093,31 @@ buildInvocation(
     /*
      * Determine the status message for Ninja to print for this invocation.
      */
-    std::string executableDisplayName = invocation.executable()->builtin().value_or(executablePath);
+    std::string executableDisplayName = invocation.executable()->builtin().value_or(command.back());
     std::string description = NinjaDescription(_formatter->beginInvocation(invocation, executableDisplayName, false));
 
     /*
-     * Add the dependency info converter & file.
+     * Add the dependency info file. A Makefile-format dependency info is
+     * already a depfile, so Ninja can read it directly. Other dependency info
+     * is converted into a depfile in one batch after Ninja runs, resolving
+     * relative paths against the invocation's directory.
      */
     std::string dependencyInfoFile;
-    std::string dependencyInfoExec;
+    bool nativeDependencyInfo = false;
 
-    if (!invocation.dependencyInfo().empty()) {
+    if (NinjaDependencyInfo::Native(invocation)) {
+        dependencyInfoFile = invocation.dependencyInfo().front().path();
+        nativeDependencyInfo = true;
+    } else if (!invocation.dependencyInfo().empty()) {
         /* Determine the first output; Ninja expects that as the Makefile rule. */
         std::string output = NinjaInvocationOutputs(invocation).front();
 
         /* Find where the generated dependency info should go. */
         dependencyInfoFile = temporaryDirectory + "/" + ".ninja-dependency-info-" + NinjaHash(output.data(), output.size()) + ".d";
 
-        /* Build the dependency info rewriter arguments. */
-        std::vector<std::string> dependencyInfoArguments = {
-            "--name", output,
-            "--output", dependencyInfoFile,
-        };
-
-        /* Add the input for each dependency info. */
-        for (pbxbuild::Tool::Invocation::DependencyInfo const &dependencyInfo : invocation.dependencyInfo()) {
-            std::string formatName;
-            if (!dependency::DependencyInfoFormats::Name(dependencyInfo.format(), &formatName)) {
-                return false;
-            }
-
-            dependencyInfoArguments.push_back(formatName + ":" + dependencyInfo.path());
-        }
-
-        /* Create the command for converting the dependency info. */
-        dependencyInfoExec = Escape::Shell(dependencyInfoToolPath);
-        for (std::string const &arg : dependencyInfoArguments) {
-            dependencyInfoExec += " " + Escape::Shell(arg);
+        if (!NinjaDependencyInfo::Conversion(invocation, output, dependencyInfoFile, dependencyInfoConversions)) {
+            return false;
         }
-    } else {
-        // TODO(grp): Avoid the need for an empty dependency info command if not used.
-        dependencyInfoExec = "true";
     }
 
     /*
@@ -960,12 +1131,13 @@ buildInvocation(
     if (!environment.empty()) {
         bindings.push_back({ "env", ninja::Value::String(environment) });
     }
-    if (!dependencyInfoExec.empty()) {
-        bindings.push_back({ "depexec", ninja::Value::String(dependencyInfoExec) });
-    }
     if (!dependencyInfoFile.empty()) {
         bindings.push_back({ "depfile", ninja::Value::String(dependencyInfoFile) });
     }
+    if (nativeDependencyInfo) {
+        /* Ninja stores the dependencies itself, so it doesn't need to re-read depfiles. */
+        bindings.push_back({ "deps", ninja::Value::String("gcc") });
+    }
 
     /*
      * Build up outputs as literal Ninja values.
@@ -1013,11 +1185,13 @@ buildInvocation(
 }
 
 std::unique_ptr<NinjaExecutor> NinjaExecutor::
-Create(std::shared_ptr<xcformatter::Formatter> const &formatter, bool dryRun, bool generate)
+Create(std::shared_ptr<xcformatter::Formatter> const &formatter, bool dryRun, bool generate, bool verbose, builtin::Registry const &builtins)
 {
     return std::unique_ptr<NinjaExecutor>(new NinjaExecutor(
         formatter,
         dryRun,
-        generate
+        generate,
+        verbose,
+        builtins
     ));
 }
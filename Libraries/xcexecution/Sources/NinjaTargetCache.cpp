@@ -0,0 +1,270 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree.
+ */
+
+#include <xcexecution/NinjaTargetCache.h>
+#include <xcexecution/Parameters.h>
+#include <pbxbuild/Build/Context.h>
+#include <pbxbuild/Build/Environment.h>
+#include <pbxspec/Manager.h>
+#include <libutil/Filesystem.h>
+#include <libutil/md5.h>
+#include <process/Context.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
+
+using xcexecution::NinjaTargetCache;
+using xcexecution::Parameters;
+using libutil::Filesystem;
+
+static std::string
+Hash(char const *data, size_t size)
+{
+    md5_state_t state;
+    md5_init(&state);
+    md5_append(&state, reinterpret_cast<const md5_byte_t *>(data), size);
+    uint8_t digest[16];
+    md5_finish(&state, reinterpret_cast<md5_byte_t *>(&digest));
+
+    std::ostringstream ss;
+    ss << std::hex << std::setfill('0');
+    for (uint8_t c : digest) {
+        ss << std::setw(2) << static_cast<int>(c);
+    }
+
+    return ss.str();
+}
+
+static std::string
+FileHash(Filesystem const *filesystem, std::string const &path, std::unordered_map<std::string, std::string> *hashes)
+{
+    auto it = hashes->find(path);
+    if (it != hashes->end()) {
+        return it->second;
+    }
+
+    std::string hash = "-";
+    std::vector<uint8_t> contents;
+    if (filesystem->exists(path) && filesystem->read(&contents, path)) {
+        hash = Hash(reinterpret_cast<char const *>(contents.data()), contents.size());
+    }
+
+    hashes->insert({ path, hash });
+    return hash;
+}
+
+static void
+ConfigFingerprint(Filesystem const *filesystem, pbxsetting::XC::Config const &config, std::unordered_map<std::string, std::string> *hashes, std::string *fingerprint)
+{
+    *fingerprint += config.path() + '\0' + FileHash(filesystem, config.path(), hashes) + '\0';
+
+    /* Included configs are inputs too. */
+    for (pbxsetting::XC::Config::Entry const &entry : config.contents()) {
+        if (entry.config() != nullptr) {
+            ConfigFingerprint(filesystem, *entry.config(), hashes, fingerprint);
+        }
+    }
+}
+
+std::string NinjaTargetCache::
+SpecificationsFingerprint(Filesystem const *filesystem, pbxspec::Manager const &specManager)
+{
+    /*
+     * There are many specification files, so compare their status rather than
+     * reading them all each build. Directories change when files are added.
+     */
+    std::string fingerprint;
+    for (std::string const &input : specManager.inputs()) {
+        fingerprint += input + '\0';
+
+        if (ext::optional<Filesystem::Status> status = filesystem->stat(input)) {
+            fingerprint += std::to_string(static_cast<int>(status->type())) + ':' + std::to_string(status->size()) + ':' + std::to_string(status->modificationTime());
+        } else {
+            fingerprint += '-';
+        }
+        fingerprint += '\0';
+    }
+
+    return Hash(fingerprint.data(), fingerprint.size());
+}
+
+std::unordered_map<pbxproj::PBX::Target::shared_ptr, std::string> NinjaTargetCache::
+Fingerprints(
+    process::Context const *processContext,
+    Filesystem const *filesystem,
+    Parameters const &buildParameters,
+    pbxbuild::Build::Environment const &buildEnvironment,
+    pbxbuild::Build::Context const &buildContext,
+    pbxbuild::DirectedGraph<pbxproj::PBX::Target::shared_ptr> const &targetGraph)
+{
+    std::unordered_map<pbxproj::PBX::Target::shared_ptr, std::string> fingerprints;
+
+    /* Fingerprints include dependencies, so need dependencies first. */
+    ext::optional<std::vector<pbxproj::PBX::Target::shared_ptr>> orderedTargets = targetGraph.ordered();
+    if (!orderedTargets) {
+        return fingerprints;
+    }
+
+    std::unordered_map<std::string, std::string> hashes;
+
+    /*
+     * Inputs shared by all targets.
+     */
+    std::string shared = "xcbuild ninja target v1";
+    shared += '\0' + buildParameters.canonicalHash();
+    shared += '\0' + FileHash(filesystem, processContext->executablePath(), &hashes);
+    shared += '\0' + SpecificationsFingerprint(filesystem, *buildEnvironment.specManager());
+    shared += '\0' + buildEnvironment.sdkManager()->path();
+    for (xcsdk::SDK::Platform::shared_ptr const &platform : buildEnvironment.sdkManager()->platforms()) {
+        shared += '\0' + platform->path() + '\0' + platform->version().value_or("");
+        if (platform->platformVersion() != nullptr) {
+            shared += '\0' + platform->platformVersion()->buildVersion().value_or("");
+        }
+
+        for (xcsdk::SDK::Target::shared_ptr const &sdk : platform->targets()) {
+            shared += '\0' + sdk->path() + '\0' + sdk->version().value_or("");
+            if (sdk->product() != nullptr) {
+                shared += '\0' + sdk->product()->buildVersion().value_or("");
+            }
+        }
+    }
+
+    auto const &configs = buildContext.workspaceContext().configs();
+
+    for (pbxproj::PBX::Target::shared_ptr const &target : *orderedTargets) {
+        std::string fingerprint = shared;
+        fingerprint += '\0' + target->name();
+
+        /*
+         * The project defining the target, and the configuration files used by
+         * the project and target for the configuration being built.
+         */
+        std::vector<pbxproj::XC::ConfigurationList::shared_ptr> configurationLists = { target->buildConfigurationList() };
+        if (pbxproj::PBX::Project::shared_ptr const &project = target->project()) {
+            fingerprint += '\0' + project->dataFile() + '\0' + FileHash(filesystem, project->dataFile(), &hashes);
+            configurationLists.push_back(project->buildConfigurationList());
+        }
+
+        for (pbxproj::XC::ConfigurationList::shared_ptr const &configurationList : configurationLists) {
+            if (configurationList == nullptr) {
+                continue;
+            }
+
+            for (pbxproj::XC::BuildConfiguration::shared_ptr const &buildConfiguration : configurationList->buildConfigurations()) {
+                if (buildConfiguration->name() != buildContext.configuration()) {
+                    continue;
+                }
+
+                auto it = configs.find(buildConfiguration);
+                if (it != configs.end()) {
+                    ConfigFingerprint(filesystem, it->second, &hashes, &fingerprint);
+                }
+            }
+        }
+
+        /*
+         * The targets this target depends on. Sorted to be independent of graph order.
+         */
+        std::vector<std::string> dependencyFingerprints;
+        for (pbxproj::PBX::Target::shared_ptr const &dependency : targetGraph.adjacent(target)) {
+            dependencyFingerprints.push_back(fingerprints[dependency]);
+        }
+        std::sort(dependencyFingerprints.begin(), dependencyFingerprints.end());
+        for (std::string const &dependencyFingerprint : dependencyFingerprints) {
+            fingerprint += '\0' + dependencyFingerprint;
+        }
+
+        fingerprints[target] = Hash(fingerprint.data(), fingerprint.size());
+    }
+
+    return fingerprints;
+}
+
+std::string NinjaTargetCache::
+Path(std::string const &intermediatesDirectory, pbxproj::PBX::Target::shared_ptr const &target)
+{
+    std::string key = target->name();
+    if (pbxproj::PBX::Project::shared_ptr const &project = target->project()) {
+        key += '\0' + project->dataFile();
+    }
+
+    return intermediatesDirectory + "/" + ".ninja-target-" + Hash(key.data(), key.size());
+}
+
+/*
+ * The target cache stores what was generated for a target: its fingerprint,
+ * the path to its Ninja file, its section of the top-level Ninja file, then
+ * its dependency info conversions. Fields before the last are on one line;
+ * the top-level section is prefixed by its length.
+ */
+bool NinjaTargetCache::
+Write(
+    Filesystem *filesystem,
+    std::string const &path,
+    std::string const &fingerprint,
+    std::string const &targetNinjaPath,
+    std::string const &targetNinja,
+    std::string const &dependencyInfoConversions)
+{
+    if (targetNinjaPath.find('\n') != std::string::npos) {
+        return false;
+    }
+
+    std::string contents = fingerprint + "\n" + targetNinjaPath + "\n" + std::to_string(targetNinja.size()) + "\n" + targetNinja + dependencyInfoConversions;
+    return filesystem->write(std::vector<uint8_t>(contents.begin(), contents.end()), path);
+}
+
+bool NinjaTargetCache::
+Load(
+    Filesystem const *filesystem,
+    std::string const &path,
+    std::string const &fingerprint,
+    std::string *targetNinja,
+    std::string *dependencyInfoConversions)
+{
+    std::vector<uint8_t> contents;
+    if (!filesystem->exists(path) || !filesystem->read(&contents, path)) {
+        return false;
+    }
+
+    std::string string = std::string(contents.begin(), contents.end());
+
+    std::string::size_type fingerprintEnd = string.find('\n');
+    if (fingerprintEnd == std::string::npos || string.compare(0, fingerprintEnd, fingerprint) != 0 || fingerprintEnd != fingerprint.size()) {
+        return false;
+    }
+
+    std::string::size_type pathEnd = string.find('\n', fingerprintEnd + 1);
+    if (pathEnd == std::string::npos) {
+        return false;
+    }
+
+    /* The generated target Ninja must still exist. */
+    std::string targetNinjaPath = string.substr(fingerprintEnd + 1, pathEnd - fingerprintEnd - 1);
+    if (!filesystem->exists(targetNinjaPath)) {
+        return false;
+    }
+
+    std::string::size_type sizeEnd = string.find('\n', pathEnd + 1);
+    if (sizeEnd == std::string::npos) {
+        return false;
+    }
+
+    char *end = nullptr;
+    std::string sizeString = string.substr(pathEnd + 1, sizeEnd - pathEnd - 1);
+    unsigned long long size = std::strtoull(sizeString.c_str(), &end, 10);
+    if (sizeString.empty() || *end != '\0' || size > string.size() - sizeEnd - 1) {
+        return false;
+    }
+
+    *targetNinja = string.substr(sizeEnd + 1, size);
+    *dependencyInfoConversions = string.substr(sizeEnd + 1 + size);
+    return true;
+}
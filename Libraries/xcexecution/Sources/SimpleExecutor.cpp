@@ -9,11 +9,13 @@
 #include <xcexecution/SimpleExecutor.h>
 
 #include <xcexecution/Parameters.h>
+#include <xcexecution/BuildLog.h>
 #include <builtin/Driver.h>
 #include <pbxbuild/Phase/Environment.h>
 #include <pbxbuild/Phase/PhaseInvocations.h>
 #include <libutil/Filesystem.h>
 #include <libutil/FSUtil.h>
+#include <libutil/ThreadPool.h>
 #include <process/Context.h>
 #include <process/MemoryContext.h>
 #include <process/Launcher.h>
@@ -22,6 +24,12 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
 #include <set>
 
 using xcexecution::SimpleExecutor;
@@ -31,10 +39,15 @@ using libutil::FSUtil;
 using libutil::Permissions;
 
 SimpleExecutor::
-SimpleExecutor(std::shared_ptr<xcformatter::Formatter> const &formatter, bool dryRun, builtin::Registry const &builtins) :
-    Executor (formatter, dryRun, false),
-    _builtins(builtins)
+SimpleExecutor(std::shared_ptr<xcformatter::Formatter> const &formatter, bool dryRun, size_t jobs, bool parallelizeTargets, builtin::Registry const &builtins) :
+    Executor           (formatter, dryRun, false),
+    _jobs              (jobs != 0 ? jobs : 1),
+    _parallelizeTargets(parallelizeTargets),
+    _builtins          (builtins)
 {
+    if (_jobs > 1) {
+        _jobPool = std::make_shared<libutil::ThreadPool>(_jobs);
+    }
 }
 
 SimpleExecutor::
@@ -42,6 +55,46 @@ SimpleExecutor::
 {
 }
 
+/*
+ * Finds how many nodes each node in a sorted graph is waiting on, and the
+ * nodes waiting on each node. Nodes are referred to by their sorted index.
+ */
+template<typename T>
+static void
+GraphDependents(
+    pbxbuild::DirectedGraph<T> const &graph,
+    std::vector<T> const &ordered,
+    std::vector<size_t> *waiting,
+    std::vector<std::vector<size_t>> *dependents)
+{
+    std::unordered_map<T, size_t> indexes;
+    for (size_t i = 0; i < ordered.size(); ++i) {
+        indexes.insert({ ordered[i], i });
+    }
+
+    *waiting = std::vector<size_t>(ordered.size(), 0);
+    *dependents = std::vector<std::vector<size_t>>(ordered.size());
+    for (size_t i = 0; i < ordered.size(); ++i) {
+        for (T const &dependency : graph.adjacent(ordered[i])) {
+            (*waiting)[i]++;
+            (*dependents)[indexes.at(dependency)].push_back(i);
+        }
+    }
+}
+
+/*
+ * Print formatted output, or collect it in `output` to print later.
+ */
+static void
+Print(std::string *output, std::string const &string)
+{
+    if (output != nullptr) {
+        output->append(string);
+    } else {
+        xcformatter::Formatter::Print(string);
+    }
+}
+
 bool SimpleExecutor::
 build(
     process::User const *user,
@@ -74,37 +127,158 @@ build(
         return false;
     }
 
-    for (pbxproj::PBX::Target::shared_ptr const &target : *orderedTargets) {
-        xcformatter::Formatter::Print(_formatter->beginTarget(*buildContext, target));
+    /*
+     * Load the record of previous builds to skip invocations that are already
+     * up to date. The record is shared by all targets in the build.
+     */
+    std::unique_ptr<BuildLog> buildLog;
+    if (!_dryRun) {
+        pbxsetting::Environment environment = pbxsetting::Environment(buildEnvironment.baseEnvironment());
+        environment.insertFront(pbxsetting::Level(workspaceContext->derivedDataHash().overrideSettings()), false);
+        for (pbxsetting::Level const &level : buildContext->overrideLevels()) {
+            environment.insertFront(level, false);
+        }
+
+        buildLog = BuildLog::Open(filesystem, environment.resolve("OBJROOT") + "/" + ".xcbuild-log");
+    }
+
+    std::vector<size_t> waiting;
+    std::vector<std::vector<size_t>> dependents;
+    GraphDependents(*targetGraph, *orderedTargets, &waiting, &dependents);
+
+    /* Ready targets start in dependency order, so serial builds are unchanged. */
+    std::set<size_t> ready;
+    for (size_t i = 0; i < orderedTargets->size(); ++i) {
+        if (waiting[i] == 0) {
+            ready.insert(i);
+        }
+    }
+
+    auto complete = [&](size_t index) {
+        for (size_t dependent : dependents[index]) {
+            if (--waiting[dependent] == 0) {
+                ready.insert(dependent);
+            }
+        }
+    };
+
+    /*
+     * When parallelizing targets, each target builds on its own thread as soon
+     * as the targets it depends on finish. Targets share the executor's jobs.
+     */
+    std::unique_ptr<libutil::ThreadPool> pool;
+    if (_parallelizeTargets) {
+        pool = std::unique_ptr<libutil::ThreadPool>(new libutil::ThreadPool(_jobs));
+    }
+
+    std::mutex finishedMutex;
+    std::condition_variable finishedCondition;
+    std::deque<std::pair<size_t, std::pair<bool, std::vector<pbxbuild::Tool::Invocation>>>> finished;
+    size_t running = 0;
+
+    bool success = true;
+    std::vector<pbxbuild::Tool::Invocation> failures;
+
+    while (true) {
+        /* Start ready targets. Stop starting targets after any failure. */
+        while (success && !ready.empty() && (pool == nullptr || running < pool->threads())) {
+            size_t index = *ready.begin();
+            ready.erase(ready.begin());
+
+            pbxproj::PBX::Target::shared_ptr const &target = (*orderedTargets)[index];
+
+            if (pool == nullptr) {
+                auto result = resolveAndBuildTarget(processContext, processLauncher, filesystem, buildEnvironment, *buildContext, target, buildLog.get(), nullptr);
+                if (result.first) {
+                    complete(index);
+                } else {
+                    success = false;
+                    failures.insert(failures.end(), result.second.begin(), result.second.end());
+                }
+            } else {
+                running++;
+                pbxbuild::Build::Context const *context = &*buildContext;
+                BuildLog *log = buildLog.get();
+                pool->dispatch([=, &buildEnvironment, &finishedMutex, &finishedCondition, &finished] {
+                    /* Print each target's output together, rather than interleaved with other targets. */
+                    std::string output;
+                    auto result = this->resolveAndBuildTarget(processContext, processLauncher, filesystem, buildEnvironment, *context, target, log, &output);
+
+                    std::unique_lock<std::mutex> lock(finishedMutex);
+                    xcformatter::Formatter::Print(output);
+                    finished.push_back({ index, result });
+                    finishedCondition.notify_one();
+                });
+            }
+        }
 
-        ext::optional<pbxbuild::Target::Environment> targetEnvironment = buildContext->targetEnvironment(buildEnvironment, target);
-        if (!targetEnvironment) {
-            fprintf(stderr, "error: couldn't create target environment for %s\n", target->name().c_str());
-            xcformatter::Formatter::Print(_formatter->finishTarget(*buildContext, target));
-            return false;
+        if (running == 0) {
+            break;
         }
 
-        xcformatter::Formatter::Print(_formatter->beginCheckDependencies(target));
-        pbxbuild::Phase::Environment phaseEnvironment = pbxbuild::Phase::Environment(buildEnvironment, *buildContext, target, *targetEnvironment);
-        pbxbuild::Phase::PhaseInvocations phaseInvocations = pbxbuild::Phase::PhaseInvocations::Create(phaseEnvironment, target);
-        xcformatter::Formatter::Print(_formatter->finishCheckDependencies(target));
+        /* Wait for any running target to finish. */
+        std::pair<size_t, std::pair<bool, std::vector<pbxbuild::Tool::Invocation>>> result;
+        {
+            std::unique_lock<std::mutex> lock(finishedMutex);
+            finishedCondition.wait(lock, [&finished] { return !finished.empty(); });
+            result = finished.front();
+            finished.pop_front();
+        }
+        running--;
 
-        auto result = buildTarget(processContext, processLauncher, filesystem, target, *targetEnvironment, phaseInvocations.auxiliaryFiles(), phaseInvocations.invocations());
-        if (!result.first) {
-            xcformatter::Formatter::Print(_formatter->finishTarget(*buildContext, target));
-            xcformatter::Formatter::Print(_formatter->failure(*buildContext, result.second));
-            return false;
+        if (result.second.first) {
+            complete(result.first);
+        } else {
+            success = false;
+            failures.insert(failures.end(), result.second.second.begin(), result.second.second.end());
         }
+    }
 
-        xcformatter::Formatter::Print(_formatter->finishTarget(*buildContext, target));
+    if (buildLog != nullptr && !buildLog->write(filesystem)) {
+        fprintf(stderr, "warning: unable to write build log to %s\n", buildLog->path().c_str());
+    }
+
+    if (!success) {
+        xcformatter::Formatter::Print(_formatter->failure(*buildContext, failures));
+        return false;
     }
 
     xcformatter::Formatter::Print(_formatter->success(*buildContext));
     return true;
 }
 
-static ext::optional<std::vector<pbxbuild::Tool::Invocation>>
-SortInvocations(std::vector<pbxbuild::Tool::Invocation> const &invocations)
+std::pair<bool, std::vector<pbxbuild::Tool::Invocation>> SimpleExecutor::
+resolveAndBuildTarget(
+    process::Context const *processContext,
+    process::Launcher *processLauncher,
+    Filesystem *filesystem,
+    pbxbuild::Build::Environment const &buildEnvironment,
+    pbxbuild::Build::Context const &buildContext,
+    pbxproj::PBX::Target::shared_ptr const &target,
+    BuildLog *buildLog,
+    std::string *output)
+{
+    Print(output, _formatter->beginTarget(buildContext, target));
+
+    ext::optional<pbxbuild::Target::Environment> targetEnvironment = buildContext.targetEnvironment(buildEnvironment, target);
+    if (!targetEnvironment) {
+        fprintf(stderr, "error: couldn't create target environment for %s\n", target->name().c_str());
+        Print(output, _formatter->finishTarget(buildContext, target));
+        return std::make_pair(false, std::vector<pbxbuild::Tool::Invocation>());
+    }
+
+    Print(output, _formatter->beginCheckDependencies(target));
+    pbxbuild::Phase::Environment phaseEnvironment = pbxbuild::Phase::Environment(buildEnvironment, buildContext, target, *targetEnvironment);
+    pbxbuild::Phase::PhaseInvocations phaseInvocations = pbxbuild::Phase::PhaseInvocations::Create(phaseEnvironment, target);
+    Print(output, _formatter->finishCheckDependencies(target));
+
+    auto result = buildTarget(processContext, processLauncher, filesystem, target, *targetEnvironment, phaseInvocations.auxiliaryFiles(), phaseInvocations.invocations(), buildLog, output);
+    Print(output, _formatter->finishTarget(buildContext, target));
+    return result;
+}
+
+static pbxbuild::DirectedGraph<pbxbuild::Tool::Invocation const *>
+InvocationGraph(std::vector<pbxbuild::Tool::Invocation> const &invocations)
 {
     std::unordered_map<std::string, pbxbuild::Tool::Invocation const *> outputToInvocation;
     std::set<uint32_t, std::less<uint32_t>> orderedPhasePriorities;
@@ -149,6 +323,14 @@ SortInvocations(std::vector<pbxbuild::Tool::Invocation> const &invocations)
         }
     }
 
+    return graph;
+}
+
+static ext::optional<std::vector<pbxbuild::Tool::Invocation>>
+SortInvocations(std::vector<pbxbuild::Tool::Invocation> const &invocations)
+{
+    pbxbuild::DirectedGraph<pbxbuild::Tool::Invocation const *> graph = InvocationGraph(invocations);
+
     std::vector<pbxbuild::Tool::Invocation> result;
 
     ext::optional<std::vector<pbxbuild::Tool::Invocation const *>> orderedInvocations = graph.ordered();
@@ -162,24 +344,35 @@ SortInvocations(std::vector<pbxbuild::Tool::Invocation> const &invocations)
     return result;
 }
 
+/*
+ * Create a directory for outputs. Targets building at the same time create
+ * the same directories, so finding one created by another target is fine.
+ */
+static bool
+CreateOutputDirectory(Filesystem *filesystem, std::string const &directory)
+{
+    return (filesystem->createDirectory(directory, true) || filesystem->type(directory) == Filesystem::Type::Directory);
+}
+
 bool SimpleExecutor::
 writeAuxiliaryFiles(
     Filesystem *filesystem,
-    std::vector<pbxbuild::Tool::AuxiliaryFile> const &auxiliaryFiles)
+    std::vector<pbxbuild::Tool::AuxiliaryFile> const &auxiliaryFiles,
+    std::string *output)
 {
     for (pbxbuild::Tool::AuxiliaryFile const &auxiliaryFile : auxiliaryFiles) {
         std::string directory = FSUtil::GetDirectoryName(auxiliaryFile.path());
         if (filesystem->type(directory) != Filesystem::Type::Directory) {
-            xcformatter::Formatter::Print(_formatter->createAuxiliaryDirectory(directory));
+            Print(output, _formatter->createAuxiliaryDirectory(directory));
 
             if (!_dryRun) {
-                if (!filesystem->createDirectory(directory, true)) {
+                if (!CreateOutputDirectory(filesystem, directory)) {
                     return false;
                 }
             }
         }
 
-        xcformatter::Formatter::Print(_formatter->writeAuxiliaryFile(auxiliaryFile.path()));
+        Print(output, _formatter->writeAuxiliaryFile(auxiliaryFile.path()));
 
         if (!_dryRun) {
             std::vector<uint8_t> data;
@@ -208,7 +401,7 @@ writeAuxiliaryFiles(
         }
 
         if (auxiliaryFile.executable() && !filesystem->isExecutable(auxiliaryFile.path())) {
-            xcformatter::Formatter::Print(_formatter->setAuxiliaryExecutable(auxiliaryFile.path()));
+            Print(output, _formatter->setAuxiliaryExecutable(auxiliaryFile.path()));
 
             if (!_dryRun) {
                 Permissions permissions = Permissions(
@@ -225,6 +418,28 @@ writeAuxiliaryFiles(
     return true;
 }
 
+namespace {
+
+/*
+ * The result of an invocation run on a worker thread or as a process. The
+ * output is captured so it can be printed along with the invocation once
+ * finished.
+ */
+struct InvocationResult {
+    size_t      index;
+    std::string executable;
+    std::string output;
+    bool        success;
+};
+
+/*
+ * How often to check for finished builtin tools, in milliseconds, while
+ * also waiting for processes.
+ */
+static int const BuiltinPollInterval = 10;
+
+}
+
 std::pair<bool, std::vector<pbxbuild::Tool::Invocation>> SimpleExecutor::
 performInvocations(
     process::Context const *processContext,
@@ -232,48 +447,137 @@ performInvocations(
     Filesystem *filesystem,
     std::vector<std::string> const &executablePaths,
     std::vector<pbxbuild::Tool::Invocation> const &orderedInvocations,
-    bool createProductStructure)
+    bool createProductStructure,
+    BuildLog *buildLog,
+    std::string *output)
 {
+    /*
+     * Track the invocations each invocation is waiting on. An invocation is
+     * ready once every invocation producing one of its inputs has finished.
+     */
+    pbxbuild::DirectedGraph<pbxbuild::Tool::Invocation const *> graph = InvocationGraph(orderedInvocations);
+
+    std::vector<pbxbuild::Tool::Invocation const *> invocationPointers;
     for (pbxbuild::Tool::Invocation const &invocation : orderedInvocations) {
-        // TODO(grp): This should perhaps be a separate flag for a 'phony' invocation.
-        if (!invocation.executable()) {
-            continue;
+        invocationPointers.push_back(&invocation);
+    }
+
+    std::vector<size_t> waiting;
+    std::vector<std::vector<size_t>> dependents;
+    GraphDependents(graph, invocationPointers, &waiting, &dependents);
+
+    /* Ready invocations start in sorted order, so a single job runs in sequence. */
+    std::set<size_t> ready;
+    for (size_t i = 0; i < orderedInvocations.size(); ++i) {
+        if (waiting[i] == 0) {
+            ready.insert(i);
         }
-        pbxbuild::Tool::Invocation::Executable const &executable = *invocation.executable();
+    }
 
-        if (invocation.createsProductStructure() != createProductStructure) {
-            continue;
+    size_t completed = 0;
+    auto complete = [&](size_t index) {
+        completed++;
+        for (size_t dependent : dependents[index]) {
+            if (--waiting[dependent] == 0) {
+                ready.insert(dependent);
+            }
         }
+    };
 
-        if (!_dryRun) {
-            bool success = true;
+    /*
+     * When running more than one job, builtin tools run on the shared job
+     * threads and external tools are started and waited for on this thread,
+     * all with their output captured. All output stays on this thread.
+     */
+    libutil::ThreadPool *pool = (!_dryRun ? _jobPool.get() : nullptr);
+
+    std::mutex finishedMutex;
+    std::condition_variable finishedCondition;
+    std::deque<InvocationResult> finished;
+    size_t running = 0;
+
+    std::map<process::Launcher::Handle, InvocationResult> processes;
 
+    std::vector<pbxbuild::Tool::Invocation> failures;
+
+    /* Hashed before each invocation runs, in case its inputs change while it runs. */
+    std::vector<ext::optional<std::string>> declaredInputs = std::vector<ext::optional<std::string>>(orderedInvocations.size());
+
+    auto finish = [&](size_t index, bool success) {
+        pbxbuild::Tool::Invocation const &invocation = orderedInvocations[index];
+        if (buildLog != nullptr) {
+            buildLog->record(filesystem, invocation, declaredInputs[index], success);
+        }
+
+        if (success) {
+            complete(index);
+        } else {
+            failures.push_back(invocation);
+        }
+    };
+
+    while (true) {
+        /* Start ready invocations until out of jobs. Stop starting work after any failure. */
+        while (failures.empty() && !ready.empty() && running + processes.size() < _jobs) {
+            size_t index = *ready.begin();
+            ready.erase(ready.begin());
+
+            pbxbuild::Tool::Invocation const &invocation = orderedInvocations[index];
+
+            // TODO(grp): This should perhaps be a separate flag for a 'phony' invocation.
+            if (!invocation.executable() || invocation.createsProductStructure() != createProductStructure || _dryRun) {
+                complete(index);
+                continue;
+            }
+            pbxbuild::Tool::Invocation::Executable const &executable = *invocation.executable();
+
+            /* Skip invocations with outputs already matching their inputs. */
+            if (buildLog != nullptr && buildLog->upToDate(filesystem, invocation)) {
+                complete(index);
+                continue;
+            }
+
+            if (buildLog != nullptr) {
+                declaredInputs[index] = buildLog->declaredInputsHash(filesystem, invocation);
+            }
+
+            bool directories = true;
             for (std::string const &output : invocation.outputs()) {
                 std::string directory = FSUtil::GetDirectoryName(output);
 
-                if (!filesystem->createDirectory(directory, true)) {
-                    return std::make_pair(false, std::vector<pbxbuild::Tool::Invocation>({ invocation }));
+                if (!CreateOutputDirectory(filesystem, directory)) {
+                    directories = false;
+                    break;
                 }
             }
+            if (!directories) {
+                failures.push_back(invocation);
+                continue;
+            }
+
+            /* The tool to run, and how to run it with its output captured or not. */
+            std::string name;
+            std::function<bool(std::string *)> run;
 
             if (ext::optional<std::string> const &builtin = executable.builtin()) {
                 /* Builtin tool, find and run in-process. */
-                if (std::shared_ptr<builtin::Driver> driver = _builtins.driver(*builtin)) {
-                    xcformatter::Formatter::Print(_formatter->beginInvocation(invocation, *builtin, createProductStructure));
-
-                    process::MemoryContext context = process::MemoryContext(
-                        *builtin,
-                        invocation.workingDirectory(),
-                        invocation.arguments(),
-                        invocation.environment());
-                    int exitCode = driver->run(&context, filesystem);
-                    success = (exitCode == 0);
-
-                    xcformatter::Formatter::Print(_formatter->finishInvocation(invocation, *builtin, createProductStructure));
-                } else {
+                std::shared_ptr<builtin::Driver> driver = _builtins.driver(*builtin);
+                if (driver == nullptr) {
                     /* Failed to find builtin tool. */
-                    return std::make_pair(false, std::vector<pbxbuild::Tool::Invocation>({ invocation }));
+                    failures.push_back(invocation);
+                    continue;
                 }
+
+                auto context = std::make_shared<process::MemoryContext>(
+                    *builtin,
+                    invocation.workingDirectory(),
+                    invocation.arguments(),
+                    invocation.environment());
+
+                name = *builtin;
+                run = [driver, context, filesystem](std::string *output) -> bool {
+                    return driver->run(context.get(), filesystem, output) == 0;
+                };
             } else if (ext::optional<std::string> const &external = executable.external()) {
                 /* External tool, find on the filesystem. */
                 ext::optional<std::string> path;
@@ -285,34 +589,135 @@ performInvocations(
                     path = filesystem->findExecutable(*external, executablePaths);
                 }
 
-                if (path) {
-                    xcformatter::Formatter::Print(_formatter->beginInvocation(invocation, *path, createProductStructure));
+                if (!path) {
+                    /* Failed to find executable. */
+                    failures.push_back(invocation);
+                    continue;
+                }
 
-                    /* Create the execution environment from the process and invocation environments, preferring the invocation. */
-                    std::unordered_map<std::string, std::string> environment = invocation.environment();
-                    environment.insert(processContext->environmentVariables().begin(), processContext->environmentVariables().end());
+                /* Create the execution environment from the process and invocation environments, preferring the invocation. */
+                std::unordered_map<std::string, std::string> environment = invocation.environment();
+                environment.insert(processContext->environmentVariables().begin(), processContext->environmentVariables().end());
 
-                    process::MemoryContext context = process::MemoryContext(
-                        *path,
-                        invocation.workingDirectory(),
-                        invocation.arguments(),
-                        environment);
-                    ext::optional<int> exitCode = processLauncher->launch(filesystem, &context);
-                    success = (exitCode && *exitCode == 0);
+                auto context = std::make_shared<process::MemoryContext>(
+                    *path,
+                    invocation.workingDirectory(),
+                    invocation.arguments(),
+                    environment);
 
-                    xcformatter::Formatter::Print(_formatter->finishInvocation(invocation, *path, createProductStructure));
-                } else {
-                    /* Failed to find executable. */
-                    return std::make_pair(false, std::vector<pbxbuild::Tool::Invocation>({ invocation }));
+                name = *path;
+
+                if (pool != nullptr) {
+                    /* Wait for the process along with the others rather than on a job thread. */
+                    ext::optional<process::Launcher::Handle> handle = processLauncher->start(filesystem, context.get());
+                    if (!handle) {
+                        Print(output,
+                            _formatter->beginInvocation(invocation, name, createProductStructure) +
+                            _formatter->finishInvocation(invocation, name, createProductStructure));
+
+                        finish(index, false);
+                        continue;
+                    }
+
+                    InvocationResult result;
+                    result.index = index;
+                    result.executable = name;
+                    processes.insert({ *handle, result });
+                    continue;
                 }
+
+                run = [processLauncher, context, filesystem](std::string *output) -> bool {
+                    ext::optional<int> exitCode = processLauncher->launch(filesystem, context.get(), output);
+                    return (exitCode && *exitCode == 0);
+                };
             } else {
                 abort();
             }
 
-            if (!success) {
-                return std::make_pair(false, std::vector<pbxbuild::Tool::Invocation>({ invocation }));
+            if (pool == nullptr) {
+                Print(output, _formatter->beginInvocation(invocation, name, createProductStructure));
+                bool success = run(output);
+                Print(output, _formatter->finishInvocation(invocation, name, createProductStructure));
+
+                finish(index, success);
+            } else {
+                running++;
+                pool->dispatch([=, &finishedMutex, &finishedCondition, &finished] {
+                    InvocationResult result;
+                    result.index = index;
+                    result.executable = name;
+                    result.success = run(&result.output);
+
+                    std::unique_lock<std::mutex> lock(finishedMutex);
+                    finished.push_back(result);
+                    finishedCondition.notify_one();
+                });
             }
         }
+
+        if (running == 0 && processes.empty()) {
+            break;
+        }
+
+        /*
+         * Wait for any running invocation to finish, then print it all at once.
+         * While both builtins and processes are running, check each in turn.
+         */
+        ext::optional<InvocationResult> result;
+        while (!result) {
+            if (!processes.empty()) {
+                ext::optional<process::Launcher::Result> exited = processLauncher->wait(running == 0);
+                if (exited) {
+                    auto it = processes.find(exited->handle());
+                    result = it->second;
+                    processes.erase(it);
+
+                    /* Standard error follows standard output, as they are captured separately. */
+                    result->output = exited->standardOutput() + exited->standardError();
+                    result->success = (exited->exitCode() && *exited->exitCode() == 0);
+                    break;
+                } else if (running == 0) {
+                    /* Couldn't wait for the processes; they can't succeed. */
+                    result = processes.begin()->second;
+                    result->success = false;
+                    processes.erase(processes.begin());
+                    break;
+                }
+            }
+
+            if (running != 0) {
+                auto available = [&finished] { return !finished.empty(); };
+
+                std::unique_lock<std::mutex> lock(finishedMutex);
+                if (processes.empty()) {
+                    finishedCondition.wait(lock, available);
+                } else if (!finishedCondition.wait_for(lock, std::chrono::milliseconds(BuiltinPollInterval), available)) {
+                    continue;
+                }
+
+                result = finished.front();
+                finished.pop_front();
+                running--;
+            }
+        }
+
+        /* Print as one string so output from other targets can't interleave. */
+        pbxbuild::Tool::Invocation const &invocation = orderedInvocations[result->index];
+        Print(output,
+            _formatter->beginInvocation(invocation, result->executable, createProductStructure) +
+            result->output +
+            _formatter->finishInvocation(invocation, result->executable, createProductStructure));
+
+        finish(result->index, result->success);
+    }
+
+    if (!failures.empty()) {
+        return std::make_pair(false, failures);
+    }
+
+    if (completed != orderedInvocations.size()) {
+        fprintf(stderr, "error: cycle detected building invocation graph\n");
+        return std::make_pair(false, std::vector<pbxbuild::Tool::Invocation>());
     }
 
     return std::make_pair(true, std::vector<pbxbuild::Tool::Invocation>());
@@ -326,11 +731,13 @@ buildTarget(
     pbxproj::PBX::Target::shared_ptr const &target,
     pbxbuild::Target::Environment const &targetEnvironment,
     std::vector<pbxbuild::Tool::AuxiliaryFile> const &auxiliaryFiles,
-    std::vector<pbxbuild::Tool::Invocation> const &invocations)
+    std::vector<pbxbuild::Tool::Invocation> const &invocations,
+    BuildLog *buildLog,
+    std::string *output)
 {
-    xcformatter::Formatter::Print(_formatter->beginWriteAuxiliaryFiles(target));
-    bool auxiliaryFilesSuccess = this->writeAuxiliaryFiles(filesystem, auxiliaryFiles);
-    xcformatter::Formatter::Print(_formatter->finishWriteAuxiliaryFiles(target));
+    Print(output, _formatter->beginWriteAuxiliaryFiles(target));
+    bool auxiliaryFilesSuccess = this->writeAuxiliaryFiles(filesystem, auxiliaryFiles, output);
+    Print(output, _formatter->finishWriteAuxiliaryFiles(target));
     if (!auxiliaryFilesSuccess) {
         return std::make_pair(false, std::vector<pbxbuild::Tool::Invocation>());
     }
@@ -341,14 +748,14 @@ buildTarget(
         return std::make_pair(false, std::vector<pbxbuild::Tool::Invocation>());
     }
 
-    xcformatter::Formatter::Print(_formatter->beginCreateProductStructure(target));
-    std::pair<bool, std::vector<pbxbuild::Tool::Invocation>> structureResult = performInvocations(processContext, processLauncher, filesystem, targetEnvironment.executablePaths(), *orderedInvocations, true);
-    xcformatter::Formatter::Print(_formatter->finishCreateProductStructure(target));
+    Print(output, _formatter->beginCreateProductStructure(target));
+    std::pair<bool, std::vector<pbxbuild::Tool::Invocation>> structureResult = performInvocations(processContext, processLauncher, filesystem, targetEnvironment.executablePaths(), *orderedInvocations, true, buildLog, output);
+    Print(output, _formatter->finishCreateProductStructure(target));
     if (!structureResult.first) {
         return structureResult;
     }
 
-    std::pair<bool, std::vector<pbxbuild::Tool::Invocation>> invocationsResult = performInvocations(processContext, processLauncher, filesystem, targetEnvironment.executablePaths(), *orderedInvocations, false);
+    std::pair<bool, std::vector<pbxbuild::Tool::Invocation>> invocationsResult = performInvocations(processContext, processLauncher, filesystem, targetEnvironment.executablePaths(), *orderedInvocations, false, buildLog, output);
     if (!invocationsResult.first) {
         return invocationsResult;
     }
@@ -357,11 +764,13 @@ buildTarget(
 }
 
 std::unique_ptr<SimpleExecutor> SimpleExecutor::
-Create(std::shared_ptr<xcformatter::Formatter> const &formatter, bool dryRun, builtin::Registry const &builtins)
+Create(std::shared_ptr<xcformatter::Formatter> const &formatter, bool dryRun, size_t jobs, bool parallelizeTargets, builtin::Registry const &builtins)
 {
     return std::unique_ptr<SimpleExecutor>(new SimpleExecutor(
         formatter,
         dryRun,
+        jobs,
+        parallelizeTargets,
         builtins
     ));
 }
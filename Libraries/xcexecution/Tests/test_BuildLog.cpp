@@ -0,0 +1,129 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+#include <xcexecution/BuildLog.h>
+#include <pbxbuild/Tool/Invocation.h>
+#include <libutil/MemoryFilesystem.h>
+
+using xcexecution::BuildLog;
+using libutil::MemoryFilesystem;
+
+static std::vector<uint8_t>
+Contents(std::string const &string)
+{
+    return std::vector<uint8_t>(string.begin(), string.end());
+}
+
+static pbxbuild::Tool::Invocation
+CreateInvocation(MemoryFilesystem const &filesystem)
+{
+    pbxbuild::Tool::Invocation invocation;
+    invocation.executable() = pbxbuild::Tool::Invocation::Executable::External("tool");
+    invocation.arguments() = { "-o", filesystem.path("output") };
+    invocation.inputs() = { filesystem.path("input") };
+    invocation.outputs() = { filesystem.path("output") };
+    return invocation;
+}
+
+TEST(BuildLog, UpToDate)
+{
+    auto filesystem = MemoryFilesystem({
+        MemoryFilesystem::Entry::File("input", Contents("input")),
+        MemoryFilesystem::Entry::File("output", Contents("output")),
+    });
+    pbxbuild::Tool::Invocation invocation = CreateInvocation(filesystem);
+
+    /* Nothing is up to date before it has run. */
+    BuildLog buildLog(filesystem.path("log"));
+    EXPECT_FALSE(buildLog.upToDate(&filesystem, invocation));
+
+    buildLog.record(&filesystem, invocation, buildLog.declaredInputsHash(&filesystem, invocation), true);
+    EXPECT_TRUE(buildLog.upToDate(&filesystem, invocation));
+
+    /* Failed invocations need to run again. */
+    buildLog.record(&filesystem, invocation, buildLog.declaredInputsHash(&filesystem, invocation), false);
+    EXPECT_FALSE(buildLog.upToDate(&filesystem, invocation));
+}
+
+TEST(BuildLog, Changes)
+{
+    auto filesystem = MemoryFilesystem({
+        MemoryFilesystem::Entry::File("input", Contents("input")),
+        MemoryFilesystem::Entry::File("output", Contents("output")),
+    });
+    pbxbuild::Tool::Invocation invocation = CreateInvocation(filesystem);
+
+    BuildLog buildLog(filesystem.path("log"));
+    buildLog.record(&filesystem, invocation, buildLog.declaredInputsHash(&filesystem, invocation), true);
+    EXPECT_TRUE(buildLog.upToDate(&filesystem, invocation));
+
+    /* Different arguments are a different command. */
+    pbxbuild::Tool::Invocation changed = invocation;
+    changed.arguments().push_back("-v");
+    EXPECT_FALSE(buildLog.upToDate(&filesystem, changed));
+
+    /* Missing outputs need to be created again. */
+    ASSERT_TRUE(filesystem.removeFile(filesystem.path("output")));
+    EXPECT_FALSE(buildLog.upToDate(&filesystem, invocation));
+    ASSERT_TRUE(filesystem.write(Contents("output"), filesystem.path("output")));
+    buildLog.record(&filesystem, invocation, buildLog.declaredInputsHash(&filesystem, invocation), true);
+    EXPECT_TRUE(buildLog.upToDate(&filesystem, invocation));
+
+    /* Input contents are hashed once per build, so use a new log to see changes. */
+    ASSERT_TRUE(filesystem.write(Contents("changed"), filesystem.path("input")));
+    ASSERT_TRUE(buildLog.write(&filesystem));
+    std::unique_ptr<BuildLog> loaded = BuildLog::Open(&filesystem, filesystem.path("log"));
+    ASSERT_NE(nullptr, loaded);
+    EXPECT_FALSE(loaded->upToDate(&filesystem, invocation));
+}
+
+TEST(BuildLog, ChangedWhileRunning)
+{
+    auto filesystem = MemoryFilesystem({
+        MemoryFilesystem::Entry::File("input", Contents("input")),
+        MemoryFilesystem::Entry::File("output", Contents("output")),
+    });
+    pbxbuild::Tool::Invocation invocation = CreateInvocation(filesystem);
+
+    /* Hashed before running, then the input is edited while the invocation runs. */
+    BuildLog buildLog(filesystem.path("log"));
+    ext::optional<std::string> declaredInputs = buildLog.declaredInputsHash(&filesystem, invocation);
+    ASSERT_TRUE(declaredInputs);
+    ASSERT_TRUE(filesystem.write(Contents("edited"), filesystem.path("input")));
+    buildLog.record(&filesystem, invocation, declaredInputs, true);
+    ASSERT_TRUE(buildLog.write(&filesystem));
+
+    /* The output was built from the old contents, so it needs to be built again. */
+    std::unique_ptr<BuildLog> loaded = BuildLog::Open(&filesystem, filesystem.path("log"));
+    ASSERT_NE(nullptr, loaded);
+    EXPECT_FALSE(loaded->upToDate(&filesystem, invocation));
+}
+
+TEST(BuildLog, WriteOpen)
+{
+    auto filesystem = MemoryFilesystem({
+        MemoryFilesystem::Entry::File("input", Contents("input")),
+        MemoryFilesystem::Entry::File("output", Contents("output")),
+    });
+    pbxbuild::Tool::Invocation invocation = CreateInvocation(filesystem);
+
+    BuildLog buildLog(filesystem.path("dir/log"));
+    buildLog.record(&filesystem, invocation, buildLog.declaredInputsHash(&filesystem, invocation), true);
+    ASSERT_TRUE(buildLog.write(&filesystem));
+
+    std::unique_ptr<BuildLog> loaded = BuildLog::Open(&filesystem, filesystem.path("dir/log"));
+    ASSERT_NE(nullptr, loaded);
+    EXPECT_TRUE(loaded->upToDate(&filesystem, invocation));
+
+    /* Invalid logs are ignored. */
+    ASSERT_TRUE(filesystem.write(Contents("invalid"), filesystem.path("dir/log")));
+    loaded = BuildLog::Open(&filesystem, filesystem.path("dir/log"));
+    ASSERT_NE(nullptr, loaded);
+    EXPECT_FALSE(loaded->upToDate(&filesystem, invocation));
+}
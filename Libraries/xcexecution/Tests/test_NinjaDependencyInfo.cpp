@@ -0,0 +1,163 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+#include <xcexecution/NinjaDependencyInfo.h>
+#include <pbxbuild/Tool/Invocation.h>
+#include <libutil/DefaultFilesystem.h>
+#include <libutil/MemoryFilesystem.h>
+
+#if !_WIN32
+#include <cstdlib>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+using xcexecution::NinjaDependencyInfo;
+using libutil::DefaultFilesystem;
+using libutil::MemoryFilesystem;
+
+static std::vector<uint8_t>
+Contents(std::string const &string)
+{
+    return std::vector<uint8_t>(string.begin(), string.end());
+}
+
+static std::string
+String(std::vector<uint8_t> const &contents)
+{
+    return std::string(contents.begin(), contents.end());
+}
+
+static pbxbuild::Tool::Invocation
+CreateInvocation(std::string const &workingDirectory, dependency::DependencyInfoFormat format, std::string const &path)
+{
+    pbxbuild::Tool::Invocation invocation;
+    invocation.executable() = pbxbuild::Tool::Invocation::Executable::External("tool");
+    invocation.workingDirectory() = workingDirectory;
+    invocation.dependencyInfo() = { pbxbuild::Tool::Invocation::DependencyInfo(format, path) };
+    return invocation;
+}
+
+TEST(NinjaDependencyInfo, Native)
+{
+    /* Wherever the invocation runs. */
+    pbxbuild::Tool::Invocation invocation = CreateInvocation("/objroot", dependency::DependencyInfoFormat::Makefile, "/objroot/file.d");
+    EXPECT_TRUE(NinjaDependencyInfo::Native(invocation));
+    invocation = CreateInvocation("/source", dependency::DependencyInfoFormat::Makefile, "/objroot/file.d");
+    EXPECT_TRUE(NinjaDependencyInfo::Native(invocation));
+
+    /* Other formats need to be converted. */
+    invocation = CreateInvocation("/objroot", dependency::DependencyInfoFormat::Binary, "/objroot/file.dat");
+    EXPECT_FALSE(NinjaDependencyInfo::Native(invocation));
+
+    /* Several dependency info need to be combined. */
+    invocation = CreateInvocation("/objroot", dependency::DependencyInfoFormat::Makefile, "/objroot/file.d");
+    invocation.dependencyInfo().push_back(pbxbuild::Tool::Invocation::DependencyInfo(dependency::DependencyInfoFormat::Makefile, "/objroot/other.d"));
+    EXPECT_FALSE(NinjaDependencyInfo::Native(invocation));
+}
+
+TEST(NinjaDependencyInfo, Conversion)
+{
+    pbxbuild::Tool::Invocation invocation = CreateInvocation("/source", dependency::DependencyInfoFormat::Makefile, "/objroot/file.d");
+
+    std::string conversions;
+    EXPECT_TRUE(NinjaDependencyInfo::Conversion(invocation, "/objroot/file.o", "/objroot/file.ninja.d", &conversions));
+    EXPECT_EQ("/objroot/file.o\t/objroot/file.ninja.d\t/source\tmakefile:/objroot/file.d\n", conversions);
+
+    /* Paths that can't be stored are skipped. */
+    invocation.workingDirectory() = "/so\turce";
+    EXPECT_TRUE(NinjaDependencyInfo::Conversion(invocation, "/objroot/other.o", "/objroot/other.ninja.d", &conversions));
+    EXPECT_EQ("/objroot/file.o\t/objroot/file.ninja.d\t/source\tmakefile:/objroot/file.d\n", conversions);
+}
+
+TEST(NinjaDependencyInfo, Convert)
+{
+    auto filesystem = MemoryFilesystem({
+        MemoryFilesystem::Entry::Directory("objroot", {
+            MemoryFilesystem::Entry::File("file.d", Contents("file.o: input.c ../include/input.h /absolute.h\n")),
+        }),
+        MemoryFilesystem::Entry::Directory("source", { }),
+    });
+
+    pbxbuild::Tool::Invocation invocation = CreateInvocation(filesystem.path("source"), dependency::DependencyInfoFormat::Makefile, filesystem.path("objroot/file.d"));
+
+    std::string conversions;
+    ASSERT_TRUE(NinjaDependencyInfo::Conversion(invocation, filesystem.path("objroot/file.o"), filesystem.path("objroot/file.ninja.d"), &conversions));
+    ASSERT_TRUE(filesystem.write(Contents(conversions), filesystem.path("objroot/conversions")));
+
+    /* Relative inputs are resolved against the invocation's directory. */
+    EXPECT_TRUE(NinjaDependencyInfo::Convert(&filesystem, filesystem.path("objroot/conversions")));
+    std::vector<uint8_t> contents;
+    ASSERT_TRUE(filesystem.read(&contents, filesystem.path("objroot/file.ninja.d")));
+    std::string depfile = String(contents);
+    EXPECT_NE(std::string::npos, depfile.find(filesystem.path("source/input.c")));
+    EXPECT_NE(std::string::npos, depfile.find(filesystem.path("include/input.h")));
+    EXPECT_NE(std::string::npos, depfile.find("/absolute.h"));
+}
+
+TEST(NinjaDependencyInfo, ConvertMissing)
+{
+    auto filesystem = MemoryFilesystem({
+        MemoryFilesystem::Entry::Directory("objroot", { }),
+    });
+
+    /* Nothing to convert. */
+    EXPECT_TRUE(NinjaDependencyInfo::Convert(&filesystem, filesystem.path("objroot/conversions")));
+
+    /* The invocation hasn't run, so there should be no depfile for Ninja to trust. */
+    pbxbuild::Tool::Invocation invocation = CreateInvocation(filesystem.path("objroot"), dependency::DependencyInfoFormat::Makefile, filesystem.path("objroot/file.d"));
+    std::string conversions;
+    ASSERT_TRUE(NinjaDependencyInfo::Conversion(invocation, filesystem.path("objroot/file.o"), filesystem.path("objroot/file.ninja.d"), &conversions));
+    ASSERT_TRUE(filesystem.write(Contents(conversions), filesystem.path("objroot/conversions")));
+
+    EXPECT_TRUE(NinjaDependencyInfo::Convert(&filesystem, filesystem.path("objroot/conversions")));
+    EXPECT_FALSE(filesystem.exists(filesystem.path("objroot/file.ninja.d")));
+}
+
+#if !_WIN32
+static bool
+SetModificationTime(std::string const &path, time_t seconds)
+{
+    struct timeval times[2] = { { seconds, 0 }, { seconds, 0 } };
+    return ::utimes(path.c_str(), times) == 0;
+}
+
+TEST(NinjaDependencyInfo, ConvertUnmodified)
+{
+    char temporary[] = "/tmp/xcexecution-test-XXXXXX";
+    ASSERT_NE(nullptr, ::mkdtemp(temporary));
+    std::string directory = temporary;
+
+    DefaultFilesystem filesystem;
+    ASSERT_TRUE(filesystem.write(Contents("file.o: /input.c\n"), directory + "/file.d"));
+
+    pbxbuild::Tool::Invocation invocation = CreateInvocation(directory, dependency::DependencyInfoFormat::Makefile, directory + "/file.d");
+    std::string conversions;
+    ASSERT_TRUE(NinjaDependencyInfo::Conversion(invocation, directory + "/file.o", directory + "/file.ninja.d", &conversions));
+    ASSERT_TRUE(filesystem.write(Contents(conversions), directory + "/conversions"));
+
+    /* Dependency info older than its depfile isn't read again. */
+    ASSERT_TRUE(filesystem.write(Contents("stale"), directory + "/file.ninja.d"));
+    ASSERT_TRUE(SetModificationTime(directory + "/file.d", 1000));
+    ASSERT_TRUE(SetModificationTime(directory + "/file.ninja.d", 2000));
+    EXPECT_TRUE(NinjaDependencyInfo::Convert(&filesystem, directory + "/conversions"));
+
+    std::vector<uint8_t> contents;
+    ASSERT_TRUE(filesystem.read(&contents, directory + "/file.ninja.d"));
+    EXPECT_EQ("stale", String(contents));
+
+    /* Once it's modified, it's converted. */
+    ASSERT_TRUE(SetModificationTime(directory + "/file.d", 3000));
+    EXPECT_TRUE(NinjaDependencyInfo::Convert(&filesystem, directory + "/conversions"));
+    ASSERT_TRUE(filesystem.read(&contents, directory + "/file.ninja.d"));
+    EXPECT_NE(std::string::npos, String(contents).find("/input.c"));
+
+    EXPECT_TRUE(filesystem.removeDirectory(directory, true));
+}
+#endif
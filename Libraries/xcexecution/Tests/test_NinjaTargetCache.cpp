@@ -0,0 +1,95 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+#include <xcexecution/NinjaTargetCache.h>
+#include <pbxspec/Manager.h>
+#include <libutil/MemoryFilesystem.h>
+
+using xcexecution::NinjaTargetCache;
+using libutil::MemoryFilesystem;
+
+static std::vector<uint8_t>
+Contents(std::string const &string)
+{
+    return std::vector<uint8_t>(string.begin(), string.end());
+}
+
+TEST(NinjaTargetCache, SpecificationsFingerprint)
+{
+    auto filesystem = MemoryFilesystem({
+        MemoryFilesystem::Entry::Directory("specifications", {
+            MemoryFilesystem::Entry::File("Tool.xcspec", Contents("( )")),
+        }),
+        MemoryFilesystem::Entry::File("rules.plist", Contents("( )")),
+    });
+
+    auto specManager = pbxspec::Manager::Create();
+    specManager->registerDomains(&filesystem, { { "default", filesystem.path("specifications") } });
+    specManager->registerBuildRules(&filesystem, filesystem.path("rules.plist"));
+
+    std::string fingerprint = NinjaTargetCache::SpecificationsFingerprint(&filesystem, *specManager);
+    EXPECT_EQ(fingerprint, NinjaTargetCache::SpecificationsFingerprint(&filesystem, *specManager));
+
+    /* Changing a specification changes the fingerprint. */
+    ASSERT_TRUE(filesystem.write(Contents("( { Identifier = tool; Type = Tool; } )"), filesystem.path("specifications/Tool.xcspec")));
+    std::string changed = NinjaTargetCache::SpecificationsFingerprint(&filesystem, *specManager);
+    EXPECT_NE(fingerprint, changed);
+
+    /* So do build rules. */
+    ASSERT_TRUE(filesystem.write(Contents("( { } )"), filesystem.path("rules.plist")));
+    EXPECT_NE(changed, NinjaTargetCache::SpecificationsFingerprint(&filesystem, *specManager));
+
+    /* And removing a specification. */
+    ASSERT_TRUE(filesystem.removeFile(filesystem.path("specifications/Tool.xcspec")));
+    EXPECT_NE(changed, NinjaTargetCache::SpecificationsFingerprint(&filesystem, *specManager));
+}
+
+TEST(NinjaTargetCache, Reuse)
+{
+    auto filesystem = MemoryFilesystem({
+        MemoryFilesystem::Entry::File("target.ninja", Contents("build")),
+    });
+
+    std::string path = filesystem.path("cache");
+    std::string targetNinja;
+    std::string dependencyInfoConversions;
+
+    /* Nothing to reuse before it's written. */
+    EXPECT_FALSE(NinjaTargetCache::Load(&filesystem, path, "fingerprint", &targetNinja, &dependencyInfoConversions));
+
+    ASSERT_TRUE(NinjaTargetCache::Write(&filesystem, path, "fingerprint", filesystem.path("target.ninja"), "subninja target.ninja\n", "output\tdepfile\n"));
+    EXPECT_TRUE(NinjaTargetCache::Load(&filesystem, path, "fingerprint", &targetNinja, &dependencyInfoConversions));
+    EXPECT_EQ("subninja target.ninja\n", targetNinja);
+    EXPECT_EQ("output\tdepfile\n", dependencyInfoConversions);
+}
+
+TEST(NinjaTargetCache, Invalidate)
+{
+    auto filesystem = MemoryFilesystem({
+        MemoryFilesystem::Entry::File("target.ninja", Contents("build")),
+    });
+
+    std::string path = filesystem.path("cache");
+    std::string targetNinja;
+    std::string dependencyInfoConversions;
+    ASSERT_TRUE(NinjaTargetCache::Write(&filesystem, path, "fingerprint", filesystem.path("target.ninja"), "subninja target.ninja\n", ""));
+
+    /* A changed fingerprint, including a prefix of the original, isn't reused. */
+    EXPECT_FALSE(NinjaTargetCache::Load(&filesystem, path, "other", &targetNinja, &dependencyInfoConversions));
+    EXPECT_FALSE(NinjaTargetCache::Load(&filesystem, path, "finger", &targetNinja, &dependencyInfoConversions));
+
+    /* Truncated caches aren't reused. */
+    ASSERT_TRUE(filesystem.write(Contents("fingerprint\n" + filesystem.path("target.ninja") + "\n100\nsubninja"), path));
+    EXPECT_FALSE(NinjaTargetCache::Load(&filesystem, path, "fingerprint", &targetNinja, &dependencyInfoConversions));
+
+    /* Nor if the target's Ninja is gone. */
+    ASSERT_TRUE(NinjaTargetCache::Write(&filesystem, path, "fingerprint", filesystem.path("target.ninja"), "subninja target.ninja\n", ""));
+    ASSERT_TRUE(filesystem.removeFile(filesystem.path("target.ninja")));
+    EXPECT_FALSE(NinjaTargetCache::Load(&filesystem, path, "fingerprint", &targetNinja, &dependencyInfoConversions));
+}
@@ -16,6 +16,8 @@
 #include <process/MemoryLauncher.h>
 #include <libutil/MemoryFilesystem.h>
 
+#include <mutex>
+
 using xcexecution::SimpleExecutor;
 using libutil::Filesystem;
 using libutil::MemoryFilesystem;
@@ -40,7 +42,7 @@ public:
     { return _name; }
 
 public:
-    virtual int run(process::Context const *processContext, Filesystem *filesystem)
+    virtual int run(process::Context const *processContext, Filesystem *filesystem, builtin::Driver::Output const &output)
     { return _impl(processContext, filesystem); }
 };
 
@@ -90,7 +92,7 @@ TEST(SimpleExecutor, PropagateToolResult)
     /* Create test executor. */
     auto formatter = xcformatter::NullFormatter::Create();
     std::vector<std::string> const executablePaths = { filesystem.path("") };
-    SimpleExecutor executor = SimpleExecutor(formatter, false, registry);
+    SimpleExecutor executor = SimpleExecutor(formatter, false, 1, false, registry);
 
     /* Succeed if all tools succeed. */
     auto success = executor.performInvocations(
@@ -102,7 +104,8 @@ TEST(SimpleExecutor, PropagateToolResult)
             builtinSuccess,
             externalSuccess,
         },
-        false);
+        false,
+        nullptr);
     ASSERT_TRUE(success.first);
     EXPECT_EQ(success.second.size(), 0);
 
@@ -117,7 +120,8 @@ TEST(SimpleExecutor, PropagateToolResult)
             builtinSuccess,
             externalSuccess,
         },
-        false);
+        false,
+        nullptr);
     ASSERT_FALSE(fail1.first);
     EXPECT_EQ(fail1.second.size(), 1);
 
@@ -133,8 +137,202 @@ TEST(SimpleExecutor, PropagateToolResult)
             externalSuccess,
             externalFail,
         },
-        false);
+        false,
+        nullptr);
     ASSERT_FALSE(fail2.first);
     EXPECT_EQ(fail2.second.size(), 1);
 }
 
+
+TEST(SimpleExecutor, ParallelDependencyOrder)
+{
+    /* Create in-memory execution environment. */
+    auto filesystem = MemoryFilesystem({
+        MemoryFilesystem::Entry::File("tool", std::vector<uint8_t>()),
+        MemoryFilesystem::Entry::File("fail-tool", std::vector<uint8_t>()),
+    });
+
+    std::mutex mutex;
+    std::vector<std::string> launched;
+    auto launcher = process::MemoryLauncher({
+        { filesystem.path("tool"), [&](Filesystem *filesystem, process::Context const *context) -> ext::optional<int> {
+            std::lock_guard<std::mutex> lock(mutex);
+            launched.push_back(context->commandLineArguments().front());
+            return 0;
+        } },
+        { filesystem.path("fail-tool"), [&](Filesystem *filesystem, process::Context const *context) -> ext::optional<int> {
+            std::lock_guard<std::mutex> lock(mutex);
+            launched.push_back(context->commandLineArguments().front());
+            return 1;
+        } },
+    });
+
+    auto context = process::MemoryContext(
+        "",
+        filesystem.path(""),
+        std::vector<std::string>(),
+        std::unordered_map<std::string, std::string>());
+
+    /* Create a chain of invocations: first -> second -> third. */
+    auto first = pbxbuild::Tool::Invocation();
+    first.executable() = pbxbuild::Tool::Invocation::Executable::External("tool");
+    first.arguments() = { "first" };
+    first.outputs() = { filesystem.path("first.o") };
+
+    auto second = pbxbuild::Tool::Invocation();
+    second.executable() = pbxbuild::Tool::Invocation::Executable::External("tool");
+    second.arguments() = { "second" };
+    second.inputs() = { filesystem.path("first.o") };
+    second.outputs() = { filesystem.path("second.o") };
+
+    auto third = pbxbuild::Tool::Invocation();
+    third.executable() = pbxbuild::Tool::Invocation::Executable::External("tool");
+    third.arguments() = { "third" };
+    third.phonyInputs() = { filesystem.path("second.o") };
+
+    /* Create test executor with several jobs. */
+    auto formatter = xcformatter::NullFormatter::Create();
+    auto registry = builtin::Registry::Create({ });
+    std::vector<std::string> const executablePaths = { filesystem.path("") };
+    SimpleExecutor executor = SimpleExecutor(formatter, false, 4, false, registry);
+
+    /* Dependent invocations run in order, regardless of the order passed in. */
+    auto success = executor.performInvocations(
+        &context,
+        &launcher,
+        &filesystem,
+        executablePaths,
+        { third, second, first },
+        false,
+        nullptr);
+    ASSERT_TRUE(success.first);
+    EXPECT_EQ(std::vector<std::string>({ "first", "second", "third" }), launched);
+
+    /* Invocations depending on a failed invocation are never started. */
+    launched.clear();
+    auto failing = first;
+    failing.executable() = pbxbuild::Tool::Invocation::Executable::External("fail-tool");
+    auto fail = executor.performInvocations(
+        &context,
+        &launcher,
+        &filesystem,
+        executablePaths,
+        { failing, second, third },
+        false,
+        nullptr);
+    ASSERT_FALSE(fail.first);
+    EXPECT_EQ(1, fail.second.size());
+    EXPECT_EQ(std::vector<std::string>({ "first" }), launched);
+}
+
+TEST(SimpleExecutor, ParallelBuiltins)
+{
+    auto filesystem = MemoryFilesystem({ });
+    auto launcher = process::MemoryLauncher({ });
+
+    std::mutex mutex;
+    std::vector<std::string> ran;
+    auto registry = builtin::Registry::Create({
+        std::static_pointer_cast<builtin::Driver>(std::make_shared<Driver>("builtin-record", [&](process::Context const *context, Filesystem *filesystem) -> int {
+            std::lock_guard<std::mutex> lock(mutex);
+            ran.push_back(context->commandLineArguments().front());
+            return 0;
+        })),
+    });
+
+    auto context = process::MemoryContext(
+        "",
+        filesystem.path(""),
+        std::vector<std::string>(),
+        std::unordered_map<std::string, std::string>());
+
+    /* Create a chain of builtin invocations: first -> second -> third. */
+    auto first = pbxbuild::Tool::Invocation();
+    first.executable() = pbxbuild::Tool::Invocation::Executable::Builtin("builtin-record");
+    first.arguments() = { "first" };
+    first.outputs() = { filesystem.path("first.plist") };
+
+    auto second = pbxbuild::Tool::Invocation();
+    second.executable() = pbxbuild::Tool::Invocation::Executable::Builtin("builtin-record");
+    second.arguments() = { "second" };
+    second.inputs() = { filesystem.path("first.plist") };
+    second.outputs() = { filesystem.path("second.plist") };
+
+    auto third = pbxbuild::Tool::Invocation();
+    third.executable() = pbxbuild::Tool::Invocation::Executable::Builtin("builtin-record");
+    third.arguments() = { "third" };
+    third.inputs() = { filesystem.path("second.plist") };
+
+    /* Builtin tools run on the job threads, but still in dependency order. */
+    auto formatter = xcformatter::NullFormatter::Create();
+    std::vector<std::string> const executablePaths = { filesystem.path("") };
+    SimpleExecutor executor = SimpleExecutor(formatter, false, 4, false, registry);
+
+    auto success = executor.performInvocations(
+        &context,
+        &launcher,
+        &filesystem,
+        executablePaths,
+        { third, second, first },
+        false,
+        nullptr);
+    ASSERT_TRUE(success.first);
+    EXPECT_EQ(std::vector<std::string>({ "first", "second", "third" }), ran);
+}
+
+class PrintDriver : public builtin::Driver {
+public:
+    virtual std::string name()
+    { return "builtin-print"; }
+
+public:
+    virtual int run(process::Context const *processContext, Filesystem *filesystem, builtin::Driver::Output const &output)
+    {
+        builtin::Driver::Print(output, stdout, "%s\n", processContext->commandLineArguments().front().c_str());
+        return 0;
+    }
+};
+
+TEST(SimpleExecutor, CollectOutput)
+{
+    auto filesystem = MemoryFilesystem({ });
+    auto launcher = process::MemoryLauncher({ });
+    auto registry = builtin::Registry::Create({
+        std::static_pointer_cast<builtin::Driver>(std::make_shared<PrintDriver>()),
+    });
+
+    auto context = process::MemoryContext(
+        "",
+        filesystem.path(""),
+        std::vector<std::string>(),
+        std::unordered_map<std::string, std::string>());
+
+    auto first = pbxbuild::Tool::Invocation();
+    first.executable() = pbxbuild::Tool::Invocation::Executable::Builtin("builtin-print");
+    first.arguments() = { "first" };
+    first.outputs() = { filesystem.path("first") };
+
+    auto second = pbxbuild::Tool::Invocation();
+    second.executable() = pbxbuild::Tool::Invocation::Executable::Builtin("builtin-print");
+    second.arguments() = { "second" };
+    second.inputs() = { filesystem.path("first") };
+
+    /* Output is collected to print later, both with and without job threads. */
+    auto formatter = xcformatter::NullFormatter::Create();
+    for (size_t jobs : { 1, 4 }) {
+        SimpleExecutor executor = SimpleExecutor(formatter, false, jobs, false, registry);
+
+        std::string output;
+        auto success = executor.performInvocations(
+            &context,
+            &launcher,
+            &filesystem,
+            { },
+            { first, second },
+            false,
+            nullptr,
+            &output);
+        ASSERT_TRUE(success.first);
+        EXPECT_EQ("first\nsecond\n", output);
+    }
+}
@@ -0,0 +1,105 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef __xcsdk_SDK_Cache_h
+#define __xcsdk_SDK_Cache_h
+
+#include <libutil/Filesystem.h>
+#include <plist/Object.h>
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace xcsdk { namespace SDK {
+
+/*
+ * Parsed property lists read from a developer root. Each one is used
+ * again for as long as the file it was read from is unchanged, so
+ * loading the same toolchains, platforms, and SDKs doesn't parse them.
+ */
+class Cache {
+private:
+    class Entry {
+    private:
+        libutil::Filesystem::Status _status;
+        plist::Object const        *_contents;
+        bool                        _used;
+
+    public:
+        Entry(libutil::Filesystem::Status const &status, plist::Object const *contents, bool used);
+
+    public:
+        libutil::Filesystem::Status const &status() const
+        { return _status; }
+        plist::Object const *contents() const
+        { return _contents; }
+
+    public:
+        bool used() const
+        { return _used; }
+        void use()
+        { _used = true; }
+    };
+
+private:
+    std::string                                 _developerRoot;
+    std::unordered_map<std::string, Entry>      _entries;
+    std::vector<std::unique_ptr<plist::Object>> _objects;
+    bool                                        _modified;
+
+public:
+    explicit Cache(std::string const &developerRoot);
+
+public:
+    /*
+     * The developer root the property lists are from.
+     */
+    std::string const &developerRoot() const
+    { return _developerRoot; }
+
+    /*
+     * If any property list had to be read since the cache was loaded.
+     */
+    bool modified() const
+    { return _modified; }
+
+public:
+    /*
+     * Read a property list file, or find it in the cache if it hasn't
+     * changed. The result is owned by the cache. Returns nullptr if the
+     * file can't be read or parsed.
+     */
+    plist::Object const *read(libutil::Filesystem const *filesystem, std::string const &path);
+
+public:
+    /*
+     * Write the property lists read through the cache to a path,
+     * replacing any existing cache there.
+     */
+    bool store(libutil::Filesystem *filesystem, std::string const &path) const;
+
+public:
+    /*
+     * Read a cache from a path. If there is no usable cache there, the
+     * result is empty.
+     */
+    static Cache
+    Load(libutil::Filesystem const *filesystem, std::string const &path, std::string const &developerRoot);
+
+    /*
+     * The path to cache a developer root at, in a cache directory.
+     */
+    static std::string
+    Path(std::string const &directory, std::string const &developerRoot);
+};
+
+} }
+
+#endif  // !__xcsdk_SDK_Cache_h
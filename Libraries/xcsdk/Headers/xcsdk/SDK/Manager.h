@@ -9,6 +9,7 @@
 #ifndef __xcsdk_SDK_Manager_h
 #define __xcsdk_SDK_Manager_h
 
+#include <xcsdk/SDK/Cache.h>
 #include <xcsdk/SDK/Platform.h>
 #include <xcsdk/SDK/Toolchain.h>
 #include <xcsdk/SDK/Target.h>
@@ -19,6 +20,8 @@
 #include <ext/optional>
 
 namespace libutil { class Filesystem; }
+namespace process { class Context; }
+namespace process { class User; }
 namespace xcsdk { class Configuration; }
 
 namespace xcsdk { namespace SDK {
@@ -104,9 +107,23 @@ public:
 
 public:
     /*
-     * Load from a developer root. Returns nullptr on error.
+     * Load from a developer root. Property lists are read through the
+     * cache, if one is provided. Returns nullptr on error.
      */
-    static std::shared_ptr<Manager> Open(libutil::Filesystem const *filesystem, std::string const &path, ext::optional<Configuration> const &configuration);
+    static std::shared_ptr<Manager> Open(libutil::Filesystem const *filesystem, std::string const &path, ext::optional<Configuration> const &configuration, Cache *cache = nullptr);
+
+    /*
+     * Load from a developer root, using the property lists cached in a
+     * directory by a previous load if they have not changed. The cache
+     * is updated if any had to be read. Returns nullptr on error.
+     */
+    static std::shared_ptr<Manager> Open(libutil::Filesystem *filesystem, std::string const &path, ext::optional<Configuration> const &configuration, std::string const &cacheDirectory);
+
+public:
+    /*
+     * The directory to cache developer roots in, if any.
+     */
+    static ext::optional<std::string> DefaultCacheDirectory(process::User const *user, process::Context const *processContext);
 };
 
 } }
@@ -127,7 +127,7 @@ public:
     std::vector<std::string> executablePaths() const;
 
 public:
-    static Platform::shared_ptr Open(libutil::Filesystem const *filesystem, std::shared_ptr<Manager> manager, std::string const &path);
+    static Platform::shared_ptr Open(libutil::Filesystem const *filesystem, std::shared_ptr<Manager> manager, std::string const &path, Cache *cache = nullptr);
 
 private:
     bool parse(plist::Dictionary const *dict);
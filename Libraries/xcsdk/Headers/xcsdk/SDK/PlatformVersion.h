@@ -18,6 +18,8 @@ namespace plist { class Dictionary; }
 
 namespace xcsdk { namespace SDK {
 
+class Cache;
+
 class PlatformVersion {
 public:
     typedef std::shared_ptr <PlatformVersion> shared_ptr;
@@ -48,7 +50,7 @@ public:
     { return _bundleVersion; }
 
 public:
-    static PlatformVersion::shared_ptr Open(libutil::Filesystem const *filesystem, std::string const &path);
+    static PlatformVersion::shared_ptr Open(libutil::Filesystem const *filesystem, std::string const &path, Cache *cache = nullptr);
 
 private:
     bool parse(plist::Dictionary const *dict);
@@ -62,18 +62,19 @@ LoadArray(plist::Array const *array)
 ext::optional<Configuration> Configuration::
 Load(Filesystem const *filesystem, std::vector<std::string> const &paths)
 {
-    std::vector<uint8_t> contents;
+    std::unique_ptr<Filesystem::MappedFile> contents;
     for (std::string const &path : paths) {
-        if (filesystem->read(&contents, path)) {
+        contents = filesystem->map(path);
+        if (contents != nullptr) {
             break;
         }
     }
 
-    if (contents.size() == 0) {
+    if (contents == nullptr || contents->contents().empty()) {
         return ext::nullopt;
     }
 
-    auto result = plist::Format::Any::Deserialize(contents);
+    auto result = plist::Format::Any::Deserialize(contents->contents());
     if (result.first == nullptr) {
         return ext::nullopt;
     }
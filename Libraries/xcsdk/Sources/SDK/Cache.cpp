@@ -0,0 +1,184 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree.
+ */
+
+#include <xcsdk/SDK/Cache.h>
+#include <libutil/PersistentCache.h>
+#include <plist/Array.h>
+#include <plist/Dictionary.h>
+#include <plist/Integer.h>
+#include <plist/String.h>
+#include <plist/Format/Any.h>
+#include <plist/Format/Binary.h>
+
+#include <algorithm>
+
+using xcsdk::SDK::Cache;
+using libutil::Filesystem;
+using libutil::PersistentCache;
+
+/*
+ * Increment when the format of the cache changes.
+ */
+static int64_t const CacheVersion = 1;
+
+Cache::Entry::
+Entry(Filesystem::Status const &status, plist::Object const *contents, bool used) :
+    _status  (status),
+    _contents(contents),
+    _used    (used)
+{
+}
+
+Cache::
+Cache(std::string const &developerRoot) :
+    _developerRoot(developerRoot),
+    _modified     (false)
+{
+}
+
+plist::Object const *Cache::
+read(Filesystem const *filesystem, std::string const &path)
+{
+    /*
+     * The status is read before the contents, so if the file changes while
+     * it is being read, the entry is out of date and will be read again.
+     */
+    ext::optional<Filesystem::Status> status = filesystem->stat(path);
+    if (!status) {
+        return nullptr;
+    }
+
+    auto it = _entries.find(path);
+    if (it != _entries.end()) {
+        if (PersistentCache::StatusEqual(it->second.status(), *status)) {
+            it->second.use();
+            return it->second.contents();
+        }
+
+        _entries.erase(it);
+    }
+
+    std::unique_ptr<Filesystem::MappedFile> contents = filesystem->map(path);
+    if (contents == nullptr) {
+        return nullptr;
+    }
+
+    auto result = plist::Format::Any::Deserialize(contents->contents());
+    if (result.first == nullptr) {
+        return nullptr;
+    }
+
+    plist::Object const *object = result.first.get();
+    _objects.push_back(std::move(result.first));
+    _entries.insert({ path, Entry(*status, object, true) });
+    _modified = true;
+
+    return object;
+}
+
+bool Cache::
+store(Filesystem *filesystem, std::string const &path) const
+{
+    /*
+     * Only files read this time are kept, so files that are no longer part
+     * of the developer root don't accumulate. Sort for a stable output.
+     */
+    std::vector<std::pair<std::string, Entry const *>> entries;
+    for (auto const &entry : _entries) {
+        if (entry.second.used()) {
+            entries.push_back({ entry.first, &entry.second });
+        }
+    }
+
+    std::sort(entries.begin(), entries.end(), [](std::pair<std::string, Entry const *> const &a, std::pair<std::string, Entry const *> const &b) -> bool {
+        return a.first < b.first;
+    });
+
+    auto files = plist::Array::New();
+    for (auto const &entry : entries) {
+        auto file = plist::Dictionary::New();
+        file->set("Path", plist::String::New(entry.first));
+        file->set("Type", plist::Integer::New(static_cast<int64_t>(entry.second->status().type())));
+        file->set("Size", plist::Integer::New(static_cast<int64_t>(entry.second->status().size())));
+        file->set("ModificationTime", plist::Integer::New(entry.second->status().modificationTime()));
+        file->set("Contents", entry.second->contents()->copy());
+        files->append(std::move(file));
+    }
+
+    auto root = plist::Dictionary::New();
+    root->set("Version", plist::Integer::New(CacheVersion));
+    root->set("DeveloperRoot", plist::String::New(_developerRoot));
+    root->set("Files", std::move(files));
+
+    auto serialize = plist::Format::Binary::Serialize(root.get(), plist::Format::Binary::Create());
+    if (serialize.first == nullptr) {
+        return false;
+    }
+
+    return PersistentCache::Write(filesystem, *serialize.first, path);
+}
+
+Cache Cache::
+Load(Filesystem const *filesystem, std::string const &path, std::string const &developerRoot)
+{
+    Cache cache = Cache(developerRoot);
+
+    if (!filesystem->exists(path)) {
+        return cache;
+    }
+
+    std::unique_ptr<Filesystem::MappedFile> contents = filesystem->map(path);
+    if (contents == nullptr) {
+        return cache;
+    }
+
+    auto deserialize = plist::Format::Binary::Deserialize(contents->contents(), plist::Format::Binary::Create());
+    auto root = plist::CastTo<plist::Dictionary>(deserialize.first.get());
+    if (root == nullptr) {
+        return cache;
+    }
+
+    /*
+     * The developer root is checked in case two developer roots hash the same.
+     */
+    auto version = root->value<plist::Integer>("Version");
+    auto storedRoot = root->value<plist::String>("DeveloperRoot");
+    auto files = root->value<plist::Array>("Files");
+    if (version == nullptr || version->value() != CacheVersion || storedRoot == nullptr || storedRoot->value() != developerRoot || files == nullptr) {
+        return cache;
+    }
+
+    for (size_t n = 0; n < files->count(); n++) {
+        auto file = files->value<plist::Dictionary>(n);
+        if (file == nullptr) {
+            continue;
+        }
+
+        auto path = file->value<plist::String>("Path");
+        auto type = file->value<plist::Integer>("Type");
+        auto size = file->value<plist::Integer>("Size");
+        auto modificationTime = file->value<plist::Integer>("ModificationTime");
+        auto contents = file->value("Contents");
+        if (path == nullptr || type == nullptr || size == nullptr || modificationTime == nullptr || contents == nullptr) {
+            continue;
+        }
+
+        /* Entries are used in place, in the cache's contents. */
+        Filesystem::Status status = Filesystem::Status(static_cast<Filesystem::Type>(type->value()), static_cast<uint64_t>(size->value()), modificationTime->value());
+        cache._entries.insert({ path->value(), Entry(status, contents, false) });
+    }
+
+    cache._objects.push_back(std::move(deserialize.first));
+    return cache;
+}
+
+std::string Cache::
+Path(std::string const &directory, std::string const &developerRoot)
+{
+    return PersistentCache::Path(directory, developerRoot);
+}
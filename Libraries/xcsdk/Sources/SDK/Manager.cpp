@@ -9,6 +9,9 @@
 #include <xcsdk/SDK/Manager.h>
 #include <xcsdk/Configuration.h>
 #include <libutil/FSUtil.h>
+#include <libutil/PersistentCache.h>
+#include <process/Context.h>
+#include <process/User.h>
 #include <pbxsetting/Setting.h>
 #include <pbxsetting/Type.h>
 
@@ -16,6 +19,7 @@
 #include <iostream>
 
 using xcsdk::Configuration;
+using xcsdk::SDK::Cache;
 using xcsdk::SDK::Manager;
 using xcsdk::SDK::Platform;
 using xcsdk::SDK::Target;
@@ -167,7 +171,7 @@ executablePaths(Platform::shared_ptr const &platform, Target::shared_ptr const &
 }
 
 std::shared_ptr<Manager> Manager::
-Open(Filesystem const *filesystem, std::string const &path, ext::optional<Configuration> const &configuration)
+Open(Filesystem const *filesystem, std::string const &path, ext::optional<Configuration> const &configuration, Cache *cache)
 {
     if (path.empty()) {
         fprintf(stderr, "error: empty path for sdk manager\n");
@@ -191,7 +195,7 @@ Open(Filesystem const *filesystem, std::string const &path, ext::optional<Config
             }
 
             auto path = _resolvePath(filesystem, toolchainsPath + "/" + filename);
-            auto toolchain = SDK::Toolchain::Open(filesystem, path);
+            auto toolchain = SDK::Toolchain::Open(filesystem, path, cache);
             if (toolchain != nullptr) {
                 toolchains.push_back(toolchain);
             }
@@ -213,7 +217,7 @@ Open(Filesystem const *filesystem, std::string const &path, ext::optional<Config
             }
 
             auto path = _resolvePath(filesystem, platformsPath + "/" + filename);
-            auto platform = SDK::Platform::Open(filesystem, manager, path);
+            auto platform = SDK::Platform::Open(filesystem, manager, path, cache);
             if (platform != nullptr) {
                 platforms.push_back(platform);
             }
@@ -226,3 +230,31 @@ Open(Filesystem const *filesystem, std::string const &path, ext::optional<Config
 
     return manager;
 }
+
+std::shared_ptr<Manager> Manager::
+Open(Filesystem *filesystem, std::string const &path, ext::optional<Configuration> const &configuration, std::string const &cacheDirectory)
+{
+    std::string cachePath = Cache::Path(cacheDirectory, path);
+    Cache cache = Cache::Load(filesystem, cachePath, path);
+
+    std::shared_ptr<Manager> manager = Open(filesystem, path, configuration, &cache);
+    if (manager == nullptr) {
+        return nullptr;
+    }
+
+    /*
+     * Only write the cache if something changed; a failure to write it
+     * means the next load will be slower, but is otherwise harmless.
+     */
+    if (cache.modified() && !cache.store(filesystem, cachePath)) {
+        fprintf(stderr, "warning: failed to write sdk cache '%s'\n", cachePath.c_str());
+    }
+
+    return manager;
+}
+
+ext::optional<std::string> Manager::
+DefaultCacheDirectory(process::User const *user, process::Context const *processContext)
+{
+    return libutil::PersistentCache::Directory(processContext->environmentVariable("XCBUILD_CACHE_DIR"), user->userCacheDirectory(processContext), "SDKs");
+}
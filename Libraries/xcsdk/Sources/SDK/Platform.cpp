@@ -7,6 +7,7 @@
  */
 
 #include <xcsdk/SDK/Platform.h>
+#include <xcsdk/SDK/Cache.h>
 #include <xcsdk/SDK/Manager.h>
 #include <pbxsetting/Type.h>
 #include <libutil/Filesystem.h>
@@ -15,12 +16,12 @@
 #include <plist/Boolean.h>
 #include <plist/Dictionary.h>
 #include <plist/String.h>
-#include <plist/Format/Any.h>
 #include <plist/Keys/Unpack.h>
 
 #include <algorithm>
 
 using xcsdk::SDK::Platform;
+using xcsdk::SDK::Cache;
 using xcsdk::SDK::Manager;
 using xcsdk::SDK::Target;
 using libutil::Filesystem;
@@ -299,7 +300,7 @@ parse(plist::Dictionary const *dict)
 }
 
 Platform::shared_ptr Platform::
-Open(Filesystem const *filesystem, std::shared_ptr<Manager> manager, std::string const &path)
+Open(Filesystem const *filesystem, std::shared_ptr<Manager> manager, std::string const &path, Cache *cache)
 {
     if (path.empty()) {
         return nullptr;
@@ -318,20 +319,11 @@ Open(Filesystem const *filesystem, std::shared_ptr<Manager> manager, std::string
         return nullptr;
     }
 
-    std::vector<uint8_t> contents;
-    if (!filesystem->read(&contents, settingsFileName)) {
-        return nullptr;
-    }
-
     /*
      * Parse platform info property list.
      */
-    auto result = plist::Format::Any::Deserialize(contents);
-    if (result.first == nullptr) {
-        return nullptr;
-    }
-
-    plist::Dictionary *plist = plist::CastTo<plist::Dictionary>(result.first.get());
+    Cache uncached = Cache(std::string());
+    plist::Dictionary const *plist = plist::CastTo<plist::Dictionary>((cache != nullptr ? cache : &uncached)->read(filesystem, settingsFileName));
     if (plist == nullptr) {
         return nullptr;
     }
@@ -353,7 +345,7 @@ Open(Filesystem const *filesystem, std::shared_ptr<Manager> manager, std::string
     /*
      * Load platform version information.
      */
-    platform->_platformVersion = PlatformVersion::Open(filesystem, platform->_path);
+    platform->_platformVersion = PlatformVersion::Open(filesystem, platform->_path, cache);
 
     /*
      * Load all the SDKs inside the platform.
@@ -364,7 +356,7 @@ Open(Filesystem const *filesystem, std::shared_ptr<Manager> manager, std::string
             return;
         }
 
-        if (auto target = Target::Open(filesystem, manager, platform, sdksPath + "/" + filename)) {
+        if (auto target = Target::Open(filesystem, manager, platform, sdksPath + "/" + filename, cache)) {
             platform->_targets.push_back(target);
         }
     });
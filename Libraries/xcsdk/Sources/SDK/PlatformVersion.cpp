@@ -7,13 +7,14 @@
  */
 
 #include <xcsdk/SDK/PlatformVersion.h>
+#include <xcsdk/SDK/Cache.h>
 #include <libutil/Filesystem.h>
 #include <plist/Dictionary.h>
 #include <plist/String.h>
-#include <plist/Format/Any.h>
 #include <plist/Keys/Unpack.h>
 
 using xcsdk::SDK::PlatformVersion;
+using xcsdk::SDK::Cache;
 using libutil::Filesystem;
 
 PlatformVersion::
@@ -66,7 +67,7 @@ parse(plist::Dictionary const *dict)
 }
 
 PlatformVersion::shared_ptr PlatformVersion::
-Open(Filesystem const *filesystem, std::string const &path)
+Open(Filesystem const *filesystem, std::string const &path, Cache *cache)
 {
     if (path.empty()) {
         return nullptr;
@@ -85,20 +86,11 @@ Open(Filesystem const *filesystem, std::string const &path)
         return nullptr;
     }
 
-    std::vector<uint8_t> contents;
-    if (!filesystem->read(&contents, versionFileName)) {
-        return nullptr;
-    }
-
     /*
      * Parse property list.
      */
-    auto result = plist::Format::Any::Deserialize(contents);
-    if (result.first == nullptr) {
-        return nullptr;
-    }
-
-    plist::Dictionary *plist = plist::CastTo<plist::Dictionary>(result.first.get());
+    Cache uncached = Cache(std::string());
+    plist::Dictionary const *plist = plist::CastTo<plist::Dictionary>((cache != nullptr ? cache : &uncached)->read(filesystem, versionFileName));
     if (plist == nullptr) {
         return nullptr;
     }
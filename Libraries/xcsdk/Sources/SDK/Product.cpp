@@ -7,13 +7,14 @@
  */
 
 #include <xcsdk/SDK/Product.h>
+#include <xcsdk/SDK/Cache.h>
 #include <libutil/Filesystem.h>
 #include <plist/Dictionary.h>
 #include <plist/String.h>
-#include <plist/Format/Any.h>
 #include <plist/Keys/Unpack.h>
 
 using xcsdk::SDK::Product;
+using xcsdk::SDK::Cache;
 using libutil::Filesystem;
 
 Product::
@@ -61,7 +62,7 @@ parse(plist::Dictionary const *dict)
 }
 
 Product::shared_ptr Product::
-Open(Filesystem const *filesystem, std::string const &path)
+Open(Filesystem const *filesystem, std::string const &path, Cache *cache)
 {
     if (path.empty()) {
         return nullptr;
@@ -80,20 +81,11 @@ Open(Filesystem const *filesystem, std::string const &path)
         return nullptr;
     }
 
-    std::vector<uint8_t> contents;
-    if (!filesystem->read(&contents, settingsFileName)) {
-        return nullptr;
-    }
-
     /*
      * Parse property list.
      */
-    auto result = plist::Format::Any::Deserialize(contents);
-    if (result.first == nullptr) {
-        return nullptr;
-    }
-
-    plist::Dictionary *plist = plist::CastTo<plist::Dictionary>(result.first.get());
+    Cache uncached = Cache(std::string());
+    plist::Dictionary const *plist = plist::CastTo<plist::Dictionary>((cache != nullptr ? cache : &uncached)->read(filesystem, settingsFileName));
     if (plist == nullptr) {
         return nullptr;
     }
@@ -7,18 +7,19 @@
  */
 
 #include <xcsdk/SDK/Target.h>
+#include <xcsdk/SDK/Cache.h>
 #include <xcsdk/SDK/Manager.h>
 #include <pbxsetting/Type.h>
 #include <plist/Array.h>
 #include <plist/Boolean.h>
 #include <plist/Dictionary.h>
 #include <plist/String.h>
-#include <plist/Format/Any.h>
 #include <plist/Keys/Unpack.h>
 #include <libutil/Filesystem.h>
 #include <libutil/FSUtil.h>
 
 using xcsdk::SDK::Target;
+using xcsdk::SDK::Cache;
 using xcsdk::SDK::Manager;
 using xcsdk::SDK::Platform;
 using libutil::Filesystem;
@@ -200,7 +201,7 @@ parse(plist::Dictionary const *dict)
 }
 
 Target::shared_ptr Target::
-Open(Filesystem const *filesystem, std::shared_ptr<Manager> manager, std::shared_ptr<Platform> platform, std::string const &path)
+Open(Filesystem const *filesystem, std::shared_ptr<Manager> manager, std::shared_ptr<Platform> platform, std::string const &path, Cache *cache)
 {
     if (path.empty()) {
         return nullptr;
@@ -222,20 +223,11 @@ Open(Filesystem const *filesystem, std::shared_ptr<Manager> manager, std::shared
         return nullptr;
     }
 
-    std::vector<uint8_t> contents;
-    if (!filesystem->read(&contents, settingsFileName)) {
-        return nullptr;
-    }
-
     /*
      * Parse settings property list.
      */
-    auto result = plist::Format::Any::Deserialize(contents);
-    if (result.first == nullptr) {
-        return nullptr;
-    }
-
-    plist::Dictionary *plist = plist::CastTo<plist::Dictionary>(result.first.get());
+    Cache uncached = Cache(std::string());
+    plist::Dictionary const *plist = plist::CastTo<plist::Dictionary>((cache != nullptr ? cache : &uncached)->read(filesystem, settingsFileName));
     if (plist == nullptr) {
         return nullptr;
     }
@@ -259,7 +251,7 @@ Open(Filesystem const *filesystem, std::shared_ptr<Manager> manager, std::shared
     /*
      * Parse product information.
      */
-    target->_product = Product::Open(filesystem, target->_path);
+    target->_product = Product::Open(filesystem, target->_path, cache);
 
     return target;
 }
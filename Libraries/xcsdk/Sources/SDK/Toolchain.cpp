@@ -7,6 +7,7 @@
  */
 
 #include <xcsdk/SDK/Toolchain.h>
+#include <xcsdk/SDK/Cache.h>
 #include <libutil/Filesystem.h>
 #include <libutil/FSUtil.h>
 #include <plist/Array.h>
@@ -15,9 +16,9 @@
 #include <plist/Integer.h>
 #include <plist/String.h>
 #include <plist/Keys/Unpack.h>
-#include <plist/Format/Any.h>
 
 using xcsdk::SDK::Toolchain;
+using xcsdk::SDK::Cache;
 using libutil::Filesystem;
 using libutil::FSUtil;
 
@@ -133,7 +134,7 @@ parse(plist::Dictionary const *dict)
 }
 
 Toolchain::shared_ptr Toolchain::
-Open(Filesystem const *filesystem, std::string const &path)
+Open(Filesystem const *filesystem, std::string const &path, Cache *cache)
 {
     if (path.empty()) {
         return nullptr;
@@ -155,20 +156,11 @@ Open(Filesystem const *filesystem, std::string const &path)
         return nullptr;
     }
 
-    std::vector<uint8_t> contents;
-    if (!filesystem->read(&contents, settingsFileName)) {
-        return nullptr;
-    }
-
     /*
      * Parse property list.
      */
-    auto result = plist::Format::Any::Deserialize(contents);
-    if (result.first == nullptr) {
-        return nullptr;
-    }
-
-    plist::Dictionary *plist = plist::CastTo<plist::Dictionary>(result.first.get());
+    Cache uncached = Cache(std::string());
+    plist::Dictionary const *plist = plist::CastTo<plist::Dictionary>((cache != nullptr ? cache : &uncached)->read(filesystem, settingsFileName));
     if (plist == nullptr) {
         return nullptr;
     }
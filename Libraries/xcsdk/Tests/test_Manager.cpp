@@ -8,12 +8,14 @@
 
 #include <gtest/gtest.h>
 #include <xcsdk/Configuration.h>
+#include <xcsdk/SDK/Cache.h>
 #include <xcsdk/SDK/Manager.h>
 #include <xcsdk/SDK/Platform.h>
 #include <xcsdk/SDK/Toolchain.h>
 #include <libutil/MemoryFilesystem.h>
 
 using xcsdk::Configuration;
+using xcsdk::SDK::Cache;
 using xcsdk::SDK::Manager;
 using xcsdk::SDK::Platform;
 using xcsdk::SDK::Toolchain;
@@ -58,3 +60,45 @@ TEST(Manager, ConfigurationExtraPaths)
     Toolchain::shared_ptr const &toolchain = manager->toolchains().front();
     EXPECT_EQ(toolchain->identifier(), std::string("extra"));
 }
+
+TEST(Manager, Cache)
+{
+    auto filesystem = MemoryFilesystem({
+        MemoryFilesystem::Entry::Directory("Platforms", {
+            MemoryFilesystem::Entry::Directory("Test.platform", {
+                MemoryFilesystem::Entry::File("Info.plist", Contents("{ Identifier = test; Name = Test; }")),
+            }),
+        }),
+        MemoryFilesystem::Entry::Directory("Cache", { }),
+    });
+
+    /* The first load writes the cache. */
+    auto manager = Manager::Open(&filesystem, filesystem.path(""), ext::nullopt, filesystem.path("Cache"));
+    ASSERT_NE(manager, nullptr);
+    ASSERT_EQ(manager->platforms().size(), 1);
+    EXPECT_EQ(manager->platforms().front()->name(), "Test");
+
+    std::vector<std::string> cached;
+    filesystem.readDirectory(filesystem.path("Cache"), false, [&](std::string const &name) {
+        cached.push_back(name);
+    });
+    ASSERT_EQ(cached.size(), 1);
+
+    /* Unchanged files are found in the cache. */
+    Cache cache = Cache::Load(&filesystem, Cache::Path(filesystem.path("Cache"), filesystem.path("")), filesystem.path(""));
+    EXPECT_NE(cache.read(&filesystem, filesystem.path("") + "/Platforms/Test.platform/Info.plist"), nullptr);
+    EXPECT_FALSE(cache.modified());
+
+    /* Later loads use the cache. */
+    manager = Manager::Open(&filesystem, filesystem.path(""), ext::nullopt, filesystem.path("Cache"));
+    ASSERT_NE(manager, nullptr);
+    ASSERT_EQ(manager->platforms().size(), 1);
+    EXPECT_EQ(manager->platforms().front()->name(), "Test");
+
+    /* Changed files are read again. */
+    ASSERT_TRUE(filesystem.write(Contents("{ Identifier = test; Name = Changed; }"), filesystem.path("Platforms/Test.platform/Info.plist")));
+    manager = Manager::Open(&filesystem, filesystem.path(""), ext::nullopt, filesystem.path("Cache"));
+    ASSERT_NE(manager, nullptr);
+    ASSERT_EQ(manager->platforms().size(), 1);
+    EXPECT_EQ(manager->platforms().front()->name(), "Changed");
+}
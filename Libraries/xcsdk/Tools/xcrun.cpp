@@ -209,8 +209,8 @@ Help(std::string const &error = std::string())
     fprintf(stderr, "Options:\n");
     fprintf(stderr, INDENT "-v, --verbose\n");
     fprintf(stderr, INDENT "-l, --log\n");
-    fprintf(stderr, INDENT "-n, --no-cache (not implemented)\n");
-    fprintf(stderr, INDENT "-k, --kill-cache (not implemented)\n");
+    fprintf(stderr, INDENT "-n, --no-cache\n");
+    fprintf(stderr, INDENT "-k, --kill-cache\n");
 #undef INDENT
 
     return (error.empty() ? 0 : -1);
@@ -264,10 +264,13 @@ static int Run(Filesystem *filesystem, process::User const *user, process::Conte
     bool nocache = options.noCache() || (bool)processContext->environmentVariable("xcrun_nocache");
 
     /*
-     * Warn about unhandled arguments.
+     * Find the SDK cache. Killing the cache removes it, so it is rebuilt.
      */
-    if (nocache || options.killCache()) {
-        fprintf(stderr, "warning: cache options not implemented\n");
+    ext::optional<std::string> cacheDirectory = xcsdk::SDK::Manager::DefaultCacheDirectory(user, processContext);
+    if (cacheDirectory && options.killCache() && filesystem->exists(*cacheDirectory)) {
+        if (!filesystem->removeDirectory(*cacheDirectory, true)) {
+            fprintf(stderr, "warning: unable to remove cache '%s'\n", cacheDirectory->c_str());
+        }
     }
 
     /*
@@ -279,7 +282,12 @@ static int Run(Filesystem *filesystem, process::User const *user, process::Conte
         return -1;
     }
     auto configuration = xcsdk::Configuration::Load(filesystem, xcsdk::Configuration::DefaultPaths(user, processContext));
-    auto manager = xcsdk::SDK::Manager::Open(filesystem, *developerRoot, configuration);
+    std::shared_ptr<xcsdk::SDK::Manager> manager;
+    if (cacheDirectory && !nocache) {
+        manager = xcsdk::SDK::Manager::Open(filesystem, *developerRoot, configuration, *cacheDirectory);
+    } else {
+        manager = xcsdk::SDK::Manager::Open(filesystem, *developerRoot, configuration);
+    }
     if (manager == nullptr) {
         fprintf(stderr, "error: unable to load manager from '%s'\n", developerRoot->c_str());
         return -1;
@@ -453,7 +461,7 @@ static int Run(Filesystem *filesystem, process::User const *user, process::Conte
                 options.args(),
                 environment);
 
-            ext::optional<int> exitCode = processLauncher->launch(filesystem, &context);
+            ext::optional<int> exitCode = processLauncher->launch(filesystem, &context, nullptr);
             if (!exitCode) {
                 fprintf(stderr, "error: unable to execute tool '%s'\n", options.tool()->c_str());
                 return -1;